@@ -0,0 +1,357 @@
+/// \file BenchGeometry.cpp
+/// \brief A small benchmark program for the global functions in Geometry.hpp,
+///   and for how much memory a Mesh takes to prepare.
+/// \author Sean Malloy
+/// \version A08
+///
+/// Run with no arguments to time everything from 1 thousand to 10 million
+///   vertices, or pass a smaller maximum vertex count as the only argument.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "Bvh.hpp"
+#include "Geometry.hpp"
+#include "Mesh.hpp"
+#include "MockOpenGLContext.hpp"
+#include "Parallel.hpp"
+#include "Primitives.hpp"
+#include "ShaderProgram.hpp"
+#include "Simd.hpp"
+#include "TriangleBuffer.hpp"
+
+/// \brief Builds an unindexed, wavy grid of quads with interleaved position /
+///   normal data, the way a height-field import looks before indexing.
+/// \param[in] vertexCount The approximate number of vertices wanted.
+/// \return Six floats per vertex, six vertices per quad.
+std::vector<float>
+buildGridSoup (unsigned int vertexCount)
+{
+  const unsigned int quads = vertexCount / 6;
+  const unsigned int side = static_cast<unsigned int> (std::ceil (std::sqrt (quads)));
+  std::vector<float> soup;
+  soup.reserve (quads * 36);
+  const unsigned int corners[6][2] = { {0, 0}, {1, 0}, {0, 1}, {1, 1}, {0, 1}, {1, 0} };
+  for (unsigned int quad = 0; quad < quads; quad++)
+  {
+    unsigned int row = quad / side;
+    unsigned int column = quad % side;
+    for (unsigned int corner = 0; corner < 6; corner++)
+    {
+      float x = (column + corners[corner][0]) * 0.01f;
+      float z = (row + corners[corner][1]) * 0.01f;
+      float y = 0.1f * std::sin (x * 3.0f) * std::cos (z * 2.0f);
+      soup.push_back (x);
+      soup.push_back (y);
+      soup.push_back (z);
+      soup.push_back (0.0f);
+      soup.push_back (1.0f);
+      soup.push_back (0.0f);
+    }
+  }
+  return soup;
+}
+
+/// \brief Builds a wavy grid of triangles for the face kernels.
+/// \param[in] faceCount The approximate number of faces wanted.
+/// \return Two triangles per quad.
+std::vector<Triangle>
+buildGridTriangles (unsigned int faceCount)
+{
+  std::vector<float> soup = buildGridSoup (faceCount * 3);
+  std::vector<Triangle> faces (soup.size () / 18);
+  for (unsigned int face = 0; face < faces.size (); face++)
+  {
+    for (unsigned int corner = 0; corner < 3; corner++)
+    {
+      const float* vertex = &soup[(face * 3 + corner) * 6];
+      faces[face][corner] = Vector3 (vertex[0], vertex[1], vertex[2]);
+    }
+  }
+  return faces;
+}
+
+/// \brief Gets the number of seconds that have passed since some start time.
+double
+secondsSince (std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+}
+
+/// \brief Reads one of this process's memory statistics, in kilobytes.
+/// \param[in] field "VmRSS" for the resident set size now, or "VmHWM" for
+///   its peak.
+/// \return The value, or 0 where /proc is not available.
+long
+readMemoryKilobytes (const std::string& field)
+{
+  std::ifstream status ("/proc/self/status");
+  std::string line;
+  while (std::getline (status, line))
+  {
+    if (line.compare (0, field.size () + 1, field + ":") == 0)
+    {
+      return std::stol (line.substr (field.size () + 1));
+    }
+  }
+  return 0;
+}
+
+int
+main (int argc, char* argv[])
+{
+  unsigned long maxVertices = 10000000;
+  if (argc > 1)
+  {
+    maxVertices = std::strtoul (argv[1], nullptr, 10);
+  }
+
+  std::printf ("indexData (6 floats per vertex)\n");
+  std::printf ("%12s %12s %12s %14s\n", "vertices", "unique", "seconds", "ns / vertex");
+  for (unsigned long vertices = 1000; vertices <= maxVertices; vertices *= 10)
+  {
+    std::vector<float> geometry = buildGridSoup (vertices);
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    auto start = std::chrono::steady_clock::now ();
+    indexData (geometry, 6, data, indices);
+    double seconds = secondsSince (start);
+    std::printf ("%12zu %12zu %12.4f %14.1f\n", indices.size (), data.size () / 6,
+                 seconds, seconds * 1e9 / indices.size ());
+  }
+
+  std::printf ("\nindexData with %u threads (6 floats per vertex)\n", resolveThreadCount (0));
+  std::printf ("%12s %12s %12s %14s\n", "vertices", "unique", "seconds", "ns / vertex");
+  for (unsigned long vertices = 1000; vertices <= maxVertices; vertices *= 10)
+  {
+    std::vector<float> geometry = buildGridSoup (vertices);
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    auto start = std::chrono::steady_clock::now ();
+    indexData (geometry, 6, data, indices, 0);
+    double seconds = secondsSince (start);
+    std::printf ("%12zu %12zu %12.4f %14.1f\n", indices.size (), data.size () / 6,
+                 seconds, seconds * 1e9 / indices.size ());
+  }
+
+  const unsigned int FACES = std::min (maxVertices / 3, 1000000ul);
+  std::vector<Triangle> faces = buildGridTriangles (FACES);
+  std::printf ("\nFace kernels on %zu faces, %u floats per SIMD register\n",
+               faces.size (), FloatLanes::WIDTH);
+  std::printf ("%24s %12s %12s\n", "", "scalar", "SoA + SIMD");
+
+  auto start = std::chrono::steady_clock::now ();
+  TriangleBuffer buffer (faces);
+  double toBuffer = secondsSince (start);
+  start = std::chrono::steady_clock::now ();
+  std::vector<Triangle> back = buffer.toTriangles ();
+  double fromBuffer = secondsSince (start);
+  std::printf ("%24s %12s %12.4f\n", "to TriangleBuffer", "", toBuffer);
+  std::printf ("%24s %12s %12.4f\n", "to std::vector<Triangle>", "", fromBuffer);
+
+  start = std::chrono::steady_clock::now ();
+  std::vector<Vector3> scalarNormals = computeFaceNormals (faces);
+  double scalar = secondsSince (start);
+  start = std::chrono::steady_clock::now ();
+  std::vector<Vector3> simdNormals = buffer.computeFaceNormals ();
+  std::printf ("%24s %12.4f %12.4f\n", "face normals", scalar, secondsSince (start));
+
+  start = std::chrono::steady_clock::now ();
+  std::vector<float> scalarAreas;
+  for (const Triangle& face : faces)
+  {
+    scalarAreas.push_back (0.5f * ((face[1] - face[0]).cross (face[2] - face[0])).length ());
+  }
+  scalar = secondsSince (start);
+  start = std::chrono::steady_clock::now ();
+  std::vector<float> simdAreas = buffer.computeAreas ();
+  std::printf ("%24s %12.4f %12.4f\n", "areas", scalar, secondsSince (start));
+
+  start = std::chrono::steady_clock::now ();
+  std::vector<float> scalarAngles;
+  for (const Triangle& face : faces)
+  {
+    for (unsigned int corner = 0; corner < 3; corner++)
+    {
+      scalarAngles.push_back ((face[(corner + 1) % 3] - face[corner]).angleBetween (face[(corner + 2) % 3] - face[corner]));
+    }
+  }
+  scalar = secondsSince (start);
+  start = std::chrono::steady_clock::now ();
+  std::vector<float> simdAngles = buffer.computeCornerAngles ();
+  std::printf ("%24s %12.4f %12.4f\n", "corner angles", scalar, secondsSince (start));
+
+  std::printf ("\nBounding volume hierarchy picking, rays cast down onto the grid\n");
+  std::printf ("%12s %12s %14s %14s\n", "triangles", "nodes", "build seconds", "us / ray");
+  for (unsigned long vertices = 3000; vertices <= std::min (maxVertices, 3000000ul); vertices *= 10)
+  {
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    indexData (buildGridSoup (vertices), 6, data, indices);
+    start = std::chrono::steady_clock::now ();
+    Bvh bvh = buildBvh (data, 6, indices);
+    double build = secondsSince (start);
+    BoundingBox box = computeBoundingBox (data, 6);
+    const unsigned int RAYS = 10000;
+    unsigned int hits = 0;
+    start = std::chrono::steady_clock::now ();
+    for (unsigned int ray = 0; ray < RAYS; ray++)
+    {
+      float x = box.m_min.m_x + (box.m_max.m_x - box.m_min.m_x) * ((ray * 7919) % RAYS) / RAYS;
+      float z = box.m_min.m_z + (box.m_max.m_z - box.m_min.m_z) * ((ray * 104729) % RAYS) / RAYS;
+      RayHit hit;
+      Vector3 direction (0.1f, -1.0f, 0.05f);
+      direction.normalize ();
+      hits += intersectBvh (bvh, { Vector3 (x, 1.0f, z), direction },
+                            std::numeric_limits<float>::infinity (), hit);
+    }
+    double seconds = secondsSince (start);
+    std::printf ("%12zu %12zu %14.4f %14.3f\n", indices.size () / 3, bvh.m_nodes.size (),
+                 build, seconds * 1e6 / RAYS);
+    if (hits == 0)
+    {
+      std::printf ("no ray hit the grid\n");
+    }
+  }
+
+  std::printf ("\nIndexed primitive generators, 1 thread and %u threads\n", resolveThreadCount (0));
+  std::printf ("%24s %12s %12s %12s\n", "", "triangles", "1 thread", "all threads");
+  const unsigned int SIDE = static_cast<unsigned int> (std::sqrt (std::min (maxVertices, 10000000ul) / 2.0));
+  std::vector<float> heights (static_cast<std::size_t> (SIDE + 1) * (SIDE + 1));
+  for (std::size_t sample = 0; sample < heights.size (); sample++)
+  {
+    heights[sample] = 0.1f * std::sin (sample % (SIDE + 1) * 0.01f) * std::cos (sample / (SIDE + 1) * 0.02f);
+  }
+  const std::pair<const char*, std::function<void (std::vector<float>&, std::vector<unsigned int>&, unsigned int)>> GENERATORS[] = {
+    { "UV sphere", [&] (std::vector<float>& d, std::vector<unsigned int>& i, unsigned int t) {
+        buildUvSphere (1.0f, SIDE, SIDE / 2 + 1, d, i, t); } },
+    { "icosphere", [&] (std::vector<float>& d, std::vector<unsigned int>& i, unsigned int t) {
+        buildIcosphere (1.0f, static_cast<unsigned int> (SIDE / std::sqrt (20.0)), d, i, t); } },
+    { "torus", [&] (std::vector<float>& d, std::vector<unsigned int>& i, unsigned int t) {
+        buildTorus (1.0f, 0.25f, SIDE, SIDE / 2, d, i, t); } },
+    { "cylinder", [&] (std::vector<float>& d, std::vector<unsigned int>& i, unsigned int t) {
+        buildCylinder (1.0f, 2.0f, SIDE, SIDE / 2, d, i, t); } },
+    { "height field", [&] (std::vector<float>& d, std::vector<unsigned int>& i, unsigned int t) {
+        buildHeightField (heights, SIDE + 1, 0.01f, d, i, t); } } };
+  for (const auto& generator : GENERATORS)
+  {
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    start = std::chrono::steady_clock::now ();
+    generator.second (data, indices, 1);
+    double serial = secondsSince (start);
+    start = std::chrono::steady_clock::now ();
+    generator.second (data, indices, 0);
+    std::printf ("%24s %12zu %12.4f %12.4f\n", generator.first, indices.size () / 3, serial,
+                 secondsSince (start));
+  }
+
+  std::printf ("\nRandom colors on %zu faces, 1 thread and %u threads\n", faces.size (),
+               resolveThreadCount (0));
+  std::printf ("%24s %12s %12s\n", "", "1 thread", "all threads");
+  start = std::chrono::steady_clock::now ();
+  std::vector<Vector3> serialColors = generateRandomFaceColors (faces, 1, 1);
+  double serialSeconds = secondsSince (start);
+  start = std::chrono::steady_clock::now ();
+  std::vector<Vector3> parallelColors = generateRandomFaceColors (faces, 1, 0);
+  std::printf ("%24s %12.4f %12.4f\n", "face colors", serialSeconds, secondsSince (start));
+  start = std::chrono::steady_clock::now ();
+  serialColors = generateRandomVertexColors (faces, 1, 1);
+  serialSeconds = secondsSince (start);
+  start = std::chrono::steady_clock::now ();
+  parallelColors = generateRandomVertexColors (faces, 1, 0);
+  std::printf ("%24s %12.4f %12.4f\n", "vertex colors", serialSeconds, secondsSince (start));
+  if (serialColors != parallelColors)
+  {
+    std::printf ("colors differ between thread counts\n");
+  }
+
+  // Last, since the allocator is retuned for it.
+#ifdef __GLIBC__
+  // A fixed threshold keeps every large vector in its own mapping, which
+  //   goes back to the system as soon as it is freed.
+  mallopt (M_MMAP_THRESHOLD, 128 * 1024);
+#endif
+  const unsigned int COLUMNS = static_cast<unsigned int> (std::sqrt (std::min (maxVertices, 490000ul))) + 1;
+  const std::vector<float> FLAT (static_cast<std::size_t> (COLUMNS) * COLUMNS, 0.0f);
+  std::printf ("\nMesh memory while preparing a %u x %u height field, counting the mock"
+               " context's copy of the buffers\n", COLUMNS - 1, COLUMNS - 1);
+  std::printf ("%24s %12s %12s %12s\n", "retention", "peak KiB", "steady KiB", "retained KiB");
+  const std::pair<const char*, GeometryRetention> RETENTIONS[] = {
+    { "keep", GeometryRetention::KEEP }, { "discard", GeometryRetention::DISCARD },
+    { "compress", GeometryRetention::COMPRESS } };
+  for (const auto& retention : RETENTIONS)
+  {
+    MockOpenGLContext context;
+    ShaderProgram shader (&context);
+    // Writing 5 resets the peak, where the kernel allows it.
+    std::ofstream ("/proc/self/clear_refs") << "5";
+    long before = readMemoryKilobytes ("VmRSS");
+    Mesh mesh (&context, &shader, NormalsLayout ());
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    buildHeightField (FLAT, COLUMNS, 1.0f, data, indices, 1);
+    mesh.addGeometry (std::move (data));
+    mesh.addIndices (std::move (indices));
+    mesh.setGeometryRetention (retention.second);
+    mesh.prepareVao ();
+    long steady = readMemoryKilobytes ("VmRSS") - before;
+    long peak = readMemoryKilobytes ("VmHWM") - before;
+    std::printf ("%24s %12ld %12ld %12zu\n", retention.first, peak, steady,
+                 mesh.getRetainedBytes () / 1024);
+  }
+
+  const std::size_t MODEL_VERTICES = std::min (maxVertices, 1000000ul);
+  std::printf ("\nMesh memory while loading %zu vertices and %zu triangles\n", MODEL_VERTICES,
+               2 * MODEL_VERTICES);
+  std::printf ("%24s %12s\n", "", "peak KiB");
+  for (unsigned int move = 0; move < 2; move++)
+  {
+    MockOpenGLContext context;
+    ShaderProgram shader (&context);
+    std::ofstream ("/proc/self/clear_refs") << "5";
+    long before = readMemoryKilobytes ("VmRSS");
+    {
+      // Built as the loader builds it, then handed to the mesh.
+      std::vector<float> data;
+      std::vector<unsigned int> indices;
+      data.reserve (MODEL_VERTICES * 6);
+      indices.reserve (MODEL_VERTICES * 6);
+      for (std::size_t vertex = 0; vertex < MODEL_VERTICES; vertex++)
+      {
+        unsigned int next = (vertex + 1) % MODEL_VERTICES;
+        unsigned int after = (vertex + 2) % MODEL_VERTICES;
+        data.insert (data.end (), { float (vertex), 0.0f, 0.0f, 0.0f, 0.0f, 1.0f });
+        indices.insert (indices.end (), { unsigned (vertex), next, after, unsigned (vertex), after, next });
+      }
+      Mesh mesh (&context, &shader, NormalsLayout ());
+      if (move == 1)
+      {
+        mesh.addGeometry (std::move (data));
+        mesh.addIndices (std::move (indices));
+      }
+      else
+      {
+        mesh.addGeometry (data);
+        mesh.addIndices (indices);
+      }
+    }
+    std::printf ("%24s %12ld\n", move == 1 ? "moved in" : "copied in",
+                 readMemoryKilobytes ("VmHWM") - before);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,233 @@
+/// \file BufferArena.cpp
+/// \brief Implementation of BufferArena, which packs the vertex and index
+///   data of many meshes into a few large buffers.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// System includes
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+/******************************************************************/
+// Local includes
+#include "BufferArena.hpp"
+
+/******************************************************************/
+/// Index ranges start on a multiple of this many bytes, which suits every
+///   index type.
+static const std::size_t INDEX_ALIGNMENT = 4;
+
+/******************************************************************/
+RangeAllocator::RangeAllocator (std::size_t capacity)
+  : m_free (),
+    m_capacity (capacity),
+    m_used (0)
+{
+  if (capacity > 0)
+  {
+    m_free[0] = capacity;
+  }
+}
+
+bool
+RangeAllocator::allocate (std::size_t size, std::size_t alignment, std::size_t& offset)
+{
+  for (auto range = m_free.begin (); range != m_free.end (); ++range)
+  {
+    std::size_t start = (range->first + alignment - 1) / alignment * alignment;
+    std::size_t end = range->first + range->second;
+    if (start + size > end)
+    {
+      continue;
+    }
+    std::size_t before = range->first;
+    m_free.erase (range);
+    if (start > before)
+    {
+      m_free[before] = start - before;
+    }
+    if (end > start + size)
+    {
+      m_free[start + size] = end - (start + size);
+    }
+    m_used += size;
+    offset = start;
+    return true;
+  }
+  return false;
+}
+
+void
+RangeAllocator::release (std::size_t offset, std::size_t size)
+{
+  if (size == 0)
+  {
+    return;
+  }
+  m_used -= size;
+  auto next = m_free.lower_bound (offset);
+  if (next != m_free.end () && next->first == offset + size)
+  {
+    size += next->second;
+    next = m_free.erase (next);
+  }
+  if (next != m_free.begin ())
+  {
+    auto previous = std::prev (next);
+    if (previous->first + previous->second == offset)
+    {
+      previous->second += size;
+      return;
+    }
+  }
+  m_free[offset] = size;
+}
+
+std::size_t
+RangeAllocator::getCapacity () const
+{
+  return m_capacity;
+}
+
+std::size_t
+RangeAllocator::getUsed () const
+{
+  return m_used;
+}
+
+/******************************************************************/
+BufferArena::BufferArena (OpenGLContext* context, std::size_t vertexBlockBytes,
+                          std::size_t indexBlockBytes)
+  : m_context (context),
+    m_vertexBlockBytes (vertexBlockBytes),
+    m_indexBlockBytes (indexBlockBytes),
+    m_blocks (),
+    m_pools (),
+    m_usedBytes (0)
+{
+}
+
+BufferArena::~BufferArena ()
+{
+  for (auto& block : m_blocks)
+  {
+    m_context->deleteVertexArrays (1, &block.second.m_vao);
+    m_context->deleteBuffers (1, &block.second.m_vbo);
+    m_context->deleteBuffers (1, &block.second.m_ibo);
+  }
+}
+
+ArenaAllocation
+BufferArena::allocate (const ArenaLayout& layout, const void* vertices, std::size_t vertexBytes,
+                       std::size_t vertexCount, const void* indices, std::size_t indexBytes)
+{
+  assert (vertexCount > 0 && vertexBytes % vertexCount == 0);
+  const std::size_t stride = vertexBytes / vertexCount;
+  PoolKey pool (layout.m_format.m_position, layout.m_format.m_attribute, layout.m_signature,
+                stride);
+
+  ArenaAllocation allocation = {};
+  Block* block = nullptr;
+  for (GLuint vbo : m_pools[pool])
+  {
+    Block& candidate = m_blocks.at (vbo);
+    std::size_t firstVertex;
+    if (!candidate.m_vertices.allocate (vertexCount, 1, firstVertex))
+    {
+      continue;
+    }
+    if (!candidate.m_indices.allocate (indexBytes, INDEX_ALIGNMENT, allocation.m_indexOffset))
+    {
+      candidate.m_vertices.release (firstVertex, vertexCount);
+      continue;
+    }
+    allocation.m_baseVertex = static_cast<GLint> (firstVertex);
+    block = &candidate;
+    break;
+  }
+  if (block == nullptr)
+  {
+    block = &m_blocks.at (makeBlock (pool, stride, vertexCount, indexBytes));
+    std::size_t firstVertex = 0;
+    block->m_vertices.allocate (vertexCount, 1, firstVertex);
+    block->m_indices.allocate (indexBytes, INDEX_ALIGNMENT, allocation.m_indexOffset);
+    allocation.m_baseVertex = static_cast<GLint> (firstVertex);
+    allocation.m_newVertexArray = true;
+  }
+  ++block->m_allocations;
+  m_usedBytes += vertexBytes + indexBytes;
+
+  allocation.m_vao = block->m_vao;
+  allocation.m_vbo = block->m_vbo;
+  allocation.m_ibo = block->m_ibo;
+  allocation.m_vertexCount = vertexCount;
+  allocation.m_indexBytes = indexBytes;
+
+  m_context->bindVertexArray (block->m_vao);
+  m_context->bindBuffer (GL_ARRAY_BUFFER, block->m_vbo);
+  m_context->bufferSubData (GL_ARRAY_BUFFER, allocation.m_baseVertex * stride, vertexBytes,
+                            vertices);
+  m_context->bufferSubData (GL_ELEMENT_ARRAY_BUFFER, allocation.m_indexOffset, indexBytes,
+                            indices);
+  return allocation;
+}
+
+void
+BufferArena::release (const ArenaAllocation& allocation)
+{
+  auto found = m_blocks.find (allocation.m_vbo);
+  assert (found != m_blocks.end ());
+  Block& block = found->second;
+  block.m_vertices.release (allocation.m_baseVertex, allocation.m_vertexCount);
+  block.m_indices.release (allocation.m_indexOffset, allocation.m_indexBytes);
+  m_usedBytes -= allocation.m_vertexCount * block.m_stride + allocation.m_indexBytes;
+  if (--block.m_allocations > 0)
+  {
+    return;
+  }
+
+  std::vector<GLuint>& pool = m_pools[block.m_pool];
+  pool.erase (std::find (pool.begin (), pool.end (), block.m_vbo));
+  m_context->deleteVertexArrays (1, &block.m_vao);
+  m_context->deleteBuffers (1, &block.m_vbo);
+  m_context->deleteBuffers (1, &block.m_ibo);
+  m_blocks.erase (found);
+}
+
+std::size_t
+BufferArena::getBlockCount () const
+{
+  return m_blocks.size ();
+}
+
+std::size_t
+BufferArena::getUsedBytes () const
+{
+  return m_usedBytes;
+}
+
+GLuint
+BufferArena::makeBlock (const PoolKey& pool, std::size_t stride, std::size_t vertexCount,
+                        std::size_t indexBytes)
+{
+  std::size_t vertexCapacity = std::max (m_vertexBlockBytes / stride, vertexCount);
+  std::size_t indexCapacity = std::max (m_indexBlockBytes, indexBytes);
+  GLuint vao;
+  GLuint buffers[2];
+  m_context->genVertexArrays (1, &vao);
+  m_context->genBuffers (2, buffers);
+
+  // The IBO is bound while the vertex array is, so the vertex array keeps it.
+  m_context->bindVertexArray (vao);
+  m_context->bindBuffer (GL_ARRAY_BUFFER, buffers[0]);
+  m_context->bufferData (GL_ARRAY_BUFFER, vertexCapacity * stride, nullptr, GL_STATIC_DRAW);
+  m_context->bindBuffer (GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+  m_context->bufferData (GL_ELEMENT_ARRAY_BUFFER, indexCapacity, nullptr, GL_STATIC_DRAW);
+
+  m_blocks.emplace (buffers[0], Block { vao, buffers[0], buffers[1], stride,
+                                        RangeAllocator (vertexCapacity),
+                                        RangeAllocator (indexCapacity), 0, pool });
+  m_pools[pool].push_back (buffers[0]);
+  return buffers[0];
+}
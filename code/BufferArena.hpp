@@ -0,0 +1,206 @@
+/// \file BufferArena.hpp
+/// \brief Declaration of BufferArena, which packs the vertex and index data
+///   of many meshes into a few large buffers.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// Macro guard
+#ifndef BUFFERARENA_HPP
+#define BUFFERARENA_HPP
+
+/******************************************************************/
+// System includes
+#include <cstddef>
+#include <map>
+#include <tuple>
+#include <vector>
+
+/******************************************************************/
+// Local includes
+#include "Geometry.hpp"
+#include "OpenGLContext.hpp"
+
+/******************************************************************/
+/// \brief Hands out ranges of some fixed span, reusing the ranges that are
+///   handed back.
+class RangeAllocator
+{
+public:
+  /// \brief Constructs a RangeAllocator with everything free.
+  /// \param[in] capacity The size of the span.
+  RangeAllocator (std::size_t capacity);
+
+  /// \brief Takes the first free range that is big enough.
+  /// \param[in] size The size of the range wanted.
+  /// \param[in] alignment What the range's offset must be a multiple of.
+  /// \param[out] offset Set to where the range starts, if there is room.
+  /// \return Whether there was room.
+  bool
+  allocate (std::size_t size, std::size_t alignment, std::size_t& offset);
+
+  /// \brief Hands back a range from allocate.
+  /// \param[in] offset Where the range starts.
+  /// \param[in] size The size it was allocated with.
+  /// \post The range is free again, merged with any free neighbors.
+  void
+  release (std::size_t offset, std::size_t size);
+
+  /// \brief Gets the size of the span.
+  std::size_t
+  getCapacity () const;
+
+  /// \brief Gets how much of the span is allocated.
+  std::size_t
+  getUsed () const;
+
+private:
+  /// Every free range's size, by where it starts.
+  std::map<std::size_t, std::size_t> m_free;
+  /// The size of the span.
+  std::size_t m_capacity;
+  /// How much is allocated.
+  std::size_t m_used;
+};
+
+/// \brief What decides how a vertex array reads its VBO, which must match
+///   for two meshes to be drawn from the same buffers.
+struct ArenaLayout
+{
+  /// How each vertex is stored.
+  VertexFormat m_format;
+  /// The signature of the VertexLayout each vertex was built with.
+  unsigned int m_signature;
+};
+
+/// \brief Where a mesh's geometry was put in a BufferArena.
+struct ArenaAllocation
+{
+  /// The vertex array of the buffers the geometry is in.
+  GLuint m_vao;
+  /// The vertex buffer.
+  GLuint m_vbo;
+  /// The index buffer.
+  GLuint m_ibo;
+  /// The number of vertices before the geometry's first one, to be added to
+  ///   each index when drawing.
+  GLint m_baseVertex;
+  /// The number of vertices.
+  std::size_t m_vertexCount;
+  /// The byte offset of the first index.
+  std::size_t m_indexOffset;
+  /// The number of index bytes.
+  std::size_t m_indexBytes;
+  /// Whether m_vao is new, so its attributes still have to be set up.
+  bool m_newVertexArray;
+};
+
+/// \brief Large VBOs and IBOs, one set per vertex layout, that the geometry
+///   of many meshes is suballocated from, so they can all be drawn with a
+///   few vertex arrays and base-vertex offsets.
+class BufferArena
+{
+public:
+  /// The default size of each block's vertex buffer.
+  static const std::size_t DEFAULT_VERTEX_BLOCK_BYTES = 4u << 20;
+  /// The default size of each block's index buffer.
+  static const std::size_t DEFAULT_INDEX_BLOCK_BYTES = 1u << 20;
+
+  /// \brief Constructs an empty BufferArena.
+  /// \param[in] context The context buffers are made and filled through.
+  /// \param[in] vertexBlockBytes How big each vertex buffer is made.
+  /// \param[in] indexBlockBytes How big each index buffer is made.
+  /// Geometry bigger than a block gets a block of its own, sized to fit.
+  BufferArena (OpenGLContext* context,
+               std::size_t vertexBlockBytes = DEFAULT_VERTEX_BLOCK_BYTES,
+               std::size_t indexBlockBytes = DEFAULT_INDEX_BLOCK_BYTES);
+
+  /// \brief Destructs a BufferArena, deleting any blocks it still has.
+  ~BufferArena ();
+
+  /// \brief Copy constructor removed because buffers cannot be copied.
+  BufferArena (const BufferArena&) = delete;
+
+  /// \brief Assignment operator removed because buffers cannot be copied.
+  BufferArena&
+  operator= (const BufferArena&) = delete;
+
+  /// \brief Puts some geometry in the first block for its layout with room,
+  ///   making a new block if none has.
+  /// \param[in] layout How the vertices are read.
+  /// \param[in] vertices The bytes to put in a VBO.
+  /// \param[in] vertexBytes The number of vertex bytes.
+  /// \param[in] vertexCount The number of vertices, which vertexBytes must be
+  ///   a multiple of.  Every allocation with the same layout must have the
+  ///   same bytes per vertex.
+  /// \param[in] indices The bytes to put in an IBO.
+  /// \param[in] indexBytes The number of index bytes.
+  /// \post The block's vertex array is bound.
+  /// \return Where the geometry went, which must be handed back to release
+  ///   once the caller is done with it.  Index ranges start on a multiple of
+  ///   4 bytes, so any index type may be used.
+  ArenaAllocation
+  allocate (const ArenaLayout& layout, const void* vertices, std::size_t vertexBytes,
+            std::size_t vertexCount, const void* indices, std::size_t indexBytes);
+
+  /// \brief Hands back a range from allocate.
+  /// \param[in] allocation The range.
+  /// \post Once a block has nothing left in it, it is deleted.
+  void
+  release (const ArenaAllocation& allocation);
+
+  /// \brief Gets the number of blocks, each of which is one vertex array and
+  ///   two buffers.
+  std::size_t
+  getBlockCount () const;
+
+  /// \brief Gets the number of vertex and index bytes allocated.
+  std::size_t
+  getUsedBytes () const;
+
+private:
+  /// \brief What blocks are pooled by.
+  typedef std::tuple<PositionFormat, AttributeFormat, unsigned int, std::size_t> PoolKey;
+
+  /// \brief One vertex array, with its VBO and IBO, and what is free in them.
+  struct Block
+  {
+    GLuint m_vao;
+    GLuint m_vbo;
+    GLuint m_ibo;
+    /// The bytes per vertex of everything in the VBO.
+    std::size_t m_stride;
+    /// Vertex ranges, counted in vertices.
+    RangeAllocator m_vertices;
+    /// Index ranges, counted in bytes.
+    RangeAllocator m_indices;
+    /// The number of allocations not yet released.
+    unsigned int m_allocations;
+    /// The pool the block is in.
+    PoolKey m_pool;
+  };
+
+  /// \brief Makes a new block and puts it in a pool.
+  /// \param[in] pool The pool.
+  /// \param[in] stride The bytes per vertex.
+  /// \param[in] vertexCount The most vertices the block must hold.
+  /// \param[in] indexBytes The most index bytes the block must hold.
+  /// \return The block's VBO, which it is filed under.
+  GLuint
+  makeBlock (const PoolKey& pool, std::size_t stride, std::size_t vertexCount,
+             std::size_t indexBytes);
+
+  /// The context buffers are made through.
+  OpenGLContext* m_context;
+  /// How big each vertex buffer is made.
+  std::size_t m_vertexBlockBytes;
+  /// How big each index buffer is made.
+  std::size_t m_indexBlockBytes;
+  /// Every block, by its VBO.
+  std::map<GLuint, Block> m_blocks;
+  /// The VBOs of the blocks in each pool, oldest first.
+  std::map<PoolKey, std::vector<GLuint>> m_pools;
+  /// The vertex and index bytes allocated.
+  std::size_t m_usedBytes;
+};
+
+#endif//BUFFERARENA_HPP
@@ -0,0 +1,333 @@
+/// \file Bvh.cpp
+/// \brief Definitions of global functions that build a bounding volume
+///   hierarchy over an indexed mesh's triangles, and cast rays through it.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// System includes
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+
+/******************************************************************/
+// Local includes
+#include "Bvh.hpp"
+
+/******************************************************************/
+/// The number of candidate split planes tried along each axis, plus one.
+static const unsigned int BIN_COUNT = 16;
+
+/// How much visiting a node costs, relative to testing one triangle.
+static const float TRAVERSAL_COST = 1.0f;
+
+/// \brief Gets the position of a vertex.
+static Vector3
+positionOf (const std::vector<float>& data, unsigned int floatsPerVertex, unsigned int vertex)
+{
+  const float* position = &data[static_cast<std::size_t> (vertex) * floatsPerVertex];
+  return Vector3 (position[0], position[1], position[2]);
+}
+
+/// \brief Gets a box that holds nothing, which grows to fit whatever is
+///   added to it.
+static BoundingBox
+emptyBox ()
+{
+  const float INF = std::numeric_limits<float>::infinity ();
+  return { Vector3 (INF, INF, INF), Vector3 (-INF, -INF, -INF) };
+}
+
+/// \brief Grows a box to hold a point.
+static void
+grow (BoundingBox& box, const Vector3& point)
+{
+  box.m_min = Vector3 (std::min (box.m_min.m_x, point.m_x), std::min (box.m_min.m_y, point.m_y),
+                       std::min (box.m_min.m_z, point.m_z));
+  box.m_max = Vector3 (std::max (box.m_max.m_x, point.m_x), std::max (box.m_max.m_y, point.m_y),
+                       std::max (box.m_max.m_z, point.m_z));
+}
+
+/// \brief Grows a box to hold another box, which may be empty.
+static void
+grow (BoundingBox& box, const BoundingBox& other)
+{
+  box.m_min = Vector3 (std::min (box.m_min.m_x, other.m_min.m_x), std::min (box.m_min.m_y, other.m_min.m_y),
+                       std::min (box.m_min.m_z, other.m_min.m_z));
+  box.m_max = Vector3 (std::max (box.m_max.m_x, other.m_max.m_x), std::max (box.m_max.m_y, other.m_max.m_y),
+                       std::max (box.m_max.m_z, other.m_max.m_z));
+}
+
+/// \brief Gets half the surface area of a box, which is proportional to the
+///   chance that a random ray through its parent hits it.
+static float
+halfArea (const BoundingBox& box)
+{
+  Vector3 size = box.m_max - box.m_min;
+  return size.m_x * size.m_y + size.m_y * size.m_z + size.m_z * size.m_x;
+}
+
+/// \brief Gets one coordinate of a vector.
+static float
+axisOf (const Vector3& v, unsigned int axis)
+{
+  return axis == 0 ? v.m_x : (axis == 1 ? v.m_y : v.m_z);
+}
+
+Bvh
+buildBvh (const std::vector<float>& data, unsigned int floatsPerVertex,
+          const std::vector<unsigned int>& indices)
+{
+  assert (indices.size () % 3 == 0);
+  const unsigned int triangleCount = indices.size () / 3;
+  Bvh bvh;
+  if (triangleCount == 0)
+  {
+    return bvh;
+  }
+
+  std::vector<BoundingBox> boxes (triangleCount, emptyBox ());
+  std::vector<Vector3> centers (triangleCount);
+  for (unsigned int triangle = 0; triangle < triangleCount; triangle++)
+  {
+    for (unsigned int corner = 0; corner < 3; corner++)
+    {
+      grow (boxes[triangle], positionOf (data, floatsPerVertex, indices[triangle * 3 + corner]));
+    }
+    centers[triangle] = (boxes[triangle].m_min + boxes[triangle].m_max) / 2.0f;
+  }
+  bvh.m_triangles.resize (triangleCount);
+  std::iota (bvh.m_triangles.begin (), bvh.m_triangles.end (), 0u);
+  bvh.m_nodes.push_back ({ emptyBox (), 0, triangleCount });
+
+  std::vector<unsigned int> pending = { 0 };
+  while (!pending.empty ())
+  {
+    const unsigned int node = pending.back ();
+    pending.pop_back ();
+    const unsigned int first = bvh.m_nodes[node].m_first;
+    const unsigned int count = bvh.m_nodes[node].m_count;
+    unsigned int* slots = &bvh.m_triangles[first];
+
+    BoundingBox bounds = emptyBox ();
+    BoundingBox centerBounds = emptyBox ();
+    for (unsigned int slot = 0; slot < count; slot++)
+    {
+      grow (bounds, boxes[slots[slot]]);
+      grow (centerBounds, centers[slots[slot]]);
+    }
+    bvh.m_nodes[node].m_bounds = bounds;
+    if (count == 1)
+    {
+      continue;
+    }
+
+    // Bin the triangles by center along each axis, and cost every plane
+    //   between two bins by the area and triangle count on each side.
+    unsigned int bestAxis = 0;
+    unsigned int bestPlane = 0;
+    float bestCost = std::numeric_limits<float>::infinity ();
+    for (unsigned int axis = 0; axis < 3; axis++)
+    {
+      const float low = axisOf (centerBounds.m_min, axis);
+      const float extent = axisOf (centerBounds.m_max, axis) - low;
+      if (!(extent > 0.0f))
+      {
+        continue;
+      }
+      const float scale = BIN_COUNT / extent;
+      BoundingBox binBoxes[BIN_COUNT];
+      unsigned int binCounts[BIN_COUNT] = {};
+      std::fill (binBoxes, binBoxes + BIN_COUNT, emptyBox ());
+      for (unsigned int slot = 0; slot < count; slot++)
+      {
+        unsigned int bin = std::min (BIN_COUNT - 1, static_cast<unsigned int> (
+          (axisOf (centers[slots[slot]], axis) - low) * scale));
+        grow (binBoxes[bin], boxes[slots[slot]]);
+        binCounts[bin]++;
+      }
+      float rightCosts[BIN_COUNT] = {};
+      BoundingBox right = emptyBox ();
+      unsigned int rightCount = 0;
+      for (unsigned int bin = BIN_COUNT - 1; bin > 0; bin--)
+      {
+        grow (right, binBoxes[bin]);
+        rightCount += binCounts[bin];
+        rightCosts[bin] = rightCount == 0 ? 0.0f : halfArea (right) * rightCount;
+      }
+      BoundingBox left = emptyBox ();
+      unsigned int leftCount = 0;
+      for (unsigned int plane = 1; plane < BIN_COUNT; plane++)
+      {
+        grow (left, binBoxes[plane - 1]);
+        leftCount += binCounts[plane - 1];
+        if (leftCount == 0 || leftCount == count)
+        {
+          continue;
+        }
+        float cost = halfArea (left) * leftCount + rightCosts[plane];
+        if (cost < bestCost)
+        {
+          bestCost = cost;
+          bestAxis = axis;
+          bestPlane = plane;
+        }
+      }
+    }
+    // Stay a leaf when every center is in the same place, or when splitting
+    //   costs more than testing every triangle and the leaf is small.
+    const float leafCost = halfArea (bounds) * count;
+    if (bestPlane == 0
+        || (TRAVERSAL_COST * halfArea (bounds) + bestCost >= leafCost
+            && count <= MAX_BVH_LEAF_TRIANGLES))
+    {
+      continue;
+    }
+
+    const float low = axisOf (centerBounds.m_min, bestAxis);
+    const float scale = BIN_COUNT / (axisOf (centerBounds.m_max, bestAxis) - low);
+    unsigned int* middle = std::partition (slots, slots + count, [&] (unsigned int triangle) {
+      return std::min (BIN_COUNT - 1, static_cast<unsigned int> (
+        (axisOf (centers[triangle], bestAxis) - low) * scale)) < bestPlane;
+    });
+    const unsigned int leftCount = middle - slots;
+    const unsigned int child = bvh.m_nodes.size ();
+    bvh.m_nodes[node].m_first = child;
+    bvh.m_nodes[node].m_count = 0;
+    bvh.m_nodes.push_back ({ emptyBox (), first, leftCount });
+    bvh.m_nodes.push_back ({ emptyBox (), first + leftCount, count - leftCount });
+    pending.push_back (child + 1);
+    pending.push_back (child);
+  }
+  bvh.m_nodes.shrink_to_fit ();
+
+  bvh.m_corners.reserve (static_cast<std::size_t> (triangleCount) * 3);
+  for (unsigned int triangle : bvh.m_triangles)
+  {
+    for (unsigned int corner = 0; corner < 3; corner++)
+    {
+      bvh.m_corners.push_back (positionOf (data, floatsPerVertex, indices[triangle * 3 + corner]));
+    }
+  }
+  return bvh;
+}
+
+/// \brief Finds where a ray enters a box.
+/// \param[in] box The box.
+/// \param[in] origin Where the ray starts.
+/// \param[in] inverse One over each part of the ray's direction.
+/// \param[in] limit How far along the ray to look.
+/// \return The ray's t where it enters the box, clamped to 0 if it starts
+///   inside, or infinity if it misses the box before limit.
+static float
+enterBox (const BoundingBox& box, const Vector3& origin, const Vector3& inverse, float limit)
+{
+  float xNear = (box.m_min.m_x - origin.m_x) * inverse.m_x;
+  float xFar = (box.m_max.m_x - origin.m_x) * inverse.m_x;
+  float yNear = (box.m_min.m_y - origin.m_y) * inverse.m_y;
+  float yFar = (box.m_max.m_y - origin.m_y) * inverse.m_y;
+  float zNear = (box.m_min.m_z - origin.m_z) * inverse.m_z;
+  float zFar = (box.m_max.m_z - origin.m_z) * inverse.m_z;
+  float enter = std::max (std::max (std::min (xNear, xFar), std::min (yNear, yFar)),
+                          std::max (std::min (zNear, zFar), 0.0f));
+  float leave = std::min (std::min (std::max (xNear, xFar), std::max (yNear, yFar)),
+                          std::max (zNear, zFar));
+  return enter <= leave && enter < limit ? enter : std::numeric_limits<float>::infinity ();
+}
+
+bool
+intersectBvh (const Bvh& bvh, const Ray& ray, float maxDistance, RayHit& hit)
+{
+  if (bvh.m_nodes.empty ())
+  {
+    return false;
+  }
+  const float INF = std::numeric_limits<float>::infinity ();
+  const Vector3 inverse (1.0f / ray.m_direction.m_x, 1.0f / ray.m_direction.m_y,
+                         1.0f / ray.m_direction.m_z);
+  float nearest = maxDistance;
+  bool found = false;
+
+  // Each pending node is kept with where the ray enters it, so nodes that
+  //   turn out to be behind a hit found later are skipped without a test.
+  struct Pending
+  {
+    unsigned int m_node;
+    float m_enter;
+  };
+  std::vector<Pending> pending;
+  pending.reserve (64);
+  float rootEnter = enterBox (bvh.m_nodes[0].m_bounds, ray.m_origin, inverse, nearest);
+  if (rootEnter < INF)
+  {
+    pending.push_back ({ 0, rootEnter });
+  }
+  while (!pending.empty ())
+  {
+    Pending next = pending.back ();
+    pending.pop_back ();
+    if (next.m_enter >= nearest)
+    {
+      continue;
+    }
+    const BvhNode& node = bvh.m_nodes[next.m_node];
+    if (node.m_count == 0)
+    {
+      unsigned int nearChild = node.m_first;
+      unsigned int farChild = node.m_first + 1;
+      float nearEnter = enterBox (bvh.m_nodes[nearChild].m_bounds, ray.m_origin, inverse, nearest);
+      float farEnter = enterBox (bvh.m_nodes[farChild].m_bounds, ray.m_origin, inverse, nearest);
+      if (farEnter < nearEnter)
+      {
+        std::swap (nearChild, farChild);
+        std::swap (nearEnter, farEnter);
+      }
+      if (farEnter < INF)
+      {
+        pending.push_back ({ farChild, farEnter });
+      }
+      if (nearEnter < INF)
+      {
+        pending.push_back ({ nearChild, nearEnter });
+      }
+      continue;
+    }
+
+    // Moller and Trumbore, 1997, accepting either winding.
+    for (unsigned int slot = node.m_first; slot < node.m_first + node.m_count; slot++)
+    {
+      const Vector3* corners = &bvh.m_corners[static_cast<std::size_t> (slot) * 3];
+      Vector3 edge1 = corners[1] - corners[0];
+      Vector3 edge2 = corners[2] - corners[0];
+      Vector3 p = ray.m_direction.cross (edge2);
+      float determinant = edge1.dot (p);
+      if (determinant == 0.0f)
+      {
+        continue;
+      }
+      float inverseDeterminant = 1.0f / determinant;
+      Vector3 s = ray.m_origin - corners[0];
+      float u = s.dot (p) * inverseDeterminant;
+      if (u < 0.0f || u > 1.0f)
+      {
+        continue;
+      }
+      Vector3 q = s.cross (edge1);
+      float v = ray.m_direction.dot (q) * inverseDeterminant;
+      if (v < 0.0f || u + v > 1.0f)
+      {
+        continue;
+      }
+      float t = edge2.dot (q) * inverseDeterminant;
+      if (t >= 0.0f && t < nearest)
+      {
+        nearest = t;
+        hit = { t, bvh.m_triangles[slot], u, v };
+        found = true;
+      }
+    }
+  }
+  return found;
+}
@@ -0,0 +1,90 @@
+/// \file Bvh.hpp
+/// \brief Declarations of global functions that build a bounding volume
+///   hierarchy over an indexed mesh's triangles, and cast rays through it.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// Macro guard
+#ifndef BVH_HPP
+#define BVH_HPP
+
+/******************************************************************/
+// System includes
+#include <vector>
+
+/******************************************************************/
+// Local includes
+#include "Geometry.hpp"
+#include "Ray.hpp"
+#include "Vector3.hpp"
+
+/******************************************************************/
+/// The most triangles a leaf holds once splitting it no longer pays off.
+const unsigned int MAX_BVH_LEAF_TRIANGLES = 8;
+
+/// \brief A box in a bounding volume hierarchy, which holds either two
+///   smaller boxes or a run of triangles.
+struct BvhNode
+{
+  /// The box around everything below this node.
+  BoundingBox m_bounds;
+  /// For a leaf, where its triangles start in Bvh::m_triangles.  Otherwise,
+  ///   the index of the first child, which is followed by the second.
+  unsigned int m_first;
+  /// The number of triangles in a leaf, or 0 for an inner node.
+  unsigned int m_count;
+};
+
+/// \brief A bounding volume hierarchy over the triangles of one mesh.
+struct Bvh
+{
+  /// The nodes, with the root first.  Empty if there are no triangles.
+  std::vector<BvhNode> m_nodes;
+  /// Which original triangle each leaf slot holds.
+  std::vector<unsigned int> m_triangles;
+  /// The three corners of each triangle, in leaf order, so a leaf's
+  ///   triangles are read from one contiguous run of memory.
+  std::vector<Vector3> m_corners;
+};
+
+/// \brief Where a ray first hits a mesh.
+struct RayHit
+{
+  /// The ray's t at the hit, which is a distance when its direction is a unit
+  ///   vector.
+  float m_distance;
+  /// The index of the hit triangle, counted in threes in the index buffer.
+  unsigned int m_triangle;
+  /// The barycentric weights of the hit's second and third corners.
+  float m_u;
+  float m_v;
+};
+
+/// \brief Builds a bounding volume hierarchy over an indexed mesh.
+/// \param[in] data Interleaved vertex data, as made by indexData, whose
+///   first three floats per vertex are a position.
+/// \param[in] floatsPerVertex The number of floats used for each vertex.
+/// \param[in] indices Three vertex indices per triangle.
+/// \pre indices.size () is a multiple of 3, and every index is less than
+///   data.size () / floatsPerVertex.
+/// \return The hierarchy, which holds every triangle exactly once.
+/// Each node is split where the surface area heuristic says rays will test
+///   the fewest triangles, choosing among 16 evenly spaced planes along each
+///   axis.
+Bvh
+buildBvh (const std::vector<float>& data, unsigned int floatsPerVertex,
+          const std::vector<unsigned int>& indices);
+
+/// \brief Finds the first triangle a ray hits.
+/// \param[in] bvh The hierarchy over the triangles.
+/// \param[in] ray The ray, in the same coordinates as the triangles.
+/// \param[in] maxDistance Hits with t at or past this are ignored.
+/// \param[out] hit Set to the nearest hit, if there is one.
+/// \return Whether the ray hits any triangle, from either side, before
+///   maxDistance.
+/// Nearer children are visited first, and boxes that start past the nearest
+///   hit so far are skipped, so a query only touches a few leaves.
+bool
+intersectBvh (const Bvh& bvh, const Ray& ray, float maxDistance, RayHit& hit);
+
+#endif//BVH_HPP
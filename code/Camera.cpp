@@ -129,6 +129,36 @@ Camera::getProjectionMatrix()
   return m_projectionMatrix;
 }
 
+Ray
+Camera::getPickRay(double x, double y, double width, double height)
+{
+  // Normalized device coordinates run from -1 to 1, with y up.
+  const float* p = m_projectionMatrix.data();
+  float ndcX = static_cast<float>(2.0 * x / width - 1.0);
+  float ndcY = static_cast<float>(1.0 - 2.0 * y / height);
+
+  // A perspective projection divides by -z, so its bottom row is (0 0 -1 0),
+  //   and the point on the z = -1 plane with these coordinates has
+  //   ndc = scale * eye - offset.  An orthographic projection maps eye
+  //   coordinates straight across, with ndc = scale * eye + offset.
+  Vector3 eyeOrigin(0.0f, 0.0f, 0.0f);
+  Vector3 eyeDirection(0.0f, 0.0f, -1.0f);
+  if (p[15] == 0.0f)
+  {
+    eyeDirection = Vector3((ndcX + p[8]) / p[0], (ndcY + p[9]) / p[5], -1.0f);
+    eyeDirection.normalize();
+  }
+  else
+  {
+    eyeOrigin = Vector3((ndcX - p[12]) / p[0], (ndcY - p[13]) / p[5], 0.0f);
+  }
+
+  Matrix3 orientation = m_world.getOrientation();
+  Ray ray = { orientation * eyeOrigin + m_world.getPosition(), orientation * eyeDirection };
+  ray.m_direction.normalize();
+  return ray;
+}
+
 void
 Camera::resetPose()
 {
@@ -11,6 +11,7 @@
 #include "Matrix3.hpp"
 #include "Transform.hpp"
 #include "Matrix4.hpp"
+#include "Ray.hpp"
 
 /// \brief An eye that is viewing the scene.
 class Camera
@@ -127,6 +128,18 @@ public:
   Matrix4
   getProjectionMatrix ();
 
+  /// \brief Gets the ray from the eye through a point on the screen, for
+  ///   picking what is under the mouse.
+  /// \param[in] x The point's distance from the left of the window, in pixels.
+  /// \param[in] y The point's distance from the top of the window, in pixels.
+  /// \param[in] width The width of the window, in pixels.
+  /// \param[in] height The height of the window, in pixels.
+  /// \return A ray in world coordinates with a unit direction.  For a
+  ///   perspective projection it starts at the eye; for an orthographic one
+  ///   it starts on the plane of the eye and points straight ahead.
+  Ray
+  getPickRay (double x, double y, double width, double height);
+
   /// \brief Resets the camera to its original pose.
   /// \post The position (eye point) is the same as what had been specified in
   ///   the constructor.
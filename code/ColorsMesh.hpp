@@ -11,17 +11,10 @@
 
 /******************************************************************/
 
+/// \brief A Mesh laid out as a ColorsLayout: a position and then a color.
 class ColorsMesh : public Mesh
 {
 public:
   /// \brief Initial value constructor
   ColorsMesh(OpenGLContext* context, ShaderProgram* shader);
-
-  virtual unsigned int
-  getFloatsPerVertex() const;
-protected:
-
-  virtual void
-  enableAttributes();
-
 };
\ No newline at end of file
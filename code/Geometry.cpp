@@ -3,50 +3,220 @@
 /// \author Chad Hogg
 /// \version A08
 
-#include <random>
 #include <cassert>
 #include <iostream>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <tuple>
+#include <numeric>
 
 #include "Geometry.hpp"
+#include "SpatialHash.hpp"
+#include "Parallel.hpp"
+#include "Simd.hpp"
+#include "VertexLayout.hpp"
+
+/// The largest difference between two floats that indexData treats as equal.
+static const float EPSILON = 0.00001f;
+/// Marks a vertex that was not copied into the data vector.
+static const unsigned int NOT_DATA = std::numeric_limits<unsigned int>::max ();
+
+/// \brief Tests whether two vertices match, the way indexData compares them.
+/// \param[in] a A pointer to the first float of one vertex.
+/// \param[in] b A pointer to the first float of another vertex.
+/// \param[in] floatsPerVertex The number of floats used for each vertex.
+/// \return Whether or not every float of a is within EPSILON of b.
+static bool
+verticesMatch (const float* a, const float* b, unsigned int floatsPerVertex)
+{
+  for (unsigned int part = 0; part < floatsPerVertex; part++)
+  {
+    if (fabs (a[part] - b[part]) >= EPSILON)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// \brief Finds the earliest vertex that was in data before indexing began
+///   and matches a vertex.
+/// \param[in] vertex A pointer to the first float of the vertex.
+/// \param[in] data The data vector being indexed into.
+/// \param[in] floatsPerVertex The number of floats used for each vertex.
+/// \param[in] previous A grid over the vertices that were already in data.
+/// \return The index of the matching vertex in data, or NOT_DATA.
+static unsigned int
+findPreviousMatch (const float* vertex, const std::vector<float>& data,
+    unsigned int floatsPerVertex, const SpatialHash& previous)
+{
+  unsigned int match = NOT_DATA;
+  previous.forEachNear (vertex, EPSILON, [&] (unsigned int other)
+  {
+    if (other < match && verticesMatch (vertex, &data[other * floatsPerVertex], floatsPerVertex))
+    {
+      match = other;
+    }
+  });
+  return match;
+}
+
+/// \brief Finds the earliest vertex copied into data from geometry that
+///   matches one of the later geometry vertices.
+/// \param[in] vertex A pointer to the first float of the vertex to match.
+/// \param[in] floatsPerVertex The number of floats used for each vertex.
+/// \param[in] geoIndex The index of that vertex in the geometry.
+/// \param[in] grid A grid over all of the geometry vertices.
+/// \param[in] dataIndexOf Where each earlier geometry vertex was copied to in
+///   data, or NOT_DATA.
+/// \param[in] data A pointer to the first float of the data vertices.
+/// \return The index in data of the matching vertex, or NOT_DATA.
+/// Candidates are compared through their copies in data rather than in the
+///   geometry, so this still works when data overwrites the geometry.
+static unsigned int
+findKeptMatch (const float* vertex, unsigned int floatsPerVertex,
+    unsigned int geoIndex, const SpatialHash& grid,
+    const std::vector<unsigned int>& dataIndexOf, const float* data)
+{
+  unsigned int match = NOT_DATA;
+  grid.forEachNear (vertex, EPSILON, [&] (unsigned int other)
+  {
+    if (other < geoIndex && dataIndexOf[other] < match
+        && verticesMatch (vertex, data + static_cast<std::size_t> (dataIndexOf[other]) * floatsPerVertex, floatsPerVertex))
+    {
+      match = dataIndexOf[other];
+    }
+  });
+  return match;
+}
 
 void
 indexData (const std::vector<float>& geometry, unsigned int floatsPerVertex,
     std::vector<float>& data, std::vector<unsigned int>& indices)
 {
   const unsigned int VERTICES_PER_TRIANGLE = 3;
-  const float EPSILON = 0.00001f;
   assert (geometry.size () % (floatsPerVertex * VERTICES_PER_TRIANGLE) == 0);
+  const unsigned int vertexCount = geometry.size () / floatsPerVertex;
+  const unsigned int dimensions = std::min (3u, floatsPerVertex);
+  // Two vertices can only match if their positions are within EPSILON, so
+  //   bucketing by position lets us check just a handful of candidates instead
+  //   of every vertex we have already kept.
+  const SpatialHash grid (geometry.data (), vertexCount, floatsPerVertex,
+      dimensions, 2.0f * EPSILON);
+  // Vertices that were already in data before this call come first, exactly
+  //   as if we had scanned data from the beginning.
+  const SpatialHash previous (data.data (), data.size () / floatsPerVertex,
+      floatsPerVertex, dimensions, 2.0f * EPSILON);
+  // Where each geometry vertex was copied to in data, if it was.
+  std::vector<unsigned int> dataIndexOf (vertexCount, NOT_DATA);
+  indices.reserve (indices.size () + vertexCount);
   // We must account for each vertex in the geometry vector.
-  for (unsigned int geoIndex = 0; geoIndex < geometry.size () / floatsPerVertex; geoIndex++)
+  for (unsigned int geoIndex = 0; geoIndex < vertexCount; geoIndex++)
   {
-    // Try to find a copy of it in the data vector.
-    bool found = false;
-    for (unsigned int dataIndex = 0; dataIndex < data.size () / floatsPerVertex && !found; dataIndex++)
+    const float* vertex = &geometry[geoIndex * floatsPerVertex];
+    // Try to find the earliest copy of it in the data vector.
+    unsigned int match = findPreviousMatch (vertex, data, floatsPerVertex, previous);
+    if (match == NOT_DATA)
+    {
+      match = findKeptMatch (vertex, floatsPerVertex, geoIndex, grid, dataIndexOf, data.data ());
+    }
+    if (match != NOT_DATA)
     {
-      bool matches = true;
-      for (unsigned int part = 0; part < floatsPerVertex && matches; part++)
+      // Found it, just save that index!
+      indices.push_back (match);
+    }
+    else
+    {
+      // Didn't find it, so copy it to data vector and add new index.
+      data.insert (data.end (), vertex, vertex + floatsPerVertex);
+      dataIndexOf[geoIndex] = data.size () / floatsPerVertex - 1;
+      indices.push_back (dataIndexOf[geoIndex]);
+    }
+  }
+}
+
+void
+indexData (const std::vector<float>& geometry, unsigned int floatsPerVertex,
+    std::vector<float>& data, std::vector<unsigned int>& indices,
+    unsigned int threadCount)
+{
+  const unsigned int VERTICES_PER_TRIANGLE = 3;
+  const unsigned int VERTICES_PER_CHUNK = 16384;
+  threadCount = resolveThreadCount (threadCount);
+  if (threadCount == 1)
+  {
+    indexData (geometry, floatsPerVertex, data, indices);
+    return;
+  }
+  assert (geometry.size () % (floatsPerVertex * VERTICES_PER_TRIANGLE) == 0);
+  const unsigned int vertexCount = geometry.size () / floatsPerVertex;
+  const unsigned int dimensions = std::min (3u, floatsPerVertex);
+  const SpatialHash grid (geometry.data (), vertexCount, floatsPerVertex,
+      dimensions, 2.0f * EPSILON);
+  const SpatialHash previous (data.data (), data.size () / floatsPerVertex,
+      floatsPerVertex, dimensions, 2.0f * EPSILON);
+
+  // Each chunk of vertices is deduplicated on its own thread: every vertex
+  //   looks up the earliest vertex before it (in any chunk) that matches.
+  //   That only depends on the input, so the thread count cannot matter.
+  std::vector<unsigned int> previousMatch (previous.size () > 0 ? vertexCount : 0, NOT_DATA);
+  std::vector<unsigned int> earliestMatch (vertexCount, NOT_DATA);
+  unsigned int chunkCount = (vertexCount + VERTICES_PER_CHUNK - 1) / VERTICES_PER_CHUNK;
+  parallelFor (chunkCount, threadCount, [&] (unsigned int chunk)
+  {
+    unsigned int end = std::min (vertexCount, (chunk + 1) * VERTICES_PER_CHUNK);
+    for (unsigned int geoIndex = chunk * VERTICES_PER_CHUNK; geoIndex < end; geoIndex++)
+    {
+      const float* vertex = &geometry[geoIndex * floatsPerVertex];
+      if (!previousMatch.empty ())
       {
-        if (fabs (geometry[geoIndex * floatsPerVertex + part] -
-            data[dataIndex * floatsPerVertex + part]) >= EPSILON)
-        {
-          matches = false;
-        }
+        previousMatch[geoIndex] = findPreviousMatch (vertex, data, floatsPerVertex, previous);
       }
-      if (matches)
+      unsigned int match = NOT_DATA;
+      grid.forEachNear (vertex, EPSILON, [&] (unsigned int other)
       {
-        // Found it, just save that index!
-        indices.push_back (dataIndex);
-        found = true;
-      }
+        if (other < geoIndex && other < match
+            && verticesMatch (vertex, &geometry[other * floatsPerVertex], floatsPerVertex))
+        {
+          match = other;
+        }
+      });
+      earliestMatch[geoIndex] = match;
     }
-    if(!found)
+  });
+
+  // Merge the chunks in order.  The earliest match is almost always a vertex
+  //   that was itself kept, and then it is exactly what the serial search
+  //   would find.  Only when it was not kept (a chain of vertices each within
+  //   EPSILON of the next) do we fall back to the serial search.
+  std::vector<unsigned int> dataIndexOf (vertexCount, NOT_DATA);
+  indices.reserve (indices.size () + vertexCount);
+  for (unsigned int geoIndex = 0; geoIndex < vertexCount; geoIndex++)
+  {
+    unsigned int match = previousMatch.empty () ? NOT_DATA : previousMatch[geoIndex];
+    if (match == NOT_DATA && earliestMatch[geoIndex] != NOT_DATA)
     {
-      // Didn't find it, so copy it to data vector and add new index.
-      for (unsigned int part = 0; part < floatsPerVertex; part++)
+      match = dataIndexOf[earliestMatch[geoIndex]];
+      if (match == NOT_DATA)
       {
-        data.push_back (geometry[geoIndex * floatsPerVertex + part]);
+        match = findKeptMatch (&geometry[geoIndex * floatsPerVertex], floatsPerVertex,
+            geoIndex, grid, dataIndexOf, data.data ());
       }
-      indices.push_back (data.size () / floatsPerVertex - 1);
+    }
+    if (match != NOT_DATA)
+    {
+      indices.push_back (match);
+    }
+    else
+    {
+      const float* vertex = &geometry[geoIndex * floatsPerVertex];
+      data.insert (data.end (), vertex, vertex + floatsPerVertex);
+      dataIndexOf[geoIndex] = data.size () / floatsPerVertex - 1;
+      indices.push_back (dataIndexOf[geoIndex]);
     }
   }
 }
@@ -65,174 +235,1333 @@ computeFaceNormals (const std::vector<Triangle>& faces)
   return faceNormals;
 }
 
+unsigned int
+indexDataInPlace (float* geometry, unsigned int vertexCount,
+    unsigned int floatsPerVertex, std::vector<unsigned int>& indices)
+{
+  const unsigned int VERTICES_PER_TRIANGLE = 3;
+  assert (vertexCount % VERTICES_PER_TRIANGLE == 0);
+  const SpatialHash grid (geometry, vertexCount, floatsPerVertex,
+      std::min (3u, floatsPerVertex), 2.0f * EPSILON);
+  std::vector<unsigned int> dataIndexOf (vertexCount, NOT_DATA);
+  indices.reserve (indices.size () + vertexCount);
+  // Kept vertices are packed toward the front in the order they first
+  //   appear.  The n-th kept vertex was at least the n-th vertex, so moving it
+  //   never overwrites a vertex that has not been looked at yet.
+  unsigned int keptCount = 0;
+  for (unsigned int geoIndex = 0; geoIndex < vertexCount; geoIndex++)
+  {
+    float* vertex = geometry + static_cast<std::size_t> (geoIndex) * floatsPerVertex;
+    unsigned int match = findKeptMatch (vertex, floatsPerVertex, geoIndex, grid,
+        dataIndexOf, geometry);
+    if (match == NOT_DATA)
+    {
+      match = keptCount++;
+      dataIndexOf[geoIndex] = match;
+      if (match != geoIndex)
+      {
+        std::copy (vertex, vertex + floatsPerVertex,
+            geometry + static_cast<std::size_t> (match) * floatsPerVertex);
+      }
+    }
+    indices.push_back (match);
+  }
+  return keptCount;
+}
+
+/// \brief Tests whether two vertices are close enough to weld.
+/// \param[in] a A pointer to the first float of one vertex.
+/// \param[in] b A pointer to the first float of another vertex.
+/// \param[in] floatsPerVertex The number of floats used for each vertex.
+/// \param[in] attribute What follows each position.
+/// \param[in] tolerances How far apart the parts of the vertices may be.
+/// \param[in] minimumCosine The cosine of the largest normal angle allowed.
+/// \return Whether every part of a is within tolerance of b.
+static bool
+verticesWeld (const float* a, const float* b, unsigned int floatsPerVertex,
+    VertexAttribute attribute, const WeldTolerances& tolerances, float minimumCosine)
+{
+  Vector3 positionA (a[0], a[1], a[2]);
+  Vector3 positionB (b[0], b[1], b[2]);
+  if ((positionA - positionB).length () > tolerances.m_positionDistance)
+  {
+    return false;
+  }
+  unsigned int compared = 3;
+  if (attribute != VertexAttribute::NONE)
+  {
+    Vector3 attributeA (a[3], a[4], a[5]);
+    Vector3 attributeB (b[3], b[4], b[5]);
+    if (attribute == VertexAttribute::COLOR
+        && (attributeA - attributeB).length () > tolerances.m_colorDistance)
+    {
+      return false;
+    }
+    if (attribute == VertexAttribute::NORMAL
+        && attributeA.dot (attributeB) < minimumCosine * attributeA.length () * attributeB.length ())
+    {
+      return false;
+    }
+    compared = 6;
+  }
+  return verticesMatch (a + compared, b + compared, floatsPerVertex - compared);
+}
+
+WeldStatistics
+weldVertices (std::vector<float>& data, unsigned int floatsPerVertex,
+    std::vector<unsigned int>& indices, VertexAttribute attribute,
+    const WeldTolerances& tolerances)
+{
+  assert (floatsPerVertex >= (attribute == VertexAttribute::NONE ? 3u : 6u));
+  assert (indices.size () % 3 == 0);
+  const unsigned int vertexCount = data.size () / floatsPerVertex;
+  const float radius = std::max (tolerances.m_positionDistance, EPSILON);
+  const float minimumCosine = static_cast<float> (
+      std::cos (std::min (tolerances.m_normalAngleDegrees, 180.0f) * M_PI / 180.0));
+  const SpatialHash grid (data.data (), vertexCount, floatsPerVertex, 3, 2.0f * radius);
+
+  // Every vertex looks for the earliest kept vertex it welds to.  Kept
+  //   vertices keep their own values, so the result does not depend on how
+  //   the vertices that welded to them were spread out.
+  std::vector<unsigned int> weldedTo (vertexCount);
+  for (unsigned int vertex = 0; vertex < vertexCount; vertex++)
+  {
+    const float* values = &data[static_cast<std::size_t> (vertex) * floatsPerVertex];
+    unsigned int match = vertex;
+    grid.forEachNear (values, radius, [&] (unsigned int other)
+    {
+      if (other < match && weldedTo[other] == other
+          && verticesWeld (values, &data[static_cast<std::size_t> (other) * floatsPerVertex],
+                           floatsPerVertex, attribute, tolerances, minimumCosine))
+      {
+        match = other;
+      }
+    });
+    weldedTo[vertex] = match;
+  }
+
+  // Drop the triangles welding collapsed, then the vertices nothing uses.
+  WeldStatistics statistics = { 0, 0 };
+  std::vector<bool> used (vertexCount, false);
+  std::size_t kept = 0;
+  for (std::size_t corner = 0; corner < indices.size (); corner += 3)
+  {
+    unsigned int a = weldedTo[indices[corner]];
+    unsigned int b = weldedTo[indices[corner + 1]];
+    unsigned int c = weldedTo[indices[corner + 2]];
+    if (a == b || b == c || a == c)
+    {
+      statistics.m_trianglesRemoved++;
+      continue;
+    }
+    indices[kept++] = a;
+    indices[kept++] = b;
+    indices[kept++] = c;
+    used[a] = used[b] = used[c] = true;
+  }
+  indices.resize (kept);
+  std::vector<unsigned int> newIndexOf (vertexCount, NOT_DATA);
+  unsigned int keptVertices = 0;
+  for (unsigned int vertex = 0; vertex < vertexCount; vertex++)
+  {
+    if (used[vertex])
+    {
+      std::copy_n (&data[static_cast<std::size_t> (vertex) * floatsPerVertex], floatsPerVertex,
+          &data[static_cast<std::size_t> (keptVertices) * floatsPerVertex]);
+      newIndexOf[vertex] = keptVertices++;
+    }
+  }
+  data.resize (static_cast<std::size_t> (keptVertices) * floatsPerVertex);
+  for (unsigned int& index : indices)
+  {
+    index = newIndexOf[index];
+  }
+  statistics.m_verticesRemoved = vertexCount - keptVertices;
+  return statistics;
+}
+
+/// \brief Groups together the corners of some faces that share a position.
+/// \param[in] faces A collection of faces that are part of the mesh.
+/// \param[in] threadCount The number of threads to use, where 0 means one per
+///   hardware thread.
+/// \param[in] facesPerChunk How many faces each thread handles at a time.
+/// \return For each corner (three per face), the index of the first corner
+///   of its group, which is itself for the first.  Positions are compared
+///   with Vector3's operator==, which is not transitive, so a group holds
+///   every corner reached through a chain of equal positions.
+static std::vector<unsigned int>
+groupCornersByPosition (const std::vector<Triangle>& faces, unsigned int threadCount = 1,
+    unsigned int facesPerChunk = DEFAULT_FACES_PER_CHUNK)
+{
+  static_assert (sizeof (Triangle) == 9 * sizeof (float),
+      "corner positions must be tightly packed floats");
+  assert (facesPerChunk > 0);
+  const unsigned int cornerCount = faces.size () * 3;
+  const float* positions = faces.empty () ? nullptr : &faces[0][0].m_x;
+  const SpatialHash grid (positions, cornerCount, 3, 3, 2.0f * EPSILON);
+  std::vector<unsigned int> groups (cornerCount);
+  // Each corner first finds the earliest corner at the same position, which
+  //   needs no other corner's result, so chunks can run in any order.
+  const unsigned int cornersPerChunk = facesPerChunk * 3;
+  const unsigned int chunkCount = (cornerCount + cornersPerChunk - 1) / cornersPerChunk;
+  parallelFor (chunkCount, threadCount, [&] (unsigned int chunk)
+  {
+    unsigned int end = std::min (cornerCount, (chunk + 1) * cornersPerChunk);
+    for (unsigned int corner = chunk * cornersPerChunk; corner < end; corner++)
+    {
+      const Vector3& position = faces[corner / 3][corner % 3];
+      unsigned int group = corner;
+      grid.forEachNear (&position.m_x, EPSILON, [&] (unsigned int other)
+      {
+        if (other < group && faces[other / 3][other % 3] == position)
+        {
+          group = other;
+        }
+      });
+      groups[corner] = group;
+    }
+  });
+  // That corner may itself belong to an earlier group, when positions chain
+  //   through near-equal ones.  It is always earlier, so one ascending pass
+  //   points every corner at the first corner of its group.
+  for (unsigned int corner = 0; corner < cornerCount; corner++)
+  {
+    groups[corner] = groups[groups[corner]];
+  }
+  return groups;
+}
+
 std::vector<Vector3>
 computeVertexNormals (const std::vector<Triangle>& faces,
           const std::vector<Vector3>& faceNormals)
 {
   assert (faces.size () == faceNormals.size ());
-  std::vector<Vector3> vertexNormals;
+  // Hey, we derived the area formula in Lecture 04!  Each face's area and
+  //   corner angles only need to be computed once.
+  std::vector<float> areas (faces.size ());
+  std::vector<float> angles (faces.size () * 3);
   for (unsigned int faceIndex = 0; faceIndex < faces.size (); faceIndex++)
   {
+    const Triangle& face = faces[faceIndex];
+    areas[faceIndex] = 0.5f * ((face[1] - face[0]).cross (face[2] - face[0])).length ();
     for (unsigned int vertexIndex = 0; vertexIndex < 3; vertexIndex++)
     {
-      // We need to find *every* vertex in any triangle that is at this
-      //   position and average their face normals.
-      Vector3 vertexNormal (0.0f, 0.0f, 0.0f);
-      for (unsigned int otherFaceIndex = 0; otherFaceIndex < faces.size (); otherFaceIndex++)
-      {
-        for (unsigned int otherVertexIndex = 0; otherVertexIndex < 3; otherVertexIndex++ )
-        {
-          if (faces[faceIndex][vertexIndex] == faces[otherFaceIndex][otherVertexIndex])
-          {
-            // Hey, we derived this formula in Lecture 04!
-            float area = 0.5f * ((faces[otherFaceIndex][1] - faces[otherFaceIndex][0]).cross (faces[otherFaceIndex][2] - faces[otherFaceIndex][0])).length ();
-            unsigned int oppositeIndexA = (otherVertexIndex + 1) % 3;
-            unsigned int oppositeIndexB = (otherVertexIndex + 2) % 3;
-            float angle = (faces[otherFaceIndex][oppositeIndexA] - faces[otherFaceIndex][otherVertexIndex]).angleBetween (faces[otherFaceIndex][oppositeIndexB] - faces[otherFaceIndex][otherVertexIndex]);
-            // Weighting the average by area makes it so that lots of smaller
-            //   faces don't overwhelm a few larger faces.
-            // Weighting the average by angle makes it so that points where
-            //   two 45 degree angles and points where one 90 degree angle meet
-            //   get the same treatment.
-            vertexNormal += faceNormals[otherFaceIndex] * fabs (area) * fabs (angle);
-          }
-        }
-      }
-      vertexNormal.normalize ();
-      vertexNormals.push_back (vertexNormal);
+      unsigned int oppositeIndexA = (vertexIndex + 1) % 3;
+      unsigned int oppositeIndexB = (vertexIndex + 2) % 3;
+      angles[faceIndex * 3 + vertexIndex] = (face[oppositeIndexA] - face[vertexIndex]).angleBetween (face[oppositeIndexB] - face[vertexIndex]);
     }
   }
+  // Every corner at the same position shares one sum of face normals, added
+  //   up in corner order.  When no two distinct positions are within EPSILON
+  //   of each other, each group holds exactly the corners that searching the
+  //   whole mesh would find.  Otherwise, since operator== is not transitive,
+  //   a group can gain or lose corners near its edge.
+  std::vector<unsigned int> groups = groupCornersByPosition (faces);
+  std::vector<Vector3> sums (groups.size (), Vector3 (0.0f, 0.0f, 0.0f));
+  for (unsigned int corner = 0; corner < groups.size (); corner++)
+  {
+    // Weighting the average by area makes it so that lots of smaller
+    //   faces don't overwhelm a few larger faces.
+    // Weighting the average by angle makes it so that points where
+    //   two 45 degree angles and points where one 90 degree angle meet
+    //   get the same treatment.
+    sums[groups[corner]] += faceNormals[corner / 3] * fabs (areas[corner / 3]) * fabs (angles[corner]);
+  }
+  std::vector<Vector3> vertexNormals;
+  vertexNormals.reserve (groups.size ());
+  for (unsigned int corner = 0; corner < groups.size (); corner++)
+  {
+    Vector3 vertexNormal = sums[groups[corner]];
+    vertexNormal.normalize ();
+    vertexNormals.push_back (vertexNormal);
+  }
   return vertexNormals;
 }
 
+/// \brief Generates a random color from a seed and a counter.
+/// \param[in] seed The seed of the whole sequence of colors.
+/// \param[in] counter Which color of that sequence to generate.
+/// \return A color whose components are each in [0, 1).
+/// The same seed and counter always give the same color, no matter what other
+///   colors have been generated, so colors can be produced in any order.
+static Vector3
+randomColor (std::uint64_t seed, std::uint64_t counter)
+{
+  Vector3 color;
+  float* components[3] = { &color.m_x, &color.m_y, &color.m_z };
+  for (unsigned int component = 0; component < 3; component++)
+  {
+    // SplitMix64 applied to the (seed, counter, component) triple.
+    std::uint64_t bits = seed + (counter * 3 + component + 1) * 0x9E3779B97F4A7C15ULL;
+    bits = (bits ^ (bits >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    bits = (bits ^ (bits >> 27)) * 0x94D049BB133111EBULL;
+    bits ^= bits >> 31;
+    // The top 24 bits fill a float's mantissa exactly.
+    *components[component] = (bits >> 40) * (1.0f / 16777216.0f);
+  }
+  return color;
+}
+
 std::vector<Vector3>
 generateRandomFaceColors (const std::vector<Triangle>& faces)
 {
-  std::default_random_engine generator;
-  std::uniform_real_distribution<float> distribution(0.0f,1.0f);
-  std::vector<Vector3> faceColors;
-  for (unsigned int faceIndex = 0; faceIndex < faces.size (); faceIndex++)
+  return generateRandomFaceColors (faces, 0, 1);
+}
+
+std::vector<Vector3>
+generateRandomFaceColors (const std::vector<Triangle>& faces, unsigned int seed,
+    unsigned int threadCount, unsigned int facesPerChunk)
+{
+  assert (facesPerChunk > 0);
+  const unsigned int faceCount = faces.size ();
+  std::vector<Vector3> faceColors (faceCount);
+  const unsigned int chunkCount = (faceCount + facesPerChunk - 1) / facesPerChunk;
+  parallelFor (chunkCount, threadCount, [&] (unsigned int chunk)
   {
-    faceColors.push_back (Vector3 (distribution (generator), distribution (generator), distribution (generator)));
-  }
+    unsigned int end = std::min (faceCount, (chunk + 1) * facesPerChunk);
+    for (unsigned int faceIndex = chunk * facesPerChunk; faceIndex < end; faceIndex++)
+    {
+      faceColors[faceIndex] = randomColor (seed, faceIndex);
+    }
+  });
   return faceColors;
 }
 
 std::vector<Vector3>
-generateRandomVertexColors (const std::vector<Triangle>& faces)
+generateRandomVertexColors (const std::vector<Triangle>& faces, unsigned int seed)
 {
-  std::default_random_engine generator;
-  std::uniform_real_distribution<float> distribution(0.0f,1.0f);
-  std::vector<Vector3> vertexColors;
+  return generateRandomVertexColors (faces, seed, 1);
+}
+
+std::vector<Vector3>
+generateRandomVertexColors (const std::vector<Triangle>& faces, unsigned int seed,
+    unsigned int threadCount, unsigned int facesPerChunk)
+{
+  // If we already assigned a color to that position, we need to copy it, so
+  //   every corner shares the color of the first corner at its position.  The
+  //   n-th distinct position always gets the n-th color of the sequence.
+  std::vector<unsigned int> groups = groupCornersByPosition (faces, threadCount, facesPerChunk);
+  const unsigned int cornerCount = groups.size ();
+  const unsigned int cornersPerChunk = facesPerChunk * 3;
+  const unsigned int chunkCount = (cornerCount + cornersPerChunk - 1) / cornersPerChunk;
+
+  // Count the new positions in each chunk, so that a running sum tells each
+  //   chunk which color of the sequence its first new position gets.
+  std::vector<unsigned int> firstColor (chunkCount + 1, 0);
+  parallelFor (chunkCount, threadCount, [&] (unsigned int chunk)
+  {
+    unsigned int end = std::min (cornerCount, (chunk + 1) * cornersPerChunk);
+    for (unsigned int corner = chunk * cornersPerChunk; corner < end; corner++)
+    {
+      firstColor[chunk + 1] += groups[corner] == corner;
+    }
+  });
+  std::partial_sum (firstColor.begin (), firstColor.end (), firstColor.begin ());
+
+  // Number the new positions, then color every corner by its group's number.
+  //   The group may be in an earlier chunk, so this takes two passes.
+  std::vector<unsigned int> colorOf (cornerCount);
+  parallelFor (chunkCount, threadCount, [&] (unsigned int chunk)
+  {
+    unsigned int next = firstColor[chunk];
+    unsigned int end = std::min (cornerCount, (chunk + 1) * cornersPerChunk);
+    for (unsigned int corner = chunk * cornersPerChunk; corner < end; corner++)
+    {
+      if (groups[corner] == corner)
+      {
+        colorOf[corner] = next++;
+      }
+    }
+  });
+  std::vector<Vector3> vertexColors (cornerCount);
+  parallelFor (chunkCount, threadCount, [&] (unsigned int chunk)
+  {
+    unsigned int end = std::min (cornerCount, (chunk + 1) * cornersPerChunk);
+    for (unsigned int corner = chunk * cornersPerChunk; corner < end; corner++)
+    {
+      vertexColors[corner] = randomColor (seed, colorOf[groups[corner]]);
+    }
+  });
+  return vertexColors;
+}
+
+/// \brief Writes interleaved position / attribute data for some faces.
+/// \tparam Layout The VertexLayout to write, which has a position and
+///   Attribute.
+/// \tparam Attribute What attributes holds.
+/// \param[in] faces A collection of faces that are part of the mesh.
+/// \param[in] attributes The colors or normals, either one per face or three
+///   per face.
+/// \param[in] perFace Whether attributes has one entry per face (otherwise it
+///   has one per corner).
+/// \param[out] destination Where to write interleavedFloatCount (faces)
+///   floats.
+/// \return A pointer just past the last float written.
+template<typename Layout, typename Attribute>
+static float*
+writeInterleaved (const std::vector<Triangle>& faces,
+    const std::vector<Vector3>& attributes, bool perFace, float* destination)
+{
+  const unsigned int POSITION = Layout::template offsetOf<PositionAttribute> ();
+  const unsigned int ATTRIBUTE = Layout::template offsetOf<Attribute> ();
+  assert (attributes.size () == (perFace ? faces.size () : faces.size () * 3));
   for (unsigned int faceIndex = 0; faceIndex < faces.size (); faceIndex++)
   {
     for (unsigned int vertexIndex = 0; vertexIndex < 3; vertexIndex++)
     {
-      // If we already assigned a color to that position, we need to copy it.
-      bool foundMatch = false;
-      for (unsigned int otherFaceIndex = 0; otherFaceIndex < faceIndex && !foundMatch; otherFaceIndex++)
+      const Vector3& position = faces[faceIndex][vertexIndex];
+      const Vector3& attribute = attributes[perFace ? faceIndex : faceIndex * 3 + vertexIndex];
+      destination[POSITION] = position.m_x;
+      destination[POSITION + 1] = position.m_y;
+      destination[POSITION + 2] = position.m_z;
+      destination[ATTRIBUTE] = attribute.m_x;
+      destination[ATTRIBUTE + 1] = attribute.m_y;
+      destination[ATTRIBUTE + 2] = attribute.m_z;
+      destination += Layout::FLOATS_PER_VERTEX;
+    }
+  }
+  return destination;
+}
+
+std::size_t
+interleavedFloatCount (const std::vector<Triangle>& faces)
+{
+  static_assert (ColorsLayout::FLOATS_PER_VERTEX == NormalsLayout::FLOATS_PER_VERTEX,
+                 "Colored and normal vertices are the same size.");
+  return faces.size () * 3 * ColorsLayout::FLOATS_PER_VERTEX;
+}
+
+float*
+writeFaceColors (const std::vector<Triangle>& faces,
+    const std::vector<Vector3>& faceColors, float* destination)
+{
+  return writeInterleaved<ColorsLayout, ColorAttribute> (faces, faceColors, true, destination);
+}
+
+float*
+writeVertexColors (const std::vector<Triangle>& faces,
+    const std::vector<Vector3>& vertexColors, float* destination)
+{
+  return writeInterleaved<ColorsLayout, ColorAttribute> (faces, vertexColors, false, destination);
+}
+
+float*
+writeFaceNormals (const std::vector<Triangle>& faces,
+    const std::vector<Vector3>& faceNormals, float* destination)
+{
+  return writeInterleaved<NormalsLayout, NormalAttribute> (faces, faceNormals, true, destination);
+}
+
+float*
+writeVertexNormals (const std::vector<Triangle>& faces,
+    const std::vector<Vector3>& vertexNormals, float* destination)
+{
+  return writeInterleaved<NormalsLayout, NormalAttribute> (faces, vertexNormals, false, destination);
+}
+
+std::vector<float>
+dataWithFaceColors (const std::vector<Triangle>& faces,
+        const std::vector<Vector3>& faceColors)
+{
+  std::vector<float> data (interleavedFloatCount (faces));
+  writeFaceColors (faces, faceColors, data.data ());
+  return data;
+}
+
+std::vector<float>
+dataWithVertexColors (const std::vector<Triangle>& faces,
+          const std::vector<Vector3>& vertexColors)
+{
+  std::vector<float> data (interleavedFloatCount (faces));
+  writeVertexColors (faces, vertexColors, data.data ());
+  return data;
+}
+
+std::vector<float>
+dataWithFaceNormals (const std::vector<Triangle>& faces,
+        const std::vector<Vector3>& faceNormals)
+{
+  std::vector<float> data (interleavedFloatCount (faces));
+  writeFaceNormals (faces, faceNormals, data.data ());
+  return data;
+}
+
+std::vector<float>
+dataWithVertexNormals (const std::vector<Triangle>& faces,
+          const std::vector<Vector3>& vertexNormals)
+{
+  std::vector<float> data (interleavedFloatCount (faces));
+  writeVertexNormals (faces, vertexNormals, data.data ());
+  return data;
+}
+
+/// \brief Rounds a byte count up to a multiple of some alignment.
+static unsigned int
+alignUp (unsigned int bytes, unsigned int alignment)
+{
+  return (bytes + alignment - 1) / alignment * alignment;
+}
+
+/// \brief Gets the size of one component of an attribute format, which is
+///   also the alignment it needs.
+static unsigned int
+attributeComponentBytes (AttributeFormat format)
+{
+  switch (format)
+  {
+  case AttributeFormat::FLOAT32:
+    return sizeof (float);
+  case AttributeFormat::OCTAHEDRAL_SNORM16:
+    return sizeof (std::int16_t);
+  default:
+    return 1;
+  }
+}
+
+/// \brief Gets the number of components of an attribute format.
+static unsigned int
+attributeComponentCount (AttributeFormat format)
+{
+  return format == AttributeFormat::OCTAHEDRAL_SNORM16
+      || format == AttributeFormat::OCTAHEDRAL_SNORM8 ? 2 : 3;
+}
+
+unsigned int
+packedAttributeOffset (const VertexFormat& format)
+{
+  unsigned int positionBytes = format.m_position == PositionFormat::FLOAT32
+    ? 3 * sizeof (float) : 3 * sizeof (std::uint16_t);
+  return alignUp (positionBytes, attributeComponentBytes (format.m_attribute));
+}
+
+unsigned int
+packedVertexStride (const VertexFormat& format)
+{
+  unsigned int attributeBytes = attributeComponentCount (format.m_attribute)
+    * attributeComponentBytes (format.m_attribute);
+  return alignUp (packedAttributeOffset (format) + attributeBytes, 4);
+}
+
+PositionQuantization
+computePositionQuantization (const std::vector<float>& data, unsigned int floatsPerVertex)
+{
+  PositionQuantization quantization = { Vector3 (0.0f, 0.0f, 0.0f), 1.0f };
+  if (data.size () < floatsPerVertex)
+  {
+    return quantization;
+  }
+  float low[3] = { data[0], data[1], data[2] };
+  float high[3] = { data[0], data[1], data[2] };
+  for (std::size_t vertex = 0; vertex + floatsPerVertex <= data.size (); vertex += floatsPerVertex)
+  {
+    for (unsigned int axis = 0; axis < 3; axis++)
+    {
+      low[axis] = std::min (low[axis], data[vertex + axis]);
+      high[axis] = std::max (high[axis], data[vertex + axis]);
+    }
+  }
+  quantization.m_offset = Vector3 ((low[0] + high[0]) / 2.0f, (low[1] + high[1]) / 2.0f,
+                                   (low[2] + high[2]) / 2.0f);
+  float halfExtent = std::max ({ high[0] - low[0], high[1] - low[1], high[2] - low[2] }) / 2.0f;
+  if (halfExtent > 0.0f)
+  {
+    quantization.m_scale = halfExtent;
+  }
+  return quantization;
+}
+
+/// \brief Copies a value's bytes into a packed vertex and moves past them.
+template<typename T>
+static void
+appendPacked (unsigned char*& destination, T value)
+{
+  std::memcpy (destination, &value, sizeof (value));
+  destination += sizeof (value);
+}
+
+std::vector<unsigned char>
+encodeVertices (const std::vector<float>& data, const VertexFormat& format,
+    const PositionQuantization& quantization)
+{
+  const unsigned int FLOATS_PER_VERTEX = 6;
+  assert (data.size () % FLOATS_PER_VERTEX == 0);
+  const unsigned int stride = packedVertexStride (format);
+  const unsigned int attributeOffset = packedAttributeOffset (format);
+  const float offset[3] = { quantization.m_offset.m_x, quantization.m_offset.m_y,
+                            quantization.m_offset.m_z };
+  std::vector<unsigned char> packed (data.size () / FLOATS_PER_VERTEX * stride, 0);
+  for (std::size_t vertex = 0; vertex < data.size () / FLOATS_PER_VERTEX; vertex++)
+  {
+    const float* source = &data[vertex * FLOATS_PER_VERTEX];
+    unsigned char* destination = &packed[vertex * stride];
+    for (unsigned int axis = 0; axis < 3; axis++)
+    {
+      float stored = (source[axis] - offset[axis]) / quantization.m_scale;
+      switch (format.m_position)
+      {
+      case PositionFormat::FLOAT32:
+        appendPacked (destination, source[axis]);
+        break;
+      case PositionFormat::HALF_FLOAT:
+        appendPacked (destination, encodeHalf (stored));
+        break;
+      case PositionFormat::SNORM16:
+        appendPacked (destination, static_cast<std::int16_t> (encodeSnorm (stored, 16)));
+        break;
+      }
+    }
+
+    destination = &packed[vertex * stride + attributeOffset];
+    const float* attribute = source + 3;
+    if (format.m_attribute == AttributeFormat::FLOAT32
+        || format.m_attribute == AttributeFormat::UNORM8)
+    {
+      for (unsigned int component = 0; component < 3; component++)
       {
-        for (unsigned int otherVertexIndex = 0; otherVertexIndex < 3; otherVertexIndex++)
+        if (format.m_attribute == AttributeFormat::FLOAT32)
         {
-          if(faces[faceIndex][vertexIndex] == faces[otherFaceIndex][otherVertexIndex])
-          {
-            vertexColors.push_back (vertexColors[otherFaceIndex * 3 + otherVertexIndex]);
-            foundMatch = true;
-          }
+          appendPacked (destination, attribute[component]);
+        }
+        else
+        {
+          appendPacked (destination, encodeUnorm8 (attribute[component]));
         }
       }
-      // If we never saw this position before, generate a new random color.
-      if(!foundMatch)
+    }
+    else
+    {
+      std::array<float, 2> folded = encodeOctahedral (Vector3 (attribute[0], attribute[1], attribute[2]));
+      for (float coordinate : folded)
       {
-        vertexColors.push_back (Vector3 (distribution (generator), distribution (generator), distribution (generator)));
+        if (format.m_attribute == AttributeFormat::OCTAHEDRAL_SNORM16)
+        {
+          appendPacked (destination, static_cast<std::int16_t> (encodeSnorm (coordinate, 16)));
+        }
+        else
+        {
+          appendPacked (destination, static_cast<std::int8_t> (encodeSnorm (coordinate, 8)));
+        }
       }
     }
   }
-  return vertexColors;
+  return packed;
 }
 
-std::vector<float>
-dataWithFaceColors (const std::vector<Triangle>& faces,
-        const std::vector<Vector3>& faceColors)
+std::uint16_t
+encodeHalf (float value)
 {
-  assert (faces.size () == faceColors.size ());
-  std::vector<float> data;
-  for(unsigned int faceIndex = 0; faceIndex < faces.size (); faceIndex++)
+  std::uint32_t bits;
+  std::memcpy (&bits, &value, sizeof (bits));
+  const std::uint32_t sign = bits & 0x80000000u;
+  bits ^= sign;
+  std::uint32_t half;
+  if (bits >= 0x47800000u)
   {
-    for(unsigned int vertexIndex = 0; vertexIndex < 3; vertexIndex++)
+    // At least 2^16, infinite, or NaN (kept a quiet NaN).
+    half = bits > 0x7F800000u ? 0x7E00u : 0x7C00u;
+  }
+  else if (bits < 0x38800000u)
+  {
+    // Below the smallest normal half, so the result is subnormal or zero.
+    //   Adding 0.5 lines the 10 remaining mantissa bits up at the bottom of a
+    //   float, and lets the FPU round them to nearest even.
+    const std::uint32_t MAGIC_BITS = 126u << 23;
+    float magic;
+    std::memcpy (&magic, &MAGIC_BITS, sizeof (magic));
+    float magnitude;
+    std::memcpy (&magnitude, &bits, sizeof (magnitude));
+    float sum = magnitude + magic;
+    std::memcpy (&half, &sum, sizeof (half));
+    half -= MAGIC_BITS;
+  }
+  else
+  {
+    // Rebias the exponent and round the mantissa to nearest even.  Rounding
+    //   up past 65504 carries into the exponent and gives infinity.
+    std::uint32_t odd = (bits >> 13) & 1u;
+    bits += (static_cast<std::uint32_t> (15 - 127) << 23) + 0xFFFu + odd;
+    half = bits >> 13;
+  }
+  return static_cast<std::uint16_t> ((sign >> 16) | half);
+}
+
+float
+decodeHalf (std::uint16_t bits)
+{
+  const unsigned int exponent = (bits >> 10) & 0x1Fu;
+  const unsigned int mantissa = bits & 0x3FFu;
+  float magnitude;
+  if (exponent == 0)
+  {
+    magnitude = std::ldexp (static_cast<float> (mantissa), -24);
+  }
+  else if (exponent == 0x1F)
+  {
+    magnitude = mantissa == 0 ? std::numeric_limits<float>::infinity ()
+      : std::numeric_limits<float>::quiet_NaN ();
+  }
+  else
+  {
+    magnitude = std::ldexp (static_cast<float> (mantissa | 0x400u), static_cast<int> (exponent) - 25);
+  }
+  return (bits & 0x8000u) != 0 ? -magnitude : magnitude;
+}
+
+int
+encodeSnorm (float value, unsigned int bits)
+{
+  assert (bits == 8 || bits == 16);
+  const float MAX = static_cast<float> ((1 << (bits - 1)) - 1);
+  return static_cast<int> (std::lround (std::max (-1.0f, std::min (1.0f, value)) * MAX));
+}
+
+std::uint8_t
+encodeUnorm8 (float value)
+{
+  return static_cast<std::uint8_t> (std::lround (std::max (0.0f, std::min (1.0f, value)) * 255.0f));
+}
+
+std::array<float, 2>
+encodeOctahedral (const Vector3& normal)
+{
+  float sum = std::fabs (normal.m_x) + std::fabs (normal.m_y) + std::fabs (normal.m_z);
+  float x = normal.m_x / sum;
+  float y = normal.m_y / sum;
+  if (normal.m_z < 0.0f)
+  {
+    // Fold the lower half of the octahedron out over the corners.
+    float foldedX = (1.0f - std::fabs (y)) * (x >= 0.0f ? 1.0f : -1.0f);
+    y = (1.0f - std::fabs (x)) * (y >= 0.0f ? 1.0f : -1.0f);
+    x = foldedX;
+  }
+  return { { x, y } };
+}
+
+Vector3
+decodeOctahedral (float x, float y)
+{
+  Vector3 normal (x, y, 1.0f - std::fabs (x) - std::fabs (y));
+  float fold = std::max (-normal.m_z, 0.0f);
+  normal.m_x += normal.m_x >= 0.0f ? -fold : fold;
+  normal.m_y += normal.m_y >= 0.0f ? -fold : fold;
+  normal.normalize ();
+  return normal;
+}
+
+CompressedGeometry
+compressGeometry (const std::vector<float>& data, unsigned int floatsPerVertex,
+                  const std::vector<unsigned int>& indices)
+{
+  CompressedGeometry compressed { floatsPerVertex, data.size (), indices.size (), {}, {} };
+  std::vector<unsigned char>& vertexBytes = compressed.m_vertexBytes;
+  std::size_t control = 0;
+  for (std::size_t value = 0; value < data.size (); value++)
+  {
+    std::uint32_t bits;
+    std::memcpy (&bits, &data[value], sizeof (bits));
+    if (value >= floatsPerVertex)
+    {
+      std::uint32_t previous;
+      std::memcpy (&previous, &data[value - floatsPerVertex], sizeof (previous));
+      bits ^= previous;
+    }
+    unsigned int byteCount = 0;
+    for (std::uint32_t rest = bits; rest != 0; rest >>= 8)
+    {
+      byteCount++;
+    }
+    if (value % 2 == 0)
+    {
+      control = vertexBytes.size ();
+      vertexBytes.push_back (0);
+    }
+    vertexBytes[control] |= byteCount << (value % 2 * 4);
+    for (unsigned int byte = 0; byte < byteCount; byte++)
     {
-      data.push_back (faces[faceIndex][vertexIndex].m_x);
-      data.push_back (faces[faceIndex][vertexIndex].m_y);
-      data.push_back (faces[faceIndex][vertexIndex].m_z);
-      data.push_back (faceColors[faceIndex].m_x);
-      data.push_back (faceColors[faceIndex].m_y);
-      data.push_back (faceColors[faceIndex].m_z);
+      vertexBytes.push_back (static_cast<unsigned char> (bits >> (byte * 8)));
     }
   }
-  return data;
+
+  std::uint32_t previous = 0;
+  for (unsigned int index : indices)
+  {
+    // Unsigned wraparound makes any difference, even to the restart index,
+    //   fit in 32 bits.
+    std::uint32_t difference = index - previous;
+    std::uint32_t zigzag = (difference << 1) ^ (0u - (difference >> 31));
+    previous = index;
+    do
+    {
+      unsigned char byte = zigzag & 0x7F;
+      zigzag >>= 7;
+      compressed.m_indexBytes.push_back (byte | (zigzag != 0 ? 0x80 : 0));
+    } while (zigzag != 0);
+  }
+  return compressed;
 }
 
-std::vector<float>
-dataWithVertexColors (const std::vector<Triangle>& faces,
-          const std::vector<Vector3>& vertexColors)
+void
+decompressGeometry (const CompressedGeometry& compressed, std::vector<float>& data,
+                    std::vector<unsigned int>& indices)
 {
-  assert (faces.size () * 3 == vertexColors.size ());
-  std::vector<float> data;
-  for(unsigned int faceIndex = 0; faceIndex < faces.size (); faceIndex++)
+  const unsigned int floatsPerVertex = compressed.m_floatsPerVertex;
+  data.resize (compressed.m_floatCount);
+  const unsigned char* next = compressed.m_vertexBytes.data ();
+  unsigned char control = 0;
+  for (std::size_t value = 0; value < data.size (); value++)
   {
-    for(unsigned int vertexIndex = 0; vertexIndex < 3; vertexIndex++)
+    if (value % 2 == 0)
+    {
+      control = *next++;
+    }
+    unsigned int byteCount = (control >> (value % 2 * 4)) & 0xF;
+    std::uint32_t bits = 0;
+    for (unsigned int byte = 0; byte < byteCount; byte++)
+    {
+      bits |= static_cast<std::uint32_t> (*next++) << (byte * 8);
+    }
+    if (value >= floatsPerVertex)
     {
-      data.push_back (faces[faceIndex][vertexIndex].m_x);
-      data.push_back (faces[faceIndex][vertexIndex].m_y);
-      data.push_back (faces[faceIndex][vertexIndex].m_z);
-      data.push_back (vertexColors[faceIndex * 3 + vertexIndex].m_x);
-      data.push_back (vertexColors[faceIndex * 3 + vertexIndex].m_y);
-      data.push_back (vertexColors[faceIndex * 3 + vertexIndex].m_z);
+      std::uint32_t previous;
+      std::memcpy (&previous, &data[value - floatsPerVertex], sizeof (previous));
+      bits ^= previous;
     }
+    std::memcpy (&data[value], &bits, sizeof (bits));
+  }
+
+  indices.resize (compressed.m_indexCount);
+  next = compressed.m_indexBytes.data ();
+  std::uint32_t previous = 0;
+  for (unsigned int& index : indices)
+  {
+    std::uint32_t zigzag = 0;
+    unsigned int shift = 0;
+    unsigned char byte;
+    do
+    {
+      byte = *next++;
+      zigzag |= static_cast<std::uint32_t> (byte & 0x7F) << shift;
+      shift += 7;
+    } while (byte & 0x80);
+    previous += (zigzag >> 1) ^ (0u - (zigzag & 1));
+    index = previous;
   }
-  return data;
 }
 
-std::vector<float>
-dataWithFaceNormals (const std::vector<Triangle>& faces,
-        const std::vector<Vector3>& faceNormals)
+/// \brief A quadric error metric: the sum of the squared distances from a
+///   point to some planes, stored as the 10 distinct entries of a symmetric
+///   4 x 4 matrix.
+struct Quadric
 {
-  assert (faces.size () == faceNormals.size ());
-  std::vector<float> data;
-  for(unsigned int faceIndex = 0; faceIndex < faces.size (); faceIndex++)
+  /// aa, ab, ac, ad, bb, bc, bd, cc, cd, dd for planes ax + by + cz + d = 0.
+  double m_entries[10];
+};
+
+/// \brief Makes the quadric of a triangle's plane.
+/// \param[in] a The position of the first corner.
+/// \param[in] b The position of the second corner.
+/// \param[in] c The position of the third corner.
+/// \return The quadric measuring squared distance to that plane, or all zeros
+///   if the triangle has no area.
+static Quadric
+triangleQuadric (const float* a, const float* b, const float* c)
+{
+  Vector3 p0 (a[0], a[1], a[2]);
+  Vector3 normal = (Vector3 (b[0], b[1], b[2]) - p0).cross (Vector3 (c[0], c[1], c[2]) - p0);
+  Quadric quadric = {};
+  float length = normal.length ();
+  if (length > 0.0f)
+  {
+    double nx = normal.m_x / length;
+    double ny = normal.m_y / length;
+    double nz = normal.m_z / length;
+    double d = -(nx * p0.m_x + ny * p0.m_y + nz * p0.m_z);
+    double entries[10] = { nx * nx, nx * ny, nx * nz, nx * d, ny * ny,
+                           ny * nz, ny * d, nz * nz, nz * d, d * d };
+    std::copy (entries, entries + 10, quadric.m_entries);
+  }
+  return quadric;
+}
+
+/// \brief Adds one quadric into another.
+static void
+addQuadric (Quadric& sum, const Quadric& quadric)
+{
+  for (unsigned int entry = 0; entry < 10; entry++)
+  {
+    sum.m_entries[entry] += quadric.m_entries[entry];
+  }
+}
+
+/// \brief Evaluates a quadric at a point.
+/// \return The sum of squared distances, which is never negative.
+static double
+evaluateQuadric (const Quadric& quadric, const float* point)
+{
+  const double* q = quadric.m_entries;
+  double x = point[0];
+  double y = point[1];
+  double z = point[2];
+  double error = q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z + 2 * q[3] * x
+    + q[4] * y * y + 2 * q[5] * y * z + 2 * q[6] * y
+    + q[7] * z * z + 2 * q[8] * z
+    + q[9];
+  return std::max (0.0, error);
+}
+
+/// \brief An indexed mesh partway through simplification.
+struct Simplification
+{
+  /// The vertex data, which never changes.
+  const float* m_data;
+  /// The number of floats used for each vertex.
+  unsigned int m_floatsPerVertex;
+  /// Three vertex indices per triangle, updated as vertices are collapsed.
+  std::vector<unsigned int> m_indices;
+  /// Whether each triangle has collapsed away.
+  std::vector<bool> m_removed;
+  /// The triangles using each vertex.  May also list removed triangles.
+  std::vector<std::vector<unsigned int>> m_trianglesOf;
+  /// Whether each vertex must stay where it is.
+  std::vector<bool> m_locked;
+  /// The earliest vertex with the same position as each vertex.
+  std::vector<unsigned int> m_positionGroup;
+  /// The planes each vertex's triangles have passed through.
+  std::vector<Quadric> m_quadrics;
+  /// The number of triangles that have not been removed.
+  unsigned int m_liveTriangles;
+
+  /// \brief Gets the position of a vertex.
+  const float*
+  position (unsigned int vertex) const
+  {
+    return m_data + static_cast<std::size_t> (vertex) * m_floatsPerVertex;
+  }
+};
+
+/// \brief A candidate edge collapse, moving one vertex onto another.
+struct Collapse
+{
+  /// The quadric error of making this collapse.
+  double m_cost;
+  /// The vertex that goes away.
+  unsigned int m_from;
+  /// The vertex whose triangles take over.
+  unsigned int m_to;
+
+  /// \brief Orders collapses cheapest first, breaking ties by vertex.
+  bool
+  operator< (const Collapse& other) const
+  {
+    return std::tie (m_cost, m_from, m_to) < std::tie (other.m_cost, other.m_from, other.m_to);
+  }
+};
+
+/// \brief Sets up a mesh for simplification: groups vertices by position,
+///   locks borders and seams, and accumulates each vertex's quadric.
+static Simplification
+startSimplification (const std::vector<float>& data, unsigned int floatsPerVertex,
+    const std::vector<unsigned int>& indices)
+{
+  Simplification mesh;
+  const unsigned int vertexCount = data.size () / floatsPerVertex;
+  mesh.m_data = data.data ();
+  mesh.m_floatsPerVertex = floatsPerVertex;
+  mesh.m_indices = indices;
+  mesh.m_removed.assign (indices.size () / 3, false);
+  mesh.m_trianglesOf.resize (vertexCount);
+  mesh.m_locked.assign (vertexCount, false);
+  mesh.m_quadrics.assign (vertexCount, Quadric ());
+  mesh.m_liveTriangles = indices.size () / 3;
+
+  // A position shared by several vertices is a seam.
+  mesh.m_positionGroup.resize (vertexCount);
+  SpatialHash grid (data.data (), vertexCount, floatsPerVertex, 3, 2 * EPSILON);
+  for (unsigned int vertex = 0; vertex < vertexCount; vertex++)
   {
-    for(unsigned int vertexIndex = 0; vertexIndex < 3; vertexIndex++)
+    unsigned int group = vertex;
+    grid.forEachNear (mesh.position (vertex), EPSILON, [&] (unsigned int other)
     {
-      data.push_back (faces[faceIndex][vertexIndex].m_x);
-      data.push_back (faces[faceIndex][vertexIndex].m_y);
-      data.push_back (faces[faceIndex][vertexIndex].m_z);
-      data.push_back (faceNormals[faceIndex].m_x);
-      data.push_back (faceNormals[faceIndex].m_y);
-      data.push_back (faceNormals[faceIndex].m_z);
+      if (other < group && verticesMatch (mesh.position (vertex), mesh.position (other), 3))
+      {
+        group = mesh.m_positionGroup[other];
+      }
+    });
+    mesh.m_positionGroup[vertex] = group;
+    if (group != vertex)
+    {
+      mesh.m_locked[group] = true;
+      mesh.m_locked[vertex] = true;
     }
   }
-  return data;
+
+  // An edge between positions that is not used by exactly two triangles is a
+  //   border (or non-manifold), and so are the positions at its ends.
+  std::vector<std::uint64_t> edges;
+  for (unsigned int triangle = 0; triangle < mesh.m_removed.size (); triangle++)
+  {
+    const unsigned int* corners = &mesh.m_indices[triangle * 3];
+    Quadric plane = triangleQuadric (mesh.position (corners[0]), mesh.position (corners[1]),
+                                     mesh.position (corners[2]));
+    for (unsigned int corner = 0; corner < 3; corner++)
+    {
+      unsigned int vertex = corners[corner];
+      mesh.m_trianglesOf[vertex].push_back (triangle);
+      addQuadric (mesh.m_quadrics[vertex], plane);
+      std::uint64_t a = mesh.m_positionGroup[vertex];
+      std::uint64_t b = mesh.m_positionGroup[corners[(corner + 1) % 3]];
+      edges.push_back (std::min (a, b) << 32 | std::max (a, b));
+    }
+  }
+  std::sort (edges.begin (), edges.end ());
+  std::vector<bool> borderGroup (vertexCount, false);
+  for (std::size_t run = 0; run < edges.size (); )
+  {
+    std::size_t end = run;
+    while (end < edges.size () && edges[end] == edges[run])
+    {
+      end++;
+    }
+    if (end - run != 2)
+    {
+      borderGroup[edges[run] >> 32] = true;
+      borderGroup[edges[run] & 0xFFFFFFFFu] = true;
+    }
+    run = end;
+  }
+  for (unsigned int vertex = 0; vertex < vertexCount; vertex++)
+  {
+    if (borderGroup[mesh.m_positionGroup[vertex]])
+    {
+      mesh.m_locked[vertex] = true;
+    }
+  }
+  return mesh;
 }
 
-std::vector<float>
-dataWithVertexNormals (const std::vector<Triangle>& faces,
-          const std::vector<Vector3>& vertexNormals)
+/// \brief Tests whether a triangle uses a vertex.
+static bool
+triangleUses (const Simplification& mesh, unsigned int triangle, unsigned int vertex)
 {
-  assert (faces.size () * 3 == vertexNormals.size ());
-  std::vector<float> data;
-  for(unsigned int faceIndex = 0; faceIndex < faces.size (); faceIndex++)
+  const unsigned int* corners = &mesh.m_indices[triangle * 3];
+  return corners[0] == vertex || corners[1] == vertex || corners[2] == vertex;
+}
+
+/// \brief Gets the distinct vertices that share a live triangle with a vertex.
+static std::vector<unsigned int>
+neighborsOf (const Simplification& mesh, unsigned int vertex)
+{
+  std::vector<unsigned int> neighbors;
+  for (unsigned int triangle : mesh.m_trianglesOf[vertex])
   {
-    for(unsigned int vertexIndex = 0; vertexIndex < 3; vertexIndex++)
+    if (mesh.m_removed[triangle])
     {
-      data.push_back (faces[faceIndex][vertexIndex].m_x);
-      data.push_back (faces[faceIndex][vertexIndex].m_y);
-      data.push_back (faces[faceIndex][vertexIndex].m_z);
-      data.push_back (vertexNormals[faceIndex * 3 + vertexIndex].m_x);
-      data.push_back (vertexNormals[faceIndex * 3 + vertexIndex].m_y);
-      data.push_back (vertexNormals[faceIndex * 3 + vertexIndex].m_z);
+      continue;
+    }
+    for (unsigned int corner = 0; corner < 3; corner++)
+    {
+      unsigned int other = mesh.m_indices[triangle * 3 + corner];
+      if (other != vertex)
+      {
+        neighbors.push_back (other);
+      }
     }
   }
-  return data;
+  std::sort (neighbors.begin (), neighbors.end ());
+  neighbors.erase (std::unique (neighbors.begin (), neighbors.end ()), neighbors.end ());
+  return neighbors;
+}
+
+/// \brief Tests whether moving one vertex onto a neighbor keeps the mesh
+///   valid.
+/// \param[in] mesh The mesh being simplified.
+/// \param[in] from The vertex that would go away.
+/// \param[in] to The vertex that would take over its triangles.
+/// \return Whether the collapse keeps seams intact, leaves the mesh manifold,
+///   and does not turn any remaining triangle over.
+static bool
+canCollapse (const Simplification& mesh, unsigned int from, unsigned int to)
+{
+  if (mesh.m_locked[from])
+  {
+    return false;
+  }
+  // The vertices opposite the edge, in the triangles that will disappear.
+  std::vector<unsigned int> opposite;
+  const float* target = mesh.position (to);
+  for (unsigned int triangle : mesh.m_trianglesOf[from])
+  {
+    if (mesh.m_removed[triangle])
+    {
+      continue;
+    }
+    const unsigned int* corners = &mesh.m_indices[triangle * 3];
+    if (triangleUses (mesh, triangle, to))
+    {
+      for (unsigned int corner = 0; corner < 3; corner++)
+      {
+        if (corners[corner] != from && corners[corner] != to)
+        {
+          opposite.push_back (corners[corner]);
+        }
+      }
+      continue;
+    }
+    // Another copy of to's position here means this triangle is across a
+    //   seam from to, and must not take on to's attributes.
+    Vector3 before[3];
+    Vector3 after[3];
+    for (unsigned int corner = 0; corner < 3; corner++)
+    {
+      unsigned int vertex = corners[corner];
+      if (vertex != from && mesh.m_positionGroup[vertex] == mesh.m_positionGroup[to])
+      {
+        return false;
+      }
+      const float* point = mesh.position (vertex);
+      before[corner] = Vector3 (point[0], point[1], point[2]);
+      after[corner] = vertex == from ? Vector3 (target[0], target[1], target[2]) : before[corner];
+    }
+    Vector3 normalBefore = (before[1] - before[0]).cross (before[2] - before[0]);
+    Vector3 normalAfter = (after[1] - after[0]).cross (after[2] - after[0]);
+    if (normalBefore.dot (normalAfter) <= 0.0f)
+    {
+      return false;
+    }
+  }
+  if (opposite.empty ())
+  {
+    return false;
+  }
+  // The link condition: the only vertices both ends share are the ones
+  //   opposite the edge, or the collapse would pinch the surface.
+  std::sort (opposite.begin (), opposite.end ());
+  opposite.erase (std::unique (opposite.begin (), opposite.end ()), opposite.end ());
+  std::vector<unsigned int> fromNeighbors = neighborsOf (mesh, from);
+  std::vector<unsigned int> toNeighbors = neighborsOf (mesh, to);
+  std::vector<unsigned int> shared;
+  std::set_intersection (fromNeighbors.begin (), fromNeighbors.end (),
+                         toNeighbors.begin (), toNeighbors.end (), std::back_inserter (shared));
+  return shared == opposite;
+}
+
+/// \brief Moves one vertex onto a neighbor, removing the triangles between
+///   them.
+static void
+collapse (Simplification& mesh, unsigned int from, unsigned int to)
+{
+  addQuadric (mesh.m_quadrics[to], mesh.m_quadrics[from]);
+  for (unsigned int triangle : mesh.m_trianglesOf[from])
+  {
+    if (mesh.m_removed[triangle])
+    {
+      continue;
+    }
+    if (triangleUses (mesh, triangle, to))
+    {
+      mesh.m_removed[triangle] = true;
+      mesh.m_liveTriangles--;
+      continue;
+    }
+    for (unsigned int corner = 0; corner < 3; corner++)
+    {
+      if (mesh.m_indices[triangle * 3 + corner] == from)
+      {
+        mesh.m_indices[triangle * 3 + corner] = to;
+      }
+    }
+    mesh.m_trianglesOf[to].push_back (triangle);
+  }
+  mesh.m_trianglesOf[from].clear ();
+}
+
+/// \brief Collapses the cheapest edges until a mesh has few enough triangles
+///   or no more edges can be collapsed.
+/// \param[in,out] mesh The mesh being simplified.
+/// \param[in] targetTriangles The most triangles that should be left.
+/// \param[in,out] maxCost The largest cost of any collapse made so far.
+static void
+simplifyTo (Simplification& mesh, unsigned int targetTriangles, double& maxCost)
+{
+  std::vector<Collapse> candidates;
+  std::vector<bool> touched (mesh.m_trianglesOf.size ());
+  while (mesh.m_liveTriangles > targetTriangles)
+  {
+    candidates.clear ();
+    for (unsigned int triangle = 0; triangle < mesh.m_removed.size (); triangle++)
+    {
+      if (mesh.m_removed[triangle])
+      {
+        continue;
+      }
+      for (unsigned int corner = 0; corner < 3; corner++)
+      {
+        unsigned int from = mesh.m_indices[triangle * 3 + corner];
+        unsigned int to = mesh.m_indices[triangle * 3 + (corner + 1) % 3];
+        for (unsigned int direction = 0; direction < 2; direction++)
+        {
+          if (!mesh.m_locked[from] && from != to)
+          {
+            double cost = evaluateQuadric (mesh.m_quadrics[from], mesh.position (to))
+              + evaluateQuadric (mesh.m_quadrics[to], mesh.position (to));
+            candidates.push_back (Collapse { cost, from, to });
+          }
+          std::swap (from, to);
+        }
+      }
+    }
+    std::sort (candidates.begin (), candidates.end ());
+
+    // Each pass only removes a fraction of what is left, so that costs are
+    //   recomputed before the cheap collapses run out.
+    std::fill (touched.begin (), touched.end (), false);
+    const unsigned int passStart = mesh.m_liveTriangles;
+    const unsigned int passLimit = std::max (2u, passStart / 8);
+    for (const Collapse& candidate : candidates)
+    {
+      if (mesh.m_liveTriangles <= targetTriangles
+          || passStart - mesh.m_liveTriangles >= passLimit)
+      {
+        break;
+      }
+      if (touched[candidate.m_from] || touched[candidate.m_to]
+          || !canCollapse (mesh, candidate.m_from, candidate.m_to))
+      {
+        continue;
+      }
+      collapse (mesh, candidate.m_from, candidate.m_to);
+      touched[candidate.m_from] = true;
+      touched[candidate.m_to] = true;
+      maxCost = std::max (maxCost, candidate.m_cost);
+    }
+    if (mesh.m_liveTriangles == passStart)
+    {
+      return;
+    }
+  }
+}
+
+std::vector<LevelOfDetail>
+buildLevelsOfDetail (const std::vector<float>& data, unsigned int floatsPerVertex,
+    const std::vector<unsigned int>& indices, const std::vector<float>& triangleRatios)
+{
+  assert (floatsPerVertex >= 3);
+  assert (indices.size () % 3 == 0);
+  Simplification mesh = startSimplification (data, floatsPerVertex, indices);
+  const unsigned int triangleCount = indices.size () / 3;
+  double maxCost = 0.0;
+  std::vector<LevelOfDetail> levels;
+  for (float ratio : triangleRatios)
+  {
+    assert (ratio > 0.0f && ratio <= 1.0f);
+    simplifyTo (mesh, static_cast<unsigned int> (ratio * triangleCount), maxCost);
+    LevelOfDetail level;
+    level.m_indices.reserve (mesh.m_liveTriangles * 3);
+    for (unsigned int triangle = 0; triangle < triangleCount; triangle++)
+    {
+      if (!mesh.m_removed[triangle])
+      {
+        level.m_indices.insert (level.m_indices.end (), &mesh.m_indices[triangle * 3],
+                                &mesh.m_indices[triangle * 3] + 3);
+      }
+    }
+    level.m_error = static_cast<float> (std::sqrt (maxCost));
+    levels.push_back (std::move (level));
+  }
+  return levels;
+}
+
+BoundingBox
+computeBoundingBox (const std::vector<float>& data, unsigned int floatsPerVertex)
+{
+  assert (floatsPerVertex >= 3);
+  const std::size_t total = data.size () / floatsPerVertex * floatsPerVertex;
+  BoundingBox box = { Vector3 (0.0f, 0.0f, 0.0f), Vector3 (0.0f, 0.0f, 0.0f) };
+  if (total == 0)
+  {
+    return box;
+  }
+  const float INF = std::numeric_limits<float>::infinity ();
+  float low[3] = { INF, INF, INF };
+  float high[3] = { -INF, -INF, -INF };
+
+  // Each step covers a whole number of vertices in a whole number of
+  //   registers, so lane k of accumulator a always sees float
+  //   (a * WIDTH + k) % floatsPerVertex of some vertex.
+  const unsigned int WIDTH = FloatLanes::WIDTH;
+  unsigned int common = WIDTH;
+  for (unsigned int other = floatsPerVertex; other != 0; )
+  {
+    unsigned int remainder = common % other;
+    common = other;
+    other = remainder;
+  }
+  const unsigned int MAX_ACCUMULATORS = 16;
+  const unsigned int accumulators = floatsPerVertex / common;
+  std::size_t next = 0;
+  if (accumulators <= MAX_ACCUMULATORS)
+  {
+    FloatLanes lows[MAX_ACCUMULATORS];
+    FloatLanes highs[MAX_ACCUMULATORS];
+    for (unsigned int accumulator = 0; accumulator < accumulators; accumulator++)
+    {
+      lows[accumulator] = FloatLanes::broadcast (INF);
+      highs[accumulator] = FloatLanes::broadcast (-INF);
+    }
+    const std::size_t step = accumulators * WIDTH;
+    for (; next + step <= total; next += step)
+    {
+      for (unsigned int accumulator = 0; accumulator < accumulators; accumulator++)
+      {
+        FloatLanes values = FloatLanes::loadUnaligned (&data[next + accumulator * WIDTH]);
+        lows[accumulator] = min (lows[accumulator], values);
+        highs[accumulator] = max (highs[accumulator], values);
+      }
+    }
+    float lanes[2][FloatLanes::WIDTH];
+    for (unsigned int accumulator = 0; accumulator < accumulators; accumulator++)
+    {
+      lows[accumulator].storeUnaligned (lanes[0]);
+      highs[accumulator].storeUnaligned (lanes[1]);
+      for (unsigned int lane = 0; lane < WIDTH; lane++)
+      {
+        unsigned int part = (accumulator * WIDTH + lane) % floatsPerVertex;
+        if (part < 3)
+        {
+          low[part] = std::min (low[part], lanes[0][lane]);
+          high[part] = std::max (high[part], lanes[1][lane]);
+        }
+      }
+    }
+  }
+  for (; next < total; next += floatsPerVertex)
+  {
+    for (unsigned int part = 0; part < 3; part++)
+    {
+      low[part] = std::min (low[part], data[next + part]);
+      high[part] = std::max (high[part], data[next + part]);
+    }
+  }
+  box.m_min = Vector3 (low[0], low[1], low[2]);
+  box.m_max = Vector3 (high[0], high[1], high[2]);
+  return box;
+}
+
+BoundingSphere
+computeBoundingSphere (const std::vector<float>& data, unsigned int floatsPerVertex,
+                       const BoundingBox& box)
+{
+  BoundingSphere sphere = { (box.m_min + box.m_max) / 2.0f, 0.0f };
+  float farthest = 0.0f;
+  for (std::size_t vertex = 0; vertex + floatsPerVertex <= data.size (); vertex += floatsPerVertex)
+  {
+    float dx = data[vertex] - sphere.m_center.m_x;
+    float dy = data[vertex + 1] - sphere.m_center.m_y;
+    float dz = data[vertex + 2] - sphere.m_center.m_z;
+    farthest = std::max (farthest, dx * dx + dy * dy + dz * dz);
+  }
+  sphere.m_radius = std::sqrt (farthest);
+  return sphere;
 }
 
 std::vector<Triangle>
@@ -3,14 +3,22 @@
 /// \author Chad Hogg
 /// \version A08
 
+#ifndef GEOMETRY_HPP
+#define GEOMETRY_HPP
+
 #include <vector>
 #include <array>
+#include <cstddef>
+#include <cstdint>
 
 #include "Vector3.hpp"
 
 // A triangle consists of exactly 3 Vector3s (the coordinates of the vertices).
 using Triangle = std::array<Vector3, 3>;
 
+/// How many faces the parallel color generators hand to a thread at a time.
+const unsigned int DEFAULT_FACES_PER_CHUNK = 4096;
+
 /// \brief Indexes some geometry.
 /// \param[in] geometry A collection containing floats defining some vertices.
 /// \param[in] floatsPerVertex The number of floats used for each vertex.
@@ -21,10 +29,103 @@ using Triangle = std::array<Vector3, 3>;
 /// \post indices contains the correct indices for each vertex to build
 ///   triangles.
 /// This uses the two out parameters simply because we can't return two tihngs.
+/// Two vertices are the same if every one of their floats is within 0.00001f.
+///   When several vertices in data match, the earliest one is used.  Vertices
+///   are bucketed by position, so this takes expected linear time.
 void
 indexData (const std::vector<float>& geometry, unsigned int floatsPerVertex,
 	   std::vector<float>& data, std::vector<unsigned int>& indices);
 
+/// \brief Indexes some geometry using several threads.
+/// \param[in] geometry A collection containing floats defining some vertices.
+/// \param[in] floatsPerVertex The number of floats used for each vertex.
+/// \param[out] data A collection into which unique vertex data can be written.
+/// \param[out] indices A collection into which vector indexes for each
+///   triangle can be written.
+/// \param[in] threadCount The number of threads to use, where 0 means one per
+///   hardware thread.
+/// \post data and indices are exactly what the single-threaded indexData
+///   would have produced, no matter how many threads were used.
+void
+indexData (const std::vector<float>& geometry, unsigned int floatsPerVertex,
+	   std::vector<float>& data, std::vector<unsigned int>& indices,
+	   unsigned int threadCount);
+
+/// \brief Indexes some geometry without copying it anywhere else.
+/// \param[in,out] geometry A pointer to floats defining some vertices.  The
+///   unique vertices are moved to the front.
+/// \param[in] vertexCount The number of vertices (3 per triangle).
+/// \param[in] floatsPerVertex The number of floats used for each vertex.
+/// \param[out] indices A collection into which vector indexes for each
+///   triangle can be written.
+/// \return The number of unique vertices.
+/// \post The first (return value) vertices of geometry, and the indices, are
+///   exactly the data and indices that indexData would have produced.  The
+///   rest of geometry is left in an unspecified state.
+unsigned int
+indexDataInPlace (float* geometry, unsigned int vertexCount,
+		  unsigned int floatsPerVertex, std::vector<unsigned int>& indices);
+
+/// \brief What the three floats after each vertex's position are.
+enum class VertexAttribute
+{
+  /// Nothing the welder needs to treat specially; compared like indexData.
+  NONE,
+  /// A red, green, blue color.
+  COLOR,
+  /// A normal vector.
+  NORMAL
+};
+
+/// \brief How different two vertices may be and still be welded together.
+struct WeldTolerances
+{
+  /// The farthest apart two positions may be.
+  float m_positionDistance;
+  /// The largest angle between two normals, in degrees.
+  float m_normalAngleDegrees;
+  /// The farthest apart two colors may be, in RGB space.
+  float m_colorDistance;
+};
+
+/// Tolerances that weld away splits too small to see: a hundred times
+///   indexData's epsilon, one degree, and half of an 8-bit color step.
+const WeldTolerances DEFAULT_WELD_TOLERANCES = { 0.001f, 1.0f, 0.5f / 255.0f };
+
+/// \brief What weldVertices changed.
+struct WeldStatistics
+{
+  /// The number of vertices merged into others or left unused.
+  unsigned int m_verticesRemoved;
+  /// The number of triangles that collapsed to a line or point and were
+  ///   dropped.
+  unsigned int m_trianglesRemoved;
+};
+
+/// \brief Merges vertices of an indexed mesh that are close enough to look
+///   the same, with a separate tolerance for each kind of data.
+/// \param[in,out] data Interleaved vertex data: a position, then (for COLOR
+///   and NORMAL) the attribute, then any other floats.  Merged vertices are
+///   removed, and those kept stay in their original order.
+/// \param[in] floatsPerVertex The number of floats used for each vertex.
+/// \param[in,out] indices Three vertex indices per triangle, rewritten to use
+///   the kept vertices.  Triangles left with a repeated vertex are removed.
+/// \param[in] attribute What follows each position.
+/// \param[in] tolerances How far apart positions, normal directions, and
+///   colors may be.  Floats that are not part of the position or attribute
+///   must match within indexData's epsilon.
+/// \pre floatsPerVertex is at least 3, or at least 6 with COLOR or NORMAL,
+///   and every index is less than data.size () / floatsPerVertex.
+/// \return How many vertices and triangles were removed.
+/// Each vertex is merged into the earliest kept vertex it matches, and takes
+///   that vertex's values, so welding never drifts along a chain of vertices
+///   that are each just within tolerance of the next.  Normals are compared
+///   by angle, so a crease sharper than the tolerance keeps its split.
+WeldStatistics
+weldVertices (std::vector<float>& data, unsigned int floatsPerVertex,
+	      std::vector<unsigned int>& indices, VertexAttribute attribute,
+	      const WeldTolerances& tolerances = DEFAULT_WELD_TOLERANCES);
+
 /// \brief Computes a normal vector for each face of a mesh.
 /// \param[in] faces A collection of faces that are part of the mesh.
 /// \return A collection containing one normal vector per face.
@@ -43,23 +144,114 @@ computeFaceNormals (const std::vector<Triangle>& faces);
 ///   there are (presumably) several faces meeting at the same vertex, and we
 ///   are outputting a normal for each of the three vertices of each face.
 ///   During indexing these will all be collapsed.
+/// Corners are grouped by position through a hash grid, so this takes expected
+///   linear time in the number of faces.
 std::vector<Vector3>
 computeVertexNormals (const std::vector<Triangle>& faces,
 		      const std::vector<Vector3>& faceNormals);
 
 /// \brief Assigns a random color to each face of a mesh.
 /// \param[in] faces A collection of faces that are part of the mesh.
-/// \return A collection containing one color (R,G,B) per face.
+/// \return A collection containing one color (R,G,B) per face, exactly as
+///   generateRandomFaceColors (faces, 0, 1) would return.
 std::vector<Vector3>
 generateRandomFaceColors (const std::vector<Triangle>& faces);
 
+/// \brief Assigns a random color to each face of a mesh using several
+///   threads.
+/// \param[in] faces A collection of faces that are part of the mesh.
+/// \param[in] seed The seed that determines which colors are chosen.
+/// \param[in] threadCount The number of threads to use, where 0 means one per
+///   hardware thread.
+/// \param[in] facesPerChunk How many faces each thread handles at a time.
+/// \pre facesPerChunk is at least 1.
+/// \return A collection containing one color (R,G,B) per face.
+/// Each color is a hash of the seed and the face's index (SplitMix64), not the
+///   next draw from a sequential engine, so the colors are the same for any
+///   thread count and chunk size.
+std::vector<Vector3>
+generateRandomFaceColors (const std::vector<Triangle>& faces, unsigned int seed,
+			  unsigned int threadCount,
+			  unsigned int facesPerChunk = DEFAULT_FACES_PER_CHUNK);
+
 /// \brief Assigns a random color to each vertex of a mesh.
-/// \param[in] A collection of faces that are part of the mesh.
+/// \param[in] faces A collection of faces that are part of the mesh.
+/// \param[in] seed The seed that determines which colors are chosen.
 /// \return A collection containing three colors per face.  When the same
 ///   vertex is shared by multiple faces, each copy of the vertex will be
 ///   assigned the same random color.
+/// The n-th distinct position in faces always gets the same color for a given
+///   seed, so generating colors for the first k faces on their own gives
+///   exactly the first 3k colors of the whole mesh.  Positions are grouped
+///   through a hash grid, so this takes expected linear time.
+std::vector<Vector3>
+generateRandomVertexColors (const std::vector<Triangle>& faces, unsigned int seed);
+
+/// \brief Assigns a random color to each vertex of a mesh using several
+///   threads.
+/// \param[in] faces A collection of faces that are part of the mesh.
+/// \param[in] seed The seed that determines which colors are chosen.
+/// \param[in] threadCount The number of threads to use, where 0 means one per
+///   hardware thread.
+/// \param[in] facesPerChunk How many faces each thread handles at a time.
+/// \pre facesPerChunk is at least 1.
+/// \return Exactly what generateRandomVertexColors (faces, seed) returns, for
+///   any thread count and chunk size.
+/// Each chunk counts its new positions, and a running sum of those counts
+///   tells every chunk where its part of the color sequence starts.
 std::vector<Vector3>
-generateRandomVertexColors (const std::vector<Triangle>& faces);
+generateRandomVertexColors (const std::vector<Triangle>& faces, unsigned int seed,
+			    unsigned int threadCount,
+			    unsigned int facesPerChunk = DEFAULT_FACES_PER_CHUNK);
+
+/// \brief Gets how many floats the interleaved writers produce for some
+///   faces.
+/// \param[in] faces A collection of faces that are part of the mesh.
+/// \return Six floats for each of the three vertices of each face.
+std::size_t
+interleavedFloatCount (const std::vector<Triangle>& faces);
+
+/// \brief Writes interleaved position / color data from faces and face
+///   colors straight into a presized buffer.
+/// \param[in] faces A collection of faces that are part of the mesh.
+/// \param[in] faceColors A collection of colors, one per face.
+/// \param[out] destination Room for interleavedFloatCount (faces) floats, for
+///   example from Mesh::stageGeometry.
+/// \return A pointer just past the last float written, so that several
+///   writes can be packed one after another.
+float*
+writeFaceColors (const std::vector<Triangle>& faces,
+		 const std::vector<Vector3>& faceColors, float* destination);
+
+/// \brief Writes interleaved position / color data from faces and vertex
+///   colors straight into a presized buffer.
+/// \param[in] faces A collection of faces that are part of the mesh.
+/// \param[in] vertexColors A collection of colors, three per face.
+/// \param[out] destination Room for interleavedFloatCount (faces) floats.
+/// \return A pointer just past the last float written.
+float*
+writeVertexColors (const std::vector<Triangle>& faces,
+		   const std::vector<Vector3>& vertexColors, float* destination);
+
+/// \brief Writes interleaved position / normal data from faces and face
+///   normals straight into a presized buffer.
+/// \param[in] faces A collection of faces that are part of the mesh.
+/// \param[in] faceNormals A collection of normals, one per face.
+/// \param[out] destination Room for interleavedFloatCount (faces) floats.
+/// \return A pointer just past the last float written.
+float*
+writeFaceNormals (const std::vector<Triangle>& faces,
+		  const std::vector<Vector3>& faceNormals, float* destination);
+
+/// \brief Writes interleaved position / normal data from faces and vertex
+///   normals straight into a presized buffer.
+/// \param[in] faces A collection of faces that are part of the mesh.
+/// \param[in] vertexNormals A collection of normals, three per face.
+/// \param[out] destination Room for interleavedFloatCount (faces) floats.
+/// \return A pointer just past the last float written.
+float*
+writeVertexNormals (const std::vector<Triangle>& faces,
+		    const std::vector<Vector3>& vertexNormals, float* destination);
 
 /// \brief Produces a collection of interleaved position / color data from
 ///   faces and face colors.
@@ -101,7 +293,243 @@ std::vector<float>
 dataWithVertexNormals (const std::vector<Triangle>& faces,
 		       const std::vector<Vector3>& vertexNormals);
 
+/// \brief How the position of each vertex is stored in a vertex buffer.
+enum class PositionFormat
+{
+  /// Three 32-bit floats (12 bytes).
+  FLOAT32,
+  /// Three 16-bit half floats (6 bytes), relative to a PositionQuantization.
+  HALF_FLOAT,
+  /// Three 16-bit signed normalized integers (6 bytes), relative to a
+  ///   PositionQuantization.
+  SNORM16
+};
+
+/// \brief How the color or normal of each vertex is stored in a vertex
+///   buffer.
+enum class AttributeFormat
+{
+  /// Three 32-bit floats (12 bytes), for colors or normals.
+  FLOAT32,
+  /// A normal folded onto an octahedron, as two 16-bit signed normalized
+  ///   integers (4 bytes).
+  OCTAHEDRAL_SNORM16,
+  /// A normal folded onto an octahedron, as two 8-bit signed normalized
+  ///   integers (2 bytes).
+  OCTAHEDRAL_SNORM8,
+  /// A color as three 8-bit unsigned normalized integers (3 bytes).
+  UNORM8
+};
+
+/// \brief The storage format of an interleaved position / attribute vertex.
+struct VertexFormat
+{
+  /// How positions are stored.
+  PositionFormat m_position;
+  /// How the color or normal is stored.
+  AttributeFormat m_attribute;
+};
+
+/// \brief The per-mesh transform that turns quantized positions back into
+///   model coordinates: position = stored * m_scale + m_offset.
+struct PositionQuantization
+{
+  /// The center of the mesh's bounding box.
+  Vector3 m_offset;
+  /// Half the longest side of the mesh's bounding box (1 if it is empty).
+  float m_scale;
+};
+
+/// \brief Gets how far into each packed vertex its attribute starts.
+/// \param[in] format The vertex format.
+/// \return The byte offset, which is aligned for the attribute's components.
+unsigned int
+packedAttributeOffset (const VertexFormat& format);
+
+/// \brief Gets the size of each packed vertex.
+/// \param[in] format The vertex format.
+/// \return The number of bytes from one vertex to the next, a multiple of 4.
+///   This is 24 for two FLOAT32s and as little as 8 for HALF_FLOAT positions
+///   with OCTAHEDRAL_SNORM8 normals.
+unsigned int
+packedVertexStride (const VertexFormat& format);
+
+/// \brief Finds the quantization that fits a mesh's positions into [-1, 1].
+/// \param[in] data Interleaved vertex data whose first three floats per
+///   vertex are a position.
+/// \param[in] floatsPerVertex The number of floats used for each vertex.
+/// \return A uniform scale and an offset, so that normals are unaffected.
+PositionQuantization
+computePositionQuantization (const std::vector<float>& data, unsigned int floatsPerVertex);
+
+/// \brief Packs interleaved position / attribute data into a smaller format.
+/// \param[in] data Six floats per vertex: a position then a color or normal.
+/// \param[in] format The format to pack into.  Octahedral formats expect unit
+///   normals, and UNORM8 expects colors in [0, 1].
+/// \param[in] quantization How positions are mapped into [-1, 1] for the
+///   HALF_FLOAT and SNORM16 formats (ignored for FLOAT32).
+/// \return packedVertexStride (format) bytes per vertex, with padding zeroed.
+std::vector<unsigned char>
+encodeVertices (const std::vector<float>& data, const VertexFormat& format,
+		const PositionQuantization& quantization);
+
+/// \brief Converts a float to the nearest 16-bit half float.
+/// \param[in] value Any float.  Values too large for a half become infinite.
+/// \return The bits of the half float.
+std::uint16_t
+encodeHalf (float value);
+
+/// \brief Converts a 16-bit half float to a float, exactly.
+float
+decodeHalf (std::uint16_t bits);
+
+/// \brief Converts a value in [-1, 1] to a signed normalized integer with a
+///   given number of bits, the way OpenGL decodes them.
+/// \param[in] value The value, which is clamped to [-1, 1].
+/// \param[in] bits 8 or 16.
+/// \return The nearest integer in [-(2^(bits-1) - 1), 2^(bits-1) - 1].
+int
+encodeSnorm (float value, unsigned int bits);
+
+/// \brief Converts a value in [0, 1] to an 8-bit unsigned normalized integer.
+/// \param[in] value The value, which is clamped to [0, 1].
+/// \return The nearest integer in [0, 255].
+std::uint8_t
+encodeUnorm8 (float value);
+
+/// \brief Folds a unit vector onto an octahedron and flattens it.
+/// \param[in] normal A vector, which need not be unit length but must not
+///   be zero.
+/// \return Two coordinates in [-1, 1].
+std::array<float, 2>
+encodeOctahedral (const Vector3& normal);
+
+/// \brief Unfolds octahedral coordinates back to a unit vector, the same way
+///   Vec3Norm.vert does.
+/// \param[in] x The first coordinate, in [-1, 1].
+/// \param[in] y The second coordinate, in [-1, 1].
+/// \return A unit vector.
+Vector3
+decodeOctahedral (float x, float y);
+
+/// \brief Vertex data and indices compressed without loss, for keeping a
+///   copy of a mesh on the CPU in less memory.
+struct CompressedGeometry
+{
+  /// The number of floats per vertex.
+  unsigned int m_floatsPerVertex;
+  /// The number of floats.
+  std::size_t m_floatCount;
+  /// The number of indices.
+  std::size_t m_indexCount;
+  /// Each float's bits XORed with the same float of the vertex before,
+  ///   stored as only its low nonzero bytes.  Each pair of floats is preceded
+  ///   by a byte holding their byte counts.
+  std::vector<unsigned char> m_vertexBytes;
+  /// Each index's difference from the one before, zigzag and varint encoded.
+  std::vector<unsigned char> m_indexBytes;
+};
+
+/// \brief Compresses vertex data and indices without loss.
+/// \param[in] data Interleaved vertex data.
+/// \param[in] floatsPerVertex The number of floats per vertex.
+/// \param[in] indices Any indices, including STRIP_RESTART_INDEX.
+/// \return The compressed geometry.
+/// Neighboring vertices of a mesh share most of their high bits, and
+///   neighboring indices are close, so both usually shrink to well under
+///   half their size.  Repeated colors and normals take no bytes at all.
+CompressedGeometry
+compressGeometry (const std::vector<float>& data, unsigned int floatsPerVertex,
+                  const std::vector<unsigned int>& indices);
+
+/// \brief Undoes compressGeometry.
+/// \param[in] compressed The compressed geometry.
+/// \param[out] data Replaced by the original vertex data, bit for bit.
+/// \param[out] indices Replaced by the original indices.
+void
+decompressGeometry (const CompressedGeometry& compressed, std::vector<float>& data,
+                    std::vector<unsigned int>& indices);
+
+/// \brief One simplified version of an indexed mesh, which is drawn with the
+///   same vertex data as the original.
+struct LevelOfDetail
+{
+  /// Three vertex indices per triangle.
+  std::vector<unsigned int> m_indices;
+  /// An estimate, in the mesh's own units, of how far this level's surface
+  ///   strays from the original: the square root of the largest quadric error
+  ///   of any edge collapse made to reach it.  0 for an exact copy.
+  float m_error;
+};
+
+/// \brief Simplifies an indexed mesh to several triangle budgets by quadric
+///   error edge collapse.
+/// \param[in] data Interleaved vertex data, as made by indexData.  The first
+///   three floats of each vertex are its position.
+/// \param[in] floatsPerVertex The number of floats used for each vertex (at
+///   least 3).
+/// \param[in] indices Three vertex indices per triangle.
+/// \param[in] triangleRatios The fraction of the original triangles each
+///   level should keep, each in (0, 1] and in non-increasing order.
+/// \return One level per ratio, each with at most ratio times the original
+///   number of triangles unless that could not be reached, and each no finer
+///   than the one before.
+/// Vertices are only ever collapsed onto a neighboring vertex, never moved, so
+///   every level reuses data unchanged.  Vertices on a border, and vertices
+///   that share their position with another vertex because the normals or
+///   colors differ there (a seam), are never removed, so borders and seams
+///   keep their exact shape and attributes are never mixed across a seam.
+///   Collapses that would flip a triangle or make the mesh non-manifold are
+///   skipped.
+std::vector<LevelOfDetail>
+buildLevelsOfDetail (const std::vector<float>& data, unsigned int floatsPerVertex,
+		     const std::vector<unsigned int>& indices,
+		     const std::vector<float>& triangleRatios);
+
+/// \brief An axis-aligned box.
+struct BoundingBox
+{
+  /// The corner with the smallest coordinates.
+  Vector3 m_min;
+  /// The corner with the largest coordinates.
+  Vector3 m_max;
+};
+
+/// \brief A sphere that holds something.
+struct BoundingSphere
+{
+  /// The center.
+  Vector3 m_center;
+  /// The radius.
+  float m_radius;
+};
+
+/// \brief Finds the smallest axis-aligned box that holds the positions in
+///   some interleaved vertex data.
+/// \param[in] data Interleaved vertex data whose first three floats per
+///   vertex are a position.
+/// \param[in] floatsPerVertex The number of floats used for each vertex.
+/// \pre floatsPerVertex is at least 3.
+/// \return The box, which is all zeros if there are no vertices.
+/// This compares whole SIMD registers of the data at a time, without
+///   separating positions from the other floats first.
+BoundingBox
+computeBoundingBox (const std::vector<float>& data, unsigned int floatsPerVertex);
+
+/// \brief Finds a sphere that holds the positions in some interleaved vertex
+///   data, centered on their bounding box.
+/// \param[in] data Interleaved vertex data whose first three floats per
+///   vertex are a position.
+/// \param[in] floatsPerVertex The number of floats used for each vertex.
+/// \param[in] box The bounding box of the data, from computeBoundingBox.
+/// \return The sphere, whose radius reaches exactly the farthest vertex.
+BoundingSphere
+computeBoundingSphere (const std::vector<float>& data, unsigned int floatsPerVertex,
+                       const BoundingBox& box);
+
 /// \brief Creates a collection of triangles in a unit cube.
 /// \return A collection of triangles in a unit cube, centered on the origin.
 std::vector<Triangle>
 buildCube ();
+
+#endif//GEOMETRY_HPP
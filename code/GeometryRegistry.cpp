@@ -0,0 +1,172 @@
+/// \file GeometryRegistry.cpp
+/// \brief Implementation of GeometryRegistry, which lets meshes with
+///   identical vertex and index data share one VBO and IBO.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// System includes
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+/******************************************************************/
+// Local includes
+#include "GeometryRegistry.hpp"
+
+/******************************************************************/
+/// \brief Scrambles a 64-bit value so every input bit affects every output
+///   bit (the SplitMix64 finalizer).
+static std::uint64_t
+mix (std::uint64_t value)
+{
+  value ^= value >> 30;
+  value *= 0xbf58476d1ce4e5b9ull;
+  value ^= value >> 27;
+  value *= 0x94d049bb133111ebull;
+  return value ^ (value >> 31);
+}
+
+/// \brief Folds some bytes into a running hash, eight at a time.
+/// \param[in] bytes The bytes.
+/// \param[in] count The number of bytes.
+/// \param[in] hash The hash so far.
+/// \param[in] multiplier An odd constant that differs between the two halves
+///   of a key, so they are independent.
+/// \return The new hash.
+static std::uint64_t
+hashBytes (const void* bytes, std::size_t count, std::uint64_t hash, std::uint64_t multiplier)
+{
+  const unsigned char* next = static_cast<const unsigned char*> (bytes);
+  for (; count >= 8; count -= 8, next += 8)
+  {
+    std::uint64_t word;
+    std::memcpy (&word, next, 8);
+    hash = (hash ^ mix (word + multiplier)) * multiplier;
+    hash = (hash << 29) | (hash >> 35);
+  }
+  std::uint64_t tail = count;
+  std::memcpy (&tail, next, count);
+  return mix ((hash ^ mix (tail + multiplier)) * multiplier);
+}
+
+/******************************************************************/
+bool
+GeometryRegistry::Key::operator== (const Key& other) const
+{
+  return m_hash[0] == other.m_hash[0] && m_hash[1] == other.m_hash[1]
+    && m_vertexBytes == other.m_vertexBytes && m_indexBytes == other.m_indexBytes
+    && m_layout.m_format.m_position == other.m_layout.m_format.m_position
+    && m_layout.m_format.m_attribute == other.m_layout.m_format.m_attribute
+    && m_layout.m_floatsPerVertex == other.m_layout.m_floatsPerVertex
+    && m_layout.m_indexType == other.m_layout.m_indexType;
+}
+
+std::size_t
+GeometryRegistry::KeyHash::operator() (const Key& key) const
+{
+  return static_cast<std::size_t> (key.m_hash[0]);
+}
+
+GeometryRegistry::GeometryRegistry (OpenGLContext* context)
+  : m_context (context),
+    m_entries (),
+    m_keysByVbo (),
+    m_uploadedBytes (0),
+    m_savedBytes (0)
+{
+}
+
+GeometryRegistry::~GeometryRegistry ()
+{
+  for (const auto& entry : m_entries)
+  {
+    m_context->deleteBuffers (1, &entry.second.m_geometry.m_vbo);
+    m_context->deleteBuffers (1, &entry.second.m_geometry.m_ibo);
+  }
+}
+
+SharedGeometry
+GeometryRegistry::acquire (const void* vertices, std::size_t vertexBytes, const void* indices,
+                           std::size_t indexBytes, const GeometryLayout& layout)
+{
+  const std::uint64_t MULTIPLIERS[2] = { 0x9e3779b97f4a7c15ull, 0xc2b2ae3d27d4eb4full };
+  const std::uint32_t shape[6] = {
+    static_cast<std::uint32_t> (layout.m_format.m_position),
+    static_cast<std::uint32_t> (layout.m_format.m_attribute),
+    layout.m_floatsPerVertex, static_cast<std::uint32_t> (layout.m_indexType),
+    static_cast<std::uint32_t> (vertexBytes), static_cast<std::uint32_t> (indexBytes) };
+  Key key = { { 0, 0 }, vertexBytes, indexBytes, layout };
+  for (unsigned int half = 0; half < 2; half++)
+  {
+    std::uint64_t hash = hashBytes (shape, sizeof (shape), MULTIPLIERS[half], MULTIPLIERS[half]);
+    hash = hashBytes (vertices, vertexBytes, hash, MULTIPLIERS[half]);
+    key.m_hash[half] = hashBytes (indices, indexBytes, hash, MULTIPLIERS[half]);
+  }
+
+  const unsigned char* vertexBegin = static_cast<const unsigned char*> (vertices);
+  const unsigned char* indexBegin = static_cast<const unsigned char*> (indices);
+  auto candidates = m_entries.equal_range (key);
+  for (auto found = candidates.first; found != candidates.second; ++found)
+  {
+    // Equal keys have equal sizes, so only the bytes are left to compare.
+    if (std::memcmp (found->second.m_vertices.data (), vertexBegin, vertexBytes) == 0
+        && std::memcmp (found->second.m_indices.data (), indexBegin, indexBytes) == 0)
+    {
+      found->second.m_users++;
+      m_savedBytes += vertexBytes + indexBytes;
+      return found->second.m_geometry;
+    }
+  }
+
+  Entry entry = { { 0, 0 }, std::vector<unsigned char> (vertexBegin, vertexBegin + vertexBytes),
+                  std::vector<unsigned char> (indexBegin, indexBegin + indexBytes), 1 };
+  m_context->genBuffers (1, &entry.m_geometry.m_vbo);
+  m_context->genBuffers (1, &entry.m_geometry.m_ibo);
+  m_context->bindBuffer (GL_ARRAY_BUFFER, entry.m_geometry.m_vbo);
+  m_context->bufferData (GL_ARRAY_BUFFER, vertexBytes, vertices, GL_STATIC_DRAW);
+  m_context->bindBuffer (GL_ELEMENT_ARRAY_BUFFER, entry.m_geometry.m_ibo);
+  m_context->bufferData (GL_ELEMENT_ARRAY_BUFFER, indexBytes, indices, GL_STATIC_DRAW);
+  SharedGeometry geometry = entry.m_geometry;
+  m_uploadedBytes += vertexBytes + indexBytes;
+  m_entries.emplace (key, std::move (entry));
+  m_keysByVbo.emplace (geometry.m_vbo, key);
+  return geometry;
+}
+
+void
+GeometryRegistry::release (const SharedGeometry& geometry)
+{
+  auto keyed = m_keysByVbo.find (geometry.m_vbo);
+  assert (keyed != m_keysByVbo.end ());
+  auto found = m_entries.equal_range (keyed->second).first;
+  while (found->second.m_geometry.m_vbo != geometry.m_vbo)
+  {
+    ++found;
+  }
+  if (--found->second.m_users == 0)
+  {
+    m_context->deleteBuffers (1, &found->second.m_geometry.m_vbo);
+    m_context->deleteBuffers (1, &found->second.m_geometry.m_ibo);
+    m_uploadedBytes -= found->second.m_vertices.size () + found->second.m_indices.size ();
+    m_entries.erase (found);
+    m_keysByVbo.erase (keyed);
+  }
+}
+
+std::size_t
+GeometryRegistry::getBufferPairCount () const
+{
+  return m_entries.size ();
+}
+
+std::size_t
+GeometryRegistry::getUploadedBytes () const
+{
+  return m_uploadedBytes;
+}
+
+std::size_t
+GeometryRegistry::getSavedBytes () const
+{
+  return m_savedBytes;
+}
@@ -0,0 +1,147 @@
+/// \file GeometryRegistry.hpp
+/// \brief Declaration of GeometryRegistry, which lets meshes with identical
+///   vertex and index data share one VBO and IBO.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// Macro guard
+#ifndef GEOMETRYREGISTRY_HPP
+#define GEOMETRYREGISTRY_HPP
+
+/******************************************************************/
+// System includes
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+/******************************************************************/
+// Local includes
+#include "Geometry.hpp"
+#include "OpenGLContext.hpp"
+
+/******************************************************************/
+/// \brief How the bytes of some geometry are to be read, which is part of
+///   what must match for two meshes to share it.
+struct GeometryLayout
+{
+  /// How each vertex is stored.
+  VertexFormat m_format;
+  /// The number of floats per vertex before any packing.
+  unsigned int m_floatsPerVertex;
+  /// The type of each index.
+  GLenum m_indexType;
+};
+
+/// \brief A VBO and IBO, filled once and shared by every mesh with the same
+///   geometry.
+struct SharedGeometry
+{
+  /// The vertex buffer.
+  GLuint m_vbo;
+  /// The index buffer.
+  GLuint m_ibo;
+};
+
+/// \brief A collection of GPU geometry keyed by its contents, so each unique
+///   vertex and index buffer pair is only allocated and uploaded once.
+class GeometryRegistry
+{
+public:
+  /// \brief Constructs an empty GeometryRegistry.
+  /// \param[in] context The context buffers are made and filled through.
+  GeometryRegistry (OpenGLContext* context);
+
+  /// \brief Destructs a GeometryRegistry, deleting any buffers it still has.
+  ~GeometryRegistry ();
+
+  /// \brief Copy constructor removed because buffers cannot be copied.
+  GeometryRegistry (const GeometryRegistry&) = delete;
+
+  /// \brief Assignment operator removed because buffers cannot be copied.
+  GeometryRegistry&
+  operator= (const GeometryRegistry&) = delete;
+
+  /// \brief Gets buffers that hold some geometry, filling new ones only if
+  ///   no geometry with the same bytes and layout is already held.
+  /// \param[in] vertices The bytes to put in the VBO.
+  /// \param[in] vertexBytes The number of vertex bytes.
+  /// \param[in] indices The bytes to put in the IBO.
+  /// \param[in] indexBytes The number of index bytes.
+  /// \param[in] layout How the bytes are read.
+  /// \pre A vertex array is bound, since filling the IBO binds it there.
+  /// \return The shared buffers, which must be handed back to release once
+  ///   the caller is done with them.
+  /// Geometry is looked up by a 128-bit hash of its bytes, then its sizes
+  ///   and layout are compared, and last its bytes, against the copy the
+  ///   registry keeps of each geometry it holds.  A hash collision therefore
+  ///   only costs an upload, and never shares the wrong geometry.
+  SharedGeometry
+  acquire (const void* vertices, std::size_t vertexBytes, const void* indices,
+           std::size_t indexBytes, const GeometryLayout& layout);
+
+  /// \brief Hands back buffers from acquire.
+  /// \param[in] geometry The buffers.
+  /// \post Once every acquire of them has been released, they are deleted.
+  void
+  release (const SharedGeometry& geometry);
+
+  /// \brief Gets the number of buffer pairs currently held.
+  std::size_t
+  getBufferPairCount () const;
+
+  /// \brief Gets the number of bytes currently held in buffers.  The
+  ///   registry keeps as many again on the CPU, to compare against.
+  std::size_t
+  getUploadedBytes () const;
+
+  /// \brief Gets the number of bytes that were not uploaded because the
+  ///   geometry was already held.
+  std::size_t
+  getSavedBytes () const;
+
+private:
+  /// \brief What identifies some geometry, short of its bytes: a hash of
+  ///   them, with sizes and layout mixed in, and the sizes and layout.
+  struct Key
+  {
+    std::uint64_t m_hash[2];
+    std::size_t m_vertexBytes;
+    std::size_t m_indexBytes;
+    GeometryLayout m_layout;
+
+    bool
+    operator== (const Key& other) const;
+  };
+
+  /// \brief Hashes a Key for std::unordered_map.
+  struct KeyHash
+  {
+    std::size_t
+    operator() (const Key& key) const;
+  };
+
+  /// \brief One buffer pair, a copy of what is in it, and how many meshes
+  ///   are using it.
+  struct Entry
+  {
+    SharedGeometry m_geometry;
+    std::vector<unsigned char> m_vertices;
+    std::vector<unsigned char> m_indices;
+    unsigned int m_users;
+  };
+
+  /// The context buffers are made through.
+  OpenGLContext* m_context;
+  /// Every buffer pair held.  Geometry whose keys collide is kept apart.
+  std::unordered_multimap<Key, Entry, KeyHash> m_entries;
+  /// Which key each held VBO was filed under.
+  std::map<GLuint, Key> m_keysByVbo;
+  /// The bytes held in buffers.
+  std::size_t m_uploadedBytes;
+  /// The bytes that sharing has avoided uploading.
+  std::size_t m_savedBytes;
+};
+
+#endif//GEOMETRYREGISTRY_HPP
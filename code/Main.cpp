@@ -152,6 +152,8 @@ recordKeys(GLFWwindow* window, int key, int scanCode, int action,
 /// \param[in] button The button that was pressed or released
 /// \param[in] action What happened to the button
 /// \param[in] modifiers Which modifier buttons were pressed.
+/// Clicking the left button while holding control makes the mesh under the
+///   cursor active.
 void
 recordMouse(GLFWwindow* window, int button, int action, int modifiers);
 
@@ -376,7 +378,7 @@ initCamera()
 void
 updateScene(double time)
 {
-  // No updates in this simple program.
+  g_scene->update(time);
 }
 
 /******************************************************************/
@@ -416,7 +418,16 @@ recordKeys(GLFWwindow* window, int key, int scanCode, int action,
 void
 recordMouse(GLFWwindow* window, int button, int action, int modifiers)
 {
-  if (action == GLFW_PRESS)
+  if (action == GLFW_PRESS && button == GLFW_MOUSE_BUTTON_LEFT
+      && (modifiers & GLFW_MOD_CONTROL))
+  {
+    double x, y;
+    int width, height;
+    glfwGetCursorPos(window, &x, &y);
+    glfwGetWindowSize(window, &width, &height);
+    g_scene->pickMesh(g_camera->getPickRay(x, y, width, height));
+  }
+  else if (action == GLFW_PRESS)
   {
     if (button == GLFW_MOUSE_BUTTON_LEFT)
       g_mouseBuffer.setLeftButton(true);
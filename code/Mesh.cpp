@@ -4,7 +4,13 @@
 /// \version A08
 /******************************************************************/
 // System includes
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <utility>
 
 /******************************************************************/
 // Local includes
@@ -14,23 +20,340 @@
 #include "Vector3.hpp"
 #include "Transform.hpp"
 #include "Matrix4.hpp"
+#include "Geometry.hpp"
+#include "MeshOptimizer.hpp"
+
+/******************************************************************/
+/// \brief Chooses the smallest index type that can address some vertices.
+/// \param[in] vertexCount The number of vertices.
+/// \return GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, or GL_UNSIGNED_INT.
+/// The largest value of each type is never needed as an index, so it stays
+///   free for use as a primitive restart index.
+static GLenum
+chooseIndexType(std::size_t vertexCount)
+{
+	if(vertexCount <= std::numeric_limits<GLubyte>::max())
+	{
+		return GL_UNSIGNED_BYTE;
+	}
+	if(vertexCount <= std::numeric_limits<GLushort>::max())
+	{
+		return GL_UNSIGNED_SHORT;
+	}
+	return GL_UNSIGNED_INT;
+}
+
+/// \brief Uploads indices to the bound element array buffer as a narrower
+///   type.
+/// \param[in] context The context to upload through.
+/// \param[in] indices The indices, each of which must fit in an Index.
+/// \param[in] usage How the buffer will be used, for example GL_STATIC_DRAW.
+template<typename Index>
+static void
+uploadNarrowedIndices(OpenGLContext* context, const std::vector<unsigned int>& indices,
+	GLenum usage)
+{
+	std::vector<Index> narrowed(indices.begin(), indices.end());
+	context->bufferData(GL_ELEMENT_ARRAY_BUFFER, narrowed.size() * sizeof(Index),
+		narrowed.data(), usage);
+}
+
+/// \brief Uploads indices to the bound element array buffer as some type.
+/// \param[in] context The context to upload through.
+/// \param[in] indices The indices, each of which must fit in the type.
+/// \param[in] type GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, or GL_UNSIGNED_INT.
+/// \param[in] usage How the buffer will be used, for example GL_STATIC_DRAW.
+static void
+uploadIndices(OpenGLContext* context, const std::vector<unsigned int>& indices,
+	GLenum type, GLenum usage)
+{
+	if(type == GL_UNSIGNED_BYTE)
+	{
+		uploadNarrowedIndices<GLubyte>(context, indices, usage);
+	}
+	else if(type == GL_UNSIGNED_SHORT)
+	{
+		uploadNarrowedIndices<GLushort>(context, indices, usage);
+	}
+	else
+	{
+		context->bufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int),
+			indices.data(), usage);
+	}
+}
+
+/// \brief Narrows indices to some type, as uploadIndices would.
+/// \param[in] indices The indices, each of which must fit in the type.
+/// \param[in] type GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, or GL_UNSIGNED_INT.
+/// \return The bytes of the narrowed indices.
+template<typename Index>
+static std::vector<unsigned char>
+narrowIndices(const std::vector<unsigned int>& indices)
+{
+	std::vector<Index> narrowed(indices.begin(), indices.end());
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(narrowed.data());
+	return std::vector<unsigned char>(bytes, bytes + narrowed.size() * sizeof(Index));
+}
+
+/// \brief Gets the bytes uploadIndices would upload for some indices.
+/// \param[in] indices The indices, each of which must fit in the type.
+/// \param[in] type GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, or GL_UNSIGNED_INT.
+/// \return The bytes of the indices as that type.
+static std::vector<unsigned char>
+indexBytes(const std::vector<unsigned int>& indices, GLenum type)
+{
+	if(type == GL_UNSIGNED_BYTE)
+	{
+		return narrowIndices<GLubyte>(indices);
+	}
+	if(type == GL_UNSIGNED_SHORT)
+	{
+		return narrowIndices<GLushort>(indices);
+	}
+	return narrowIndices<GLuint>(indices);
+}
+
+/// \brief Gets the size of an index type.
+/// \param[in] type GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, or GL_UNSIGNED_INT.
+/// \return The number of bytes in each index.
+static std::size_t
+indexSize(GLenum type)
+{
+	if(type == GL_UNSIGNED_BYTE)
+	{
+		return sizeof(GLubyte);
+	}
+	if(type == GL_UNSIGNED_SHORT)
+	{
+		return sizeof(GLushort);
+	}
+	return sizeof(GLuint);
+}
+
+/// \brief Writes indices to memory as a narrower type.
+/// \param[in] indices The first index, each of which must fit in an Index.
+/// \param[in] count The number of indices.
+/// \param[out] destination Where count Indexes are written.
+template<typename Index>
+static void
+writeNarrowedIndices(const unsigned int* indices, std::size_t count, void* destination)
+{
+	Index* narrowed = static_cast<Index*>(destination);
+	for(std::size_t index = 0; index < count; ++index)
+	{
+		narrowed[index] = static_cast<Index>(indices[index]);
+	}
+}
+
+/// \brief Writes indices to memory as some type, as uploadIndices would
+///   upload them.
+/// \param[in] indices The first index, each of which must fit in the type.
+/// \param[in] count The number of indices.
+/// \param[in] type GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, or GL_UNSIGNED_INT.
+/// \param[out] destination Where the indices are written.
+static void
+writeIndices(const unsigned int* indices, std::size_t count, GLenum type, void* destination)
+{
+	if(type == GL_UNSIGNED_BYTE)
+	{
+		writeNarrowedIndices<GLubyte>(indices, count, destination);
+	}
+	else if(type == GL_UNSIGNED_SHORT)
+	{
+		writeNarrowedIndices<GLushort>(indices, count, destination);
+	}
+	else
+	{
+		std::memcpy(destination, indices, count * sizeof(unsigned int));
+	}
+}
+
+/// \brief Grows a range to cover another.
+/// \param[in,out] range A range [first, last), which is empty if first >=
+///   last.
+/// \param[in] first The first element of the other range.
+/// \param[in] last One past the last element of the other range.
+static void
+growRange(std::pair<std::size_t, std::size_t>& range, std::size_t first, std::size_t last)
+{
+	if(range.first >= range.second)
+	{
+		range = std::make_pair(first, last);
+	}
+	else
+	{
+		range = std::make_pair(std::min(range.first, first), std::max(range.second, last));
+	}
+}
+
+/// \brief Grows bounds to hold some more vertices.
+/// \param[in,out] box An axis-aligned box.
+/// \param[in,out] sphere A sphere.
+/// \param[in] vertices Interleaved vertex data whose first three floats per
+///   vertex are a position.
+/// \param[in] floatsPerVertex The number of floats used for each vertex.
+/// The sphere grows just enough to hold both itself and each vertex outside
+///   it, so it may end up larger than computeBoundingSphere's would be.
+static void
+growBounds(BoundingBox& box, BoundingSphere& sphere, const std::vector<float>& vertices,
+	unsigned int floatsPerVertex)
+{
+	for(std::size_t vertex = 0; vertex + floatsPerVertex <= vertices.size();
+		vertex += floatsPerVertex)
+	{
+		Vector3 position(vertices[vertex], vertices[vertex + 1], vertices[vertex + 2]);
+		box.m_min = Vector3(std::min(box.m_min.m_x, position.m_x),
+			std::min(box.m_min.m_y, position.m_y), std::min(box.m_min.m_z, position.m_z));
+		box.m_max = Vector3(std::max(box.m_max.m_x, position.m_x),
+			std::max(box.m_max.m_y, position.m_y), std::max(box.m_max.m_z, position.m_z));
+		float distance = (position - sphere.m_center).length();
+		if(distance > sphere.m_radius)
+		{
+			float radius = (sphere.m_radius + distance) / 2.0f;
+			sphere.m_center += (position - sphere.m_center) * ((radius - sphere.m_radius) / distance);
+			sphere.m_radius = radius;
+		}
+	}
+}
+
+/// \brief Gets the index that restarts strips drawn with some index type.
+/// \param[in] type GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, or GL_UNSIGNED_INT.
+/// \return The largest value of the type, which is what STRIP_RESTART_INDEX
+///   becomes when the indices are narrowed to it.
+static GLuint
+restartIndexFor(GLenum type)
+{
+	if(type == GL_UNSIGNED_BYTE)
+	{
+		return std::numeric_limits<GLubyte>::max();
+	}
+	if(type == GL_UNSIGNED_SHORT)
+	{
+		return std::numeric_limits<GLushort>::max();
+	}
+	return std::numeric_limits<GLuint>::max();
+}
+
+/// \brief Takes the absolute value of each part of a vector.
+static Vector3
+absolute(const Vector3& v)
+{
+	return Vector3(std::fabs(v.m_x), std::fabs(v.m_y), std::fabs(v.m_z));
+}
+
+/// \brief Finds the most a linear transformation lengthens any vector.
+/// \param[in] m The transformation.
+/// \return The largest singular value of m.
+/// This is the square root of the largest eigenvalue of the symmetric matrix
+///   m^T m, which has a closed form (Smith, 1961).
+static float
+largestStretch(const Matrix3& m)
+{
+	const Vector3 columns[3] = { m.getRight(), m.getUp(), m.getBack() };
+	double a[3][3];
+	for(int row = 0; row < 3; ++row)
+	{
+		for(int column = 0; column < 3; ++column)
+		{
+			a[row][column] = columns[row].dot(columns[column]);
+		}
+	}
+	double offDiagonal = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+	double mean = (a[0][0] + a[1][1] + a[2][2]) / 3.0;
+	double spread = (a[0][0] - mean) * (a[0][0] - mean) + (a[1][1] - mean) * (a[1][1] - mean)
+		+ (a[2][2] - mean) * (a[2][2] - mean) + 2.0 * offDiagonal;
+	double p = std::sqrt(spread / 6.0);
+	if(p < 1e-12 * std::max(mean, 1e-30))
+	{
+		return static_cast<float>(std::sqrt(mean));
+	}
+	// The eigenvalues of b = (a - mean I) / p are 2 cos(phi + 2 pi k / 3).
+	double b[3][3];
+	for(int row = 0; row < 3; ++row)
+	{
+		for(int column = 0; column < 3; ++column)
+		{
+			b[row][column] = (a[row][column] - (row == column ? mean : 0.0)) / p;
+		}
+	}
+	double halfDeterminant = (b[0][0] * (b[1][1] * b[2][2] - b[1][2] * b[2][1])
+		- b[0][1] * (b[1][0] * b[2][2] - b[1][2] * b[2][0])
+		+ b[0][2] * (b[1][0] * b[2][1] - b[1][1] * b[2][0])) / 2.0;
+	double phi = std::acos(std::max(-1.0, std::min(1.0, halfDeterminant))) / 3.0;
+	return static_cast<float>(std::sqrt(mean + 2.0 * p * std::cos(phi)));
+}
 
 /******************************************************************/
 Mesh::Mesh(OpenGLContext* context, ShaderProgram* shader)
+	: Mesh(context, shader, PositionsLayout::DESCRIPTION)
+{
+}
+
+Mesh::Mesh(OpenGLContext* context, ShaderProgram* shader, const VertexLayoutDescription& layout)
 	: m_context(context),
 		m_shader(shader),
+		m_vao(0),
+		m_vbo(0),
+		m_ibo(0),
+		m_indexCount(0),
+		m_retention(GeometryRetention::KEEP),
+		m_compressed(),
+		m_indexType(GL_UNSIGNED_INT),
+		m_primitive(GL_TRIANGLES),
+		m_layout(layout),
+		m_format{PositionFormat::FLOAT32, AttributeFormat::FLOAT32},
+		m_dequantization(),
 		m_prepared(false),
-		m_world()
+		m_static(false),
+		m_pickable(false),
+		m_registry(nullptr),
+		m_streaming(StreamingMode::NONE),
+		m_ringRegion(0),
+		m_staleVertices(),
+		m_staleIndices(),
+		m_fences(),
+		m_streamPending(false),
+		m_sharesGeometry(false),
+		m_arena(nullptr),
+		m_allocation(),
+		m_usesArena(false),
+		m_world(),
+		m_localBox{Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 0.0f, 0.0f)},
+		m_localSphere{Vector3(0.0f, 0.0f, 0.0f), 0.0f},
+		m_worldBox(m_localBox),
+		m_worldSphere(m_localSphere),
+		m_worldBoundsStale(true)
 {
-	m_context->genVertexArrays(1, &m_vao);
-	m_context->genBuffers(1, &m_vbo);
-	m_context->genBuffers(1, &m_ibo);
 }
 
 Mesh::~Mesh()
 {
-  m_context->deleteVertexArrays(1, &m_vao);
-	m_context->deleteBuffers(1, &m_vbo);
+	for(GLsync fence : m_fences)
+	{
+		if(fence != nullptr)
+		{
+			m_context->deleteSync(fence);
+		}
+	}
+	if(m_usesArena)
+	{
+		m_arena->release(m_allocation);
+		return;
+	}
+	if(!m_prepared)
+	{
+		return;
+	}
+	m_context->deleteVertexArrays(1, &m_vao);
+	if(m_sharesGeometry)
+	{
+		m_registry->release(SharedGeometry{m_vbo, m_ibo});
+	}
+	else
+	{
+		m_context->deleteBuffers(1, &m_vbo);
+		m_context->deleteBuffers(1, &m_ibo);
+	}
 }
 
 void
@@ -39,49 +362,790 @@ Mesh::addGeometry(const std::vector<float>& geometry)
 	m_data.insert(m_data.end(), geometry.begin(), geometry.end());
 }
 
+void
+Mesh::addGeometry(std::vector<float>&& geometry)
+{
+	// Appending to an empty store would copy into a new buffer when the
+	//   caller's is already the right one.
+	if(m_data.empty() && geometry.capacity() >= m_data.capacity())
+	{
+		m_data.swap(geometry);
+	}
+	else
+	{
+		m_data.insert(m_data.end(), geometry.begin(), geometry.end());
+	}
+	std::vector<float>().swap(geometry);
+}
+
+void
+Mesh::addGeometry(const float* geometry, std::size_t floatCount)
+{
+	m_data.insert(m_data.end(), geometry, geometry + floatCount);
+}
+
+void
+Mesh::reserveGeometry(std::size_t floatCount, std::size_t indexCount)
+{
+	m_data.reserve(floatCount);
+	m_indices.reserve(indexCount);
+}
+
+float*
+Mesh::stageGeometry(std::size_t floatCount)
+{
+	std::size_t oldSize = m_data.size();
+	m_data.resize(oldSize + floatCount);
+	return m_data.data() + oldSize;
+}
+
+void
+Mesh::indexGeometry()
+{
+	unsigned int floatsPerVertex = getFloatsPerVertex();
+	unsigned int uniqueVertices = indexDataInPlace(m_data.data(),
+		m_data.size() / floatsPerVertex, floatsPerVertex, m_indices);
+	m_data.resize(uniqueVertices * floatsPerVertex);
+}
+
+WeldStatistics
+Mesh::weldGeometry(const WeldTolerances& tolerances)
+{
+	assert(m_primitive == GL_TRIANGLES);
+	return weldVertices(m_data, getFloatsPerVertex(), m_indices, getVertexAttribute(),
+		tolerances);
+}
+
 void
 Mesh::addIndices(const std::vector<unsigned int>& indices)
 {
 	m_indices.insert(m_indices.end(), indices.begin(), indices.end());
 }
 
+void
+Mesh::addIndices(std::vector<unsigned int>&& indices)
+{
+	if(m_indices.empty() && indices.capacity() >= m_indices.capacity())
+	{
+		m_indices.swap(indices);
+	}
+	else
+	{
+		m_indices.insert(m_indices.end(), indices.begin(), indices.end());
+	}
+	std::vector<unsigned int>().swap(indices);
+}
+
+void
+Mesh::addIndices(const unsigned int* indices, std::size_t indexCount)
+{
+	m_indices.insert(m_indices.end(), indices, indices + indexCount);
+}
+
+bool
+Mesh::buildMeshlets(unsigned int maxVertices, unsigned int maxTriangles)
+{
+	assert(m_primitive == GL_TRIANGLES);
+	if(m_streaming != StreamingMode::NONE)
+	{
+		return false;
+	}
+	m_meshlets = ::buildMeshlets(m_data, getFloatsPerVertex(), m_indices,
+		maxVertices, maxTriangles);
+	m_indices = m_meshlets.m_indices;
+	return true;
+}
+
+std::size_t
+Mesh::stripify()
+{
+	assert(m_meshlets.m_meshlets.empty());
+	std::size_t listSize = m_indices.size();
+	m_indices = ::stripify(m_indices, m_data.size() / getFloatsPerVertex());
+	m_primitive = GL_TRIANGLE_STRIP;
+	return listSize - std::min(listSize, m_indices.size());
+}
+
+void
+Mesh::appendStaticGeometry(const Mesh& other)
+{
+	assert(!m_prepared);
+	assert(other.m_layout.m_signature == m_layout.m_signature);
+	assert(m_meshlets.m_meshlets.empty() && other.m_meshlets.m_meshlets.empty());
+	assert(!other.m_prepared || other.m_retention != GeometryRetention::DISCARD);
+	// A compressed Mesh's geometry is only read back for as long as it is
+	//   needed here.
+	std::vector<float> decompressedData;
+	std::vector<unsigned int> decompressedIndices;
+	const std::vector<float>* otherData = &other.m_data;
+	const std::vector<unsigned int>* otherIndexSource = &other.m_indices;
+	if(other.m_prepared && other.m_retention == GeometryRetention::COMPRESS)
+	{
+		decompressGeometry(other.m_compressed, decompressedData, decompressedIndices);
+		otherData = &decompressedData;
+		otherIndexSource = &decompressedIndices;
+	}
+	if(m_primitive == GL_TRIANGLE_STRIP)
+	{
+		m_indices = unstripify(m_indices);
+		m_primitive = GL_TRIANGLES;
+	}
+
+	// Carry other's local coordinates through the world into this Mesh's.
+	Matrix3 toLocal = m_world.getOrientation();
+	toLocal.invert();
+	Matrix3 linear = toLocal * other.m_world.getOrientation();
+	Vector3 offset = toLocal * (other.m_world.getPosition() - m_world.getPosition());
+	// Normals only stay perpendicular to their surfaces under the
+	//   inverse-transpose, once scaling or shearing is involved.
+	Matrix3 normalMatrix = linear;
+	normalMatrix.invert();
+	normalMatrix.transpose();
+	const AttributeBinding* normals = nullptr;
+	for(unsigned int attribute = 0; attribute < m_layout.m_bindingCount; ++attribute)
+	{
+		if(m_layout.m_bindings[attribute].m_location == NormalAttribute::LOCATION)
+		{
+			normals = &m_layout.m_bindings[attribute];
+		}
+	}
+
+	const unsigned int floatsPerVertex = getFloatsPerVertex();
+	const unsigned int firstVertex = m_data.size() / floatsPerVertex;
+	std::size_t firstFloat = m_data.size();
+	m_data.insert(m_data.end(), otherData->begin(), otherData->end());
+	for(std::size_t vertex = firstFloat; vertex < m_data.size(); vertex += floatsPerVertex)
+	{
+		float* values = &m_data[vertex];
+		Vector3 position = linear * Vector3(values[0], values[1], values[2]) + offset;
+		values[0] = position.m_x;
+		values[1] = position.m_y;
+		values[2] = position.m_z;
+		if(normals != nullptr)
+		{
+			float* n = values + normals->m_offset;
+			Vector3 normal = normalMatrix * Vector3(n[0], n[1], n[2]);
+			normal.normalize();
+			n[0] = normal.m_x;
+			n[1] = normal.m_y;
+			n[2] = normal.m_z;
+		}
+	}
+
+	std::vector<unsigned int> otherIndices = other.m_primitive == GL_TRIANGLE_STRIP
+		? unstripify(*otherIndexSource) : *otherIndexSource;
+	// A mirroring matrix turns front faces into back faces unless the
+	//   triangles are wound the other way.
+	const bool mirrored = linear.determinant() < 0.0f;
+	std::size_t firstIndex = m_indices.size();
+	m_indices.reserve(firstIndex + otherIndices.size());
+	for(std::size_t index = 0; index < otherIndices.size(); ++index)
+	{
+		m_indices.push_back(otherIndices[index] + firstVertex);
+	}
+	if(mirrored)
+	{
+		for(std::size_t corner = firstIndex; corner + 2 < m_indices.size(); corner += 3)
+		{
+			std::swap(m_indices[corner + 1], m_indices[corner + 2]);
+		}
+	}
+}
+
+void
+Mesh::setStatic(bool isStatic)
+{
+	m_static = isStatic;
+}
+
+bool
+Mesh::isStatic() const
+{
+	return m_static;
+}
+
+bool
+Mesh::setPickable(bool pickable)
+{
+	assert(!m_prepared);
+	if(pickable && m_streaming != StreamingMode::NONE)
+	{
+		return false;
+	}
+	m_pickable = pickable;
+	return true;
+}
+
+bool
+Mesh::isPickable() const
+{
+	return m_pickable;
+}
+
+ShaderProgram*
+Mesh::getShader() const
+{
+	return m_shader;
+}
+
+const MeshletSet&
+Mesh::getMeshlets() const
+{
+	return m_meshlets;
+}
+
+bool
+Mesh::setVertexFormat(const VertexFormat& format)
+{
+	if(m_streaming != StreamingMode::NONE && (format.m_position != PositionFormat::FLOAT32
+		|| format.m_attribute != AttributeFormat::FLOAT32))
+	{
+		return false;
+	}
+	m_format = format;
+	return true;
+}
+
+VertexFormat
+Mesh::getVertexFormat() const
+{
+	return m_format;
+}
+
+bool
+Mesh::setGeometryRegistry(GeometryRegistry* registry)
+{
+	if(registry != nullptr && (m_arena != nullptr || m_streaming != StreamingMode::NONE))
+	{
+		return false;
+	}
+	m_registry = registry;
+	return true;
+}
+
+bool
+Mesh::setGeometryRetention(GeometryRetention retention)
+{
+	if(retention != GeometryRetention::KEEP && m_streaming != StreamingMode::NONE)
+	{
+		return false;
+	}
+	m_retention = retention;
+	return true;
+}
+
+GeometryRetention
+Mesh::getGeometryRetention() const
+{
+	return m_retention;
+}
+
+std::size_t
+Mesh::getRetainedBytes() const
+{
+	return m_data.capacity() * sizeof(float) + m_indices.capacity() * sizeof(unsigned int)
+		+ m_compressed.m_vertexBytes.capacity() + m_compressed.m_indexBytes.capacity()
+		+ m_meshlets.m_meshlets.capacity() * sizeof(Meshlet)
+		+ m_meshlets.m_indices.capacity() * sizeof(unsigned int)
+		+ m_visibleIndices.capacity() * sizeof(unsigned int)
+		+ m_bvh.m_nodes.capacity() * sizeof(BvhNode)
+		+ m_bvh.m_triangles.capacity() * sizeof(unsigned int)
+		+ m_bvh.m_corners.capacity() * sizeof(Vector3);
+}
+
+bool
+Mesh::setStreaming(StreamingMode mode)
+{
+	if(mode != StreamingMode::NONE
+		&& (!m_meshlets.m_meshlets.empty() || m_registry != nullptr || m_arena != nullptr
+			|| m_retention != GeometryRetention::KEEP || m_pickable
+			|| m_format.m_position != PositionFormat::FLOAT32
+			|| m_format.m_attribute != AttributeFormat::FLOAT32))
+	{
+		return false;
+	}
+	m_streaming = mode;
+	return true;
+}
+
+StreamingMode
+Mesh::getStreaming() const
+{
+	return m_streaming;
+}
+
+void
+Mesh::updateVertices(std::size_t firstVertex, const std::vector<float>& vertices)
+{
+	const unsigned int floatsPerVertex = getFloatsPerVertex();
+	assert(m_prepared && m_streaming != StreamingMode::NONE);
+	assert(vertices.size() % floatsPerVertex == 0);
+	assert(firstVertex * floatsPerVertex + vertices.size() <= m_data.size());
+	std::copy(vertices.begin(), vertices.end(), m_data.begin() + firstVertex * floatsPerVertex);
+	growBounds(m_localBox, m_localSphere, vertices, floatsPerVertex);
+	m_worldBoundsStale = true;
+	std::size_t lastVertex = firstVertex + vertices.size() / floatsPerVertex;
+	// Orphaning uploads everything at once, so only the ring tracks regions.
+	unsigned int regions = m_streaming == StreamingMode::RING ? STREAMING_RING_REGIONS : 1;
+	for(unsigned int region = 0; region < regions; ++region)
+	{
+		growRange(m_staleVertices[region], firstVertex, lastVertex);
+	}
+	m_streamPending = true;
+}
+
+void
+Mesh::updateIndices(std::size_t firstIndex, const std::vector<unsigned int>& indices)
+{
+	assert(m_prepared && m_streaming != StreamingMode::NONE);
+	assert(firstIndex + indices.size() <= m_indices.size());
+	std::copy(indices.begin(), indices.end(), m_indices.begin() + firstIndex);
+	// Orphaning uploads everything at once, so only the ring tracks regions.
+	unsigned int regions = m_streaming == StreamingMode::RING ? STREAMING_RING_REGIONS : 1;
+	for(unsigned int region = 0; region < regions; ++region)
+	{
+		growRange(m_staleIndices[region], firstIndex, firstIndex + indices.size());
+	}
+	m_streamPending = true;
+}
+
+bool
+Mesh::setBufferArena(BufferArena* arena)
+{
+	if(arena != nullptr && (m_registry != nullptr || m_streaming != StreamingMode::NONE))
+	{
+		return false;
+	}
+	m_arena = arena;
+	return true;
+}
+
+bool
+Mesh::usesBufferArena() const
+{
+	return m_usesArena;
+}
+
+bool
+Mesh::sharesGeometry() const
+{
+	return m_sharesGeometry;
+}
+
 void
 Mesh::prepareVao()
 {
-	m_context->bindVertexArray(m_vao);
+	m_localBox = computeBoundingBox(m_data, getFloatsPerVertex());
+	m_localSphere = computeBoundingSphere(m_data, getFloatsPerVertex(), m_localBox);
+	m_worldBoundsStale = true;
+	if(m_pickable)
+	{
+		m_bvh = buildBvh(m_data, getFloatsPerVertex(),
+			m_primitive == GL_TRIANGLE_STRIP ? unstripify(m_indices) : m_indices);
+	}
 
-	m_context->bindBuffer(GL_ARRAY_BUFFER, m_vbo);
-	m_context->bufferData(GL_ARRAY_BUFFER, m_data.size() * sizeof(float),
-		m_data.data(), GL_STATIC_DRAW);
-	
-	m_context->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
-	m_context->bufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(unsigned int),
-		m_indices.data(), GL_STATIC_DRAW);
+	// Packed vertices are kept here until they have been uploaded.
+	std::vector<unsigned char> packed;
+	const void* vertexBytes = m_data.data();
+	std::size_t vertexByteCount = m_data.size() * sizeof(float);
+	if(m_format.m_position != PositionFormat::FLOAT32
+		|| m_format.m_attribute != AttributeFormat::FLOAT32)
+	{
+		// Only a position and one color or normal can be packed.
+		assert(getFloatsPerVertex() == 6 && getVertexAttribute() != VertexAttribute::NONE);
+		PositionQuantization quantization = computePositionQuantization(m_data, 6);
+		if(m_format.m_position != PositionFormat::FLOAT32)
+		{
+			m_dequantization.setPosition(quantization.m_offset);
+			m_dequantization.scaleLocal(quantization.m_scale);
+		}
+		packed = encodeVertices(m_data, m_format, quantization);
+		vertexBytes = packed.data();
+		vertexByteCount = packed.size();
+	}
+	m_indexType = chooseIndexType(m_data.size() / getFloatsPerVertex());
+	m_indexCount = m_indices.size();
+
+	// A meshlet culled IBO is refilled every draw, so it cannot be shared.
+	if(m_arena != nullptr && m_meshlets.m_meshlets.empty())
+	{
+		std::vector<unsigned char> indices = indexBytes(m_indices, m_indexType);
+		m_allocation = m_arena->allocate(
+			ArenaLayout{m_format, m_layout.m_signature},
+			vertexBytes, vertexByteCount, m_data.size() / getFloatsPerVertex(),
+			indices.data(), indices.size());
+		m_vao = m_allocation.m_vao;
+		m_vbo = m_allocation.m_vbo;
+		m_ibo = m_allocation.m_ibo;
+		m_usesArena = true;
+		// Only the first Mesh in a block has to set up its vertex array.
+		if(!m_allocation.m_newVertexArray)
+		{
+			m_context->bindVertexArray(0);
+			retainGeometry();
+			m_prepared = true;
+			return;
+		}
+		m_context->bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+	}
+	else if(m_registry != nullptr && m_meshlets.m_meshlets.empty())
+	{
+		std::vector<unsigned char> indices = indexBytes(m_indices, m_indexType);
+		m_context->genVertexArrays(1, &m_vao);
+		m_context->bindVertexArray(m_vao);
+		SharedGeometry shared = m_registry->acquire(vertexBytes, vertexByteCount,
+			indices.data(), indices.size(),
+			GeometryLayout{m_format, getFloatsPerVertex(), m_indexType});
+		m_vbo = shared.m_vbo;
+		m_ibo = shared.m_ibo;
+		m_sharesGeometry = true;
+		// Binding again records the buffers in this Mesh's VAO even when they
+		//   were filled while another Mesh's VAO was bound.
+		m_context->bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+		m_context->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+	}
+	else if(m_streaming == StreamingMode::RING)
+	{
+		// Every region starts out with the whole geometry.
+		std::vector<unsigned char> indices = indexBytes(m_indices, m_indexType);
+		generateObjects();
+		m_context->bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+		m_context->bufferData(GL_ARRAY_BUFFER, STREAMING_RING_REGIONS * vertexByteCount, nullptr,
+			GL_DYNAMIC_DRAW);
+		m_context->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+		m_context->bufferData(GL_ELEMENT_ARRAY_BUFFER, STREAMING_RING_REGIONS * indices.size(),
+			nullptr, GL_DYNAMIC_DRAW);
+		for(unsigned int region = 0; region < STREAMING_RING_REGIONS; ++region)
+		{
+			m_context->bufferSubData(GL_ARRAY_BUFFER, region * vertexByteCount, vertexByteCount,
+				vertexBytes);
+			m_context->bufferSubData(GL_ELEMENT_ARRAY_BUFFER, region * indices.size(),
+				indices.size(), indices.data());
+		}
+	}
+	else
+	{
+		GLenum usage = m_streaming == StreamingMode::ORPHAN ? GL_STREAM_DRAW : GL_STATIC_DRAW;
+		generateObjects();
+		m_context->bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+		m_context->bufferData(GL_ARRAY_BUFFER, vertexByteCount, vertexBytes, usage);
+		m_context->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+		// Only meshlets that keep their indices refill the IBO as they cull.
+		uploadIndices(m_context, m_indices, m_indexType,
+			m_meshlets.m_meshlets.empty() || m_retention != GeometryRetention::KEEP
+				? usage : GL_DYNAMIC_DRAW);
+	}
 
 	enableAttributes();
 
 	m_context->bindVertexArray(0);
 
+	retainGeometry();
 	m_prepared = true;
 }
 
+void
+Mesh::generateObjects()
+{
+	m_context->genVertexArrays(1, &m_vao);
+	m_context->genBuffers(1, &m_vbo);
+	m_context->genBuffers(1, &m_ibo);
+	m_context->bindVertexArray(m_vao);
+}
+
+void
+Mesh::retainGeometry()
+{
+	if(m_retention == GeometryRetention::KEEP)
+	{
+		return;
+	}
+	if(m_retention == GeometryRetention::COMPRESS)
+	{
+		m_compressed = compressGeometry(m_data, getFloatsPerVertex(), m_indices);
+		m_compressed.m_vertexBytes.shrink_to_fit();
+		m_compressed.m_indexBytes.shrink_to_fit();
+	}
+	// Swapping with empty vectors returns the memory, which clear would not.
+	std::vector<float>().swap(m_data);
+	std::vector<unsigned int>().swap(m_indices);
+	// The IBO already holds the meshlets' indices in order, so drawMeshletRuns
+	//   can cull without them.
+	std::vector<unsigned int>().swap(m_meshlets.m_indices);
+}
+
 void
 Mesh::draw(const Transform& viewMatrix, const Matrix4& projectionMatrix)
 {
 	Transform modelView = viewMatrix;
 	modelView.combine(m_world);
+	modelView.combine(m_dequantization);
 	m_shader->enable();
 	m_shader->setUniformMatrix("uModelView", modelView.getTransform());
+	m_shader->setUniformInt("uOctahedralNormals",
+		m_format.m_attribute == AttributeFormat::OCTAHEDRAL_SNORM16
+		|| m_format.m_attribute == AttributeFormat::OCTAHEDRAL_SNORM8);
 	m_shader->setUniformMatrix("uProjection", projectionMatrix);
 
 	m_context->bindVertexArray(m_vao);
-	m_context->drawElements(GL_TRIANGLES, m_indices.size(), GL_UNSIGNED_INT, 
-		reinterpret_cast<void*>(0));
+	uploadStreamedGeometry();
+	if(m_primitive == GL_TRIANGLE_STRIP)
+	{
+		m_context->enable(GL_PRIMITIVE_RESTART);
+		m_context->primitiveRestartIndex(restartIndexFor(m_indexType));
+		drawIndices(GL_TRIANGLE_STRIP, m_indexCount);
+		m_context->disable(GL_PRIMITIVE_RESTART);
+	}
+	else if(m_meshlets.m_meshlets.empty())
+	{
+		drawIndices(GL_TRIANGLES, m_indexCount);
+	}
+	else
+	{
+		// Cull in local coordinates, where the meshlet bounds are, before any
+		//   dequantization.
+		Transform localToEye = viewMatrix;
+		localToEye.combine(m_world);
+		Matrix3 eyeToLocal = localToEye.getOrientation();
+		eyeToLocal.invert();
+		Vector3 camera = eyeToLocal * -localToEye.getPosition();
+		Frustum frustum = extractFrustum(projectionMatrix, localToEye.getTransform());
+		if(m_meshlets.m_indices.empty())
+		{
+			drawMeshletRuns(frustum, camera);
+		}
+		else
+		{
+			cullMeshlets(m_meshlets, frustum, camera, m_visibleIndices);
+			// Respecifying the whole buffer lets the driver hand back fresh storage
+			//   instead of waiting for the last frame's draw to finish.
+			uploadIndices(m_context, m_visibleIndices, m_indexType, GL_DYNAMIC_DRAW);
+			m_context->drawElements(GL_TRIANGLES, m_visibleIndices.size(), m_indexType,
+				reinterpret_cast<void*>(0));
+		}
+	}
+	if(m_streaming == StreamingMode::RING)
+	{
+		// Replacing the region's fence keeps only the one for its latest draw.
+		GLsync& fence = m_fences[m_ringRegion];
+		if(fence != nullptr)
+		{
+			m_context->deleteSync(fence);
+		}
+		fence = m_context->fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
 	m_context->bindVertexArray(0);
 
 	m_shader->disable();
 }
 
+void
+Mesh::drawIndices(GLenum mode, std::size_t count)
+{
+	if(m_usesArena)
+	{
+		// Primitive restart compares indices before the base vertex is added.
+		m_context->drawElementsBaseVertex(mode, count, m_indexType,
+			reinterpret_cast<void*>(m_allocation.m_indexOffset), m_allocation.m_baseVertex);
+	}
+	else if(m_streaming == StreamingMode::RING)
+	{
+		// Each region's indices count from the start of its own vertices.
+		std::size_t indexOffset = m_ringRegion * m_indexCount * indexSize(m_indexType);
+		m_context->drawElementsBaseVertex(mode, count, m_indexType,
+			reinterpret_cast<void*>(indexOffset),
+			m_ringRegion * (m_data.size() / getFloatsPerVertex()));
+	}
+	else
+	{
+		m_context->drawElements(mode, count, m_indexType, reinterpret_cast<void*>(0));
+	}
+}
+
+void
+Mesh::drawMeshletRuns(const Frustum& frustum, const Vector3& camera)
+{
+	std::size_t first = 0;
+	std::size_t count = 0;
+	for(const Meshlet& meshlet : m_meshlets.m_meshlets)
+	{
+		if(!isMeshletVisible(meshlet, frustum, camera))
+		{
+			continue;
+		}
+		if(count != 0 && meshlet.m_indexOffset != first + count)
+		{
+			m_context->drawElements(GL_TRIANGLES, count, m_indexType,
+				reinterpret_cast<void*>(first * indexSize(m_indexType)));
+			count = 0;
+		}
+		if(count == 0)
+		{
+			first = meshlet.m_indexOffset;
+		}
+		count += 3 * meshlet.m_triangleCount;
+	}
+	if(count != 0)
+	{
+		m_context->drawElements(GL_TRIANGLES, count, m_indexType,
+			reinterpret_cast<void*>(first * indexSize(m_indexType)));
+	}
+}
+
+void
+Mesh::uploadStreamedGeometry()
+{
+	if(!m_streamPending)
+	{
+		return;
+	}
+	const unsigned int floatsPerVertex = getFloatsPerVertex();
+	m_context->bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+
+	if(m_streaming == StreamingMode::ORPHAN)
+	{
+		m_streamPending = false;
+		// Respecifying a buffer with no data orphans its old storage, which
+		//   draws still in flight go on reading.
+		if(m_staleVertices[0].first < m_staleVertices[0].second)
+		{
+			m_context->bufferData(GL_ARRAY_BUFFER, m_data.size() * sizeof(float), nullptr,
+				GL_STREAM_DRAW);
+			m_context->bufferSubData(GL_ARRAY_BUFFER, 0, m_data.size() * sizeof(float),
+				m_data.data());
+		}
+		if(m_staleIndices[0].first < m_staleIndices[0].second)
+		{
+			std::vector<unsigned char> indices = indexBytes(m_indices, m_indexType);
+			m_context->bufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size(), nullptr, GL_STREAM_DRAW);
+			m_context->bufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size(), indices.data());
+		}
+		m_staleVertices[0] = m_staleIndices[0] = std::make_pair(0, 0);
+		return;
+	}
+
+	// The next region was last drawn two draws ago, so its fence has almost
+	//   always passed.  It is only polled: if the GPU still reads the region,
+	//   the current one is drawn again and the update waits for the next draw.
+	unsigned int next = (m_ringRegion + 1) % STREAMING_RING_REGIONS;
+	GLsync& fence = m_fences[next];
+	if(fence != nullptr)
+	{
+		GLenum status = m_context->clientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+		if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+		{
+			return;
+		}
+		m_context->deleteSync(fence);
+		fence = nullptr;
+	}
+	m_ringRegion = next;
+	m_streamPending = false;
+
+	// The fence is why the writes can be unsynchronized.
+	const GLbitfield ACCESS = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT
+		| GL_MAP_UNSYNCHRONIZED_BIT;
+	std::pair<std::size_t, std::size_t>& vertices = m_staleVertices[m_ringRegion];
+	if(vertices.first < vertices.second)
+	{
+		const std::size_t stride = floatsPerVertex * sizeof(float);
+		std::size_t length = (vertices.second - vertices.first) * stride;
+		void* mapped = m_context->mapBufferRange(GL_ARRAY_BUFFER,
+			m_ringRegion * m_data.size() * sizeof(float) + vertices.first * stride, length, ACCESS);
+		std::memcpy(mapped, &m_data[vertices.first * floatsPerVertex], length);
+		m_context->unmapBuffer(GL_ARRAY_BUFFER);
+		vertices = std::make_pair(0, 0);
+	}
+	std::pair<std::size_t, std::size_t>& indices = m_staleIndices[m_ringRegion];
+	if(indices.first < indices.second)
+	{
+		const std::size_t size = indexSize(m_indexType);
+		void* mapped = m_context->mapBufferRange(GL_ELEMENT_ARRAY_BUFFER,
+			(m_ringRegion * m_indexCount + indices.first) * size,
+			(indices.second - indices.first) * size, ACCESS);
+		writeIndices(&m_indices[indices.first], indices.second - indices.first, m_indexType, mapped);
+		m_context->unmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+		indices = std::make_pair(0, 0);
+	}
+}
+
+BoundingBox
+Mesh::getLocalBoundingBox() const
+{
+	return m_localBox;
+}
+
+BoundingSphere
+Mesh::getLocalBoundingSphere() const
+{
+	return m_localSphere;
+}
+
+BoundingBox
+Mesh::getWorldBoundingBox() const
+{
+	updateWorldBounds();
+	return m_worldBox;
+}
+
+BoundingSphere
+Mesh::getWorldBoundingSphere() const
+{
+	updateWorldBounds();
+	return m_worldSphere;
+}
+
+void
+Mesh::updateWorldBounds() const
+{
+	if(!m_worldBoundsStale)
+	{
+		return;
+	}
+	Matrix3 linear = m_world.getOrientation();
+	Vector3 position = m_world.getPosition();
+
+	// Each world axis of the box reaches as far as the local half extents,
+	//   carried by the absolute values of the matrix.
+	Vector3 center = (m_localBox.m_min + m_localBox.m_max) / 2.0f;
+	Vector3 halfExtent = (m_localBox.m_max - m_localBox.m_min) / 2.0f;
+	Vector3 worldCenter = linear * center + position;
+	Vector3 worldHalfExtent = absolute(linear.getRight()) * halfExtent.m_x
+		+ absolute(linear.getUp()) * halfExtent.m_y
+		+ absolute(linear.getBack()) * halfExtent.m_z;
+	m_worldBox.m_min = worldCenter - worldHalfExtent;
+	m_worldBox.m_max = worldCenter + worldHalfExtent;
+
+	m_worldSphere.m_center = linear * m_localSphere.m_center + position;
+	m_worldSphere.m_radius = m_localSphere.m_radius * largestStretch(linear);
+	m_worldBoundsStale = false;
+}
+
+bool
+Mesh::raycast(const Ray& ray, float maxDistance, RayHit& hit) const
+{
+	if(!m_pickable)
+	{
+		return false;
+	}
+	BoundingSphere sphere = getWorldBoundingSphere();
+	Vector3 toCenter = sphere.m_center - ray.m_origin;
+	float along = toCenter.dot(ray.m_direction);
+	float missBy = toCenter.dot(toCenter) - along * along;
+	if(missBy > sphere.m_radius * sphere.m_radius || along < -sphere.m_radius
+		|| along - sphere.m_radius >= maxDistance)
+	{
+		return false;
+	}
+
+	// The world matrix is affine, so the ray's t is the same in local
+	//   coordinates as long as its direction is carried along unnormalized.
+	Matrix3 toLocal = m_world.getOrientation();
+	toLocal.invert();
+	Ray localRay = { toLocal * (ray.m_origin - m_world.getPosition()), toLocal * ray.m_direction };
+	return intersectBvh(m_bvh, localRay, maxDistance, hit);
+}
+
 Transform
 Mesh::getWorld() const
 {
@@ -92,111 +1156,202 @@ void
 Mesh::moveRight(float distance)
 {
 	m_world.moveRight(distance);
+	m_worldBoundsStale = true;
 }
 
 void
 Mesh::moveUp(float distance)
 {
 	m_world.moveUp(distance);
+	m_worldBoundsStale = true;
 }
 
 void
 Mesh::moveBack(float distance)
 {
 	m_world.moveBack(distance);
+	m_worldBoundsStale = true;
 }
 
 void
 Mesh::moveLocal(float distance, const Vector3& localDirection)
 {
 	m_world.moveLocal(distance, localDirection);
+	m_worldBoundsStale = true;
 }
 
 void
 Mesh::moveWorld(float distance, const Vector3& worldDirection)
 {
 	m_world.moveWorld(distance, worldDirection);
+	m_worldBoundsStale = true;
 }
 
 void
 Mesh::pitch(float angleDegrees)
 {
 	m_world.pitch(angleDegrees);
+	m_worldBoundsStale = true;
 }
 
 void
 Mesh::yaw(float angleDegrees)
 {
 	m_world.yaw(angleDegrees);
+	m_worldBoundsStale = true;
 }
 
 void
 Mesh::roll(float angleDegrees)
 {
 	m_world.roll(angleDegrees);
+	m_worldBoundsStale = true;
 }
 
 void
 Mesh::rotateLocal(float angleDegrees, const Vector3& axis)
 {
 	m_world.rotateLocal(angleDegrees, axis);
+	m_worldBoundsStale = true;
 }
 
 void
 Mesh::alignWithWorldY()
 {
 	m_world.alignWithWorldY();
+	m_worldBoundsStale = true;
 }
 
 void
 Mesh::scaleLocal(float scale)
 {
 	m_world.scaleLocal(scale);
+	m_worldBoundsStale = true;
 }
 
 void
 Mesh::scaleLocal(float scaleX, float scaleY, float scaleZ)
 {
 	m_world.scaleLocal(scaleX, scaleY, scaleZ);
+	m_worldBoundsStale = true;
 }
 
 void
 Mesh::shearLocalXByYz(float shearY, float shearZ)
 {
 	m_world.shearLocalXByYz(shearY, shearZ);
+	m_worldBoundsStale = true;
 }
 
 void
 Mesh::shearLocalYByXz(float shearX, float shearZ)
 {
 	m_world.shearLocalYByXz(shearX, shearZ);
+	m_worldBoundsStale = true;
 }
 
 void
 Mesh::shearLocalZByXy(float shearX, float shearY)
 {
 	m_world.shearLocalZByXy(shearX, shearY);
+	m_worldBoundsStale = true;
 }
 
 void
 Mesh::scaleWorld(float scale)
 {
 	m_world.scaleWorld(scale);
+	m_worldBoundsStale = true;
 }
 
 unsigned int
 Mesh::getFloatsPerVertex() const
 {
-	return 3;
+	return m_layout.m_floatsPerVertex;
+}
+
+VertexAttribute
+Mesh::getVertexAttribute() const
+{
+	return m_layout.m_attribute;
+}
+
+const VertexLayoutDescription&
+Mesh::getVertexLayout() const
+{
+	return m_layout;
 }
 
 void
 Mesh::enableAttributes()
-{	
-  const GLint POSITION_ATTRIB_INDEX = 0;
-	const GLsizei VERTEX_STRIDE = 6 * sizeof(float);
+{
+	if(m_format.m_position == PositionFormat::FLOAT32
+		&& m_format.m_attribute == AttributeFormat::FLOAT32)
+	{
+		const GLsizei VERTEX_STRIDE = m_layout.m_floatsPerVertex * sizeof(float);
+		for(unsigned int attribute = 0; attribute < m_layout.m_bindingCount; ++attribute)
+		{
+			const AttributeBinding& binding = m_layout.m_bindings[attribute];
+			m_context->enableVertexAttribArray(binding.m_location);
+			m_context->vertexAttribPointer(binding.m_location, binding.m_floats, GL_FLOAT,
+				GL_FALSE, VERTEX_STRIDE,
+				reinterpret_cast<void*>(binding.m_offset * sizeof(float)));
+		}
+		return;
+	}
+
+	// Packed vertices are a position and one color or normal, as
+	//   encodeVertices writes them.
+	const VertexAttribute attribute = m_layout.m_attribute;
+	const GLsizei VERTEX_STRIDE = packedVertexStride(m_format);
+	const GLintptr ATTRIBUTE_OFFSET = packedAttributeOffset(m_format);
+	assert(attribute != VertexAttribute::NONE);
+	assert(attribute == VertexAttribute::COLOR
+		? m_format.m_attribute == AttributeFormat::FLOAT32
+			|| m_format.m_attribute == AttributeFormat::UNORM8
+		: m_format.m_attribute != AttributeFormat::UNORM8);
 
-	m_context->enableVertexAttribArray(POSITION_ATTRIB_INDEX);
-	m_context->vertexAttribPointer(POSITION_ATTRIB_INDEX, 3, GL_FLOAT, GL_FALSE,
+	// Quantized positions lie in [-1, 1] and are scaled back by draw.
+	GLenum type = GL_FLOAT;
+	GLboolean normalized = GL_FALSE;
+	if(m_format.m_position == PositionFormat::HALF_FLOAT)
+	{
+		type = GL_HALF_FLOAT;
+	}
+	else if(m_format.m_position == PositionFormat::SNORM16)
+	{
+		type = GL_SHORT;
+		normalized = GL_TRUE;
+	}
+	m_context->enableVertexAttribArray(PositionAttribute::LOCATION);
+	m_context->vertexAttribPointer(PositionAttribute::LOCATION, 3, type, normalized,
 		VERTEX_STRIDE, reinterpret_cast<void*>(0));
+
+	// Octahedral normals have two parts, which the shader unfolds.
+	const GLuint location = attribute == VertexAttribute::COLOR
+		? ColorAttribute::LOCATION : NormalAttribute::LOCATION;
+	GLint size = 3;
+	type = GL_FLOAT;
+	normalized = GL_TRUE;
+	if(m_format.m_attribute == AttributeFormat::UNORM8)
+	{
+		type = GL_UNSIGNED_BYTE;
+	}
+	else if(m_format.m_attribute == AttributeFormat::OCTAHEDRAL_SNORM16)
+	{
+		size = 2;
+		type = GL_SHORT;
+	}
+	else if(m_format.m_attribute == AttributeFormat::OCTAHEDRAL_SNORM8)
+	{
+		size = 2;
+		type = GL_BYTE;
+	}
+	else
+	{
+		normalized = GL_FALSE;
+	}
+	m_context->enableVertexAttribArray(location);
+	m_context->vertexAttribPointer(location, size, type, normalized, VERTEX_STRIDE,
+		reinterpret_cast<void*>(ATTRIBUTE_OFFSET));
 }
\ No newline at end of file
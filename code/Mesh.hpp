@@ -10,6 +10,8 @@
 /******************************************************************/
 // System includes
 #include <vector>
+#include <cstddef>
+#include <utility>
 
 /******************************************************************/
 // Local includes
@@ -18,6 +20,48 @@
 #include "Vector3.hpp"
 #include "Transform.hpp"
 #include "Matrix4.hpp"
+#include "Geometry.hpp"
+#include "Meshlet.hpp"
+#include "Bvh.hpp"
+#include "Ray.hpp"
+#include "GeometryRegistry.hpp"
+#include "BufferArena.hpp"
+#include "VertexLayout.hpp"
+
+/******************************************************************/
+/// \brief What a Mesh keeps of its geometry on the CPU once prepareVao has
+///   uploaded it.
+enum class GeometryRetention
+{
+  /// Keep the vertex data and indices as they are.
+  KEEP,
+  /// Free them.  Picking still works, since the bounding volume hierarchy
+  ///   keeps its own copy of the triangles.
+  DISCARD,
+  /// Keep them compressed with compressGeometry, so they can still be read
+  ///   back, for example to batch this Mesh with others.
+  COMPRESS
+};
+
+/// \brief How a Mesh's buffers are refilled after updateVertices or
+///   updateIndices.
+enum class StreamingMode
+{
+  /// The buffers are only filled by prepareVao.
+  NONE,
+  /// Each draw after a change respecifies the changed buffers, so the driver
+  ///   can hand back fresh storage instead of waiting for draws still
+  ///   reading the old.
+  ORPHAN,
+  /// The buffers hold STREAMING_RING_REGIONS copies of the geometry, drawn in
+  ///   turn.  Each draw after a change moves on to the next copy, waits on
+  ///   the fence of its last draw, and writes only the ranges it is missing.
+  RING
+};
+
+/// The number of copies of the geometry a RING streamed Mesh keeps, so that
+///   the GPU can still be reading two while the third is written.
+const unsigned int STREAMING_RING_REGIONS = 3;
 
 /******************************************************************/
 /// \brief An object that exists in the world, which consists of one or more
@@ -25,15 +69,37 @@
 class Mesh
 {
 public:
-  /// \brief Constructs an empty Mesh with no triangles.
+  /// \brief Constructs an empty Mesh with no triangles, whose vertices are
+  ///   positions alone.
   /// \param context A pointer to an object through which the Mesh will be able
   ///   to make OpenGL calls.
-  /// \post A unique VAO and VBO have been generated for this Mesh and stored
-  ///   for later use.
+  /// \post No OpenGL objects have been made yet.  prepareVao makes only
+  ///   those this Mesh turns out to need.
   Mesh(OpenGLContext* context, ShaderProgram* shader);
 
+  /// \brief Constructs an empty Mesh with no triangles, whose vertices hold
+  ///   some attributes.
+  /// \param context As for the other constructor.
+  /// \param shader The shader program, which reads each attribute from its
+  ///   location.
+  /// The last argument is only there to pick the attributes, for example
+  ///   VertexLayout<PositionAttribute, NormalAttribute, TexCoordAttribute> ().
+  template<typename... Attributes>
+  Mesh (OpenGLContext* context, ShaderProgram* shader, VertexLayout<Attributes...>)
+    : Mesh (context, shader, VertexLayout<Attributes...>::DESCRIPTION)
+  {
+  }
+
+  /// \brief Constructs an empty Mesh with no triangles, from a layout's
+  ///   description.
+  /// \param context As for the other constructors.
+  /// \param shader As for the other constructors.
+  /// \param layout Some VertexLayout's DESCRIPTION.
+  Mesh (OpenGLContext* context, ShaderProgram* shader, const VertexLayoutDescription& layout);
+
   /// \brief Destructs this Mesh.
-  /// \post The VAO and VBO associated with this Mesh have been deleted.
+  /// \post The VAO, VBO, and IBO associated with this Mesh have been deleted,
+  ///   or handed back to the registry they came from.
   virtual ~Mesh();
 
   /// \brief Copy constructor removed because you shouldn't be copying Meshes.
@@ -46,15 +112,76 @@ public:
 
   /// \brief Adds the geometry of [additional] triangles to this Mesh.
   /// \param[in] geometry A collection of vertex data for 1 or more triangles.
-  ///   Each vertex must contain interleaved 3-D position and 3-D color data
-  ///   (X, Y, Z, R, G, B) and the vector must contain complete triangles (3
-  ///   vertices each).
+  ///   Each vertex must be laid out as this Mesh's VertexLayout says, for
+  ///   example (X, Y, Z, R, G, B) for a ColorsLayout, and the vector must
+  ///   contain complete triangles (3 vertices each).
   /// \pre This Mesh has not yet been prepared.
   /// \post The geometry has been appended to this Mesh's internal geometry
   ///   store for future use.
   void
   addGeometry(const std::vector<float>& geometry);
 
+  /// \brief Adds the geometry of [additional] triangles to this Mesh, taking
+  ///   over the vector's storage where it can.
+  /// \param[in] geometry As for the other addGeometry.
+  /// \pre This Mesh has not yet been prepared.
+  /// \post If this Mesh had no geometry, it has adopted geometry's buffer
+  ///   without copying it.  Otherwise the geometry has been appended.
+  ///   Either way geometry is left empty.
+  void
+  addGeometry (std::vector<float>&& geometry);
+
+  /// \brief Adds the geometry of [additional] triangles to this Mesh from
+  ///   any contiguous floats, such as an importer's own arrays.
+  /// \param[in] geometry The first float, laid out as for the other
+  ///   addGeometry.
+  /// \param[in] floatCount The number of floats.
+  /// \pre This Mesh has not yet been prepared.
+  /// \post The floats have been appended to this Mesh's geometry store.
+  void
+  addGeometry (const float* geometry, std::size_t floatCount);
+
+  /// \brief Makes room for geometry and indices that are about to be added,
+  ///   so that adding them in pieces does not reallocate and copy the
+  ///   stores as they grow.
+  /// \param[in] floatCount The number of floats the geometry store should
+  ///   have room for in all.
+  /// \param[in] indexCount The number of indices the index store should have
+  ///   room for in all.
+  /// \pre This Mesh has not yet been prepared.
+  void
+  reserveGeometry (std::size_t floatCount, std::size_t indexCount);
+
+  /// \brief Makes room for more geometry at the end of this Mesh's geometry
+  ///   store, so that vertex data can be written there directly instead of
+  ///   being built elsewhere and copied in.
+  /// \param[in] floatCount The number of floats to make room for.
+  /// \pre This Mesh has not yet been prepared.
+  /// \return A pointer to the floatCount new floats, for example to pass to
+  ///   writeFaceColors.  It is only valid until the geometry changes again.
+  float*
+  stageGeometry (std::size_t floatCount);
+
+  /// \brief Indexes this Mesh's geometry where it is stored.
+  /// \pre This Mesh has not yet been prepared and has no indices.  Its
+  ///   geometry holds complete, unindexed triangles.
+  /// \post Duplicate vertices have been removed from the geometry, and
+  ///   indices that rebuild the triangles have been added, exactly as if the
+  ///   geometry had been passed through indexData.
+  void
+  indexGeometry ();
+
+  /// \brief Merges vertices of this Mesh that are close enough to look the
+  ///   same, as weldVertices does.
+  /// \param[in] tolerances How far apart positions, normal directions, and
+  ///   colors may be.
+  /// \pre This Mesh has not yet been prepared, is indexed, and has not been
+  ///   stripified.
+  /// \post The geometry and indices have been welded.
+  /// \return How many vertices and triangles were removed.
+  WeldStatistics
+  weldGeometry (const WeldTolerances& tolerances = DEFAULT_WELD_TOLERANCES);
+
   // \brief Adds additional triangles to this Mesh.
   /// \param[in] indices A collection of indices into the vertex buffer for 1
   ///   or more triangles.  There must be 3 indices per triangle.
@@ -64,12 +191,240 @@ public:
   void
   addIndices (const std::vector<unsigned int>& indices);
 
+  /// \brief Adds additional triangles to this Mesh, taking over the
+  ///   vector's storage where it can.
+  /// \param[in] indices As for the other addIndices.
+  /// \pre This Mesh has not yet been prepared.
+  /// \post If this Mesh had no indices, it has adopted indices' buffer
+  ///   without copying it.  Otherwise the indices have been appended.  Either
+  ///   way indices is left empty.
+  void
+  addIndices (std::vector<unsigned int>&& indices);
+
+  /// \brief Adds additional triangles to this Mesh from any contiguous
+  ///   indices.
+  /// \param[in] indices The first index.  There must be 3 per triangle.
+  /// \param[in] indexCount The number of indices.
+  /// \pre This Mesh has not yet been prepared.
+  /// \post The indices have been appended to this Mesh's index store.
+  void
+  addIndices (const unsigned int* indices, std::size_t indexCount);
+
+  /// \brief Groups this Mesh's triangles into meshlets, so that draw can
+  ///   skip the ones the camera cannot see.
+  /// \param[in] maxVertices The most vertices any meshlet may use.
+  /// \param[in] maxTriangles The most triangles any meshlet may hold.
+  /// \pre This Mesh has not yet been prepared, is indexed, and has not been
+  ///   stripified.  Its geometry starts each vertex with a position.
+  /// \post The indices hold the same triangles, in meshlet order.
+  /// \post Each draw will draw only the meshlets that pass frustum and normal
+  ///   cone culling.  If this Mesh keeps its geometry, prepareVao makes the
+  ///   IBO dynamic and draw fills it with them; otherwise draw draws them
+  ///   from a static IBO a run at a time.
+  /// \return False, changing nothing, if this Mesh streams its geometry.
+  bool
+  buildMeshlets (unsigned int maxVertices = MAX_MESHLET_VERTICES,
+                 unsigned int maxTriangles = MAX_MESHLET_TRIANGLES);
+
+  /// \brief Turns this Mesh's triangle list into triangle strips, so that
+  ///   draw needs fewer indices.
+  /// \pre This Mesh has not yet been prepared, is indexed, and has no
+  ///   meshlets.
+  /// \post The indices hold strips separated by STRIP_RESTART_INDEX, and draw
+  ///   will draw them as GL_TRIANGLE_STRIP with primitive restart enabled.
+  /// \return The number of indices saved.
+  /// This pays off most on grids, such as height fields, where strips follow
+  ///   whole rows.
+  std::size_t
+  stripify ();
+
+  /// \brief Appends another Mesh's triangles to this Mesh, moved by both
+  ///   world matrices into this Mesh's local coordinates, so that the two
+  ///   draw as one.
+  /// \param[in] other The Mesh to copy triangles from, which must have the
+  ///   same vertex layout as this Mesh and no meshlets.  It may already be
+  ///   prepared, unless it discarded its geometry.
+  /// \pre This Mesh has not yet been prepared, is indexed, and has no
+  ///   meshlets.
+  /// \post Other's positions have been transformed, and its normals, if any,
+  ///   have been transformed by the inverse-transpose and renormalized.
+  ///   Colors are copied unchanged.
+  /// \post Other's indices have been offset past this Mesh's vertices.  Both
+  ///   Meshes' strips, if any, have been turned back into triangle lists, and
+  ///   triangles that other's world matrix mirrors have been rewound.
+  void
+  appendStaticGeometry (const Mesh& other);
+
+  /// \brief Marks whether this Mesh never moves, so that
+  ///   Scene::batchStaticMeshes may merge it with others.
+  /// \param[in] isStatic Whether this Mesh is static.
+  void
+  setStatic (bool isStatic);
+
+  /// \brief Gets whether this Mesh never moves.
+  /// \return Whatever was last passed to setStatic, or false.
+  bool
+  isStatic () const;
+
+  /// \brief Marks whether this Mesh can be hit by raycast, and so by
+  ///   Scene::pickMesh.
+  /// \param[in] pickable Whether prepareVao should build the bounding volume
+  ///   hierarchy raycast needs, which holds a copy of every triangle.
+  /// \pre This Mesh has not yet been prepared.
+  /// \return False, changing nothing, if pickable is true and this Mesh
+  ///   streams its geometry, since streamed updates do not rebuild the
+  ///   hierarchy.
+  bool
+  setPickable (bool pickable);
+
+  /// \brief Gets whether this Mesh can be hit by raycast.
+  /// \return Whatever was last passed to setPickable, or false.
+  bool
+  isPickable () const;
+
+  /// \brief Gets the shader program this Mesh is drawn with.
+  /// \return The shader program passed to the constructor.
+  ShaderProgram*
+  getShader () const;
+
+  /// \brief Gets this Mesh's meshlets.
+  /// \return The meshlets made by buildMeshlets, or none.  Unless this Mesh
+  ///   keeps its geometry, their indices are freed by prepareVao.
+  const MeshletSet&
+  getMeshlets () const;
+
+  /// \brief Chooses how this Mesh's vertices are stored in its VBO.
+  /// \param[in] format The position format, and the format of the second
+  ///   attribute.  Colors may only use FLOAT32 or UNORM8, and normals may not
+  ///   use UNORM8.
+  /// \pre This Mesh has not yet been prepared.
+  /// \post prepareVao will pack the geometry with encodeVertices, and draw
+  ///   will undo any position quantization as part of the model-view matrix.
+  /// The geometry itself is always added as floats.  The default is FLOAT32
+  ///   for both, which uploads it unchanged.
+  /// \return False, changing nothing, if the format is not FLOAT32 for both
+  ///   and this Mesh streams its geometry.
+  bool
+  setVertexFormat (const VertexFormat& format);
+
+  /// \brief Gets how this Mesh's vertices are stored in its VBO.
+  /// \return The format chosen with setVertexFormat.
+  VertexFormat
+  getVertexFormat () const;
+
+  /// \brief Lets this Mesh share its VBO and IBO with other Meshes whose
+  ///   geometry is identical.
+  /// \param[in] registry The registry the buffers are kept in, which must
+  ///   outlive this Mesh, or nullptr to always use buffers of its own.
+  /// \pre This Mesh has not yet been prepared.
+  /// \post prepareVao will take its buffers from the registry, uploading
+  ///   only if no identical geometry in the same format is already there.
+  ///   Meshes with meshlets always keep buffers of their own.
+  /// \return False, changing nothing, if registry is not nullptr and this
+  ///   Mesh has an arena or streams its geometry.
+  bool
+  setGeometryRegistry (GeometryRegistry* registry);
+
+  /// \brief Chooses what this Mesh keeps of its geometry on the CPU after
+  ///   prepareVao.
+  /// \param[in] retention Whether to keep, discard, or compress it.  The
+  ///   default is KEEP.
+  /// \pre This Mesh has not yet been prepared.
+  /// \return False, changing nothing, if retention is not KEEP and this Mesh
+  ///   streams its geometry.
+  bool
+  setGeometryRetention (GeometryRetention retention);
+
+  /// \brief Gets what this Mesh keeps of its geometry after prepareVao.
+  /// \return The retention chosen with setGeometryRetention.
+  GeometryRetention
+  getGeometryRetention () const;
+
+  /// \brief Gets how much memory this Mesh's CPU copy of its geometry takes.
+  /// \return The bytes allocated for vertex data and indices, compressed or
+  ///   not, for meshlets and their indices, and for the bounding volume
+  ///   hierarchy.
+  std::size_t
+  getRetainedBytes () const;
+
+  /// \brief Lets this Mesh's geometry change after it has been prepared.
+  /// \param[in] mode How changed geometry reaches the buffers.  The default
+  ///   is NONE.
+  /// \pre This Mesh has not yet been prepared.
+  /// \return False, changing nothing, if mode is not NONE and this Mesh has
+  ///   meshlets, a vertex format other than FLOAT32, a registry, an arena, or
+  ///   a retention other than KEEP, or is pickable.  Streamed updates are
+  ///   written into the kept float geometry, and into buffers no other Mesh
+  ///   uses, but not into a bounding volume hierarchy.
+  bool
+  setStreaming (StreamingMode mode);
+
+  /// \brief Gets how changed geometry reaches this Mesh's buffers.
+  /// \return The mode chosen with setStreaming.
+  StreamingMode
+  getStreaming () const;
+
+  /// \brief Replaces some of this Mesh's vertices.
+  /// \param[in] firstVertex The first vertex to replace.
+  /// \param[in] vertices The new vertex data, a whole number of vertices.
+  /// \pre This Mesh has been prepared with a StreamingMode other than NONE,
+  ///   and already has every vertex being replaced.
+  /// \post The local bounds have grown to hold the new vertices, though they
+  ///   never shrink.  The next draw uploads the change, unless the GPU is
+  ///   still reading the ring region it would go to, in which case a later
+  ///   draw does.
+  void
+  updateVertices (std::size_t firstVertex, const std::vector<float>& vertices);
+
+  /// \brief Replaces some of this Mesh's indices.
+  /// \param[in] firstIndex The first index to replace.
+  /// \param[in] indices The new indices, which must address existing
+  ///   vertices.
+  /// \pre This Mesh has been prepared with a StreamingMode other than NONE,
+  ///   and already has every index being replaced.
+  /// \post The next draw uploads the change.
+  void
+  updateIndices (std::size_t firstIndex, const std::vector<unsigned int>& indices);
+
+  /// \brief Lets this Mesh keep its geometry in large buffers shared with
+  ///   other Meshes of the same vertex layout, instead of a VAO, VBO, and IBO
+  ///   of its own.
+  /// \param[in] arena The arena the buffers are kept in, which must outlive
+  ///   this Mesh, or nullptr to always use buffers of its own.
+  /// \pre This Mesh has not yet been prepared.
+  /// \post prepareVao will put the geometry in the arena, and draw will draw
+  ///   it with a base-vertex offset through the arena's vertex array.
+  ///   Meshes with meshlets always keep buffers of their own.
+  /// \return False, changing nothing, if arena is not nullptr and this Mesh
+  ///   has a registry or streams its geometry.
+  bool
+  setBufferArena (BufferArena* arena);
+
+  /// \brief Gets whether this Mesh's geometry is in a BufferArena.
+  /// \return True if prepareVao put the geometry in an arena.
+  bool
+  usesBufferArena () const;
+
+  /// \brief Gets whether this Mesh's VBO and IBO came from a registry.
+  /// \return True if prepareVao took the buffers from a GeometryRegistry.
+  bool
+  sharesGeometry () const;
+
   /// \brief Copies this Mesh's geometry into this Mesh's VBO and sets up its
   ///   VAO.
   /// \pre This Mesh has not yet been prepared.
-  /// \post The first two vertex attributes have been enabled, with
-  ///   interleaved 3-part positions and 3-part colors.
+  /// \post This Mesh has made a VAO unless it is in an arena, and a VBO and
+  ///   IBO unless it is in an arena or shares them through a registry.
+  /// \post Each attribute of the vertex layout has been enabled at its
+  ///   location, with the stride and offsets the layout worked out.
   /// \post This Mesh's geometry has been copied to its VBO.
+  /// \post This Mesh's indices have been copied to its IBO as the smallest of
+  ///   GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, and GL_UNSIGNED_INT that can
+  ///   address every vertex, which draw will then use.
+  /// \post If this Mesh is pickable, a bounding volume hierarchy over its
+  ///   triangles has been built for raycast.
+  /// \post The CPU copy of the geometry has been kept, freed, or compressed,
+  ///   as chosen with setGeometryRetention.
   void
   prepareVao();
 
@@ -82,10 +437,56 @@ public:
   ///   to set the projection matrix alone.
   /// \pre This Mesh has been prepared.
   /// \post While the ShaderProgram was enabled, the viewMatrix has been set as
-  ///   the "uModelView" uniform matrix and the geometry has been drawn.
+  ///   the "uModelView" uniform matrix, "uOctahedralNormals" has been set to
+  ///   whether normals are octahedral encoded, and the geometry has been
+  ///   drawn.
   void
   draw(const Transform& viewMatrix,  const Matrix4& projectionMatrix);
 
+  /// \brief Gets the box around this Mesh in its own coordinates.
+  /// \pre This Mesh has been prepared.
+  /// \return The box around every vertex as of prepareVao.
+  BoundingBox
+  getLocalBoundingBox () const;
+
+  /// \brief Gets the sphere around this Mesh in its own coordinates.
+  /// \pre This Mesh has been prepared.
+  /// \return The sphere around every vertex as of prepareVao.
+  BoundingSphere
+  getLocalBoundingSphere () const;
+
+  /// \brief Gets an axis-aligned box around this Mesh in world coordinates.
+  /// \pre This Mesh has been prepared.
+  /// \return The smallest world box that holds the local box, moved by the
+  ///   world matrix.
+  /// It is only recomputed the first time it is asked for after the mesh
+  ///   moves.
+  BoundingBox
+  getWorldBoundingBox () const;
+
+  /// \brief Gets a sphere around this Mesh in world coordinates.
+  /// \pre This Mesh has been prepared.
+  /// \return The local sphere, moved by the world matrix and grown by the
+  ///   most it stretches any direction.
+  /// It is only recomputed the first time it is asked for after the mesh
+  ///   moves.
+  BoundingSphere
+  getWorldBoundingSphere () const;
+
+  /// \brief Finds where a ray first hits this Mesh.
+  /// \param[in] ray The ray, in world coordinates.
+  /// \param[in] maxDistance Hits at or past this distance are ignored.
+  /// \param[out] hit Set to the nearest hit, if there is one, whose distance
+  ///   is in world units.
+  /// \pre This Mesh has been prepared, and the ray's direction is a unit
+  ///   vector.
+  /// \return Whether the ray hits any triangle before maxDistance, which is
+  ///   never the case unless this Mesh is pickable.
+  /// Rays that miss the world bounding sphere are rejected without looking
+  ///   at any triangles.
+  bool
+  raycast (const Ray& ray, float maxDistance, RayHit& hit) const;
+
   /// \brief Gets the mesh's world matrix.
   /// \return The world matrix.
   Transform
@@ -206,39 +607,152 @@ public:
 
   /// \brief Gets the number of floats used to represent each vertex.
   /// \return The number of floats used for each vertex.
-  virtual unsigned int
+  unsigned int
   getFloatsPerVertex () const;
 
+  /// \brief Gets what follows the position of each vertex.
+  /// \return What the welder should treat the attribute as.
+  VertexAttribute
+  getVertexAttribute () const;
+
+  /// \brief Gets the attributes in each vertex.
+  const VertexLayoutDescription&
+  getVertexLayout () const;
+
 protected:
+  /// A pointer to the object through which this Mesh will make OpenGL calls.
+  OpenGLContext* m_context;
+
+private:
   /// \brief Enables VAO attributes.
   /// \pre This Mesh's VAO has been bound.
-  /// \post Any attributes (positions, colors, normals, texture coordinates)
-  ///   have been enabled and configured.
+  /// \post Every attribute in m_layout has been enabled and pointed at its
+  ///   place in the VBO, as stored in m_format.
   /// This should only be called from the middle of prepareVao().
-  virtual void
-  enableAttributes();
+  void
+  enableAttributes ();
 
-  /// A pointer to the object through which this Mesh will make OpenGL calls.
-  OpenGLContext* m_context;
+  /// \brief Draws this Mesh's first indices from its IBO, at its arena
+  ///   offsets if it is in an arena.
+  /// \param[in] mode GL_TRIANGLES or GL_TRIANGLE_STRIP.
+  /// \param[in] count The number of indices.
+  /// \pre This Mesh's VAO is bound.
+  void
+  drawIndices (GLenum mode, std::size_t count);
+
+  /// \brief Draws the meshlets that might be seen straight from the IBO,
+  ///   with one call for each run of them that lies back to back.
+  /// \param[in] frustum The view volume, in local coordinates.
+  /// \param[in] camera The camera's position, in local coordinates.
+  /// \pre This Mesh's VAO is bound, and its IBO holds the meshlets' indices.
+  void
+  drawMeshletRuns (const Frustum& frustum, const Vector3& camera);
+
+  /// \brief Uploads whatever updateVertices and updateIndices have changed
+  ///   since the last draw.
+  /// \pre This Mesh's VAO is bound.
+  void
+  uploadStreamedGeometry ();
+
+  /// \brief Makes a VAO, VBO, and IBO of this Mesh's own, and binds the VAO.
+  /// This should only be called from the middle of prepareVao().
+  void
+  generateObjects ();
+
+  /// \brief Frees or compresses the CPU copy of this Mesh's geometry, as
+  ///   m_retention says.
+  /// This should only be called from the end of prepareVao().
+  void
+  retainGeometry ();
+
+  /// \brief Recomputes m_worldBox and m_worldSphere if m_world has changed
+  ///   since they were last computed.
+  void
+  updateWorldBounds () const;
 
-private:
   /// A pointer to the shader program being used by this Mesh.
   ShaderProgram* m_shader;
-  /// This Mesh's VAO.
+  /// This Mesh's VAO, or 0 until prepareVao.
   GLuint m_vao;
-  /// This Mesh's VBO.
+  /// This Mesh's VBO, or 0 until prepareVao.
   GLuint m_vbo;
-  /// This Mesh's IBO.
+  /// This Mesh's IBO, or 0 until prepareVao.
   GLuint m_ibo;
   /// This Mesh's geometry data.
   std::vector<float> m_data;
   /// This Mesh's indices for accessing geometry data.
   std::vector<unsigned int> m_indices;
+  /// The number of indices uploaded, which draw uses even once m_indices has
+  ///   been freed.
+  std::size_t m_indexCount;
+  /// What is kept of m_data and m_indices after prepareVao.
+  GeometryRetention m_retention;
+  /// m_data and m_indices, if they were compressed after prepareVao.
+  CompressedGeometry m_compressed;
+  /// The type the indices were uploaded to the IBO as.
+  GLenum m_indexType;
+  /// How the indices are drawn: GL_TRIANGLES, or GL_TRIANGLE_STRIP with
+  ///   primitive restart.
+  GLenum m_primitive;
+  /// This Mesh's meshlets, if it is culled by meshlet.
+  MeshletSet m_meshlets;
+  /// The bounding volume hierarchy over this Mesh's triangles, in local
+  ///   coordinates, used by raycast.
+  Bvh m_bvh;
+  /// The indices of the meshlets visible in the last draw.  Kept between
+  ///   draws so that culling does not allocate.
+  std::vector<unsigned int> m_visibleIndices;
+  /// The attributes in each vertex of m_data.
+  VertexLayoutDescription m_layout;
+  /// How this Mesh's vertices are stored in its VBO.
+  VertexFormat m_format;
+  /// Maps quantized positions back to local coordinates; identity unless
+  ///   positions are quantized.
+  Transform m_dequantization;
   /// Whether or not this Mesh has been prepared.
   bool m_prepared;
+  /// Whether this Mesh never moves and may be batched with others.
+  bool m_static;
+  /// Whether m_bvh is built, so that raycast can hit this Mesh.
+  bool m_pickable;
+  /// The registry to share buffers through, if any.
+  GeometryRegistry* m_registry;
+  /// How changed geometry reaches the buffers.
+  StreamingMode m_streaming;
+  /// The ring region drawn from.
+  unsigned int m_ringRegion;
+  /// The vertices, as [first, last), that each ring region (or, when
+  ///   orphaning, the only buffer) has yet to be sent.
+  std::pair<std::size_t, std::size_t> m_staleVertices[STREAMING_RING_REGIONS];
+  /// The indices, as [first, last), that each ring region has yet to be sent.
+  std::pair<std::size_t, std::size_t> m_staleIndices[STREAMING_RING_REGIONS];
+  /// The fence after the last draw from each ring region, or nullptr.
+  GLsync m_fences[STREAMING_RING_REGIONS];
+  /// Whether anything has changed that has not yet been uploaded.
+  bool m_streamPending;
+  /// Whether m_vbo and m_ibo belong to m_registry rather than this Mesh.
+  bool m_sharesGeometry;
+  /// The arena to keep geometry in, if any.
+  BufferArena* m_arena;
+  /// Where the geometry is in m_arena, once it has been put there.
+  ArenaAllocation m_allocation;
+  /// Whether m_vao, m_vbo, and m_ibo belong to m_arena rather than this
+  ///   Mesh.
+  bool m_usesArena;
   /// Transform object that contains matrix converting from mesh local
   ///   to world coordinates.
   Transform m_world;
+  /// The box around this Mesh's vertices, in local coordinates.
+  BoundingBox m_localBox;
+  /// The sphere around this Mesh's vertices, in local coordinates.
+  BoundingSphere m_localSphere;
+  /// The box around this Mesh, in world coordinates, if it is up to date.
+  mutable BoundingBox m_worldBox;
+  /// The sphere around this Mesh, in world coordinates, if it is up to date.
+  mutable BoundingSphere m_worldSphere;
+  /// Whether m_world has changed since m_worldBox and m_worldSphere were
+  ///   computed.
+  mutable bool m_worldBoundsStale;
 };
 
 #endif //MESH_HPP
@@ -0,0 +1,449 @@
+/// \file MeshOptimizer.cpp
+/// \brief Definitions of global functions that reorder indexed meshes so the
+///   GPU can draw them faster, and of the metrics used to measure them.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// System includes
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+
+/******************************************************************/
+// Local includes
+#include "MeshOptimizer.hpp"
+
+/******************************************************************/
+VertexAdjacency
+buildVertexAdjacency (const std::vector<unsigned int>& indices, unsigned int vertexCount)
+{
+  VertexAdjacency adjacency;
+  adjacency.m_begins.assign (vertexCount + 1, 0);
+  for (unsigned int index : indices)
+  {
+    assert (index < vertexCount);
+    adjacency.m_begins[index + 1]++;
+  }
+  for (unsigned int vertex = 0; vertex < vertexCount; vertex++)
+  {
+    adjacency.m_begins[vertex + 1] += adjacency.m_begins[vertex];
+  }
+  adjacency.m_triangles.resize (indices.size ());
+  std::vector<unsigned int> next (adjacency.m_begins.begin (), adjacency.m_begins.end () - 1);
+  for (unsigned int corner = 0; corner < indices.size (); corner++)
+  {
+    adjacency.m_triangles[next[indices[corner]]++] = corner / 3;
+  }
+  return adjacency;
+}
+
+std::vector<unsigned int>
+optimizeVertexCache (const std::vector<unsigned int>& indices, unsigned int vertexCount,
+                     unsigned int cacheSize)
+{
+  assert (indices.size () % 3 == 0);
+  const unsigned int triangleCount = indices.size () / 3;
+  VertexAdjacency adjacency = buildVertexAdjacency (indices, vertexCount);
+
+  // How many not-yet-emitted triangles use each vertex.
+  std::vector<unsigned int> liveTriangles (vertexCount);
+  for (unsigned int vertex = 0; vertex < vertexCount; vertex++)
+  {
+    liveTriangles[vertex] = adjacency.m_begins[vertex + 1] - adjacency.m_begins[vertex];
+  }
+  // When each vertex last entered the simulated cache.  A vertex is cached
+  //   while time - cachedAt < cacheSize, so starting time past cacheSize
+  //   makes every vertex start out uncached.
+  std::vector<unsigned int> cachedAt (vertexCount, 0);
+  unsigned int time = cacheSize + 1;
+  std::vector<bool> emitted (triangleCount, false);
+  // Recently used vertices to restart from when a fan runs out of neighbors.
+  std::vector<unsigned int> deadEnds;
+  std::vector<unsigned int> candidates;
+  unsigned int nextInOrder = 0;
+
+  std::vector<unsigned int> optimized;
+  optimized.reserve (indices.size ());
+  bool done = triangleCount == 0;
+  unsigned int fan = 0;
+  while (!done)
+  {
+    // Emit every remaining triangle around the current fan vertex.
+    candidates.clear ();
+    for (unsigned int slot = adjacency.m_begins[fan]; slot < adjacency.m_begins[fan + 1]; slot++)
+    {
+      unsigned int triangle = adjacency.m_triangles[slot];
+      if (emitted[triangle])
+      {
+        continue;
+      }
+      emitted[triangle] = true;
+      for (unsigned int corner = 0; corner < 3; corner++)
+      {
+        unsigned int vertex = indices[triangle * 3 + corner];
+        optimized.push_back (vertex);
+        deadEnds.push_back (vertex);
+        candidates.push_back (vertex);
+        liveTriangles[vertex]--;
+        if (time - cachedAt[vertex] > cacheSize)
+        {
+          cachedAt[vertex] = time;
+          time++;
+        }
+      }
+    }
+
+    // Prefer the vertex that entered the cache earliest, as long as fanning
+    //   around it will not push it back out of the cache first.
+    const unsigned int NONE = static_cast<unsigned int> (-1);
+    unsigned int best = NONE;
+    int bestPriority = -1;
+    for (unsigned int vertex : candidates)
+    {
+      if (liveTriangles[vertex] == 0)
+      {
+        continue;
+      }
+      int priority = 0;
+      if (time - cachedAt[vertex] + 2 * liveTriangles[vertex] <= cacheSize)
+      {
+        priority = static_cast<int> (time - cachedAt[vertex]);
+      }
+      if (priority > bestPriority)
+      {
+        best = vertex;
+        bestPriority = priority;
+      }
+    }
+
+    // Otherwise back up to a recently used vertex, or failing that move on to
+    //   the next vertex in index order that still has triangles.
+    while (best == NONE && !deadEnds.empty ())
+    {
+      unsigned int vertex = deadEnds.back ();
+      deadEnds.pop_back ();
+      if (liveTriangles[vertex] > 0)
+      {
+        best = vertex;
+      }
+    }
+    while (best == NONE && nextInOrder < vertexCount)
+    {
+      if (liveTriangles[nextInOrder] > 0)
+      {
+        best = nextInOrder;
+      }
+      nextInOrder++;
+    }
+    done = best == NONE;
+    fan = best;
+  }
+  assert (optimized.size () == indices.size ());
+  return optimized;
+}
+
+VertexCacheStatistics
+analyzeVertexCache (const std::vector<unsigned int>& indices, unsigned int vertexCount,
+                    unsigned int cacheSize)
+{
+  // Vertex v is cached while it is one of the last cacheSize misses, where
+  //   missNumber[v] is 1 + the number of misses before it last went in.
+  std::vector<unsigned int> missNumber (vertexCount, 0);
+  std::vector<bool> referenced (vertexCount, false);
+  unsigned int misses = 0;
+  unsigned int distinct = 0;
+  for (unsigned int index : indices)
+  {
+    assert (index < vertexCount);
+    if (missNumber[index] == 0 || misses - missNumber[index] >= cacheSize)
+    {
+      misses++;
+      missNumber[index] = misses;
+    }
+    if (!referenced[index])
+    {
+      referenced[index] = true;
+      distinct++;
+    }
+  }
+  VertexCacheStatistics statistics;
+  statistics.m_misses = misses;
+  statistics.m_acmr = indices.size () < 3 ? 0.0f : static_cast<float> (misses) / (indices.size () / 3);
+  statistics.m_atvr = distinct == 0 ? 0.0f : static_cast<float> (misses) / distinct;
+  return statistics;
+}
+
+unsigned int
+remapVerticesForFetch (std::vector<float>& data, std::vector<unsigned int>& indices,
+                       unsigned int floatsPerVertex)
+{
+  const unsigned int vertexCount = data.size () / floatsPerVertex;
+  const unsigned int UNUSED = static_cast<unsigned int> (-1);
+  std::vector<unsigned int> newIndexOf (vertexCount, UNUSED);
+  unsigned int used = 0;
+  for (unsigned int& index : indices)
+  {
+    assert (index < vertexCount);
+    if (newIndexOf[index] == UNUSED)
+    {
+      newIndexOf[index] = used++;
+    }
+    index = newIndexOf[index];
+  }
+  std::vector<float> remapped (static_cast<std::size_t> (used) * floatsPerVertex);
+  for (unsigned int vertex = 0; vertex < vertexCount; vertex++)
+  {
+    if (newIndexOf[vertex] != UNUSED)
+    {
+      std::copy (data.begin () + static_cast<std::size_t> (vertex) * floatsPerVertex,
+                 data.begin () + static_cast<std::size_t> (vertex + 1) * floatsPerVertex,
+                 remapped.begin () + static_cast<std::size_t> (newIndexOf[vertex]) * floatsPerVertex);
+    }
+  }
+  data.swap (remapped);
+  return used;
+}
+
+VertexFetchStatistics
+analyzeVertexFetch (const std::vector<unsigned int>& indices, unsigned int vertexCount,
+                    unsigned int vertexSize)
+{
+  // The same FIFO bookkeeping as analyzeVertexCache, but over memory lines.
+  const std::size_t bytes = static_cast<std::size_t> (vertexCount) * vertexSize;
+  std::vector<unsigned int> fetchNumber ((bytes + VERTEX_FETCH_LINE_SIZE - 1) / VERTEX_FETCH_LINE_SIZE, 0);
+  std::vector<bool> referenced (vertexCount, false);
+  unsigned int fetches = 0;
+  unsigned int distinct = 0;
+  for (unsigned int index : indices)
+  {
+    assert (index < vertexCount);
+    std::size_t start = static_cast<std::size_t> (index) * vertexSize;
+    std::size_t first = start / VERTEX_FETCH_LINE_SIZE;
+    std::size_t last = (start + vertexSize - 1) / VERTEX_FETCH_LINE_SIZE;
+    for (std::size_t line = first; line <= last; line++)
+    {
+      if (fetchNumber[line] == 0 || fetches - fetchNumber[line] >= VERTEX_FETCH_CACHE_LINES)
+      {
+        fetches++;
+        fetchNumber[line] = fetches;
+      }
+    }
+    if (!referenced[index])
+    {
+      referenced[index] = true;
+      distinct++;
+    }
+  }
+  VertexFetchStatistics statistics;
+  statistics.m_bytesFetched = fetches * VERTEX_FETCH_LINE_SIZE;
+  statistics.m_overfetch = distinct == 0 ? 0.0f
+    : static_cast<float> (statistics.m_bytesFetched) / (static_cast<float> (distinct) * vertexSize);
+  return statistics;
+}
+
+/// \brief Finds where a triangle has an edge between two vertices.
+/// \param[in] corners The triangle's three vertices.
+/// \param[in] from The vertex the edge starts at.
+/// \param[in] to The vertex the edge ends at.
+/// \return The corner the edge starts at (0, 1, or 2), or 3 if the triangle
+///   has no edge from "from" to "to" in its winding order.
+static unsigned int
+findDirectedEdge (const unsigned int* corners, unsigned int from, unsigned int to)
+{
+  for (unsigned int corner = 0; corner < 3; corner++)
+  {
+    if (corners[corner] == from && corners[(corner + 1) % 3] == to)
+    {
+      return corner;
+    }
+  }
+  return 3;
+}
+
+std::vector<unsigned int>
+stripify (const std::vector<unsigned int>& indices, unsigned int vertexCount)
+{
+  assert (indices.size () % 3 == 0);
+  assert (vertexCount < STRIP_RESTART_INDEX);
+  const unsigned int triangleCount = indices.size () / 3;
+  const unsigned int NONE = static_cast<unsigned int> (-1);
+  VertexAdjacency adjacency = buildVertexAdjacency (indices, vertexCount);
+
+  // The triangle across each edge, found by looking for the same edge wound
+  //   the other way.  Edge k of a triangle runs from corner k to corner k + 1.
+  std::vector<unsigned int> across (indices.size (), NONE);
+  std::vector<bool> used (triangleCount, false);
+  for (unsigned int triangle = 0; triangle < triangleCount; triangle++)
+  {
+    const unsigned int* corners = &indices[triangle * 3];
+    if (corners[0] == corners[1] || corners[1] == corners[2] || corners[0] == corners[2])
+    {
+      used[triangle] = true;
+      continue;
+    }
+    for (unsigned int edge = 0; edge < 3; edge++)
+    {
+      unsigned int from = corners[edge];
+      unsigned int to = corners[(edge + 1) % 3];
+      for (unsigned int slot = adjacency.m_begins[to]; slot < adjacency.m_begins[to + 1]; slot++)
+      {
+        unsigned int other = adjacency.m_triangles[slot];
+        if (other != triangle && findDirectedEdge (&indices[other * 3], to, from) < 3)
+        {
+          across[triangle * 3 + edge] = other;
+          break;
+        }
+      }
+    }
+  }
+
+  // Triangles are started from in order of how many unused neighbors they
+  //   have, so strips begin at the edges of the mesh and do not strand
+  //   triangles.  Stale entries in the buckets are skipped when popped.
+  std::vector<unsigned int> liveNeighbors (triangleCount, 0);
+  std::vector<std::vector<unsigned int>> buckets (4);
+  for (unsigned int triangle = triangleCount; triangle-- > 0;)
+  {
+    if (!used[triangle])
+    {
+      for (unsigned int edge = 0; edge < 3; edge++)
+      {
+        unsigned int other = across[triangle * 3 + edge];
+        liveNeighbors[triangle] += other != NONE && !used[other];
+      }
+      buckets[liveNeighbors[triangle]].push_back (triangle);
+    }
+  }
+  auto markUsed = [&] (unsigned int triangle) {
+    used[triangle] = true;
+    for (unsigned int edge = 0; edge < 3; edge++)
+    {
+      unsigned int other = across[triangle * 3 + edge];
+      if (other != NONE && !used[other])
+      {
+        buckets[--liveNeighbors[other]].push_back (other);
+      }
+    }
+  };
+
+  // Walks a strip whose first triangle ends with vertices b and c, calling
+  //   visit with each further triangle and the vertex it adds.  The walk
+  //   stops at a used triangle or one already visited on this walk.
+  std::vector<unsigned int> visitedOn (triangleCount, 0);
+  unsigned int walk = 0;
+  auto walkStrip = [&] (unsigned int first, unsigned int b, unsigned int c,
+                        const std::function<void (unsigned int, unsigned int)>& visit) {
+    walk++;
+    visitedOn[first] = walk;
+    unsigned int triangle = first;
+    for (unsigned int position = 1; ; position++)
+    {
+      // Triangle i of a strip is wound (v[i], v[i + 1], v[i + 2]) when i is
+      //   even and (v[i + 1], v[i], v[i + 2]) when i is odd, so the next
+      //   triangle must have the edge b -> c when its position is even, and
+      //   c -> b when it is odd.  Its neighbor has that edge the other way.
+      unsigned int from = position % 2 == 0 ? b : c;
+      unsigned int to = position % 2 == 0 ? c : b;
+      unsigned int edge = findDirectedEdge (&indices[triangle * 3], to, from);
+      unsigned int next = edge < 3 ? across[triangle * 3 + edge] : NONE;
+      if (next == NONE || used[next] || visitedOn[next] == walk)
+      {
+        return;
+      }
+      unsigned int nextEdge = findDirectedEdge (&indices[next * 3], from, to);
+      unsigned int added = indices[next * 3 + (nextEdge + 2) % 3];
+      visitedOn[next] = walk;
+      visit (next, added);
+      triangle = next;
+      b = c;
+      c = added;
+    }
+  };
+
+  std::vector<unsigned int> strips;
+  strips.reserve (indices.size ());
+  for (;;)
+  {
+    unsigned int start = NONE;
+    for (unsigned int count = 0; count < buckets.size () && start == NONE; count++)
+    {
+      while (!buckets[count].empty () && start == NONE)
+      {
+        unsigned int triangle = buckets[count].back ();
+        buckets[count].pop_back ();
+        if (!used[triangle] && liveNeighbors[triangle] == count)
+        {
+          start = triangle;
+        }
+      }
+    }
+    if (start == NONE)
+    {
+      break;
+    }
+
+    const unsigned int* corners = &indices[start * 3];
+    unsigned int bestTurn = 0;
+    unsigned int bestLength = 0;
+    for (unsigned int turn = 0; turn < 3; turn++)
+    {
+      unsigned int length = 0;
+      walkStrip (start, corners[(turn + 1) % 3], corners[(turn + 2) % 3],
+                 [&] (unsigned int, unsigned int) { length++; });
+      if (turn == 0 || length > bestLength)
+      {
+        bestTurn = turn;
+        bestLength = length;
+      }
+    }
+    if (!strips.empty ())
+    {
+      strips.push_back (STRIP_RESTART_INDEX);
+    }
+    strips.insert (strips.end (), { corners[bestTurn], corners[(bestTurn + 1) % 3],
+                                    corners[(bestTurn + 2) % 3] });
+    std::vector<unsigned int> stripTriangles (1, start);
+    walkStrip (start, corners[(bestTurn + 1) % 3], corners[(bestTurn + 2) % 3],
+               [&] (unsigned int triangle, unsigned int added) {
+                 stripTriangles.push_back (triangle);
+                 strips.push_back (added);
+               });
+    for (unsigned int triangle : stripTriangles)
+    {
+      markUsed (triangle);
+    }
+  }
+  return strips;
+}
+
+std::vector<unsigned int>
+unstripify (const std::vector<unsigned int>& strips)
+{
+  std::vector<unsigned int> indices;
+  std::size_t stripStart = 0;
+  for (std::size_t corner = 0; corner < strips.size (); corner++)
+  {
+    if (strips[corner] == STRIP_RESTART_INDEX)
+    {
+      stripStart = corner + 1;
+      continue;
+    }
+    if (corner < stripStart + 2)
+    {
+      continue;
+    }
+    unsigned int a = strips[corner - 2];
+    unsigned int b = strips[corner - 1];
+    unsigned int c = strips[corner];
+    if ((corner - stripStart) % 2 == 1)
+    {
+      std::swap (a, b);
+    }
+    if (a != b && b != c && a != c)
+    {
+      indices.insert (indices.end (), { a, b, c });
+    }
+  }
+  return indices;
+}
@@ -0,0 +1,154 @@
+/// \file MeshOptimizer.hpp
+/// \brief Declarations of global functions that reorder indexed meshes so
+///   the GPU can draw them faster, and of the metrics used to measure them.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// Macro guard
+#ifndef MESH_OPTIMIZER_HPP
+#define MESH_OPTIMIZER_HPP
+
+/******************************************************************/
+// System includes
+#include <limits>
+#include <vector>
+
+/******************************************************************/
+/// The number of entries in the post-transform vertex cache that meshes are
+///   optimized for by default.  Real GPUs vary, but orders that work well for
+///   16 entries also work well for most larger caches.
+const unsigned int DEFAULT_VERTEX_CACHE_SIZE = 16;
+
+/// \brief How well an index buffer uses a FIFO post-transform vertex cache.
+struct VertexCacheStatistics
+{
+  /// The number of times a vertex had to be transformed.
+  unsigned int m_misses;
+  /// The average cache miss ratio: misses per triangle.  This is 3 for a
+  ///   triangle soup and approaches 0.5 for an ideal order on a large grid.
+  float m_acmr;
+  /// The average transform to vertex ratio: misses per distinct vertex
+  ///   referenced.  This is 1 for an ideal order.
+  float m_atvr;
+};
+
+/// The size, in bytes, of the memory transactions vertex fetches are measured
+///   in.  This is a CPU cache line, and the fetch granularity of most GPUs.
+const unsigned int VERTEX_FETCH_LINE_SIZE = 64;
+
+/// The number of lines the fetch metric assumes stay resident at once.
+const unsigned int VERTEX_FETCH_CACHE_LINES = 64;
+
+/// \brief How well an index buffer's vertex reads use memory.
+struct VertexFetchStatistics
+{
+  /// The number of bytes read from memory, in whole lines.
+  unsigned int m_bytesFetched;
+  /// m_bytesFetched divided by the size of the distinct vertices referenced.
+  ///   This is 1 when every line is read exactly once and fully used.
+  float m_overfetch;
+};
+
+/// \brief The triangles that use each vertex, stored as one flat list.
+struct VertexAdjacency
+{
+  /// Where each vertex's triangles start in m_triangles; one extra entry at
+  ///   the end marks where the last vertex's triangles stop.
+  std::vector<unsigned int> m_begins;
+  /// Triangle numbers, grouped by vertex.
+  std::vector<unsigned int> m_triangles;
+};
+
+/// \brief Finds which triangles use each vertex.
+/// \param[in] indices Three vertex indices per triangle.
+/// \param[in] vertexCount The number of vertices.
+/// \pre Every index is less than vertexCount.
+/// \return The triangles of each vertex, in increasing order.  A triangle
+///   that uses a vertex twice is listed twice.
+VertexAdjacency
+buildVertexAdjacency (const std::vector<unsigned int>& indices, unsigned int vertexCount);
+
+/// \brief Reorders triangles so that their vertices are more likely to still
+///   be in the GPU's post-transform vertex cache when they are reused.
+/// \param[in] indices Three vertex indices per triangle, as made by indexData.
+/// \param[in] vertexCount The number of vertices the indices refer to.
+/// \param[in] cacheSize The number of cache entries to optimize for.
+/// \pre indices.size () is a multiple of 3 and every index is less than
+///   vertexCount.
+/// \return The same triangles, each with its corners in the same order, but
+///   with the triangles themselves in a cache-friendly order.
+/// This is Tipsify (Sander, Nehab, and Barczak, 2007): it fans out around one
+///   vertex at a time, choosing the next fan from the vertices just used, so
+///   it runs in linear time.
+std::vector<unsigned int>
+optimizeVertexCache (const std::vector<unsigned int>& indices, unsigned int vertexCount,
+                     unsigned int cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+/// \brief Simulates drawing some triangles through a FIFO vertex cache.
+/// \param[in] indices Three vertex indices per triangle.
+/// \param[in] vertexCount The number of vertices the indices refer to.
+/// \param[in] cacheSize The number of cache entries to simulate.
+/// \pre Every index is less than vertexCount.
+/// \return The number of misses, the ACMR, and the ATVR.  Both ratios are 0
+///   when there are no triangles.
+VertexCacheStatistics
+analyzeVertexCache (const std::vector<unsigned int>& indices, unsigned int vertexCount,
+                    unsigned int cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+/// \brief Reorders vertices into the order the indices first use them, so
+///   that drawing reads vertex memory front to back.
+/// \param[in,out] data Interleaved vertex data, as made by indexData.
+/// \param[in,out] indices Three vertex indices per triangle.
+/// \param[in] floatsPerVertex The number of floats used for each vertex.
+/// \pre Every index is less than data.size () / floatsPerVertex.
+/// \post data holds only the vertices that indices refer to, in the order of
+///   their first use, and indices refers to them in their new positions, so
+///   the same triangles are drawn in the same order.
+/// \return The number of vertices left in data.
+/// Run this after optimizeVertexCache, since it follows the triangle order.
+unsigned int
+remapVerticesForFetch (std::vector<float>& data, std::vector<unsigned int>& indices,
+                       unsigned int floatsPerVertex);
+
+/// \brief Simulates reading vertex data in index order through a small
+///   cache of memory lines.
+/// \param[in] indices Three vertex indices per triangle.
+/// \param[in] vertexCount The number of vertices the indices refer to.
+/// \param[in] vertexSize The number of bytes in each vertex.
+/// \pre Every index is less than vertexCount.
+/// \return The number of bytes read and the overfetch ratio, which is 0 when
+///   there are no indices.
+VertexFetchStatistics
+analyzeVertexFetch (const std::vector<unsigned int>& indices, unsigned int vertexCount,
+                    unsigned int vertexSize);
+
+/// The index that separates one strip from the next in stripify's output.
+///   Narrowed to a smaller index type, it becomes that type's largest value,
+///   which is what a Mesh draws with as its primitive restart index.
+const unsigned int STRIP_RESTART_INDEX = std::numeric_limits<unsigned int>::max ();
+
+/// \brief Turns a triangle list into triangle strips.
+/// \param[in] indices Three vertex indices per triangle.
+/// \param[in] vertexCount The number of vertices the indices refer to.
+/// \pre indices.size () is a multiple of 3 and every index is less than
+///   vertexCount, which is less than STRIP_RESTART_INDEX.
+/// \return Strips, separated by STRIP_RESTART_INDEX, for drawing as
+///   GL_TRIANGLE_STRIP with primitive restart.  They hold every triangle
+///   exactly once, with the same winding, except that triangles with a
+///   repeated vertex are dropped.
+/// Each strip starts from the triangle with the fewest neighbors left, turned
+///   whichever of its three ways makes the strip longest, and grows across
+///   the edge each new vertex makes until no unused triangle is there.  On a
+///   grid this follows rows or columns, using about a third of the indices.
+std::vector<unsigned int>
+stripify (const std::vector<unsigned int>& indices, unsigned int vertexCount);
+
+/// \brief Turns triangle strips back into a triangle list.
+/// \param[in] strips Strips separated by STRIP_RESTART_INDEX, as made by
+///   stripify.
+/// \return Three vertex indices per triangle, with the winding each had in
+///   its strip.  Triangles with a repeated vertex are dropped.
+std::vector<unsigned int>
+unstripify (const std::vector<unsigned int>& strips);
+
+#endif//MESH_OPTIMIZER_HPP
@@ -0,0 +1,314 @@
+/// \file Meshlet.cpp
+/// \brief Definitions of global functions that split indexed meshes into
+///   small clusters of triangles, and that cull those clusters on the CPU.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// System includes
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+/******************************************************************/
+// Local includes
+#include "Meshlet.hpp"
+#include "MeshOptimizer.hpp"
+
+/******************************************************************/
+/// How much buildMeshlets prefers triangles whose vertices have few unused
+///   triangles left, relative to distance measured in meshlet radii.
+static const float STRANDING_WEIGHT = 0.1f;
+
+/// \brief Gets the position of a vertex.
+static Vector3
+positionOf (const std::vector<float>& data, unsigned int floatsPerVertex, unsigned int vertex)
+{
+  const float* position = &data[static_cast<std::size_t> (vertex) * floatsPerVertex];
+  return Vector3 (position[0], position[1], position[2]);
+}
+
+/// \brief Computes the bounding sphere and normal cone of a meshlet.
+/// \param[in] data Interleaved vertex data with positions first.
+/// \param[in] floatsPerVertex The number of floats used for each vertex.
+/// \param[in] vertices The distinct vertices the meshlet uses.
+/// \param[in] triangles Three vertex indices per triangle of the meshlet.
+/// \param[in,out] meshlet The meshlet, whose bounds are filled in.
+static void
+computeMeshletBounds (const std::vector<float>& data, unsigned int floatsPerVertex,
+                      const std::vector<unsigned int>& vertices,
+                      const unsigned int* triangles, Meshlet& meshlet)
+{
+  Vector3 low = positionOf (data, floatsPerVertex, vertices[0]);
+  Vector3 high = low;
+  for (unsigned int vertex : vertices)
+  {
+    Vector3 position = positionOf (data, floatsPerVertex, vertex);
+    low = Vector3 (std::min (low.m_x, position.m_x), std::min (low.m_y, position.m_y),
+                   std::min (low.m_z, position.m_z));
+    high = Vector3 (std::max (high.m_x, position.m_x), std::max (high.m_y, position.m_y),
+                    std::max (high.m_z, position.m_z));
+  }
+  meshlet.m_center = (low + high) / 2.0f;
+  meshlet.m_radius = 0.0f;
+  for (unsigned int vertex : vertices)
+  {
+    meshlet.m_radius = std::max (meshlet.m_radius,
+                                 (positionOf (data, floatsPerVertex, vertex) - meshlet.m_center).length ());
+  }
+
+  // The cone must hold the normal of every triangle with any area.
+  std::vector<Vector3> normals;
+  Vector3 sum (0.0f, 0.0f, 0.0f);
+  for (unsigned int triangle = 0; triangle < meshlet.m_triangleCount; triangle++)
+  {
+    const unsigned int* corners = triangles + triangle * 3;
+    Vector3 first = positionOf (data, floatsPerVertex, corners[0]);
+    Vector3 normal = (positionOf (data, floatsPerVertex, corners[1]) - first).cross (
+      positionOf (data, floatsPerVertex, corners[2]) - first);
+    if (normal.length () > 0.0f)
+    {
+      normal.normalize ();
+      normals.push_back (normal);
+      sum += normal;
+    }
+  }
+  meshlet.m_coneAxis = Vector3 (0.0f, 0.0f, 1.0f);
+  meshlet.m_coneCutoff = 1.0f;
+  if (normals.empty () || sum.length () < 1e-6f)
+  {
+    return;
+  }
+  sum.normalize ();
+  float minimumDot = 1.0f;
+  for (const Vector3& normal : normals)
+  {
+    minimumDot = std::min (minimumDot, normal.dot (sum));
+  }
+  meshlet.m_coneAxis = sum;
+  // Past about 84 degrees the cone almost never culls, so skip the test.
+  if (minimumDot > 0.1f)
+  {
+    meshlet.m_coneCutoff = std::sqrt (1.0f - minimumDot * minimumDot);
+  }
+}
+
+MeshletSet
+buildMeshlets (const std::vector<float>& data, unsigned int floatsPerVertex,
+               const std::vector<unsigned int>& indices,
+               unsigned int maxVertices, unsigned int maxTriangles)
+{
+  assert (indices.size () % 3 == 0);
+  assert (maxVertices >= 3 && maxTriangles >= 1);
+  const unsigned int vertexCount = data.size () / floatsPerVertex;
+  const unsigned int triangleCount = indices.size () / 3;
+  const unsigned int NONE = static_cast<unsigned int> (-1);
+  VertexAdjacency adjacency = buildVertexAdjacency (indices, vertexCount);
+
+  MeshletSet set;
+  set.m_indices.reserve (indices.size ());
+  std::vector<bool> emitted (triangleCount, false);
+  // How many not-yet-used triangles use each vertex.
+  std::vector<unsigned int> liveTriangles (vertexCount);
+  for (unsigned int vertex = 0; vertex < vertexCount; vertex++)
+  {
+    liveTriangles[vertex] = adjacency.m_begins[vertex + 1] - adjacency.m_begins[vertex];
+  }
+  // The meshlet being built, and which vertices it already uses.
+  std::vector<unsigned int> vertices;
+  std::vector<bool> used (vertexCount, false);
+  Vector3 positionSum (0.0f, 0.0f, 0.0f);
+  Meshlet meshlet = {};
+
+  // Counts the vertices of a triangle the current meshlet does not use yet.
+  auto newVertices = [&] (unsigned int triangle) {
+    const unsigned int* corner = &indices[triangle * 3];
+    return static_cast<unsigned int> (!used[corner[0]])
+      + (!used[corner[1]] && corner[1] != corner[0])
+      + (!used[corner[2]] && corner[2] != corner[0] && corner[2] != corner[1]);
+  };
+  // Measures how far a triangle is from the middle of the current meshlet.
+  auto distanceFromMeshlet = [&] (unsigned int triangle) {
+    Vector3 center (0.0f, 0.0f, 0.0f);
+    for (unsigned int corner = 0; corner < 3; corner++)
+    {
+      center += positionOf (data, floatsPerVertex, indices[triangle * 3 + corner]);
+    }
+    return (center / 3.0f - positionSum / vertices.size ()).length ();
+  };
+  // Measures how far the farthest vertex of the current meshlet is from its
+  //   middle.
+  auto spread = [&] () {
+    float farthest = 0.0f;
+    for (unsigned int vertex : vertices)
+    {
+      farthest = std::max (farthest, (positionOf (data, floatsPerVertex, vertex)
+                                      - positionSum / vertices.size ()).length ());
+    }
+    return farthest;
+  };
+  auto finish = [&] () {
+    meshlet.m_vertexCount = vertices.size ();
+    computeMeshletBounds (data, floatsPerVertex, vertices,
+                          &set.m_indices[meshlet.m_indexOffset], meshlet);
+    set.m_meshlets.push_back (meshlet);
+    for (unsigned int vertex : vertices)
+    {
+      used[vertex] = false;
+    }
+    vertices.clear ();
+    positionSum = Vector3 (0.0f, 0.0f, 0.0f);
+    meshlet = {};
+    meshlet.m_indexOffset = set.m_indices.size ();
+  };
+
+  unsigned int nextInOrder = 0;
+  for (unsigned int added = 0; added < triangleCount; added++)
+  {
+    // Grow toward the neighboring triangle that needs the fewest new
+    //   vertices.  Ties go to the triangle nearest the middle, so the meshlet
+    //   stays round, nudged toward triangles whose vertices have few others
+    //   left, so fewer stragglers are stranded.  With no neighbors left, go
+    //   on to the first triangle left, but only if it is close enough to not
+    //   stretch the meshlet.
+    unsigned int best = NONE;
+    unsigned int bestNew = 4;
+    float bestScore = 0.0f;
+    const float size = vertices.empty () ? 1.0f : std::max (spread (), 1e-20f);
+    for (unsigned int vertex : vertices)
+    {
+      for (unsigned int slot = adjacency.m_begins[vertex]; slot < adjacency.m_begins[vertex + 1]; slot++)
+      {
+        unsigned int triangle = adjacency.m_triangles[slot];
+        if (emitted[triangle] || triangle == best)
+        {
+          continue;
+        }
+        unsigned int extra = newVertices (triangle);
+        if (extra > bestNew)
+        {
+          continue;
+        }
+        const unsigned int* corner = &indices[triangle * 3];
+        float score = distanceFromMeshlet (triangle) / size + STRANDING_WEIGHT
+          * (liveTriangles[corner[0]] + liveTriangles[corner[1]] + liveTriangles[corner[2]]);
+        if (extra < bestNew || score < bestScore)
+        {
+          best = triangle;
+          bestNew = extra;
+          bestScore = score;
+        }
+      }
+    }
+    if (best == NONE)
+    {
+      while (emitted[nextInOrder])
+      {
+        nextInOrder++;
+      }
+      best = nextInOrder;
+      bestNew = newVertices (best);
+      if (meshlet.m_triangleCount > 0 && distanceFromMeshlet (best) > spread ())
+      {
+        finish ();
+        bestNew = newVertices (best);
+      }
+    }
+    if (meshlet.m_triangleCount == maxTriangles || vertices.size () + bestNew > maxVertices)
+    {
+      finish ();
+    }
+
+    emitted[best] = true;
+    for (unsigned int corner = 0; corner < 3; corner++)
+    {
+      unsigned int vertex = indices[best * 3 + corner];
+      if (!used[vertex])
+      {
+        used[vertex] = true;
+        vertices.push_back (vertex);
+        positionSum += positionOf (data, floatsPerVertex, vertex);
+      }
+      set.m_indices.push_back (vertex);
+      liveTriangles[vertex]--;
+    }
+    meshlet.m_triangleCount++;
+  }
+  if (meshlet.m_triangleCount > 0)
+  {
+    finish ();
+  }
+  return set;
+}
+
+Frustum
+extractFrustum (const Matrix4& projection, const Matrix4& modelView)
+{
+  // Both matrices are column major, so element (row, column) is at
+  //   column * 4 + row.
+  const float* p = projection.data ();
+  const float* m = modelView.data ();
+  float clip[4][4];
+  for (unsigned int row = 0; row < 4; row++)
+  {
+    for (unsigned int column = 0; column < 4; column++)
+    {
+      clip[row][column] = 0.0f;
+      for (unsigned int k = 0; k < 4; k++)
+      {
+        clip[row][column] += p[k * 4 + row] * m[column * 4 + k];
+      }
+    }
+  }
+
+  // A point is inside when -w <= x, y, z <= w, so each plane is the w row
+  //   plus or minus another row (Gribb and Hartmann, 2001).
+  Frustum frustum;
+  for (unsigned int plane = 0; plane < 6; plane++)
+  {
+    const float side = plane % 2 == 0 ? 1.0f : -1.0f;
+    const float* other = clip[plane / 2];
+    Vector3 normal (clip[3][0] + side * other[0], clip[3][1] + side * other[1],
+                    clip[3][2] + side * other[2]);
+    float distance = clip[3][3] + side * other[3];
+    float length = normal.length ();
+    frustum[plane].m_normal = normal / length;
+    frustum[plane].m_distance = distance / length;
+  }
+  return frustum;
+}
+
+bool
+isMeshletVisible (const Meshlet& meshlet, const Frustum& frustum, const Vector3& camera)
+{
+  for (const FrustumPlane& plane : frustum)
+  {
+    if (plane.m_normal.dot (meshlet.m_center) + plane.m_distance < -meshlet.m_radius)
+    {
+      return false;
+    }
+  }
+  // Every triangle faces away if the whole sphere lies inside the cone of
+  //   directions from which all of them are seen from behind.
+  Vector3 toCenter = meshlet.m_center - camera;
+  return toCenter.dot (meshlet.m_coneAxis)
+    < meshlet.m_coneCutoff * toCenter.length () + meshlet.m_radius;
+}
+
+unsigned int
+cullMeshlets (const MeshletSet& meshlets, const Frustum& frustum, const Vector3& camera,
+              std::vector<unsigned int>& visibleIndices)
+{
+  visibleIndices.clear ();
+  unsigned int visible = 0;
+  for (const Meshlet& meshlet : meshlets.m_meshlets)
+  {
+    if (isMeshletVisible (meshlet, frustum, camera))
+    {
+      auto first = meshlets.m_indices.begin () + meshlet.m_indexOffset;
+      visibleIndices.insert (visibleIndices.end (), first, first + meshlet.m_triangleCount * 3);
+      visible++;
+    }
+  }
+  return visible;
+}
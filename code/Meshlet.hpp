@@ -0,0 +1,124 @@
+/// \file Meshlet.hpp
+/// \brief Declarations of global functions that split indexed meshes into
+///   small clusters of triangles, and that cull those clusters on the CPU.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// Macro guard
+#ifndef MESHLET_HPP
+#define MESHLET_HPP
+
+/******************************************************************/
+// System includes
+#include <array>
+#include <vector>
+
+/******************************************************************/
+// Local includes
+#include "Matrix4.hpp"
+#include "Vector3.hpp"
+
+/******************************************************************/
+/// The most vertices a meshlet built with the default limits uses.
+const unsigned int MAX_MESHLET_VERTICES = 64;
+
+/// The most triangles a meshlet built with the default limits holds.  With 64
+///   vertices, 124 triangles keeps each meshlet's local index list under 384
+///   bytes, which is what mesh shading hardware is tuned for.
+const unsigned int MAX_MESHLET_TRIANGLES = 124;
+
+/// \brief A small cluster of triangles, and what is needed to cull it.
+struct Meshlet
+{
+  /// Where the meshlet's triangles start in MeshletSet::m_indices.
+  unsigned int m_indexOffset;
+  /// The number of triangles in the meshlet.
+  unsigned int m_triangleCount;
+  /// The number of distinct vertices the meshlet uses.
+  unsigned int m_vertexCount;
+  /// The center of a sphere that holds every vertex.
+  Vector3 m_center;
+  /// The radius of that sphere.
+  float m_radius;
+  /// The average direction the triangles face.
+  Vector3 m_coneAxis;
+  /// The sine of the largest angle between m_coneAxis and any triangle's
+  ///   normal, or 1 when the triangles face too many ways to ever be culled
+  ///   as a group.
+  float m_coneCutoff;
+};
+
+/// \brief An indexed mesh's triangles grouped into meshlets.
+struct MeshletSet
+{
+  /// The meshlets, in the order they were built.
+  std::vector<Meshlet> m_meshlets;
+  /// Every triangle of the mesh, with each meshlet's triangles stored
+  ///   together.
+  std::vector<unsigned int> m_indices;
+};
+
+/// \brief A plane that bounds a view volume, facing into it.
+struct FrustumPlane
+{
+  /// A unit vector pointing into the view volume.
+  Vector3 m_normal;
+  /// Chosen so that m_normal.dot (p) + m_distance is the signed distance
+  ///   from p to the plane.
+  float m_distance;
+};
+
+/// \brief The six planes of a view volume: left, right, bottom, top, near,
+///   and far.
+using Frustum = std::array<FrustumPlane, 6>;
+
+/// \brief Groups the triangles of an indexed mesh into meshlets.
+/// \param[in] data Interleaved vertex data, as made by indexData, whose
+///   first three floats per vertex are a position.
+/// \param[in] floatsPerVertex The number of floats used for each vertex.
+/// \param[in] indices Three vertex indices per triangle.
+/// \param[in] maxVertices The most vertices any meshlet may use.
+/// \param[in] maxTriangles The most triangles any meshlet may hold.
+/// \pre indices.size () is a multiple of 3, every index is less than
+///   data.size () / floatsPerVertex, and maxVertices is at least 3.
+/// \return The meshlets, which hold every triangle exactly once, with the
+///   same winding.
+/// Each meshlet grows from one triangle by adding the neighbor that needs the
+///   fewest new vertices, so meshlets stay compact and their bounds tight.
+///   Run this after optimizeVertexCache, since it starts new meshlets in
+///   triangle order.
+MeshletSet
+buildMeshlets (const std::vector<float>& data, unsigned int floatsPerVertex,
+               const std::vector<unsigned int>& indices,
+               unsigned int maxVertices = MAX_MESHLET_VERTICES,
+               unsigned int maxTriangles = MAX_MESHLET_TRIANGLES);
+
+/// \brief Finds the view volume of a camera in a mesh's local coordinates.
+/// \param[in] projection The projection matrix.
+/// \param[in] modelView The matrix from the mesh's local coordinates to eye
+///   coordinates.
+/// \return The six planes of the view volume, in local coordinates.
+Frustum
+extractFrustum (const Matrix4& projection, const Matrix4& modelView);
+
+/// \brief Tests whether any triangle of a meshlet might be seen.
+/// \param[in] meshlet The meshlet.
+/// \param[in] frustum The view volume, in the mesh's local coordinates.
+/// \param[in] camera The camera's position, in the mesh's local coordinates.
+/// \return False only if the meshlet is entirely outside the view volume, or
+///   every one of its triangles faces away from the camera.
+bool
+isMeshletVisible (const Meshlet& meshlet, const Frustum& frustum, const Vector3& camera);
+
+/// \brief Collects the triangles of every meshlet that might be seen.
+/// \param[in] meshlets The meshlets.
+/// \param[in] frustum The view volume, in the mesh's local coordinates.
+/// \param[in] camera The camera's position, in the mesh's local coordinates.
+/// \param[out] visibleIndices Replaced by the indices of the visible
+///   meshlets, back to back, ready to be uploaded and drawn.
+/// \return The number of visible meshlets.
+unsigned int
+cullMeshlets (const MeshletSet& meshlets, const Frustum& frustum, const Vector3& camera,
+              std::vector<unsigned int>& visibleIndices);
+
+#endif//MESHLET_HPP
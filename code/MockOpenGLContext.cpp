@@ -0,0 +1,428 @@
+/// \file MockOpenGLContext.cpp
+/// \brief Definitions of MockOpenGLContext member and associated global
+///   functions.
+/// \author Sean Malloy
+/// \version A08
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "MockOpenGLContext.hpp"
+
+MockOpenGLContext::MockOpenGLContext ()
+  : m_nextName (1), m_vertexArray (0), m_restartIndex (0), m_syncWaits (0),
+    m_generatedObjects (0), m_longestSyncTimeout (0), m_syncsSignaled (true)
+{
+}
+
+MockOpenGLContext::~MockOpenGLContext ()
+{
+}
+
+bool
+MockOpenGLContext::hasBuffer (GLuint buffer) const
+{
+  return m_buffers.count (buffer) != 0;
+}
+
+const MockOpenGLContext::Buffer&
+MockOpenGLContext::getBuffer (GLuint buffer) const
+{
+  assert (hasBuffer (buffer));
+  return m_buffers.find (buffer)->second;
+}
+
+std::size_t
+MockOpenGLContext::getTotalBufferBytes (GLenum target) const
+{
+  std::size_t total = 0;
+  for (const auto& buffer : m_buffers)
+  {
+    if (buffer.second.m_target == target)
+    {
+      total += buffer.second.m_bytes.size ();
+    }
+  }
+  return total;
+}
+
+const std::vector<MockOpenGLContext::DrawCall>&
+MockOpenGLContext::getDrawCalls () const
+{
+  return m_drawCalls;
+}
+
+const std::vector<MockOpenGLContext::AttributePointer>&
+MockOpenGLContext::getAttributePointers () const
+{
+  return m_attributePointers;
+}
+
+const std::vector<MockOpenGLContext::MappedRange>&
+MockOpenGLContext::getMappedRanges () const
+{
+  return m_mappedRanges;
+}
+
+std::size_t
+MockOpenGLContext::getLiveSyncCount () const
+{
+  return m_syncs.size ();
+}
+
+unsigned int
+MockOpenGLContext::getSyncWaitCount () const
+{
+  return m_syncWaits;
+}
+
+unsigned int
+MockOpenGLContext::getGeneratedObjectCount () const
+{
+  return m_generatedObjects;
+}
+
+GLuint64
+MockOpenGLContext::getLongestSyncTimeout () const
+{
+  return m_longestSyncTimeout;
+}
+
+void
+MockOpenGLContext::setSyncsSignaled (bool signaled)
+{
+  m_syncsSignaled = signaled;
+}
+
+bool
+MockOpenGLContext::isEnabled (GLenum cap) const
+{
+  return m_enabled.count (cap) != 0;
+}
+
+void
+MockOpenGLContext::attachShader (GLuint program, GLuint shader)
+{
+}
+
+void
+MockOpenGLContext::bindBuffer (GLenum target, GLuint buffer)
+{
+  if (target == GL_ELEMENT_ARRAY_BUFFER)
+  {
+    m_elementBuffers[m_vertexArray] = buffer;
+  }
+  else
+  {
+    m_boundBuffers[target] = buffer;
+  }
+}
+
+void
+MockOpenGLContext::bindVertexArray (GLuint array)
+{
+  m_vertexArray = array;
+}
+
+void
+MockOpenGLContext::bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+  GLuint buffer = target == GL_ELEMENT_ARRAY_BUFFER ? m_elementBuffers[m_vertexArray] : m_boundBuffers[target];
+  assert (buffer != 0);
+  Buffer& contents = m_buffers[buffer];
+  contents.m_target = target;
+  contents.m_usage = usage;
+  contents.m_bytes.assign (size, 0);
+  if (data != nullptr && size > 0)
+  {
+    std::memcpy (contents.m_bytes.data (), data, size);
+  }
+}
+
+void
+MockOpenGLContext::bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+  GLuint buffer = target == GL_ELEMENT_ARRAY_BUFFER ? m_elementBuffers[m_vertexArray] : m_boundBuffers[target];
+  assert (hasBuffer (buffer));
+  Buffer& contents = m_buffers[buffer];
+  assert (offset >= 0 && static_cast<std::size_t> (offset + size) <= contents.m_bytes.size ());
+  if (size > 0)
+  {
+    std::memcpy (contents.m_bytes.data () + offset, data, size);
+  }
+}
+
+void
+MockOpenGLContext::clear (GLbitfield mask)
+{
+}
+
+void
+MockOpenGLContext::clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+}
+
+GLenum
+MockOpenGLContext::clientWaitSync (GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+  assert (m_syncs.count (sync) != 0);
+  m_syncWaits++;
+  m_longestSyncTimeout = std::max (m_longestSyncTimeout, timeout);
+  return m_syncsSignaled ? GL_ALREADY_SIGNALED : GL_TIMEOUT_EXPIRED;
+}
+
+void
+MockOpenGLContext::compileShader (GLuint shader)
+{
+}
+
+GLuint
+MockOpenGLContext::createProgram ()
+{
+  return m_nextName++;
+}
+
+GLuint
+MockOpenGLContext::createShader (GLenum shaderType)
+{
+  return m_nextName++;
+}
+
+void
+MockOpenGLContext::cullFace (GLenum mode)
+{
+}
+
+void
+MockOpenGLContext::deleteBuffers (GLsizei n, const GLuint* buffers)
+{
+  for (GLsizei buffer = 0; buffer < n; buffer++)
+  {
+    m_buffers.erase (buffers[buffer]);
+  }
+}
+
+void
+MockOpenGLContext::deleteProgram (GLuint program)
+{
+}
+
+void
+MockOpenGLContext::deleteShader (GLuint shader)
+{
+}
+
+void
+MockOpenGLContext::deleteSync (GLsync sync)
+{
+  m_syncs.erase (sync);
+}
+
+void
+MockOpenGLContext::deleteVertexArrays (GLsizei n, const GLuint* arrays)
+{
+  for (GLsizei array = 0; array < n; array++)
+  {
+    m_elementBuffers.erase (arrays[array]);
+  }
+}
+
+void
+MockOpenGLContext::detachShader (GLuint program, GLuint shader)
+{
+}
+
+void
+MockOpenGLContext::disable (GLenum cap)
+{
+  m_enabled.erase (cap);
+}
+
+void
+MockOpenGLContext::drawArrays (GLenum mode, GLint first, GLsizei count)
+{
+}
+
+void
+MockOpenGLContext::drawElements (GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+  m_drawCalls.push_back (DrawCall { mode, count, type, reinterpret_cast<std::uintptr_t> (indices),
+                                    m_vertexArray, m_elementBuffers[m_vertexArray],
+                                    isEnabled (GL_PRIMITIVE_RESTART), m_restartIndex, 0 });
+}
+
+void
+MockOpenGLContext::drawElementsBaseVertex (GLenum mode, GLsizei count, GLenum type, const void* indices,
+                                           GLint basevertex)
+{
+  m_drawCalls.push_back (DrawCall { mode, count, type, reinterpret_cast<std::uintptr_t> (indices),
+                                    m_vertexArray, m_elementBuffers[m_vertexArray],
+                                    isEnabled (GL_PRIMITIVE_RESTART), m_restartIndex, basevertex });
+}
+
+void
+MockOpenGLContext::enable (GLenum cap)
+{
+  m_enabled.insert (cap);
+}
+
+void
+MockOpenGLContext::enableVertexAttribArray (GLuint index)
+{
+}
+
+GLsync
+MockOpenGLContext::fenceSync (GLenum condition, GLbitfield flags)
+{
+  GLsync sync = reinterpret_cast<GLsync> (static_cast<std::uintptr_t> (m_nextName++));
+  m_syncs.insert (sync);
+  return sync;
+}
+
+void
+MockOpenGLContext::frontFace (GLenum mode)
+{
+}
+
+void
+MockOpenGLContext::genBuffers (GLsizei n, GLuint* buffers)
+{
+  for (GLsizei buffer = 0; buffer < n; buffer++)
+  {
+    buffers[buffer] = m_nextName++;
+  }
+  m_generatedObjects += n;
+}
+
+void
+MockOpenGLContext::genVertexArrays (GLsizei n, GLuint* arrays)
+{
+  for (GLsizei array = 0; array < n; array++)
+  {
+    arrays[array] = m_nextName++;
+  }
+  m_generatedObjects += n;
+}
+
+GLint
+MockOpenGLContext::getAttribLocation (GLuint program, const GLchar* name)
+{
+  return 0;
+}
+
+void
+MockOpenGLContext::getProgramInfoLog (GLuint program, GLsizei maxLength, GLsizei* length, GLchar* infoLog)
+{
+  if (length != nullptr)
+  {
+    *length = 0;
+  }
+  if (maxLength > 0)
+  {
+    infoLog[0] = '\0';
+  }
+}
+
+void
+MockOpenGLContext::getProgramiv (GLuint program, GLenum pname, GLint* params)
+{
+  *params = pname == GL_LINK_STATUS ? GL_TRUE : 0;
+}
+
+void
+MockOpenGLContext::getShaderInfoLog (GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog)
+{
+  if (length != nullptr)
+  {
+    *length = 0;
+  }
+  if (maxLength > 0)
+  {
+    infoLog[0] = '\0';
+  }
+}
+
+void
+MockOpenGLContext::getShaderiv (GLuint shader, GLenum pname, GLint* params)
+{
+  *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+
+const GLubyte*
+MockOpenGLContext::getString (GLenum name)
+{
+  return reinterpret_cast<const GLubyte*> ("MockOpenGLContext");
+}
+
+GLint
+MockOpenGLContext::getUniformLocation (GLuint program, const GLchar* name)
+{
+  return 0;
+}
+
+void
+MockOpenGLContext::linkProgram (GLuint program)
+{
+}
+
+void*
+MockOpenGLContext::mapBufferRange (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+  GLuint buffer = target == GL_ELEMENT_ARRAY_BUFFER ? m_elementBuffers[m_vertexArray] : m_boundBuffers[target];
+  assert (hasBuffer (buffer));
+  assert (m_mappedBuffers.count (target) == 0);
+  Buffer& contents = m_buffers[buffer];
+  assert (offset >= 0 && static_cast<std::size_t> (offset + length) <= contents.m_bytes.size ());
+  m_mappedBuffers[target] = buffer;
+  m_mappedRanges.push_back (MappedRange { buffer, static_cast<std::size_t> (offset),
+                                          static_cast<std::size_t> (length), access });
+  return contents.m_bytes.data () + offset;
+}
+
+void
+MockOpenGLContext::primitiveRestartIndex (GLuint index)
+{
+  m_restartIndex = index;
+}
+
+void
+MockOpenGLContext::shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length)
+{
+}
+
+void
+MockOpenGLContext::uniform1i (GLint location, GLint v0)
+{
+}
+
+void
+MockOpenGLContext::uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+}
+
+GLboolean
+MockOpenGLContext::unmapBuffer (GLenum target)
+{
+  assert (m_mappedBuffers.count (target) != 0);
+  m_mappedBuffers.erase (target);
+  return GL_TRUE;
+}
+
+void
+MockOpenGLContext::useProgram (GLuint program)
+{
+}
+
+void
+MockOpenGLContext::vertexAttribPointer (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer)
+{
+  m_attributePointers.push_back (AttributePointer { index, size, type, normalized, stride,
+                                                    reinterpret_cast<std::uintptr_t> (pointer),
+                                                    m_vertexArray, m_boundBuffers[GL_ARRAY_BUFFER] });
+}
+
+void
+MockOpenGLContext::viewport (GLint x, GLint y, GLsizei width, GLsizei height)
+{
+}
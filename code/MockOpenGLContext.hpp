@@ -0,0 +1,348 @@
+/// \file MockOpenGLContext.hpp
+/// \brief Declaration of MockOpenGLContext and any associated global
+///   functions.
+/// \author Sean Malloy
+/// \version A08
+
+#ifndef MOCK_OPENGL_CONTEXT_HPP
+#define MOCK_OPENGL_CONTEXT_HPP
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "OpenGLContext.hpp"
+
+/// \brief A subclass of OpenGLContext that makes no OpenGL calls at all, but
+///   remembers enough of what it was asked to do for unit tests to inspect.
+///
+/// Object names are handed out in increasing order starting at 1.  Buffer
+///   contents are copied when they are uploaded, shaders always compile and
+///   programs always link, and every uniform is at location 0.  Mapped
+///   buffers are written in place, and every fence is already signaled.
+class MockOpenGLContext : public OpenGLContext
+{
+public:
+
+  /// \brief The most recent upload to one buffer object.
+  struct Buffer
+  {
+    /// The target the buffer was bound to when it was filled.
+    GLenum m_target;
+    /// The usage hint it was filled with.
+    GLenum m_usage;
+    /// A copy of its contents (zeros if it was filled from nullptr).
+    std::vector<unsigned char> m_bytes;
+  };
+
+  /// \brief One call to drawElements.
+  struct DrawCall
+  {
+    /// The primitive type.
+    GLenum m_mode;
+    /// The number of indices.
+    GLsizei m_count;
+    /// The type of each index.
+    GLenum m_type;
+    /// The byte offset of the first index in the element array buffer.
+    std::uintptr_t m_offset;
+    /// The vertex array that was bound.
+    GLuint m_vertexArray;
+    /// The element array buffer bound in that vertex array.
+    GLuint m_elementBuffer;
+    /// Whether GL_PRIMITIVE_RESTART was enabled.
+    bool m_primitiveRestart;
+    /// The primitive restart index that was set.
+    GLuint m_restartIndex;
+    /// The value added to each index, or 0 for drawElements.
+    GLint m_baseVertex;
+  };
+
+  /// \brief One call to vertexAttribPointer.
+  struct AttributePointer
+  {
+    /// The attribute index.
+    GLuint m_index;
+    /// The number of components.
+    GLint m_size;
+    /// The type of each component.
+    GLenum m_type;
+    /// Whether integer components are normalized.
+    GLboolean m_normalized;
+    /// The number of bytes from one vertex to the next.
+    GLsizei m_stride;
+    /// The byte offset of the first component in the array buffer.
+    std::uintptr_t m_offset;
+    /// The vertex array that was bound.
+    GLuint m_vertexArray;
+    /// The array buffer that was bound.
+    GLuint m_buffer;
+  };
+
+  /// \brief One call to mapBufferRange.
+  struct MappedRange
+  {
+    /// The buffer that was mapped.
+    GLuint m_buffer;
+    /// The byte offset of the range.
+    std::size_t m_offset;
+    /// The number of bytes in the range.
+    std::size_t m_length;
+    /// The access flags.
+    GLbitfield m_access;
+  };
+
+  /// Constructs a MockOpenGLContext that has not been asked to do anything.
+  MockOpenGLContext ();
+
+  /// Destructs a MockOpenGLContext.
+  virtual
+  ~MockOpenGLContext ();
+
+  /// Copy constructor deleted because you should not be copying
+  ///   MockOpenGLContexts.
+  MockOpenGLContext (const MockOpenGLContext&) = delete;
+
+  /// Assignment operator deleted because you should not be assigning
+  ///   MockOpenGLContexts.
+  MockOpenGLContext&
+  operator= (const MockOpenGLContext&) = delete;
+
+  /// \brief Tests whether a buffer object has been filled and not deleted.
+  /// \param[in] buffer The name of the buffer.
+  /// \return Whether bufferData has been called for it.
+  bool
+  hasBuffer (GLuint buffer) const;
+
+  /// \brief Gets what has been uploaded to a buffer object.
+  /// \param[in] buffer The name of the buffer.
+  /// \pre hasBuffer (buffer).
+  /// \return Its contents, as of the last bufferData and any bufferSubData
+  ///   since.
+  const Buffer&
+  getBuffer (GLuint buffer) const;
+
+  /// \brief Adds up the sizes of every live buffer that was filled through a
+  ///   target.
+  /// \param[in] target For example, GL_ELEMENT_ARRAY_BUFFER.
+  /// \return The total number of bytes.
+  std::size_t
+  getTotalBufferBytes (GLenum target) const;
+
+  /// \brief Gets every call to drawElements, in order.
+  const std::vector<DrawCall>&
+  getDrawCalls () const;
+
+  /// \brief Gets every call to vertexAttribPointer, in order.
+  const std::vector<AttributePointer>&
+  getAttributePointers () const;
+
+  /// \brief Gets every call to mapBufferRange, in order.
+  const std::vector<MappedRange>&
+  getMappedRanges () const;
+
+  /// \brief Gets the number of fences made by fenceSync and not yet deleted.
+  std::size_t
+  getLiveSyncCount () const;
+
+  /// \brief Gets the number of calls to clientWaitSync.
+  unsigned int
+  getSyncWaitCount () const;
+
+  /// \brief Gets the number of buffers and vertex arrays made by genBuffers
+  ///   and genVertexArrays, whether or not they have been deleted since.
+  unsigned int
+  getGeneratedObjectCount () const;
+
+  /// \brief Gets the longest timeout clientWaitSync has been given.
+  GLuint64
+  getLongestSyncTimeout () const;
+
+  /// \brief Chooses whether fences have signaled, which they all have
+  ///   unless this is called with false.
+  /// \param[in] signaled Whether clientWaitSync returns GL_ALREADY_SIGNALED,
+  ///   rather than GL_TIMEOUT_EXPIRED.
+  void
+  setSyncsSignaled (bool signaled);
+
+  /// \brief Gets whether a capability is enabled.
+  /// \param[in] cap The capability, for example GL_DEPTH_TEST.
+  /// \return Whether enable has been called for it more recently than
+  ///   disable.
+  bool
+  isEnabled (GLenum cap) const;
+
+  virtual void
+  attachShader (GLuint program, GLuint shader);
+
+  virtual void
+  bindBuffer (GLenum target, GLuint buffer);
+
+  virtual void
+  bindVertexArray (GLuint array);
+
+  virtual void
+  bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage);
+
+  virtual void
+  bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data);
+
+  virtual void
+  clear (GLbitfield mask);
+
+  virtual void
+  clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+
+  virtual GLenum
+  clientWaitSync (GLsync sync, GLbitfield flags, GLuint64 timeout);
+
+  virtual void
+  compileShader (GLuint shader);
+
+  virtual GLuint
+  createProgram ();
+
+  virtual GLuint
+  createShader (GLenum shaderType);
+
+  virtual void
+  cullFace (GLenum mode);
+
+  virtual void
+  deleteBuffers (GLsizei n, const GLuint* buffers);
+
+  virtual void
+  deleteProgram (GLuint program);
+
+  virtual void
+  deleteShader (GLuint shader);
+
+  virtual void
+  deleteSync (GLsync sync);
+
+  virtual void
+  deleteVertexArrays (GLsizei n, const GLuint* arrays);
+
+  virtual void
+  detachShader (GLuint program, GLuint shader);
+
+  virtual void
+  disable (GLenum cap);
+
+  virtual void
+  drawArrays (GLenum mode, GLint first, GLsizei count);
+
+  virtual void
+  drawElements (GLenum mode, GLsizei count, GLenum type, const void* indices);
+
+  virtual void
+  drawElementsBaseVertex (GLenum mode, GLsizei count, GLenum type, const void* indices,
+                          GLint basevertex);
+
+  virtual void
+  enable (GLenum cap);
+
+  virtual void
+  enableVertexAttribArray (GLuint index);
+
+  virtual GLsync
+  fenceSync (GLenum condition, GLbitfield flags);
+
+  virtual void
+  frontFace (GLenum mode);
+
+  virtual void
+  genBuffers (GLsizei n, GLuint* buffers);
+
+  virtual void
+  genVertexArrays (GLsizei n, GLuint* arrays);
+
+  virtual GLint
+  getAttribLocation (GLuint program, const GLchar* name);
+
+  virtual void
+  getProgramInfoLog (GLuint program, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
+
+  virtual void
+  getProgramiv (GLuint program, GLenum pname, GLint* params);
+
+  virtual void
+  getShaderInfoLog (GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
+
+  virtual void
+  getShaderiv (GLuint shader, GLenum pname, GLint* params);
+
+  virtual const GLubyte*
+  getString (GLenum name);
+
+  virtual GLint
+  getUniformLocation (GLuint program, const GLchar* name);
+
+  virtual void
+  linkProgram (GLuint program);
+
+  virtual void*
+  mapBufferRange (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+
+  virtual void
+  primitiveRestartIndex (GLuint index);
+
+  virtual void
+  shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length);
+
+  virtual void
+  uniform1i (GLint location, GLint v0);
+
+  virtual void
+  uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+
+  virtual GLboolean
+  unmapBuffer (GLenum target);
+
+  virtual void
+  useProgram (GLuint program);
+
+  virtual void
+  vertexAttribPointer (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer);
+
+  virtual void
+  viewport (GLint x, GLint y, GLsizei width, GLsizei height);
+
+private:
+  /// The next name to hand out for any kind of object.
+  GLuint m_nextName;
+  /// The vertex array that is bound.
+  GLuint m_vertexArray;
+  /// The buffer bound to each target.  Element array buffers are instead
+  ///   remembered per vertex array, as OpenGL does.
+  std::map<GLenum, GLuint> m_boundBuffers;
+  /// The element array buffer bound in each vertex array.
+  std::map<GLuint, GLuint> m_elementBuffers;
+  /// The contents of every buffer that has been filled.
+  std::map<GLuint, Buffer> m_buffers;
+  /// Every call to drawElements.
+  std::vector<DrawCall> m_drawCalls;
+  /// Every call to vertexAttribPointer.
+  std::vector<AttributePointer> m_attributePointers;
+  /// Every capability that is enabled.
+  std::set<GLenum> m_enabled;
+  /// The primitive restart index.
+  GLuint m_restartIndex;
+  /// The buffer mapped through each target.
+  std::map<GLenum, GLuint> m_mappedBuffers;
+  /// Every call to mapBufferRange.
+  std::vector<MappedRange> m_mappedRanges;
+  /// Every fence that has not been deleted.
+  std::set<GLsync> m_syncs;
+  /// The number of calls to clientWaitSync.
+  unsigned int m_syncWaits;
+  /// The number of buffers and vertex arrays ever made.
+  unsigned int m_generatedObjects;
+  /// The longest timeout given to clientWaitSync.
+  GLuint64 m_longestSyncTimeout;
+  /// Whether clientWaitSync reports fences as signaled.
+  bool m_syncsSignaled;
+};
+
+#endif//MOCK_OPENGL_CONTEXT_HPP
@@ -6,6 +6,8 @@
 // System includes
 #include <vector>
 #include <cmath>
+#include <string>
+#include <utility>
 
 /******************************************************************/
 // Local includes
@@ -15,10 +17,45 @@
 #include "Geometry.hpp"
 #include "ColorsMesh.hpp"
 #include "NormalsMesh.hpp"
+#include "Primitives.hpp"
+
+/******************************************************************/
+/// The number of vertices along each side of the flag.
+static const unsigned int FLAG_SAMPLES = 32;
+
+/// \brief Writes the vertices of the flag as it is at some time, which are
+///   positions and colors in a grid with rows of FLAG_SAMPLES.
+/// \param[in] time The seconds the flag has been waving for.
+/// \param[out] vertices Where the vertices are written.
+static void
+writeFlag(double time, std::vector<float>& vertices)
+{
+  const float SPACING = 2.0f / (FLAG_SAMPLES - 1);
+  vertices.resize(FLAG_SAMPLES * FLAG_SAMPLES * 6);
+  float* vertex = vertices.data();
+  for(unsigned int row = 0; row < FLAG_SAMPLES; ++row)
+  {
+    for(unsigned int column = 0; column < FLAG_SAMPLES; ++column)
+    {
+      // The wave grows away from the pole.
+      float x = column * SPACING;
+      *vertex++ = x;
+      *vertex++ = row * SPACING;
+      *vertex++ = 0.15f * x * std::sin(3.0f * x - 4.0f * time);
+      bool stripe = (row * 6 / FLAG_SAMPLES) % 2 == 0;
+      *vertex++ = stripe ? 0.8f : 1.0f;
+      *vertex++ = stripe ? 0.1f : 1.0f;
+      *vertex++ = stripe ? 0.1f : 1.0f;
+    }
+  }
+}
 
 /******************************************************************/
 
 MyScene::MyScene(OpenGLContext* context, ShaderProgram* shaderColorInfo, ShaderProgram* shaderNormalVectors)
+  : m_registry(context),
+    m_arena(context),
+    m_flagTime(0.0)
 {
   // Constants needed for decagon
   const float x1Deca = std::cos(36.0f * M_PI/ 180.0f);
@@ -179,10 +216,12 @@ MyScene::MyScene(OpenGLContext* context, ShaderProgram* shaderColorInfo, ShaderP
   indexData(decagon, 6, decagonData, decagonIndices);
 
   this->add("decagon", new ColorsMesh(context, shaderColorInfo));
-  this->getMesh("decagon")->addGeometry(decagonData);
-  this->getMesh("decagon")->addIndices(decagonIndices);
+  this->getMesh("decagon")->addGeometry(std::move(decagonData));
+  this->getMesh("decagon")->addIndices(std::move(decagonIndices));
+  this->getMesh("decagon")->setBufferArena(&m_arena);
   this->getMesh("decagon")->moveRight(-1.0f);
   this->getMesh("decagon")->pitch(50.0f);
+  this->getMesh("decagon")->setPickable(true);
   this->getMesh("decagon")->prepareVao();
   
   // Constants for octacone
@@ -313,74 +352,182 @@ MyScene::MyScene(OpenGLContext* context, ShaderProgram* shaderColorInfo, ShaderP
   indexData(octacone, 6, octaconeData, octaconeIndices);
 
   this->add("octacone", new ColorsMesh(context, shaderColorInfo));
-  this->getMesh("octacone")->addGeometry(octaconeData);
-  this->getMesh("octacone")->addIndices(octaconeIndices);
+  this->getMesh("octacone")->addGeometry(std::move(octaconeData));
+  this->getMesh("octacone")->addIndices(std::move(octaconeIndices));
+  this->getMesh("octacone")->setBufferArena(&m_arena);
   this->getMesh("octacone")->shearLocalXByYz(0.5f, 0.5f);
   this->getMesh("octacone")->moveWorld(2.0f, Vector3(-1.0f, 2.0f, -1.0f));
+  this->getMesh("octacone")->setPickable(true);
   this->getMesh("octacone")->prepareVao();
 
   std::vector<Triangle> cube = buildCube();
+  const unsigned int VERTEX_COLOR_SEED = 1;
   
+  // The cubes' vertex data is written straight into each Mesh and indexed
+  //   there, so it is never copied between vectors.
   ColorsMesh* cubeRandomFaceColors = new ColorsMesh(context, shaderColorInfo);
   std::vector<Vector3> randomFaceColors = generateRandomFaceColors(cube);
-  std::vector<float> randomFaceColorsGeometry = dataWithFaceColors(cube, randomFaceColors);
-  std::vector<float> randomFaceColorsData;
-  std::vector<unsigned int> randomFaceColorsIndices;
-  indexData(randomFaceColorsGeometry, cubeRandomFaceColors->getFloatsPerVertex(), 
-    randomFaceColorsData, randomFaceColorsIndices);
+  writeFaceColors(cube, randomFaceColors,
+    cubeRandomFaceColors->stageGeometry(interleavedFloatCount(cube)));
+  cubeRandomFaceColors->indexGeometry();
+  cubeRandomFaceColors->setBufferArena(&m_arena);
   this->add("cubeRandomFaceColors", cubeRandomFaceColors);
-  this->getMesh("cubeRandomFaceColors")->addGeometry(randomFaceColorsData);
-  this->getMesh("cubeRandomFaceColors")->addIndices(randomFaceColorsIndices);
   this->getMesh("cubeRandomFaceColors")->moveUp(-4.0f);
   this->getMesh("cubeRandomFaceColors")->moveRight(-2.0f);
+  this->getMesh("cubeRandomFaceColors")->setPickable(true);
   this->getMesh("cubeRandomFaceColors")->prepareVao();
 
   ColorsMesh* cubeRandomVertexColors = new ColorsMesh(context, shaderColorInfo);
-  std::vector<Vector3> randomVertexColors = generateRandomVertexColors(cube);
-  std::vector<float> randomVertexColorsGeometry = dataWithVertexColors(cube, randomVertexColors);
-  std::vector<float> randomVertexColorsData;
-  std::vector<unsigned int> randomVertexColorsIndices;
-  indexData(randomVertexColorsGeometry, cubeRandomVertexColors->getFloatsPerVertex(), 
-    randomVertexColorsData, randomVertexColorsIndices);
+  std::vector<Vector3> randomVertexColors = generateRandomVertexColors(cube, VERTEX_COLOR_SEED);
+  writeVertexColors(cube, randomVertexColors,
+    cubeRandomVertexColors->stageGeometry(interleavedFloatCount(cube)));
+  cubeRandomVertexColors->indexGeometry();
+  cubeRandomVertexColors->setBufferArena(&m_arena);
+  cubeRandomVertexColors->setVertexFormat({PositionFormat::SNORM16, AttributeFormat::UNORM8});
   this->add("cubeRandomVertexColors", cubeRandomVertexColors);
-  this->getMesh("cubeRandomVertexColors")->addGeometry(randomVertexColorsData);
-  this->getMesh("cubeRandomVertexColors")->addIndices(randomVertexColorsIndices);
   this->getMesh("cubeRandomVertexColors")->moveUp(-3.0f);
   this->getMesh("cubeRandomVertexColors")->moveRight(2.0f);
+  this->getMesh("cubeRandomVertexColors")->setPickable(true);
   this->getMesh("cubeRandomVertexColors")->prepareVao();
 
   NormalsMesh* cubeFaceNormals = new NormalsMesh(context, shaderNormalVectors);
   std::vector<Vector3> faceNormals = computeFaceNormals(cube);
-  std::vector<float> faceNormalsGeometry = dataWithFaceNormals(cube, faceNormals);
-  std::vector<float> faceNormalsData;
-  std::vector<unsigned int> faceNormalsIndices;
-  indexData(faceNormalsGeometry, cubeFaceNormals->getFloatsPerVertex(), 
-    faceNormalsData, faceNormalsIndices);
+  writeFaceNormals(cube, faceNormals,
+    cubeFaceNormals->stageGeometry(interleavedFloatCount(cube)));
+  cubeFaceNormals->indexGeometry();
+  cubeFaceNormals->setGeometryRegistry(&m_registry);
   this->add("cubeFaceNormals", cubeFaceNormals);
-  this->getMesh("cubeFaceNormals")->addGeometry(faceNormalsData);
-  this->getMesh("cubeFaceNormals")->addIndices(faceNormalsIndices);
   this->getMesh("cubeFaceNormals")->moveUp(-2.0f);
   this->getMesh("cubeFaceNormals")->moveRight(-2.0f);
+  this->getMesh("cubeFaceNormals")->setPickable(true);
   this->getMesh("cubeFaceNormals")->prepareVao();
 
+  // A row of identical cubes, which all draw from the first one's buffers.
+  const unsigned int CUBE_ROW_LENGTH = 4;
+  for(unsigned int copy = 1; copy <= CUBE_ROW_LENGTH; ++copy)
+  {
+    NormalsMesh* cubeCopy = new NormalsMesh(context, shaderNormalVectors);
+    writeFaceNormals(cube, faceNormals,
+      cubeCopy->stageGeometry(interleavedFloatCount(cube)));
+    cubeCopy->indexGeometry();
+    cubeCopy->setGeometryRegistry(&m_registry);
+    std::string name = "cubeFaceNormals" + std::to_string(copy);
+    this->add(name, cubeCopy);
+    this->getMesh(name)->moveUp(-2.0f);
+    this->getMesh(name)->moveRight(-2.0f - 1.5f * copy);
+    this->getMesh(name)->setPickable(true);
+    this->getMesh(name)->prepareVao();
+  }
+
   NormalsMesh* cubeVertexNormals = new NormalsMesh(context, shaderNormalVectors);
   std::vector<Vector3> vertexNormals = computeVertexNormals(cube, faceNormals);
-  std::vector<float> vertexNormalsGeometry = dataWithVertexNormals(cube, vertexNormals);
-  std::vector<float> vertexNormalsData;
-  std::vector<unsigned int> vertexNormalsIndices;
-  indexData(vertexNormalsGeometry, cubeVertexNormals->getFloatsPerVertex(), 
-    vertexNormalsData, vertexNormalsIndices);
+  writeVertexNormals(cube, vertexNormals,
+    cubeVertexNormals->stageGeometry(interleavedFloatCount(cube)));
+  cubeVertexNormals->indexGeometry();
+  cubeVertexNormals->setBufferArena(&m_arena);
   this->add("cubeVertexNormals", cubeVertexNormals);
-  this->getMesh("cubeVertexNormals")->addGeometry(vertexNormalsData);
-  this->getMesh("cubeVertexNormals")->addIndices(vertexNormalsIndices);
   this->getMesh("cubeVertexNormals")->moveUp(-1.0f);
   this->getMesh("cubeVertexNormals")->moveRight(2.0f);
+  this->getMesh("cubeVertexNormals")->setPickable(true);
   this->getMesh("cubeVertexNormals")->prepareVao();
 
+  // Rolling terrain under the cubes, drawn as strips that each cover a whole
+  //   row of the grid.
+  const unsigned int TERRAIN_SAMPLES = 64;
+  std::vector<float> heights(TERRAIN_SAMPLES * TERRAIN_SAMPLES);
+  for(unsigned int sample = 0; sample < heights.size(); ++sample)
+  {
+    heights[sample] = 0.5f * std::sin((sample % TERRAIN_SAMPLES) * 0.2f)
+      * std::cos((sample / TERRAIN_SAMPLES) * 0.15f);
+  }
+  std::vector<float> terrainData;
+  std::vector<unsigned int> terrainIndices;
+  buildHeightField(heights, TERRAIN_SAMPLES, 0.25f, terrainData, terrainIndices);
+  NormalsMesh* terrain = new NormalsMesh(context, shaderNormalVectors);
+  terrain->addGeometry(std::move(terrainData));
+  terrain->addIndices(std::move(terrainIndices));
+  terrain->stripify();
+  // The terrain, pebbles, and flag are scenery, so they are left unpickable
+  //   and get no bounding volume hierarchy.
+  terrain->setBufferArena(&m_arena);
+  terrain->setGeometryRetention(GeometryRetention::DISCARD);
+  this->add("terrain", terrain);
+  this->getMesh("terrain")->moveUp(-7.0f);
+  this->getMesh("terrain")->prepareVao();
+
+  // Pebbles strewn over the terrain, which never move, so they are merged
+  //   into one Mesh and drawn with a single call.
+  const unsigned int PEBBLE_COUNT = 400;
+  std::vector<float> pebbleData;
+  std::vector<unsigned int> pebbleIndices;
+  buildIcosphere(0.1f, 1, pebbleData, pebbleIndices);
+  for(unsigned int pebble = 0; pebble < PEBBLE_COUNT; ++pebble)
+  {
+    NormalsMesh* mesh = new NormalsMesh(context, shaderNormalVectors);
+    mesh->addGeometry(pebbleData);
+    mesh->addIndices(pebbleIndices);
+    mesh->setStatic(true);
+    mesh->setBufferArena(&m_arena);
+    mesh->setGeometryRetention(GeometryRetention::DISCARD);
+    std::string name = "pebble" + std::to_string(pebble);
+    this->add(name, mesh);
+    unsigned int sample = (pebble * 2654435761u) % heights.size();
+    const float HALF_TERRAIN = (TERRAIN_SAMPLES - 1) / 2.0f;
+    this->getMesh(name)->moveWorld(1.0f,
+      Vector3(0.25f * (sample % TERRAIN_SAMPLES - HALF_TERRAIN), heights[sample] - 7.0f,
+        0.25f * (sample / TERRAIN_SAMPLES - HALF_TERRAIN)));
+    this->getMesh(name)->yaw(pebble * 37.0f);
+    this->getMesh(name)->scaleLocal(1.0f + (pebble % 3) * 0.5f, 0.6f, 1.0f);
+  }
+  this->batchStaticMeshes();
+
+  // The bear is stored in 12 bytes per vertex instead of 24.
   NormalsMesh* bear = new NormalsMesh(context, shaderNormalVectors, "models/bear.obj", 0);
+  bear->setVertexFormat({PositionFormat::HALF_FLOAT, AttributeFormat::OCTAHEDRAL_SNORM16});
+  bear->buildMeshlets();
+  // Picking only needs the bounding volume hierarchy, so once the bear is
+  //   uploaded its vertices need not be kept.
+  bear->setGeometryRetention(GeometryRetention::DISCARD);
   this->add("bear", bear);
   this->getMesh("bear")->scaleWorld(0.1f);
   this->getMesh("bear")->yaw(30.0f);
   this->getMesh("bear")->moveWorld(-15.0f, Vector3(0.0f, 1.0f, 0.0f));
+  this->getMesh("bear")->setPickable(true);
   this->getMesh("bear")->prepareVao();
-}
\ No newline at end of file
+
+  // A flag whose vertices are rewritten every frame, through a ring of
+  //   buffer regions so that no update waits on a draw.
+  std::vector<float> flagData;
+  writeFlag(m_flagTime, flagData);
+  std::vector<unsigned int> flagIndices;
+  for(unsigned int row = 0; row + 1 < FLAG_SAMPLES; ++row)
+  {
+    for(unsigned int column = 0; column + 1 < FLAG_SAMPLES; ++column)
+    {
+      unsigned int corner = row * FLAG_SAMPLES + column;
+      flagIndices.insert(flagIndices.end(), {corner, corner + 1, corner + FLAG_SAMPLES,
+        corner + 1, corner + FLAG_SAMPLES + 1, corner + FLAG_SAMPLES});
+    }
+  }
+  ColorsMesh* flag = new ColorsMesh(context, shaderColorInfo);
+  flag->addGeometry(std::move(flagData));
+  flag->addIndices(std::move(flagIndices));
+  flag->setStreaming(StreamingMode::RING);
+  this->add("flag", flag);
+  this->getMesh("flag")->moveWorld(1.0f, Vector3(4.0f, 1.0f, 0.0f));
+  this->getMesh("flag")->prepareVao();
+}
+
+void
+MyScene::update(double seconds)
+{
+  m_flagTime += seconds;
+  std::vector<float> flagData;
+  writeFlag(m_flagTime, flagData);
+  this->getMesh("flag")->updateVertices(0, flagData);
+}
+
+MyScene::~MyScene()
+{
+  clear();
+}
@@ -12,6 +12,8 @@
 #include "Scene.hpp"
 #include "OpenGLContext.hpp"
 #include "ShaderProgram.hpp"
+#include "GeometryRegistry.hpp"
+#include "BufferArena.hpp"
 
 /******************************************************************/
 class MyScene : public Scene
@@ -19,13 +21,28 @@ class MyScene : public Scene
 public:
   MyScene(OpenGLContext* context, ShaderProgram* shaderColorInfo, ShaderProgram* shaderNormalVectors);
 
+  /// \brief Destructs a MyScene, deleting its meshes before the registry
+  ///   and arena they share buffers through.
+  ~MyScene();
+
   MyScene(const MyScene&) = delete;
 
   void
   operator=(const MyScene&) = delete;
+
+  /// \brief Waves the flag.
+  /// \param[in] seconds The time since the last update.
+  void
+  update(double seconds) override;
   
 private:
-
+  /// Lets meshes built from the same geometry share their buffers.
+  GeometryRegistry m_registry;
+  /// Holds the geometry of the other meshes in a few large buffers, one set
+  ///   per vertex layout.
+  BufferArena m_arena;
+  /// The seconds the flag has been waving for.
+  double m_flagTime;
 };
 
 #endif // MYSCENE_HPP
\ No newline at end of file
@@ -4,6 +4,7 @@
 /// \version A08
 /******************************************************************/
 // System includes
+#include <utility>
 #include <assimp/scene.h>
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
@@ -12,11 +13,12 @@
 // Local includes
 #include "Mesh.hpp"
 #include "NormalsMesh.hpp"
+#include "MeshOptimizer.hpp"
 
 /******************************************************************/
 
 NormalsMesh::NormalsMesh(OpenGLContext* context, ShaderProgram* shader)
-  : Mesh(context, shader)
+  : Mesh(context, shader, NormalsLayout())
 {
 }
 
@@ -44,17 +46,13 @@ NormalsMesh::NormalsMesh (OpenGLContext* context, ShaderProgram* shader, std::st
     else
     {
       const aiMesh* mesh = scene->mMeshes[meshNum];
-      std::vector<float> vertexData;
+      const unsigned int FLOATS_PER_VERTEX = NormalsLayout::FLOATS_PER_VERTEX;
+      // assimp keeps positions and normals in arrays of three floats each.
+      std::vector<float> vertexData (mesh->mNumVertices * FLOATS_PER_VERTEX);
+      NormalsLayout::interleave (vertexData.data (), mesh->mNumVertices,
+                                 &mesh->mVertices[0].x, &mesh->mNormals[0].x);
       std::vector<unsigned int> indexes;
-      for (unsigned vertexNum = 0; vertexNum < mesh->mNumVertices; ++vertexNum)
-      {
-				vertexData.push_back (mesh->mVertices[vertexNum].x);
-				vertexData.push_back (mesh->mVertices[vertexNum].y);
-				vertexData.push_back (mesh->mVertices[vertexNum].z);
-				vertexData.push_back (mesh->mNormals[vertexNum].x);
-				vertexData.push_back (mesh->mNormals[vertexNum].y);
-				vertexData.push_back (mesh->mNormals[vertexNum].z);
-      }
+      indexes.reserve (mesh->mNumFaces * 3);
       for (unsigned int faceNum = 0; faceNum < mesh->mNumFaces; ++faceNum)
       {
 				const aiFace& face = mesh->mFaces[faceNum];
@@ -64,28 +62,17 @@ NormalsMesh::NormalsMesh (OpenGLContext* context, ShaderProgram* shader, std::st
 					indexes.push_back (vertexNum);
 				}
       }
-      addGeometry (vertexData);
-      addIndices (indexes);
+      // assimp only joins vertices that match exactly, so normals that
+      //   differ by rounding still split the surface.
+      weldVertices (vertexData, FLOATS_PER_VERTEX, indexes, VertexAttribute::NORMAL);
+      // Imported faces come in whatever order the modeler left them, which
+      //   makes poor use of the GPU's post-transform vertex cache, and the
+      //   vertices then need to follow the faces to be read in order.
+      indexes = optimizeVertexCache (indexes, vertexData.size () / FLOATS_PER_VERTEX);
+      remapVerticesForFetch (vertexData, indexes, FLOATS_PER_VERTEX);
+      // The Mesh takes over both buffers, so the model is never copied.
+      addGeometry (std::move (vertexData));
+      addIndices (std::move (indexes));
     }
   }
-}
-
-unsigned int
-NormalsMesh::getFloatsPerVertex() const
-{
-  return 3 + Mesh::getFloatsPerVertex();
-}
-
-void
-NormalsMesh::enableAttributes()
-{
-	const GLint NORMAL_ATTRIB_INDEX = 2;
-	const GLsizei VERTEX_STRIDE = 6 * sizeof(float);
-	const GLintptr NORMAL_OFFSET = 3 * sizeof(float);
-
-	m_context->enableVertexAttribArray(NORMAL_ATTRIB_INDEX);
-	m_context->vertexAttribPointer(NORMAL_ATTRIB_INDEX, 3, GL_FLOAT, GL_FALSE, VERTEX_STRIDE,
-		reinterpret_cast<void*>(NORMAL_OFFSET));
-
-  Mesh::enableAttributes();
 }
\ No newline at end of file
@@ -11,6 +11,7 @@
 
 /******************************************************************/
 
+/// \brief A Mesh laid out as a NormalsLayout: a position and then a normal.
 class NormalsMesh : public Mesh
 {
 public:
@@ -29,16 +30,9 @@ public:
   /// \post A unique VAO, VBO, and IBO have been generated for this Mesh and
   ///   stored for later use.
   /// \post If that file exists and contains a mesh of that number, the indexes
-  ///   and geometry from it have been pre-populated into this Mesh.  Otherwise
+  ///   and geometry from it have been welded with DEFAULT_WELD_TOLERANCES and
+  ///   pre-populated into this Mesh.  Otherwise
   ///   this Mesh is empty and an error message has been printed.
   NormalsMesh (OpenGLContext* context, ShaderProgram* shader, std::string fileName, 
     unsigned int meshNum);
-
-
-  virtual unsigned int
-  getFloatsPerVertex() const;
-protected:
-  virtual void
-  enableAttributes();
-
 };
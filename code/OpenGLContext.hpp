@@ -44,6 +44,10 @@ public:
   virtual void
   bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage) = 0;
 
+  /// See documentation of glBufferSubData.
+  virtual void
+  bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data) = 0;
+
   /// See documentation of glClear.
   virtual void
   clear (GLbitfield mask) = 0;
@@ -52,6 +56,10 @@ public:
   virtual void
   clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) = 0;
 
+  /// See documentation of glClientWaitSync.
+  virtual GLenum
+  clientWaitSync (GLsync sync, GLbitfield flags, GLuint64 timeout) = 0;
+
   /// See documentation of glCompileShader.
   virtual void
   compileShader (GLuint shader) = 0;
@@ -80,6 +88,10 @@ public:
   virtual void
   deleteShader (GLuint shader) = 0;
 
+  /// See documentation of glDeleteSync.
+  virtual void
+  deleteSync (GLsync sync) = 0;
+
   /// See documentation of glDeleteVertexArrays.
   virtual void
   deleteVertexArrays (GLsizei n, const GLuint* arrays) = 0;
@@ -88,6 +100,10 @@ public:
   virtual void
   detachShader (GLuint program, GLuint shader) = 0;
 
+  /// See documentation of glDisable.
+  virtual void
+  disable (GLenum cap) = 0;
+
   /// See documentation of glDrawArrays.
   virtual void
   drawArrays (GLenum mode, GLint first, GLsizei count) = 0;
@@ -96,6 +112,11 @@ public:
   virtual void
   drawElements (GLenum mode, GLsizei count, GLenum type, const void* indices) = 0;
 
+  /// See documentation of glDrawElementsBaseVertex.
+  virtual void
+  drawElementsBaseVertex (GLenum mode, GLsizei count, GLenum type, const void* indices,
+                          GLint basevertex) = 0;
+
   /// See documentation of glEnable.
   virtual void
   enable (GLenum cap) = 0;
@@ -104,6 +125,10 @@ public:
   virtual void
   enableVertexAttribArray (GLuint index) = 0;
 
+  /// See documentation of glFenceSync.
+  virtual GLsync
+  fenceSync (GLenum condition, GLbitfield flags) = 0;
+
   /// See documentation of glFrontFace.
   virtual void
   frontFace (GLenum mode) = 0;
@@ -148,14 +173,30 @@ public:
   virtual void
   linkProgram (GLuint program) = 0;
 
+  /// See documentation of glMapBufferRange.
+  virtual void*
+  mapBufferRange (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) = 0;
+
+  /// See documentation of glPrimitiveRestartIndex.
+  virtual void
+  primitiveRestartIndex (GLuint index) = 0;
+
   /// See documentation of glShaderSource.
   virtual void
   shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length) = 0;
 
+  /// See documentation of glUniform1i.
+  virtual void
+  uniform1i (GLint location, GLint v0) = 0;
+
   /// See documentation of glUniformMatrix4fv.
   virtual void
   uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) = 0;
 
+  /// See documentation of glUnmapBuffer.
+  virtual GLboolean
+  unmapBuffer (GLenum target) = 0;
+
   /// See documentation of glUseProgram.
   virtual void
   useProgram (GLuint program) = 0;
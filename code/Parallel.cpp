@@ -0,0 +1,71 @@
+/// \file Parallel.cpp
+/// \brief Definitions of global functions for spreading work across threads.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// System includes
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/******************************************************************/
+// Local includes
+#include "Parallel.hpp"
+
+/******************************************************************/
+unsigned int
+resolveThreadCount (unsigned int threadCount)
+{
+  if (threadCount == 0)
+  {
+    threadCount = std::thread::hardware_concurrency ();
+  }
+  return std::max (1u, threadCount);
+}
+
+void
+parallelFor (unsigned int chunkCount, unsigned int threadCount,
+             const std::function<void (unsigned int)>& task)
+{
+  const unsigned int workers = std::min (resolveThreadCount (threadCount), chunkCount);
+  std::atomic<unsigned int> nextChunk (0);
+  std::exception_ptr failure;
+  std::mutex failureMutex;
+  // Each worker keeps claiming the next unclaimed chunk until none are left,
+  //   so uneven chunks still balance out.
+  auto work = [&] ()
+  {
+    for (unsigned int chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++)
+    {
+      try
+      {
+        task (chunk);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock (failureMutex);
+        if (!failure)
+        {
+          failure = std::current_exception ();
+        }
+      }
+    }
+  };
+  std::vector<std::thread> pool;
+  for (unsigned int worker = 1; worker < workers; worker++)
+  {
+    pool.emplace_back (work);
+  }
+  work ();
+  for (std::thread& thread : pool)
+  {
+    thread.join ();
+  }
+  if (failure)
+  {
+    std::rethrow_exception (failure);
+  }
+}
@@ -0,0 +1,38 @@
+/// \file Parallel.hpp
+/// \brief Declarations of global functions for spreading work across threads.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// Macro guard
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+/******************************************************************/
+// System includes
+#include <functional>
+
+/******************************************************************/
+/// \brief Gets the number of threads that should actually be used.
+/// \param[in] threadCount The number of threads requested, where 0 means one
+///   per hardware thread.
+/// \return The number of threads to use, which is at least 1.
+unsigned int
+resolveThreadCount (unsigned int threadCount);
+
+/// \brief Runs a task once for each chunk of some work, spreading the chunks
+///   over a pool of threads.
+/// \param[in] chunkCount The number of chunks.  The task will be called with
+///   each chunk index from 0 to chunkCount - 1 exactly once.
+/// \param[in] threadCount The number of threads to use, where 0 means one per
+///   hardware thread.  The calling thread is one of them, so 1 runs every chunk
+///   on the calling thread.
+/// \param[in] task The work for a single chunk.  Chunks may run in any order
+///   and at the same time, so tasks must only write to data owned by their
+///   own chunk.
+/// \post Every chunk has finished.  If any task threw an exception, one of
+///   those exceptions has been rethrown.
+void
+parallelFor (unsigned int chunkCount, unsigned int threadCount,
+             const std::function<void (unsigned int)>& task);
+
+#endif//PARALLEL_HPP
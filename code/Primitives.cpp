@@ -0,0 +1,394 @@
+/// \file Primitives.cpp
+/// \brief Definitions of global functions that generate common shapes as
+///   indexed vertex data, ready for Mesh::addGeometry and Mesh::addIndices.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// System includes
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+/******************************************************************/
+// Local includes
+#include "Primitives.hpp"
+#include "Parallel.hpp"
+#include "Vector3.hpp"
+
+/******************************************************************/
+/// \brief Writes one vertex's position and normal.
+/// \param[out] data The vertex data, already sized to hold the vertex.
+/// \param[in] vertex Which vertex to write.
+/// \param[in] position Its position.
+/// \param[in] normal Its unit normal.
+static void
+writeVertex (std::vector<float>& data, unsigned int vertex, const Vector3& position,
+             const Vector3& normal)
+{
+  float* out = &data[static_cast<std::size_t> (vertex) * PRIMITIVE_FLOATS_PER_VERTEX];
+  out[0] = position.m_x;
+  out[1] = position.m_y;
+  out[2] = position.m_z;
+  out[3] = normal.m_x;
+  out[4] = normal.m_y;
+  out[5] = normal.m_z;
+}
+
+/// \brief Writes one triangle.
+/// \param[out] indices The indices, already sized to hold the triangle.
+/// \param[in] triangle Which triangle to write.
+static void
+writeTriangle (std::vector<unsigned int>& indices, unsigned int triangle,
+               unsigned int a, unsigned int b, unsigned int c)
+{
+  unsigned int* out = &indices[static_cast<std::size_t> (triangle) * 3];
+  out[0] = a;
+  out[1] = b;
+  out[2] = c;
+}
+
+/// \brief Writes a quad as two triangles.
+/// \param[out] indices The indices, already sized to hold both triangles.
+/// \param[in] triangle Which triangle to write first.
+/// \param[in] a, b, c, d The quad's corners, counterclockwise from outside.
+static void
+writeQuad (std::vector<unsigned int>& indices, unsigned int triangle,
+           unsigned int a, unsigned int b, unsigned int c, unsigned int d)
+{
+  writeTriangle (indices, triangle, a, b, c);
+  writeTriangle (indices, triangle + 1, a, c, d);
+}
+
+/// \brief Gets the point on the unit circle in the XZ plane at some fraction
+///   of the way around, starting at +X and turning toward +Z.
+static Vector3
+around (unsigned int step, unsigned int steps)
+{
+  double angle = 2.0 * M_PI * step / steps;
+  return Vector3 (static_cast<float> (std::cos (angle)), 0.0f,
+                  static_cast<float> (std::sin (angle)));
+}
+
+/// \brief Gets evenly spaced points around the unit circle, so generators
+///   look up their rings instead of calling cos and sin for every vertex.
+static std::vector<Vector3>
+circle (unsigned int steps)
+{
+  std::vector<Vector3> points (steps);
+  for (unsigned int step = 0; step < steps; step++)
+  {
+    points[step] = around (step, steps);
+  }
+  return points;
+}
+
+void
+buildUvSphere (float radius, unsigned int slices, unsigned int stacks,
+               std::vector<float>& data, std::vector<unsigned int>& indices,
+               unsigned int threadCount)
+{
+  assert (slices >= 3 && stacks >= 2);
+  // The north pole is vertex 0, then each ring from north to south, then
+  //   the south pole.
+  const unsigned int rings = stacks - 1;
+  const unsigned int south = 1 + rings * slices;
+  data.assign (static_cast<std::size_t> (south + 1) * PRIMITIVE_FLOATS_PER_VERTEX, 0.0f);
+  indices.assign (static_cast<std::size_t> (2) * slices * rings * 3, 0);
+  auto ringVertex = [&] (unsigned int ring, unsigned int slice) {
+    return 1 + ring * slices + slice % slices;
+  };
+
+  const std::vector<Vector3> slicePoints = circle (slices);
+  writeVertex (data, 0, Vector3 (0.0f, radius, 0.0f), Vector3 (0.0f, 1.0f, 0.0f));
+  writeVertex (data, south, Vector3 (0.0f, -radius, 0.0f), Vector3 (0.0f, -1.0f, 0.0f));
+  // Chunk k writes ring k, and the band of triangles above it.  The last
+  //   chunk also writes the fan around the south pole.
+  parallelFor (rings, threadCount, [&] (unsigned int ring)
+  {
+    double polar = M_PI * (ring + 1) / stacks;
+    float height = static_cast<float> (std::cos (polar));
+    float width = static_cast<float> (std::sin (polar));
+    for (unsigned int slice = 0; slice < slices; slice++)
+    {
+      Vector3 normal = slicePoints[slice] * width;
+      normal.m_y = height;
+      writeVertex (data, ringVertex (ring, slice), normal * radius, normal);
+    }
+
+    unsigned int triangle = ring == 0 ? 0 : slices + 2 * slices * (ring - 1);
+    for (unsigned int slice = 0; slice < slices; slice++)
+    {
+      if (ring == 0)
+      {
+        writeTriangle (indices, triangle++, 0, ringVertex (0, slice + 1), ringVertex (0, slice));
+      }
+      else
+      {
+        writeQuad (indices, triangle, ringVertex (ring - 1, slice), ringVertex (ring - 1, slice + 1),
+                   ringVertex (ring, slice + 1), ringVertex (ring, slice));
+        triangle += 2;
+      }
+    }
+    if (ring + 1 == rings)
+    {
+      for (unsigned int slice = 0; slice < slices; slice++)
+      {
+        writeTriangle (indices, triangle++, ringVertex (ring, slice), ringVertex (ring, slice + 1), south);
+      }
+    }
+  });
+}
+
+void
+buildIcosphere (float radius, unsigned int frequency,
+                std::vector<float>& data, std::vector<unsigned int>& indices,
+                unsigned int threadCount)
+{
+  assert (frequency >= 1);
+  const float T = static_cast<float> ((1.0 + std::sqrt (5.0)) / 2.0);
+  const Vector3 CORNERS[12] = {
+    Vector3 (-1, T, 0), Vector3 (1, T, 0), Vector3 (-1, -T, 0), Vector3 (1, -T, 0),
+    Vector3 (0, -1, T), Vector3 (0, 1, T), Vector3 (0, -1, -T), Vector3 (0, 1, -T),
+    Vector3 (T, 0, -1), Vector3 (T, 0, 1), Vector3 (-T, 0, -1), Vector3 (-T, 0, 1) };
+  const unsigned int FACES[20][3] = {
+    {0, 11, 5}, {0, 5, 1}, {0, 1, 7}, {0, 7, 10}, {0, 10, 11},
+    {1, 5, 9}, {5, 11, 4}, {11, 10, 2}, {10, 7, 6}, {7, 1, 8},
+    {3, 9, 4}, {3, 4, 2}, {3, 2, 6}, {3, 6, 8}, {3, 8, 9},
+    {4, 9, 5}, {2, 4, 11}, {6, 2, 10}, {8, 6, 7}, {9, 8, 1} };
+
+  // Every vertex has a fixed place: the 12 corners, then the points inside
+  //   each of the 30 edges, then the points inside each face.  Faces that
+  //   share an edge find its points by the same numbering, so nothing is ever
+  //   duplicated.
+  const unsigned int n = frequency;
+  unsigned int edgeOf[12][12];
+  unsigned int edgeEnds[30][2];
+  unsigned int edgeCount = 0;
+  for (const unsigned int* face : FACES)
+  {
+    for (unsigned int side = 0; side < 3; side++)
+    {
+      unsigned int low = std::min (face[side], face[(side + 1) % 3]);
+      unsigned int high = std::max (face[side], face[(side + 1) % 3]);
+      if (edgeCount == 0 || std::none_of (edgeEnds, edgeEnds + edgeCount, [&] (const unsigned int* ends) {
+            return ends[0] == low && ends[1] == high; }))
+      {
+        edgeEnds[edgeCount][0] = low;
+        edgeEnds[edgeCount][1] = high;
+        edgeOf[low][high] = edgeOf[high][low] = edgeCount++;
+      }
+    }
+  }
+  assert (edgeCount == 30);
+  const unsigned int EDGE_BASE = 12;
+  const unsigned int FACE_BASE = EDGE_BASE + 30 * (n - 1);
+  const unsigned int PER_FACE = (n - 1) * (n >= 2 ? n - 2 : 0) / 2;
+  data.assign (static_cast<std::size_t> (FACE_BASE + 20 * PER_FACE) * PRIMITIVE_FLOATS_PER_VERTEX, 0.0f);
+  indices.assign (static_cast<std::size_t> (20) * n * n * 3, 0);
+
+  auto writePoint = [&] (unsigned int vertex, Vector3 direction) {
+    direction.normalize ();
+    writeVertex (data, vertex, direction * radius, direction);
+  };
+  for (unsigned int corner = 0; corner < 12; corner++)
+  {
+    writePoint (corner, CORNERS[corner]);
+  }
+  for (unsigned int edge = 0; edge < 30; edge++)
+  {
+    const Vector3& from = CORNERS[edgeEnds[edge][0]];
+    const Vector3& to = CORNERS[edgeEnds[edge][1]];
+    for (unsigned int step = 1; step < n; step++)
+    {
+      writePoint (EDGE_BASE + edge * (n - 1) + step - 1, from + (to - from) * (static_cast<float> (step) / n));
+    }
+  }
+
+  // On a face with corners A, B, C, point (i, j) is i steps toward B and j
+  //   steps toward C.
+  parallelFor (20, threadCount, [&] (unsigned int face)
+  {
+    const unsigned int* corner = FACES[face];
+    auto onEdge = [&] (unsigned int from, unsigned int to, unsigned int step) {
+      unsigned int edge = edgeOf[from][to];
+      unsigned int fromLow = from < to ? step : n - step;
+      return EDGE_BASE + edge * (n - 1) + fromLow - 1;
+    };
+    auto vertexAt = [&] (unsigned int i, unsigned int j) {
+      if (i + j == 0)
+      {
+        return corner[0];
+      }
+      if (i == n)
+      {
+        return corner[1];
+      }
+      if (j == n)
+      {
+        return corner[2];
+      }
+      if (j == 0)
+      {
+        return onEdge (corner[0], corner[1], i);
+      }
+      if (i == 0)
+      {
+        return onEdge (corner[0], corner[2], j);
+      }
+      if (i + j == n)
+      {
+        return onEdge (corner[1], corner[2], j);
+      }
+      return FACE_BASE + face * PER_FACE + (j - 1) * (n - 1) - (j - 1) * j / 2 + i - 1;
+    };
+
+    const Vector3& a = CORNERS[corner[0]];
+    const Vector3 toB = (CORNERS[corner[1]] - a) / static_cast<float> (n);
+    const Vector3 toC = (CORNERS[corner[2]] - a) / static_cast<float> (n);
+    for (unsigned int j = 1; j + 1 < n; j++)
+    {
+      for (unsigned int i = 1; i + j < n; i++)
+      {
+        writePoint (vertexAt (i, j), a + toB * static_cast<float> (i) + toC * static_cast<float> (j));
+      }
+    }
+
+    unsigned int triangle = face * n * n;
+    for (unsigned int j = 0; j < n; j++)
+    {
+      for (unsigned int i = 0; i + j < n; i++)
+      {
+        writeTriangle (indices, triangle++, vertexAt (i, j), vertexAt (i + 1, j), vertexAt (i, j + 1));
+        if (i + j + 1 < n)
+        {
+          writeTriangle (indices, triangle++, vertexAt (i + 1, j), vertexAt (i + 1, j + 1), vertexAt (i, j + 1));
+        }
+      }
+    }
+  });
+}
+
+void
+buildTorus (float majorRadius, float minorRadius, unsigned int majorSegments,
+            unsigned int minorSegments, std::vector<float>& data,
+            std::vector<unsigned int>& indices, unsigned int threadCount)
+{
+  assert (majorSegments >= 3 && minorSegments >= 3);
+  data.assign (static_cast<std::size_t> (majorSegments) * minorSegments * PRIMITIVE_FLOATS_PER_VERTEX, 0.0f);
+  indices.assign (static_cast<std::size_t> (2) * majorSegments * minorSegments * 3, 0);
+  auto vertexAt = [&] (unsigned int major, unsigned int minor) {
+    return major % majorSegments * minorSegments + minor % minorSegments;
+  };
+
+  const std::vector<Vector3> majorPoints = circle (majorSegments);
+  const std::vector<Vector3> minorPoints = circle (minorSegments);
+  parallelFor (majorSegments, threadCount, [&] (unsigned int major)
+  {
+    const Vector3& outward = majorPoints[major];
+    for (unsigned int minor = 0; minor < minorSegments; minor++)
+    {
+      const Vector3& tube = minorPoints[minor];
+      Vector3 normal = outward * tube.m_x + Vector3 (0.0f, tube.m_z, 0.0f);
+      writeVertex (data, vertexAt (major, minor), outward * majorRadius + normal * minorRadius, normal);
+      writeQuad (indices, 2 * vertexAt (major, minor), vertexAt (major, minor + 1),
+                 vertexAt (major + 1, minor + 1), vertexAt (major + 1, minor), vertexAt (major, minor));
+    }
+  });
+}
+
+void
+buildCylinder (float radius, float height, unsigned int slices, unsigned int stacks,
+               std::vector<float>& data, std::vector<unsigned int>& indices,
+               unsigned int threadCount)
+{
+  assert (slices >= 3 && stacks >= 1);
+  // The side's rings come first, from bottom to top, then each cap's center
+  //   and rim.
+  const unsigned int sideVertices = (stacks + 1) * slices;
+  const unsigned int capBase[2] = { sideVertices, sideVertices + slices + 1 };
+  data.assign (static_cast<std::size_t> (sideVertices + 2 * (slices + 1)) * PRIMITIVE_FLOATS_PER_VERTEX, 0.0f);
+  indices.assign (static_cast<std::size_t> (2) * slices * (stacks + 1) * 3, 0);
+  auto sideVertex = [&] (unsigned int ring, unsigned int slice) {
+    return ring * slices + slice % slices;
+  };
+
+  const std::vector<Vector3> slicePoints = circle (slices);
+  parallelFor (stacks + 1, threadCount, [&] (unsigned int ring)
+  {
+    float y = height * (static_cast<float> (ring) / stacks - 0.5f);
+    for (unsigned int slice = 0; slice < slices; slice++)
+    {
+      const Vector3& normal = slicePoints[slice];
+      writeVertex (data, sideVertex (ring, slice), normal * radius + Vector3 (0.0f, y, 0.0f), normal);
+      if (ring > 0)
+      {
+        writeQuad (indices, 2 * ((ring - 1) * slices + slice), sideVertex (ring, slice),
+                   sideVertex (ring, slice + 1), sideVertex (ring - 1, slice + 1), sideVertex (ring - 1, slice));
+      }
+    }
+  });
+
+  for (unsigned int cap = 0; cap < 2; cap++)
+  {
+    const float side = cap == 0 ? -1.0f : 1.0f;
+    const Vector3 normal (0.0f, side, 0.0f);
+    const unsigned int center = capBase[cap];
+    writeVertex (data, center, normal * (height / 2.0f), normal);
+    unsigned int triangle = 2 * slices * stacks + cap * slices;
+    for (unsigned int slice = 0; slice < slices; slice++)
+    {
+      writeVertex (data, center + 1 + slice, slicePoints[slice] * radius + normal * (height / 2.0f), normal);
+      unsigned int here = center + 1 + slice;
+      unsigned int next = center + 1 + (slice + 1) % slices;
+      if (cap == 0)
+      {
+        writeTriangle (indices, triangle++, center, here, next);
+      }
+      else
+      {
+        writeTriangle (indices, triangle++, center, next, here);
+      }
+    }
+  }
+}
+
+void
+buildHeightField (const std::vector<float>& heights, unsigned int columns, float spacing,
+                  std::vector<float>& data, std::vector<unsigned int>& indices,
+                  unsigned int threadCount)
+{
+  assert (columns >= 2 && heights.size () % columns == 0 && heights.size () >= 2 * columns);
+  const unsigned int rows = heights.size () / columns;
+  data.assign (heights.size () * PRIMITIVE_FLOATS_PER_VERTEX, 0.0f);
+  indices.assign (static_cast<std::size_t> (2) * (columns - 1) * (rows - 1) * 3, 0);
+  const float left = -0.5f * spacing * (columns - 1);
+  const float front = -0.5f * spacing * (rows - 1);
+  auto heightAt = [&] (unsigned int row, unsigned int column) {
+    return heights[static_cast<std::size_t> (row) * columns + column];
+  };
+
+  parallelFor (rows, threadCount, [&] (unsigned int row)
+  {
+    // Slopes are central differences, or one sided along the border.
+    unsigned int back = std::min (row + 1, rows - 1);
+    unsigned int ahead = row == 0 ? 0 : row - 1;
+    for (unsigned int column = 0; column < columns; column++)
+    {
+      unsigned int right = std::min (column + 1, columns - 1);
+      unsigned int leftColumn = column == 0 ? 0 : column - 1;
+      float slopeX = (heightAt (row, right) - heightAt (row, leftColumn)) / ((right - leftColumn) * spacing);
+      float slopeZ = (heightAt (back, column) - heightAt (ahead, column)) / ((back - ahead) * spacing);
+      Vector3 normal (-slopeX, 1.0f, -slopeZ);
+      normal.normalize ();
+      unsigned int vertex = row * columns + column;
+      writeVertex (data, vertex, Vector3 (left + column * spacing, heightAt (row, column),
+                                          front + row * spacing), normal);
+      if (row + 1 < rows && column + 1 < columns)
+      {
+        writeQuad (indices, 2 * (row * (columns - 1) + column), vertex, vertex + columns,
+                   vertex + columns + 1, vertex + 1);
+      }
+    }
+  });
+}
@@ -0,0 +1,112 @@
+/// \file Primitives.hpp
+/// \brief Declarations of global functions that generate common shapes as
+///   indexed vertex data, ready for Mesh::addGeometry and Mesh::addIndices.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// Macro guard
+#ifndef PRIMITIVES_HPP
+#define PRIMITIVES_HPP
+
+/******************************************************************/
+// System includes
+#include <vector>
+
+/******************************************************************/
+/// The number of floats each generator writes per vertex: a position, then a
+///   unit normal.
+const unsigned int PRIMITIVE_FLOATS_PER_VERTEX = 6;
+
+/// \brief Generates a sphere from rings of latitude and longitude.
+/// \param[in] radius The sphere's radius.
+/// \param[in] slices The number of vertices around each ring.
+/// \param[in] stacks The number of bands from pole to pole.
+/// \param[out] data Replaced by six floats per vertex: (stacks - 1) * slices
+///   ring vertices, and one at each pole.
+/// \param[out] indices Replaced by three indices per triangle, 2 * slices *
+///   (stacks - 1) triangles in all.
+/// \param[in] threadCount The number of threads to use, where 0 means one per
+///   hardware thread.
+/// \pre slices >= 3 and stacks >= 2.
+/// Every generator sizes its outputs exactly once, shares every vertex that
+///   its triangles meet at, and winds triangles counterclockwise seen from
+///   outside, so nothing needs to go through indexData afterward.  The output
+///   is the same for every thread count.
+void
+buildUvSphere (float radius, unsigned int slices, unsigned int stacks,
+               std::vector<float>& data, std::vector<unsigned int>& indices,
+               unsigned int threadCount = 1);
+
+/// \brief Generates a sphere by splitting each face of an icosahedron into
+///   smaller triangles and pushing their corners out to the sphere.
+/// \param[in] radius The sphere's radius.
+/// \param[in] frequency How many pieces each icosahedron edge is split into.
+/// \param[out] data Replaced by six floats per vertex, 10 * frequency^2 + 2
+///   vertices in all.
+/// \param[out] indices Replaced by three indices per triangle, 20 *
+///   frequency^2 triangles in all.
+/// \param[in] threadCount The number of threads to use, where 0 means one per
+///   hardware thread.
+/// \pre frequency >= 1.
+/// Its triangles are much closer to the same size than a UV sphere's.
+void
+buildIcosphere (float radius, unsigned int frequency,
+                std::vector<float>& data, std::vector<unsigned int>& indices,
+                unsigned int threadCount = 1);
+
+/// \brief Generates a torus around the Y axis.
+/// \param[in] majorRadius The distance from the center to the middle of the
+///   tube.
+/// \param[in] minorRadius The radius of the tube.
+/// \param[in] majorSegments The number of vertices around the Y axis.
+/// \param[in] minorSegments The number of vertices around the tube.
+/// \param[out] data Replaced by six floats per vertex, majorSegments *
+///   minorSegments vertices in all.
+/// \param[out] indices Replaced by three indices per triangle, 2 *
+///   majorSegments * minorSegments triangles in all.
+/// \param[in] threadCount The number of threads to use, where 0 means one per
+///   hardware thread.
+/// \pre majorSegments >= 3 and minorSegments >= 3.
+void
+buildTorus (float majorRadius, float minorRadius, unsigned int majorSegments,
+            unsigned int minorSegments, std::vector<float>& data,
+            std::vector<unsigned int>& indices, unsigned int threadCount = 1);
+
+/// \brief Generates a capped cylinder around the Y axis, centered on the
+///   origin.
+/// \param[in] radius The cylinder's radius.
+/// \param[in] height The cylinder's height.
+/// \param[in] slices The number of vertices around each ring.
+/// \param[in] stacks The number of bands from bottom to top.
+/// \param[out] data Replaced by six floats per vertex: (stacks + 1) * slices
+///   for the side, and slices + 1 for each cap, whose vertices are separate
+///   from the side's because their normals differ.
+/// \param[out] indices Replaced by three indices per triangle, 2 * slices *
+///   (stacks + 1) triangles in all.
+/// \param[in] threadCount The number of threads to use, where 0 means one per
+///   hardware thread.
+/// \pre slices >= 3 and stacks >= 1.
+void
+buildCylinder (float radius, float height, unsigned int slices, unsigned int stacks,
+               std::vector<float>& data, std::vector<unsigned int>& indices,
+               unsigned int threadCount = 1);
+
+/// \brief Generates a terrain facing +Y from a grid of heights.
+/// \param[in] heights The height of each sample, row by row, with rows
+///   running along +Z and samples within a row along +X.
+/// \param[in] columns The number of samples in each row.
+/// \param[in] spacing The distance between neighboring samples.
+/// \param[out] data Replaced by six floats per vertex, one per sample,
+///   centered on the origin in X and Z, with normals from the slope.
+/// \param[out] indices Replaced by three indices per triangle, 2 * (columns -
+///   1) * (rows - 1) triangles in all.
+/// \param[in] threadCount The number of threads to use, where 0 means one per
+///   hardware thread.
+/// \pre columns >= 2, and heights.size () is a multiple of columns that is at
+///   least 2 * columns.
+void
+buildHeightField (const std::vector<float>& heights, unsigned int columns, float spacing,
+                  std::vector<float>& data, std::vector<unsigned int>& indices,
+                  unsigned int threadCount = 1);
+
+#endif//PRIMITIVES_HPP
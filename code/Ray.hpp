@@ -0,0 +1,25 @@
+/// \file Ray.hpp
+/// \brief Declaration of the Ray struct, used to pick things in a scene.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// Macro guard
+#ifndef RAY_HPP
+#define RAY_HPP
+
+/******************************************************************/
+// Local includes
+#include "Vector3.hpp"
+
+/******************************************************************/
+/// \brief A half-line, whose points are m_origin + t * m_direction for every
+///   t >= 0.
+struct Ray
+{
+  /// Where the ray starts.
+  Vector3 m_origin;
+  /// The way the ray goes.  When it is a unit vector, t is a distance.
+  Vector3 m_direction;
+};
+
+#endif//RAY_HPP
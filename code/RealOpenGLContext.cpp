@@ -39,6 +39,12 @@ RealOpenGLContext::bufferData (GLenum target, GLsizeiptr size, const GLvoid* dat
   glBufferData (target, size, data, usage);
 }
 
+void
+RealOpenGLContext::bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+  glBufferSubData (target, offset, size, data);
+}
+
 void
 RealOpenGLContext::clear (GLbitfield mask)
 {
@@ -51,6 +57,12 @@ RealOpenGLContext::clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat
   glClearColor (red, green, blue, alpha);
 }
 
+GLenum
+RealOpenGLContext::clientWaitSync (GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+  return glClientWaitSync (sync, flags, timeout);
+}
+
 void
 RealOpenGLContext::compileShader (GLuint shader)
 {
@@ -93,6 +105,12 @@ RealOpenGLContext::deleteShader (GLuint shader)
   glDeleteShader (shader);
 }
 
+void
+RealOpenGLContext::deleteSync (GLsync sync)
+{
+  glDeleteSync (sync);
+}
+
 void
 RealOpenGLContext::deleteVertexArrays (GLsizei n, const GLuint* arrays)
 {
@@ -105,6 +123,12 @@ RealOpenGLContext::detachShader (GLuint program, GLuint shader)
   glDetachShader (program, shader);
 }
 
+void
+RealOpenGLContext::disable (GLenum cap)
+{
+  glDisable (cap);
+}
+
 void
 RealOpenGLContext::drawArrays (GLenum mode, GLint first, GLsizei count)
 {
@@ -117,6 +141,13 @@ RealOpenGLContext::drawElements (GLenum mode, GLsizei count, GLenum type, const
   glDrawElements (mode, count, type, indices);
 }
 
+void
+RealOpenGLContext::drawElementsBaseVertex (GLenum mode, GLsizei count, GLenum type, const void* indices,
+                                           GLint basevertex)
+{
+  glDrawElementsBaseVertex (mode, count, type, indices, basevertex);
+}
+
 void
 RealOpenGLContext::enable (GLenum cap)
 {
@@ -129,6 +160,12 @@ RealOpenGLContext::enableVertexAttribArray (GLuint index)
   glEnableVertexAttribArray (index);
 }
 
+GLsync
+RealOpenGLContext::fenceSync (GLenum condition, GLbitfield flags)
+{
+  return glFenceSync (condition, flags);
+}
+
 void
 RealOpenGLContext::frontFace (GLenum mode)
 {
@@ -195,18 +232,42 @@ RealOpenGLContext::linkProgram (GLuint program)
   glLinkProgram (program);
 }
 
+void*
+RealOpenGLContext::mapBufferRange (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+  return glMapBufferRange (target, offset, length, access);
+}
+
+void
+RealOpenGLContext::primitiveRestartIndex (GLuint index)
+{
+  glPrimitiveRestartIndex (index);
+}
+
 void
 RealOpenGLContext::shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length)
 {
   glShaderSource (shader, count, string, length);
 }
 
+void
+RealOpenGLContext::uniform1i (GLint location, GLint v0)
+{
+  glUniform1i (location, v0);
+}
+
 void
 RealOpenGLContext::uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 {
   glUniformMatrix4fv (location, count, transpose, value);
 }
 
+GLboolean
+RealOpenGLContext::unmapBuffer (GLenum target)
+{
+  return glUnmapBuffer (target);
+}
+
 void
 RealOpenGLContext::useProgram (GLuint program)
 {
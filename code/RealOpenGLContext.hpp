@@ -48,12 +48,18 @@ public:
   virtual void
   bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage);
 
+  virtual void
+  bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data);
+
   virtual void
   clear (GLbitfield mask);
 
   virtual void
   clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
 
+  virtual GLenum
+  clientWaitSync (GLsync sync, GLbitfield flags, GLuint64 timeout);
+
   virtual void
   compileShader (GLuint shader);
 
@@ -75,24 +81,37 @@ public:
   virtual void
   deleteShader (GLuint shader);
 
+  virtual void
+  deleteSync (GLsync sync);
+
   virtual void
   deleteVertexArrays (GLsizei n, const GLuint* arrays);
 
   virtual void
   detachShader (GLuint program, GLuint shader);
 
+  virtual void
+  disable (GLenum cap);
+
   virtual void
   drawArrays (GLenum mode, GLint first, GLsizei count);
 
   virtual void
   drawElements (GLenum mode, GLsizei count, GLenum type, const void* indices);
 
+  virtual void
+  drawElementsBaseVertex (GLenum mode, GLsizei count, GLenum type, const void* indices,
+                          GLint basevertex);
+
   virtual void
   enable (GLenum cap);
 
   virtual void
   enableVertexAttribArray (GLuint index);
 
+  virtual GLsync
+  fenceSync (GLenum condition, GLbitfield flags);
+
   virtual void
   frontFace (GLenum mode);
 
@@ -126,12 +145,24 @@ public:
   virtual void
   linkProgram (GLuint program);
 
+  virtual void*
+  mapBufferRange (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+
+  virtual void
+  primitiveRestartIndex (GLuint index);
+
   virtual void
   shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length);
 
+  virtual void
+  uniform1i (GLint location, GLint v0);
+
   virtual void
   uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
 
+  virtual GLboolean
+  unmapBuffer (GLenum target);
+
   virtual void
   useProgram (GLuint program);
   
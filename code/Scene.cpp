@@ -5,7 +5,10 @@
 /******************************************************************/
 // System includes
 #include <iostream>
+#include <limits>
 #include <string>
+#include <tuple>
+#include <vector>
 
 /******************************************************************/
 // Local includes
@@ -60,6 +63,11 @@ Scene::draw(const Transform& viewMatrix, const Matrix4& projectionMatrix)
     mesh.second->draw(viewMatrix, projectionMatrix);
 }
 
+void
+Scene::update(double seconds)
+{
+}
+
 bool
 Scene::hasMesh(const std::string& meshName)
 {
@@ -100,3 +108,65 @@ Scene::activatePreviousMesh()
   --m_activeMesh;
 }
 
+bool
+Scene::pickMesh(const Ray& ray)
+{
+  // Each Mesh only has to beat the nearest hit so far, so most are rejected
+  //   by their bounding spheres.
+  float nearest = std::numeric_limits<float>::infinity();
+  auto picked = m_scene.end();
+  for (auto mesh = m_scene.begin(); mesh != m_scene.end(); ++mesh)
+  {
+    RayHit hit;
+    if (mesh->second->raycast(ray, nearest, hit))
+    {
+      nearest = hit.m_distance;
+      picked = mesh;
+    }
+  }
+  if (picked == m_scene.end())
+    return false;
+  m_activeMesh = picked;
+  return true;
+}
+
+unsigned int
+Scene::batchStaticMeshes()
+{
+  // Meshes can only share a draw call if they are drawn the same way.
+  typedef std::tuple<ShaderProgram*, unsigned int, PositionFormat, AttributeFormat> BatchKey;
+  std::map<BatchKey, std::vector<std::string>> batches;
+  for (auto& mesh : m_scene)
+  {
+    if (!mesh.second->isStatic())
+      continue;
+    // Meshlets are culled one by one, which batching would defeat.
+    if (!mesh.second->getMeshlets().m_meshlets.empty())
+      continue;
+    VertexFormat format = mesh.second->getVertexFormat();
+    BatchKey key(mesh.second->getShader(), mesh.second->getVertexLayout().m_signature,
+      format.m_position, format.m_attribute);
+    batches[key].push_back(mesh.first);
+  }
+
+  std::string active = m_activeMesh == m_scene.end() ? "" : m_activeMesh->first;
+  unsigned int saved = 0;
+  for (auto& batch : batches)
+  {
+    // A Mesh with nothing to merge with is left for the caller to prepare.
+    if (batch.second.size() == 1)
+      continue;
+    Mesh* first = m_scene[batch.second.front()];
+    for (std::size_t other = 1; other < batch.second.size(); ++other)
+    {
+      first->appendStaticGeometry(*m_scene[batch.second[other]]);
+      remove(batch.second[other]);
+      ++saved;
+    }
+    first->prepareVao();
+  }
+  m_activeMesh = m_scene.find(active);
+  if (m_activeMesh == m_scene.end())
+    m_activeMesh = m_scene.begin();
+  return saved;
+}
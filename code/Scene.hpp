@@ -17,6 +17,7 @@
 #include "Mesh.hpp"
 #include "ShaderProgram.hpp"
 #include "Matrix4.hpp"
+#include "Ray.hpp"
 
 /******************************************************************/
 
@@ -74,6 +75,13 @@ public:
   void
   draw(const Transform& viewMatrix, const Matrix4& projectionMatrix);
 
+  /// \brief Advances anything in this Scene that moves on its own.  This
+  ///   should be called once per frame, before draw.
+  /// \param[in] seconds The time since the last update.
+  /// A plain Scene has nothing to advance.
+  virtual void
+  update(double seconds);
+
   /// \brief Tests whether or not this Scene contains a Mesh associated with a
   ///   name.
   /// \param[in] meshName The name of the requested Mesh.
@@ -119,6 +127,32 @@ public:
   void
   activatePreviousMesh ();
 
+  /// \brief Makes the nearest Mesh under a ray the active mesh.
+  /// \param[in] ray The ray, in world coordinates, with a unit direction.
+  /// \pre Every Mesh in this Scene has been prepared.
+  /// \return Whether the ray hit any Mesh.
+  /// \post If the ray hit a Mesh, the first one it hit is active.  Otherwise
+  ///   the active mesh is unchanged.
+  bool
+  pickMesh (const Ray& ray);
+
+  /// \brief Merges static Meshes that are drawn the same way, so that each
+  ///   group takes one draw call instead of one per Mesh.
+  /// \pre Every Mesh marked static with Mesh::setStatic that has others to
+  ///   be merged with has not yet been prepared.
+  /// \post Static Meshes without meshlets that share a ShaderProgram, vertex
+  ///   layout, and vertex format have been appended, with
+  ///   appendStaticGeometry, to the one whose name comes first, and removed.
+  ///   Each Mesh that others were appended to has then been prepared.
+  ///   Every other Mesh is left as it was, prepared or not.
+  /// \post The active mesh is unchanged, unless it was removed, in which
+  ///   case the first Mesh is active.
+  /// \return The number of draw calls saved, which is the number of Meshes
+  ///   removed.
+  /// A merged group is picked, and transformed, as a single Mesh.
+  unsigned int
+  batchStaticMeshes ();
+
 private:
   std::map<std::string, Mesh*> m_scene;
   std::map<std::string, Mesh*>::iterator m_activeMesh;
@@ -45,6 +45,13 @@ ShaderProgram::setUniformMatrix (const std::string& uniform, const Matrix4& valu
   m_context->uniformMatrix4fv (location, 1, GL_FALSE, value.data());
 }
 
+void
+ShaderProgram::setUniformInt (const std::string& uniform, int value)
+{
+  GLint location = getUniformLocation (uniform);
+  m_context->uniform1i (location, value);
+}
+
 void
 ShaderProgram::createVertexShader (const std::string& vertexShaderFilename)
 {
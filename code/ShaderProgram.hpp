@@ -60,6 +60,14 @@ public:
   void
   setUniformMatrix (const std::string& uniform, const Matrix4& value);
 
+  /// \brief Sets the value of a uniform int or bool.
+  /// \param[in] uniform The name of the uniform.
+  /// \param[in] value The value to use.
+  /// \pre This ShaderProgram is enabled.
+  /// If no attached shader declares the uniform, nothing happens.
+  void
+  setUniformInt (const std::string& uniform, int value);
+
   /// \brief Creates and attaches a vertex shader.
   /// \param[in] vertexShaderFilename The name of a file that contains the
   ///   vertex shader's source code.
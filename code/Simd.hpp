@@ -0,0 +1,156 @@
+/// \file Simd.hpp
+/// \brief Declaration of FloatLanes, a thin wrapper over whichever SIMD
+///   registers the compiler was told it may use.
+/// \author Sean Malloy
+/// \version A08
+///
+/// With -mavx (or -march=native on a machine that has it) FloatLanes holds 8
+///   floats, on any other x86-64 build it holds 4 (SSE2 is always available),
+///   and everywhere else it falls back to a single float.  Code written against
+///   FloatLanes therefore compiles and gives the same answers on every target.
+/******************************************************************/
+// Macro guard
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+/******************************************************************/
+// System includes
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define SIMD_USE_AVX
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SIMD_USE_SSE
+#endif
+
+/******************************************************************/
+/// \brief A fixed number of floats that are operated on together.
+struct FloatLanes
+{
+#if defined(SIMD_USE_AVX)
+  /// The number of floats in each FloatLanes.
+  static const unsigned int WIDTH = 8;
+  /// The type of the underlying register.
+  typedef __m256 Native;
+#elif defined(SIMD_USE_SSE)
+  static const unsigned int WIDTH = 4;
+  typedef __m128 Native;
+#else
+  static const unsigned int WIDTH = 1;
+  typedef float Native;
+#endif
+  /// The alignment, in bytes, that load and store require.
+  static const unsigned int ALIGNMENT = WIDTH * sizeof (float);
+
+  /// The lanes themselves.
+  Native m_lanes;
+
+  /// \brief Reads WIDTH floats from ALIGNMENT-aligned memory.
+  static FloatLanes
+  load (const float* source);
+
+  /// \brief Reads WIDTH floats from memory with any alignment.
+  static FloatLanes
+  loadUnaligned (const float* source);
+
+  /// \brief Makes a FloatLanes with every lane equal to one value.
+  static FloatLanes
+  broadcast (float value);
+
+  /// \brief Writes all lanes to ALIGNMENT-aligned memory.
+  void
+  store (float* destination) const;
+
+  /// \brief Writes all lanes to memory with any alignment.
+  void
+  storeUnaligned (float* destination) const;
+};
+
+/******************************************************************/
+// Inline definitions.  Comparisons return a mask that is all ones in the lanes
+//   where they hold, which is only meaningful as the first argument to select.
+
+#if defined(SIMD_USE_AVX)
+
+inline FloatLanes FloatLanes::load (const float* source) { return FloatLanes { _mm256_load_ps (source) }; }
+inline FloatLanes FloatLanes::loadUnaligned (const float* source) { return FloatLanes { _mm256_loadu_ps (source) }; }
+inline FloatLanes FloatLanes::broadcast (float value) { return FloatLanes { _mm256_set1_ps (value) }; }
+inline void FloatLanes::store (float* destination) const { _mm256_store_ps (destination, m_lanes); }
+inline void FloatLanes::storeUnaligned (float* destination) const { _mm256_storeu_ps (destination, m_lanes); }
+inline FloatLanes operator+ (FloatLanes a, FloatLanes b) { return FloatLanes { _mm256_add_ps (a.m_lanes, b.m_lanes) }; }
+inline FloatLanes operator- (FloatLanes a, FloatLanes b) { return FloatLanes { _mm256_sub_ps (a.m_lanes, b.m_lanes) }; }
+inline FloatLanes operator* (FloatLanes a, FloatLanes b) { return FloatLanes { _mm256_mul_ps (a.m_lanes, b.m_lanes) }; }
+inline FloatLanes operator/ (FloatLanes a, FloatLanes b) { return FloatLanes { _mm256_div_ps (a.m_lanes, b.m_lanes) }; }
+inline FloatLanes sqrt (FloatLanes a) { return FloatLanes { _mm256_sqrt_ps (a.m_lanes) }; }
+inline FloatLanes min (FloatLanes a, FloatLanes b) { return FloatLanes { _mm256_min_ps (a.m_lanes, b.m_lanes) }; }
+inline FloatLanes max (FloatLanes a, FloatLanes b) { return FloatLanes { _mm256_max_ps (a.m_lanes, b.m_lanes) }; }
+inline FloatLanes lessThan (FloatLanes a, FloatLanes b) { return FloatLanes { _mm256_cmp_ps (a.m_lanes, b.m_lanes, _CMP_LT_OQ) }; }
+inline FloatLanes select (FloatLanes mask, FloatLanes ifTrue, FloatLanes ifFalse) { return FloatLanes { _mm256_blendv_ps (ifFalse.m_lanes, ifTrue.m_lanes, mask.m_lanes) }; }
+
+#elif defined(SIMD_USE_SSE)
+
+inline FloatLanes FloatLanes::load (const float* source) { return FloatLanes { _mm_load_ps (source) }; }
+inline FloatLanes FloatLanes::loadUnaligned (const float* source) { return FloatLanes { _mm_loadu_ps (source) }; }
+inline FloatLanes FloatLanes::broadcast (float value) { return FloatLanes { _mm_set1_ps (value) }; }
+inline void FloatLanes::store (float* destination) const { _mm_store_ps (destination, m_lanes); }
+inline void FloatLanes::storeUnaligned (float* destination) const { _mm_storeu_ps (destination, m_lanes); }
+inline FloatLanes operator+ (FloatLanes a, FloatLanes b) { return FloatLanes { _mm_add_ps (a.m_lanes, b.m_lanes) }; }
+inline FloatLanes operator- (FloatLanes a, FloatLanes b) { return FloatLanes { _mm_sub_ps (a.m_lanes, b.m_lanes) }; }
+inline FloatLanes operator* (FloatLanes a, FloatLanes b) { return FloatLanes { _mm_mul_ps (a.m_lanes, b.m_lanes) }; }
+inline FloatLanes operator/ (FloatLanes a, FloatLanes b) { return FloatLanes { _mm_div_ps (a.m_lanes, b.m_lanes) }; }
+inline FloatLanes sqrt (FloatLanes a) { return FloatLanes { _mm_sqrt_ps (a.m_lanes) }; }
+inline FloatLanes min (FloatLanes a, FloatLanes b) { return FloatLanes { _mm_min_ps (a.m_lanes, b.m_lanes) }; }
+inline FloatLanes max (FloatLanes a, FloatLanes b) { return FloatLanes { _mm_max_ps (a.m_lanes, b.m_lanes) }; }
+inline FloatLanes lessThan (FloatLanes a, FloatLanes b) { return FloatLanes { _mm_cmplt_ps (a.m_lanes, b.m_lanes) }; }
+inline FloatLanes select (FloatLanes mask, FloatLanes ifTrue, FloatLanes ifFalse)
+{
+  return FloatLanes { _mm_or_ps (_mm_and_ps (mask.m_lanes, ifTrue.m_lanes), _mm_andnot_ps (mask.m_lanes, ifFalse.m_lanes)) };
+}
+
+#else
+
+inline FloatLanes FloatLanes::load (const float* source) { return FloatLanes { *source }; }
+inline FloatLanes FloatLanes::loadUnaligned (const float* source) { return FloatLanes { *source }; }
+inline FloatLanes FloatLanes::broadcast (float value) { return FloatLanes { value }; }
+inline void FloatLanes::store (float* destination) const { *destination = m_lanes; }
+inline void FloatLanes::storeUnaligned (float* destination) const { *destination = m_lanes; }
+inline FloatLanes operator+ (FloatLanes a, FloatLanes b) { return FloatLanes { a.m_lanes + b.m_lanes }; }
+inline FloatLanes operator- (FloatLanes a, FloatLanes b) { return FloatLanes { a.m_lanes - b.m_lanes }; }
+inline FloatLanes operator* (FloatLanes a, FloatLanes b) { return FloatLanes { a.m_lanes * b.m_lanes }; }
+inline FloatLanes operator/ (FloatLanes a, FloatLanes b) { return FloatLanes { a.m_lanes / b.m_lanes }; }
+inline FloatLanes sqrt (FloatLanes a) { return FloatLanes { std::sqrt (a.m_lanes) }; }
+inline FloatLanes min (FloatLanes a, FloatLanes b) { return FloatLanes { b.m_lanes < a.m_lanes ? b.m_lanes : a.m_lanes }; }
+inline FloatLanes max (FloatLanes a, FloatLanes b) { return FloatLanes { a.m_lanes < b.m_lanes ? b.m_lanes : a.m_lanes }; }
+inline FloatLanes lessThan (FloatLanes a, FloatLanes b) { return FloatLanes { a.m_lanes < b.m_lanes ? 1.0f : 0.0f }; }
+inline FloatLanes select (FloatLanes mask, FloatLanes ifTrue, FloatLanes ifFalse) { return mask.m_lanes != 0.0f ? ifTrue : ifFalse; }
+
+#endif
+
+/// \brief Computes the arc cosine of every lane.
+/// \param[in] x The cosines, which are clamped to [-1, 1] first.
+/// \return The angles in radians, accurate to about 1e-7.
+/// This is the 8-term polynomial from Abramowitz and Stegun 4.4.46, since
+///   there is no vector std::acos.
+inline FloatLanes
+acos (FloatLanes x)
+{
+  const FloatLanes ZERO = FloatLanes::broadcast (0.0f);
+  const FloatLanes ONE = FloatLanes::broadcast (1.0f);
+  x = max (FloatLanes::broadcast (-1.0f), min (ONE, x));
+  FloatLanes negative = lessThan (x, ZERO);
+  FloatLanes a = select (negative, ZERO - x, x);
+  FloatLanes poly = FloatLanes::broadcast (-0.0012624911f);
+  poly = poly * a + FloatLanes::broadcast (0.0066700901f);
+  poly = poly * a + FloatLanes::broadcast (-0.0170881256f);
+  poly = poly * a + FloatLanes::broadcast (0.0308918810f);
+  poly = poly * a + FloatLanes::broadcast (-0.0501743046f);
+  poly = poly * a + FloatLanes::broadcast (0.0889789874f);
+  poly = poly * a + FloatLanes::broadcast (-0.2145988016f);
+  poly = poly * a + FloatLanes::broadcast (1.5707963050f);
+  FloatLanes angle = sqrt (ONE - a) * poly;
+  return select (negative, FloatLanes::broadcast (3.14159265358979f) - angle, angle);
+}
+
+#endif//SIMD_HPP
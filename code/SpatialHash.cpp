@@ -0,0 +1,147 @@
+/// \file SpatialHash.cpp
+/// \brief Implementation of SpatialHash class and any associated global
+///   functions.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// System includes
+#include <cassert>
+
+/******************************************************************/
+// Local includes
+#include "SpatialHash.hpp"
+
+/******************************************************************/
+SpatialHash::SpatialHash (const float* points, unsigned int count,
+                          unsigned int stride, unsigned int dimensions,
+                          float cellSize)
+  : m_dimensions (dimensions),
+    m_inverseCellSize (1.0 / static_cast<double> (cellSize)),
+    m_count (count),
+    m_mask (15),
+    m_occupied (0),
+    m_keys (16),
+    m_begins (16),
+    m_counts (16, 0),
+    m_ids (count)
+{
+  assert (dimensions >= 1 && dimensions <= 3 && dimensions <= stride);
+  assert (cellSize > 0.0f);
+  // First pass: count how many points land in each cell.
+  for (unsigned int pointIndex = 0; pointIndex < count; pointIndex++)
+  {
+    std::uint64_t key = hashPoint (points + static_cast<std::size_t> (pointIndex) * stride);
+    std::uint64_t slot = findSlot (key);
+    if (m_counts[slot] == 0)
+    {
+      m_keys[slot] = key;
+      m_occupied++;
+      if (m_occupied * 2 > m_mask + 1)
+      {
+        m_counts[slot] = 1;
+        grow ();
+        continue;
+      }
+    }
+    m_counts[slot]++;
+  }
+  // Give each cell a contiguous run of m_ids.
+  unsigned int next = 0;
+  for (std::uint64_t slot = 0; slot <= m_mask; slot++)
+  {
+    m_begins[slot] = next;
+    next += m_counts[slot];
+  }
+  // Second pass: fill each run in increasing point order.
+  std::vector<unsigned int> filled (m_mask + 1, 0);
+  for (unsigned int pointIndex = 0; pointIndex < count; pointIndex++)
+  {
+    std::uint64_t slot = findSlot (hashPoint (points + static_cast<std::size_t> (pointIndex) * stride));
+    m_ids[m_begins[slot] + filled[slot]] = pointIndex;
+    filled[slot]++;
+  }
+}
+
+unsigned int
+SpatialHash::size () const
+{
+  return m_count;
+}
+
+std::int64_t
+SpatialHash::cellCoordinate (double value) const
+{
+  // Keep non-finite and absurdly large coordinates from overflowing; they
+  //   simply share the outermost cells.
+  const double LIMIT = 4.0e18;
+  double scaled = std::floor (value * m_inverseCellSize);
+  if (!(scaled > -LIMIT))
+  {
+    return scaled != scaled ? 0 : static_cast<std::int64_t> (-LIMIT);
+  }
+  if (scaled > LIMIT)
+  {
+    return static_cast<std::int64_t> (LIMIT);
+  }
+  return static_cast<std::int64_t> (scaled);
+}
+
+std::uint64_t
+SpatialHash::hashCell (const std::int64_t cell[3])
+{
+  std::uint64_t hash = static_cast<std::uint64_t> (cell[0]) * 0x9E3779B97F4A7C15ULL;
+  hash ^= static_cast<std::uint64_t> (cell[1]) * 0xC2B2AE3D27D4EB4FULL;
+  hash = (hash << 31) | (hash >> 33);
+  hash ^= static_cast<std::uint64_t> (cell[2]) * 0x165667B19E3779F9ULL;
+  // Final avalanche from MurmurHash3, so the low bits can index the table.
+  hash ^= hash >> 33;
+  hash *= 0xFF51AFD7ED558CCDULL;
+  hash ^= hash >> 33;
+  hash *= 0xC4CEB9FE1A85EC53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+std::uint64_t
+SpatialHash::hashPoint (const float* point) const
+{
+  std::int64_t cell[3] = { 0, 0, 0 };
+  for (unsigned int axis = 0; axis < m_dimensions; axis++)
+  {
+    cell[axis] = cellCoordinate (point[axis]);
+  }
+  return hashCell (cell);
+}
+
+std::uint64_t
+SpatialHash::findSlot (std::uint64_t key) const
+{
+  std::uint64_t slot = key & m_mask;
+  while (m_counts[slot] != 0 && m_keys[slot] != key)
+  {
+    slot = (slot + 1) & m_mask;
+  }
+  return slot;
+}
+
+void
+SpatialHash::grow ()
+{
+  std::vector<std::uint64_t> oldKeys;
+  std::vector<unsigned int> oldCounts;
+  oldKeys.swap (m_keys);
+  oldCounts.swap (m_counts);
+  m_mask = m_mask * 2 + 1;
+  m_keys.assign (m_mask + 1, 0);
+  m_counts.assign (m_mask + 1, 0);
+  m_begins.assign (m_mask + 1, 0);
+  for (std::size_t oldSlot = 0; oldSlot < oldKeys.size (); oldSlot++)
+  {
+    if (oldCounts[oldSlot] != 0)
+    {
+      std::uint64_t slot = findSlot (oldKeys[oldSlot]);
+      m_keys[slot] = oldKeys[oldSlot];
+      m_counts[slot] = oldCounts[oldSlot];
+    }
+  }
+}
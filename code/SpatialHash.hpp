@@ -0,0 +1,143 @@
+/// \file SpatialHash.hpp
+/// \brief Declaration of SpatialHash class and any associated global functions.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// Macro guard
+#ifndef SPATIAL_HASH_HPP
+#define SPATIAL_HASH_HPP
+
+/******************************************************************/
+// System includes
+#include <cstdint>
+#include <cmath>
+#include <vector>
+
+/******************************************************************/
+/// \brief A uniform grid over a fixed set of points, used to find every point
+///   near some position without scanning all of them.
+///
+/// Cells are identified only by a 64-bit hash of their integer coordinates, so
+///   two distant cells may (very rarely) share a bucket.  Queries therefore
+///   return a superset of the nearby points, and callers must still compare
+///   the actual values.  For the same reason a point may occasionally be
+///   visited more than once by a single query.
+class SpatialHash
+{
+public:
+  /// \brief Builds a grid over a collection of points.
+  /// \param[in] points A pointer to the first float of the first point.
+  /// \param[in] count The number of points.
+  /// \param[in] stride The number of floats from the start of one point to the
+  ///   start of the next.
+  /// \param[in] dimensions How many of the leading floats of each point are
+  ///   used as its position (1, 2, or 3).
+  /// \param[in] cellSize The width of each grid cell.
+  /// \post Every point has been placed in the cell containing its position.
+  ///   Within a cell, points are stored in increasing order of their index.
+  SpatialHash (const float* points, unsigned int count, unsigned int stride,
+               unsigned int dimensions, float cellSize);
+
+  /// \brief Visits every point in the cells that overlap a box around a
+  ///   position.
+  /// \param[in] point A pointer to the position being searched around.  Only
+  ///   the first dimensions floats are read.
+  /// \param[in] radius Every point whose coordinates are each within radius
+  ///   of the position will be visited.
+  /// \param[in] visit A callable taking the unsigned int index of a point.
+  ///   Within each cell indices are visited in increasing order.
+  template<typename Visitor>
+  void
+  forEachNear (const float* point, float radius, Visitor visit) const;
+
+  /// \brief Gets the number of points in this grid.
+  /// \return The number of points.
+  unsigned int
+  size () const;
+
+private:
+  /// \brief Gets the integer coordinate of the cell containing a value.
+  /// \param[in] value A coordinate along one axis.
+  /// \return The index of the cell along that axis.
+  std::int64_t
+  cellCoordinate (double value) const;
+
+  /// \brief Hashes the coordinates of a cell.
+  /// \param[in] cell The integer coordinates of the cell.
+  /// \return A well-mixed 64-bit hash of the coordinates.
+  static std::uint64_t
+  hashCell (const std::int64_t cell[3]);
+
+  /// \brief Gets the hash of the cell containing a point.
+  /// \param[in] point A pointer to the point's position.
+  /// \return The hash of the cell containing that point.
+  std::uint64_t
+  hashPoint (const float* point) const;
+
+  /// \brief Finds the slot in which a cell hash is (or would be) stored.
+  /// \param[in] key The hash of a cell.
+  /// \return The index of the slot holding key, or of the empty slot where it
+  ///   belongs.
+  std::uint64_t
+  findSlot (std::uint64_t key) const;
+
+  /// \brief Doubles the number of slots, rehashing every occupied one.
+  /// \post Every occupied slot has been moved to its place in the new table.
+  void
+  grow ();
+
+  /// The number of leading floats of each point used as its position.
+  unsigned int m_dimensions;
+  /// The reciprocal of the width of a cell.
+  double m_inverseCellSize;
+  /// The number of points in this grid.
+  unsigned int m_count;
+  /// The number of slots minus one (the slot count is a power of two).
+  std::uint64_t m_mask;
+  /// The number of occupied slots.
+  std::uint64_t m_occupied;
+  /// The cell hash stored in each slot.
+  std::vector<std::uint64_t> m_keys;
+  /// The position in m_ids of each slot's first point.
+  std::vector<unsigned int> m_begins;
+  /// The number of points in each slot, or 0 for an empty slot.
+  std::vector<unsigned int> m_counts;
+  /// The indices of all points, grouped by slot.
+  std::vector<unsigned int> m_ids;
+};
+
+/******************************************************************/
+// Template member definitions
+
+template<typename Visitor>
+void
+SpatialHash::forEachNear (const float* point, float radius, Visitor visit) const
+{
+  // Widen the search a little so that rounding in the caller's own distance
+  //   test can never reject a cell that holds a genuine match.
+  const double reach = static_cast<double> (radius) * 1.001;
+  std::int64_t low[3] = { 0, 0, 0 };
+  std::int64_t high[3] = { 0, 0, 0 };
+  for (unsigned int axis = 0; axis < m_dimensions; axis++)
+  {
+    low[axis] = cellCoordinate (point[axis] - reach);
+    high[axis] = cellCoordinate (point[axis] + reach);
+  }
+  std::int64_t cell[3];
+  for (cell[0] = low[0]; cell[0] <= high[0]; cell[0]++)
+  {
+    for (cell[1] = low[1]; cell[1] <= high[1]; cell[1]++)
+    {
+      for (cell[2] = low[2]; cell[2] <= high[2]; cell[2]++)
+      {
+        std::uint64_t slot = findSlot (hashCell (cell));
+        for (unsigned int id = 0; id < m_counts[slot]; id++)
+        {
+          visit (m_ids[m_begins[slot] + id]);
+        }
+      }
+    }
+  }
+}
+
+#endif//SPATIAL_HASH_HPP
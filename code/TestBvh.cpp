@@ -0,0 +1,184 @@
+/// \file TestBvh.cpp
+/// \brief A collection of Catch2 unit tests for the global functions in
+///   Bvh.hpp.
+/// \author Sean Malloy
+/// \version A08
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "Bvh.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+/// \brief Casts a ray against every triangle, as a reference the hierarchy
+///   must agree with.
+/// \return The nearest t, or infinity for a miss, and the triangle hit.
+std::pair<float, unsigned int>
+bruteForceHit (const std::vector<float>& data, const std::vector<unsigned int>& indices,
+               const Ray& ray)
+{
+  std::pair<float, unsigned int> nearest (std::numeric_limits<float>::infinity (), 0);
+  for (unsigned int triangle = 0; triangle < indices.size () / 3; triangle++)
+  {
+    Vector3 corners[3];
+    for (unsigned int corner = 0; corner < 3; corner++)
+    {
+      const float* position = &data[indices[triangle * 3 + corner] * 3];
+      corners[corner] = Vector3 (position[0], position[1], position[2]);
+    }
+    Vector3 edge1 = corners[1] - corners[0];
+    Vector3 edge2 = corners[2] - corners[0];
+    Vector3 p = ray.m_direction.cross (edge2);
+    float determinant = edge1.dot (p);
+    if (determinant == 0.0f)
+    {
+      continue;
+    }
+    Vector3 s = ray.m_origin - corners[0];
+    float u = s.dot (p) / determinant;
+    Vector3 q = s.cross (edge1);
+    float v = ray.m_direction.dot (q) / determinant;
+    float t = edge2.dot (q) / determinant;
+    if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t >= 0.0f && t < nearest.first)
+    {
+      nearest = std::make_pair (t, triangle);
+    }
+  }
+  return nearest;
+}
+
+/// \brief Gets a random unit vector.
+Vector3
+randomDirection (std::mt19937& generator)
+{
+  std::normal_distribution<float> normal;
+  Vector3 direction (normal (generator), normal (generator), normal (generator));
+  direction.normalize ();
+  return direction;
+}
+
+SCENARIO ("Building bounding volume hierarchies.", "[Bvh][A08]") {
+  GIVEN ("A few thousand random small triangles in a cube.") {
+    std::mt19937 generator (3);
+    std::uniform_real_distribution<float> place (-10.0f, 10.0f);
+    std::uniform_real_distribution<float> offset (-0.5f, 0.5f);
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    for (unsigned int triangle = 0; triangle < 3000; triangle++)
+    {
+      Vector3 center (place (generator), place (generator), place (generator));
+      for (unsigned int corner = 0; corner < 3; corner++)
+      {
+        indices.push_back (data.size () / 3);
+        data.insert (data.end (), { center.m_x + offset (generator), center.m_y + offset (generator),
+                                    center.m_z + offset (generator) });
+      }
+    }
+    Bvh bvh = buildBvh (data, 3, indices);
+
+    THEN ("Every triangle should be in exactly one leaf, inside every box above it.") {
+      std::vector<unsigned int> seen (bvh.m_triangles);
+      std::sort (seen.begin (), seen.end ());
+      for (unsigned int triangle = 0; triangle < seen.size (); triangle++)
+      {
+        REQUIRE (triangle == seen[triangle]);
+      }
+      std::vector<unsigned int> leafHits (bvh.m_triangles.size (), 0);
+      std::vector<std::pair<unsigned int, unsigned int>> pending = { { 0u, 0u } };
+      while (!pending.empty ())
+      {
+        unsigned int node = pending.back ().first;
+        unsigned int depth = pending.back ().second;
+        pending.pop_back ();
+        const BvhNode& bvhNode = bvh.m_nodes[node];
+        REQUIRE (depth < 64u);
+        if (bvhNode.m_count == 0)
+        {
+          for (unsigned int child = bvhNode.m_first; child < bvhNode.m_first + 2; child++)
+          {
+            const BoundingBox& inner = bvh.m_nodes[child].m_bounds;
+            REQUIRE (inner.m_min.m_x >= bvhNode.m_bounds.m_min.m_x);
+            REQUIRE (inner.m_max.m_z <= bvhNode.m_bounds.m_max.m_z);
+            pending.push_back ({ child, depth + 1 });
+          }
+          continue;
+        }
+        REQUIRE (bvhNode.m_count <= MAX_BVH_LEAF_TRIANGLES);
+        for (unsigned int slot = bvhNode.m_first; slot < bvhNode.m_first + bvhNode.m_count; slot++)
+        {
+          leafHits[slot]++;
+          for (unsigned int corner = 0; corner < 3; corner++)
+          {
+            const Vector3& position = bvh.m_corners[slot * 3 + corner];
+            REQUIRE (position.m_x >= bvhNode.m_bounds.m_min.m_x);
+            REQUIRE (position.m_y <= bvhNode.m_bounds.m_max.m_y);
+          }
+        }
+      }
+      REQUIRE (std::all_of (leafHits.begin (), leafHits.end (), [] (unsigned int hits) { return hits == 1; }));
+    }
+
+    THEN ("Rays in every direction should find the same nearest hit as testing every triangle.") {
+      unsigned int hits = 0;
+      for (unsigned int test = 0; test < 500; test++)
+      {
+        Ray ray = { Vector3 (place (generator), place (generator), place (generator)),
+                    randomDirection (generator) };
+        std::pair<float, unsigned int> expected = bruteForceHit (data, indices, ray);
+        RayHit hit;
+        bool found = intersectBvh (bvh, ray, std::numeric_limits<float>::infinity (), hit);
+        CAPTURE (test);
+        REQUIRE ((expected.first < std::numeric_limits<float>::infinity ()) == found);
+        if (found)
+        {
+          REQUIRE (expected.second == hit.m_triangle);
+          REQUIRE (expected.first == Approx (hit.m_distance));
+          hits++;
+        }
+      }
+      // Enough rays should hit for the comparison to mean something.
+      REQUIRE (hits > 100u);
+    }
+
+    THEN ("Hits past the maximum distance should be ignored.") {
+      Ray ray = { Vector3 (-20.0f, 0.0f, 0.0f), Vector3 (1.0f, 0.0f, 0.0f) };
+      RayHit hit;
+      REQUIRE (intersectBvh (bvh, ray, std::numeric_limits<float>::infinity (), hit));
+      const float first = hit.m_distance;
+      REQUIRE_FALSE (intersectBvh (bvh, ray, first, hit));
+      REQUIRE (intersectBvh (bvh, ray, first + 1e-3f, hit));
+    }
+  }
+
+  GIVEN ("One triangle, facing +Z.") {
+    std::vector<float> data = { 0.0f, 0.0f, 0.0f,   1.0f, 0.0f, 0.0f,   0.0f, 1.0f, 0.0f };
+    Bvh bvh = buildBvh (data, 3, { 0, 1, 2 });
+    THEN ("It should be hit from either side, with barycentric weights.") {
+      RayHit hit;
+      REQUIRE (intersectBvh (bvh, { Vector3 (0.25f, 0.5f, 2.0f), Vector3 (0.0f, 0.0f, -1.0f) }, 100.0f, hit));
+      REQUIRE (2.0f == Approx (hit.m_distance));
+      REQUIRE (0.25f == Approx (hit.m_u));
+      REQUIRE (0.5f == Approx (hit.m_v));
+      REQUIRE (intersectBvh (bvh, { Vector3 (0.25f, 0.5f, -3.0f), Vector3 (0.0f, 0.0f, 1.0f) }, 100.0f, hit));
+      REQUIRE (3.0f == Approx (hit.m_distance));
+    }
+    THEN ("Rays that miss or point away should not hit.") {
+      RayHit hit;
+      REQUIRE_FALSE (intersectBvh (bvh, { Vector3 (0.75f, 0.75f, 2.0f), Vector3 (0.0f, 0.0f, -1.0f) }, 100.0f, hit));
+      REQUIRE_FALSE (intersectBvh (bvh, { Vector3 (0.25f, 0.5f, 2.0f), Vector3 (0.0f, 0.0f, 1.0f) }, 100.0f, hit));
+    }
+  }
+
+  GIVEN ("No triangles.") {
+    THEN ("Nothing should be hit.") {
+      Bvh bvh = buildBvh ({}, 3, {});
+      RayHit hit;
+      REQUIRE (bvh.m_nodes.empty ());
+      REQUIRE_FALSE (intersectBvh (bvh, { Vector3 (0.0f, 0.0f, 0.0f), Vector3 (1.0f, 0.0f, 0.0f) }, 1.0f, hit));
+    }
+  }
+}
@@ -0,0 +1,975 @@
+/// \file TestGeometry.cpp
+/// \brief A collection of Catch2 unit tests for the global functions in
+///   Geometry.hpp.
+/// \author Sean Malloy
+/// \version A08
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "Geometry.hpp"
+#include "TestHelpers.hpp"
+#include "VertexLayout.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+/// \brief The original quadratic indexData, kept as a reference that faster
+///   implementations must agree with exactly.
+void
+referenceIndexData (const std::vector<float>& geometry, unsigned int floatsPerVertex,
+    std::vector<float>& data, std::vector<unsigned int>& indices)
+{
+  const float EPSILON = 0.00001f;
+  for (unsigned int geoIndex = 0; geoIndex < geometry.size () / floatsPerVertex; geoIndex++)
+  {
+    bool found = false;
+    for (unsigned int dataIndex = 0; dataIndex < data.size () / floatsPerVertex && !found; dataIndex++)
+    {
+      bool matches = true;
+      for (unsigned int part = 0; part < floatsPerVertex && matches; part++)
+      {
+        if (fabs (geometry[geoIndex * floatsPerVertex + part] -
+            data[dataIndex * floatsPerVertex + part]) >= EPSILON)
+        {
+          matches = false;
+        }
+      }
+      if (matches)
+      {
+        indices.push_back (dataIndex);
+        found = true;
+      }
+    }
+    if (!found)
+    {
+      for (unsigned int part = 0; part < floatsPerVertex; part++)
+      {
+        data.push_back (geometry[geoIndex * floatsPerVertex + part]);
+      }
+      indices.push_back (data.size () / floatsPerVertex - 1);
+    }
+  }
+}
+
+/// \brief Builds a triangle soup whose vertices sit on a coarse lattice and
+///   are then nudged by up to about one EPSILON, so that many of them land
+///   right on the edge of matching one another.
+std::vector<float>
+jitteredSoup (unsigned int triangles, unsigned int floatsPerVertex, unsigned int seed)
+{
+  std::mt19937 generator (seed);
+  std::uniform_int_distribution<int> lattice (-3, 3);
+  std::uniform_real_distribution<float> jitter (-0.000012f, 0.000012f);
+  std::vector<float> soup;
+  for (unsigned int vertex = 0; vertex < triangles * 3; vertex++)
+  {
+    for (unsigned int part = 0; part < floatsPerVertex; part++)
+    {
+      float value = lattice (generator) * 0.25f;
+      if (generator () % 2 == 0)
+      {
+        value += jitter (generator);
+      }
+      soup.push_back (value);
+    }
+  }
+  return soup;
+}
+
+/// \brief The original computeVertexNormals for one corner, which searches
+///   every face, kept as a reference for the weighting that faster
+///   implementations must reproduce.
+Vector3
+referenceComputeVertexNormal (const std::vector<Triangle>& faces,
+    const std::vector<Vector3>& faceNormals, unsigned int faceIndex, unsigned int vertexIndex)
+{
+  Vector3 vertexNormal (0.0f, 0.0f, 0.0f);
+  for (unsigned int otherFaceIndex = 0; otherFaceIndex < faces.size (); otherFaceIndex++)
+  {
+    for (unsigned int otherVertexIndex = 0; otherVertexIndex < 3; otherVertexIndex++ )
+    {
+      if (faces[faceIndex][vertexIndex] == faces[otherFaceIndex][otherVertexIndex])
+      {
+        float area = 0.5f * ((faces[otherFaceIndex][1] - faces[otherFaceIndex][0]).cross (faces[otherFaceIndex][2] - faces[otherFaceIndex][0])).length ();
+        unsigned int oppositeIndexA = (otherVertexIndex + 1) % 3;
+        unsigned int oppositeIndexB = (otherVertexIndex + 2) % 3;
+        float angle = (faces[otherFaceIndex][oppositeIndexA] - faces[otherFaceIndex][otherVertexIndex]).angleBetween (faces[otherFaceIndex][oppositeIndexB] - faces[otherFaceIndex][otherVertexIndex]);
+        vertexNormal += faceNormals[otherFaceIndex] * fabs (area) * fabs (angle);
+      }
+    }
+  }
+  vertexNormal.normalize ();
+  return vertexNormal;
+}
+
+/// \brief The original quadratic computeVertexNormals, for every corner.
+std::vector<Vector3>
+referenceComputeVertexNormals (const std::vector<Triangle>& faces,
+    const std::vector<Vector3>& faceNormals)
+{
+  std::vector<Vector3> vertexNormals;
+  for (unsigned int faceIndex = 0; faceIndex < faces.size (); faceIndex++)
+  {
+    for (unsigned int vertexIndex = 0; vertexIndex < 3; vertexIndex++)
+    {
+      vertexNormals.push_back (referenceComputeVertexNormal (faces, faceNormals, faceIndex, vertexIndex));
+    }
+  }
+  return vertexNormals;
+}
+
+/// \brief Builds a bumpy square grid of triangles whose neighbouring faces
+///   share corner positions, like a terrain patch.
+/// \param[in] side The number of quads along each edge.
+/// \param[in] amplitude The height of the bumps, where 0 gives a flat grid.
+/// \return Two triangles per quad.
+std::vector<Triangle>
+buildWavyGrid (unsigned int side, float amplitude = 0.3f)
+{
+  auto point = [amplitude, side] (unsigned int vertex) {
+    float x = vertex % (side + 1) * 0.1f;
+    float z = vertex / (side + 1) * 0.1f;
+    return Vector3 (x, amplitude * std::sin (x * 2.0f) * std::cos (z * 3.0f), z);
+  };
+  std::vector<unsigned int> indices = buildGridIndices (side, true);
+  std::vector<Triangle> faces;
+  for (std::size_t corner = 0; corner < indices.size (); corner += 3)
+  {
+    faces.push_back ((Triangle){point (indices[corner]), point (indices[corner + 1]), point (indices[corner + 2])});
+  }
+  return faces;
+}
+
+/// \brief Indexes the positions of some faces, with 3 floats per vertex.
+void
+indexPositions (const std::vector<Triangle>& faces, std::vector<float>& data,
+                std::vector<unsigned int>& indices)
+{
+  std::vector<float> geometry;
+  for (const Triangle& face : faces)
+  {
+    for (const Vector3& corner : face)
+    {
+      geometry.insert (geometry.end (), { corner.m_x, corner.m_y, corner.m_z });
+    }
+  }
+  indexData (geometry, 3, data, indices);
+}
+
+/// \brief Gets the (unnormalized) normal of one indexed triangle.
+Vector3
+indexedNormal (const std::vector<float>& data, unsigned int floatsPerVertex,
+               const unsigned int* corners)
+{
+  Vector3 points[3];
+  for (unsigned int corner = 0; corner < 3; corner++)
+  {
+    const float* vertex = &data[corners[corner] * floatsPerVertex];
+    points[corner] = Vector3 (vertex[0], vertex[1], vertex[2]);
+  }
+  return (points[1] - points[0]).cross (points[2] - points[0]);
+}
+
+SCENARIO ("indexData matches the original linear search.", "[Geometry][A08]") {
+  GIVEN ("A cube with random face colors.") {
+    std::vector<Triangle> cube = buildCube ();
+    std::vector<float> geometry = dataWithFaceColors (cube, generateRandomFaceColors (cube));
+    WHEN ("I index it.") {
+      std::vector<float> data, expectedData;
+      std::vector<unsigned int> indices, expectedIndices;
+      indexData (geometry, 6, data, indices);
+      referenceIndexData (geometry, 6, expectedData, expectedIndices);
+      THEN ("The data and indices should be identical to the original's.") {
+        REQUIRE (expectedData == data);
+        REQUIRE (expectedIndices == indices);
+      }
+    }
+  }
+
+  GIVEN ("Triangle soups whose vertices are within about EPSILON of each other.") {
+    WHEN ("I index soups with 1 through 6 floats per vertex.") {
+      THEN ("The epsilon matching and output order should be unchanged.") {
+        for (unsigned int floatsPerVertex = 1; floatsPerVertex <= 6; floatsPerVertex++) {
+          CAPTURE (floatsPerVertex);
+          std::vector<float> geometry = jitteredSoup (2000, floatsPerVertex, floatsPerVertex);
+          std::vector<float> data, expectedData;
+          std::vector<unsigned int> indices, expectedIndices;
+          indexData (geometry, floatsPerVertex, data, indices);
+          referenceIndexData (geometry, floatsPerVertex, expectedData, expectedIndices);
+          REQUIRE (expectedData == data);
+          REQUIRE (expectedIndices == indices);
+        }
+      }
+    }
+  }
+
+  GIVEN ("A data vector that already holds some vertices.") {
+    std::vector<float> geometry = jitteredSoup (300, 3, 11);
+    std::vector<float> data (geometry.begin (), geometry.begin () + 90);
+    std::vector<float> expectedData = data;
+    std::vector<unsigned int> indices, expectedIndices;
+    WHEN ("I index more geometry into it.") {
+      indexData (geometry, 3, data, indices);
+      referenceIndexData (geometry, 3, expectedData, expectedIndices);
+      THEN ("The existing vertices should be reused and kept in place.") {
+        REQUIRE (expectedData == data);
+        REQUIRE (expectedIndices == indices);
+      }
+    }
+  }
+}
+
+SCENARIO ("Parallel indexData matches serial indexData.", "[Geometry][A08]") {
+  GIVEN ("Triangle soups whose vertices are within about EPSILON of each other.") {
+    std::vector<float> geometry = jitteredSoup (40000, 6, 7);
+    std::vector<float> serialData;
+    std::vector<unsigned int> serialIndices;
+    indexData (geometry, 6, serialData, serialIndices);
+    WHEN ("I index them with different numbers of threads.") {
+      THEN ("The data and indices should be bit-identical to the serial path.") {
+        for (unsigned int threads : { 1u, 2u, 3u, 8u, 0u }) {
+          CAPTURE (threads);
+          std::vector<float> data;
+          std::vector<unsigned int> indices;
+          indexData (geometry, 6, data, indices, threads);
+          REQUIRE (serialData == data);
+          REQUIRE (serialIndices == indices);
+        }
+      }
+    }
+  }
+
+  GIVEN ("A data vector that already holds some vertices.") {
+    std::vector<float> geometry = jitteredSoup (20000, 3, 13);
+    std::vector<float> start (geometry.begin (), geometry.begin () + 300);
+    std::vector<float> serialData = start;
+    std::vector<unsigned int> serialIndices;
+    indexData (geometry, 3, serialData, serialIndices);
+    WHEN ("I index more geometry into it with 4 threads.") {
+      std::vector<float> data = start;
+      std::vector<unsigned int> indices;
+      indexData (geometry, 3, data, indices, 4);
+      THEN ("The result should be bit-identical to the serial path.") {
+        REQUIRE (serialData == data);
+        REQUIRE (serialIndices == indices);
+      }
+    }
+  }
+}
+
+SCENARIO ("computeVertexNormals keeps the original weighting.", "[Geometry][A08]") {
+  GIVEN ("A cube.") {
+    std::vector<Triangle> cube = buildCube ();
+    std::vector<Vector3> faceNormals = computeFaceNormals (cube);
+    WHEN ("I compute its vertex normals.") {
+      std::vector<Vector3> normals = computeVertexNormals (cube, faceNormals);
+      std::vector<Vector3> expected = referenceComputeVertexNormals (cube, faceNormals);
+      THEN ("They should match the area- and angle-weighted average.") {
+        REQUIRE (expected.size () == normals.size ());
+        for (unsigned int corner = 0; corner < normals.size (); corner++) {
+          REQUIRE (expected[corner] == normals[corner]);
+        }
+      }
+    }
+  }
+
+  GIVEN ("A 150 x 150 bumpy grid, which has 45000 faces.") {
+    std::vector<Triangle> grid = buildWavyGrid (150);
+    std::vector<Vector3> faceNormals = computeFaceNormals (grid);
+    WHEN ("I compute its vertex normals.") {
+      std::vector<Vector3> normals = computeVertexNormals (grid, faceNormals);
+      THEN ("Corners spread over the whole grid should match the original weighting.") {
+        REQUIRE (grid.size () * 3 == normals.size ());
+        // The reference searches every face for each corner, so only every
+        //   101st corner is checked.  101 is prime, so every corner of a
+        //   triangle, and every part of the grid, is sampled.
+        unsigned int mismatches = 0;
+        unsigned int checked = 0;
+        for (unsigned int corner = 0; corner < normals.size (); corner += 101) {
+          if (!(referenceComputeVertexNormal (grid, faceNormals, corner / 3, corner % 3) == normals[corner])) {
+            mismatches++;
+          }
+          checked++;
+        }
+        REQUIRE (checked > 1000u);
+        REQUIRE (0u == mismatches);
+      }
+    }
+  }
+}
+
+SCENARIO ("generateRandomVertexColors is seedable and order independent.", "[Geometry][A08]") {
+  GIVEN ("A large bumpy grid with thousands of shared corners.") {
+    std::vector<Triangle> grid = buildWavyGrid (60);
+    WHEN ("I generate vertex colors with a seed.") {
+      std::vector<Vector3> colors = generateRandomVertexColors (grid, 42);
+      THEN ("Every corner at the same position should have the same color.") {
+        REQUIRE (grid.size () * 3 == colors.size ());
+        std::map<std::tuple<float, float, float>, Vector3> colorAt;
+        for (unsigned int corner = 0; corner < colors.size (); corner++) {
+          const Vector3& position = grid[corner / 3][corner % 3];
+          auto key = std::make_tuple (position.m_x, position.m_y, position.m_z);
+          auto inserted = colorAt.insert (std::make_pair (key, colors[corner]));
+          REQUIRE (inserted.first->second == colors[corner]);
+        }
+        REQUIRE (61u * 61u == colorAt.size ());
+      }
+      THEN ("Each component should be in [0, 1).") {
+        for (const Vector3& color : colors) {
+          REQUIRE (color.m_x >= 0.0f);
+          REQUIRE (color.m_x < 1.0f);
+          REQUIRE (color.m_y >= 0.0f);
+          REQUIRE (color.m_y < 1.0f);
+          REQUIRE (color.m_z >= 0.0f);
+          REQUIRE (color.m_z < 1.0f);
+        }
+      }
+      THEN ("The same seed should reproduce them and another seed should not.") {
+        REQUIRE (colors == generateRandomVertexColors (grid, 42));
+        REQUIRE_FALSE (colors == generateRandomVertexColors (grid, 43));
+      }
+    }
+
+    WHEN ("I generate the colors of the first chunk of faces on their own.") {
+      std::vector<Vector3> colors = generateRandomVertexColors (grid, 7);
+      std::vector<Triangle> chunk (grid.begin (), grid.begin () + grid.size () / 3);
+      std::vector<Vector3> chunkColors = generateRandomVertexColors (chunk, 7);
+      THEN ("They should be exactly the first colors of the whole mesh.") {
+        REQUIRE (chunk.size () * 3 == chunkColors.size ());
+        REQUIRE (std::equal (chunkColors.begin (), chunkColors.end (), colors.begin ()));
+      }
+    }
+  }
+}
+
+SCENARIO ("Random colors do not depend on threads or chunks.", "[Geometry][A08]") {
+  GIVEN ("A large bumpy grid, and colors generated on one thread.") {
+    std::vector<Triangle> grid = buildWavyGrid (60);
+    std::vector<Vector3> faceColors = generateRandomFaceColors (grid, 11, 1);
+    std::vector<Vector3> vertexColors = generateRandomVertexColors (grid, 11);
+    THEN ("Face colors should be seedable, in [0, 1), and not all alike.") {
+      REQUIRE (grid.size () == faceColors.size ());
+      REQUIRE_FALSE (faceColors == generateRandomFaceColors (grid, 12, 1));
+      REQUIRE (generateRandomFaceColors (grid) == generateRandomFaceColors (grid, 0, 1));
+      std::set<std::tuple<float, float, float>> distinct;
+      for (const Vector3& color : faceColors) {
+        REQUIRE (color.m_x >= 0.0f);
+        REQUIRE (color.m_z < 1.0f);
+        distinct.insert (std::make_tuple (color.m_x, color.m_y, color.m_z));
+      }
+      REQUIRE (faceColors.size () == distinct.size ());
+    }
+    WHEN ("I generate them again with other thread counts and chunk sizes.") {
+      const unsigned int THREADS[] = { 1, 2, 3, 8, 0 };
+      const unsigned int CHUNKS[] = { 1, 7, 100, DEFAULT_FACES_PER_CHUNK, 1000000 };
+      THEN ("Every color should be exactly the same.") {
+        for (unsigned int threads : THREADS) {
+          for (unsigned int chunk : CHUNKS) {
+            CAPTURE (threads, chunk);
+            REQUIRE (faceColors == generateRandomFaceColors (grid, 11, threads, chunk));
+            REQUIRE (vertexColors == generateRandomVertexColors (grid, 11, threads, chunk));
+          }
+        }
+      }
+    }
+  }
+
+  GIVEN ("A face far away, then three faces whose first corners chain together, each within"
+         " tolerance of the next but the first and last not within tolerance of each other.") {
+    std::vector<Triangle> faces = {
+      { Vector3 (5.0f, 5.0f, 5.0f), Vector3 (6.0f, 5.0f, 5.0f), Vector3 (5.0f, 6.0f, 5.0f) },
+      { Vector3 (0.0f, 0.0f, 0.0f), Vector3 (1.0f, 0.0f, 0.0f), Vector3 (0.0f, 1.0f, 0.0f) },
+      { Vector3 (8e-6f, 0.0f, 0.0f), Vector3 (2.0f, 0.0f, 0.0f), Vector3 (0.0f, 2.0f, 0.0f) },
+      { Vector3 (1.6e-5f, 0.0f, 0.0f), Vector3 (3.0f, 0.0f, 0.0f), Vector3 (0.0f, 3.0f, 0.0f) } };
+    WHEN ("I generate vertex colors with any thread count and chunk size.") {
+      const unsigned int THREADS[] = { 1, 2, 4 };
+      const unsigned int CHUNKS[] = { 1, 2, DEFAULT_FACES_PER_CHUNK };
+      THEN ("The chained corners should share one color, which is not the far face's.") {
+        for (unsigned int threads : THREADS) {
+          for (unsigned int chunk : CHUNKS) {
+            CAPTURE (threads, chunk);
+            std::vector<Vector3> colors = generateRandomVertexColors (faces, 3, threads, chunk);
+            REQUIRE (colors[3] == colors[6]);
+            REQUIRE (colors[3] == colors[9]);
+            REQUIRE_FALSE (colors[0] == colors[9]);
+          }
+        }
+      }
+    }
+  }
+
+  GIVEN ("No faces.") {
+    THEN ("There should be no colors.") {
+      REQUIRE (generateRandomFaceColors ({}, 1, 4).empty ());
+      REQUIRE (generateRandomVertexColors ({}, 1, 4).empty ());
+    }
+  }
+}
+
+/// \brief Builds a flat grid of side x side quads facing +Z, where every quad
+///   has four vertices of its own whose positions and normals are nudged a
+///   little, like a mesh exported with rounding in it.
+/// \param[in] side The number of quads along each edge.
+/// \param[in] nudge How far positions are moved, at most, along each axis.
+/// \param[in] tiltDegrees How far normals are tilted, at most.
+/// \param[out] data Six floats per vertex: a position and a normal.
+/// \param[out] indices Three indices per triangle, two triangles per quad.
+void
+buildSplitGrid (unsigned int side, float nudge, float tiltDegrees, std::vector<float>& data,
+                std::vector<unsigned int>& indices)
+{
+  std::mt19937 generator (5);
+  std::uniform_real_distribution<float> unit (-1.0f, 1.0f);
+  const float tilt = std::tan (tiltDegrees * static_cast<float> (M_PI) / 180.0f) / std::sqrt (2.0f);
+  for (unsigned int row = 0; row < side; row++) {
+    for (unsigned int column = 0; column < side; column++) {
+      unsigned int first = data.size () / 6;
+      const unsigned int CORNERS[4][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+      for (const auto& corner : CORNERS) {
+        Vector3 normal (tilt * unit (generator), tilt * unit (generator), 1.0f);
+        normal.normalize ();
+        data.insert (data.end (), { (column + corner[0]) * 0.1f + nudge * unit (generator),
+                                    (row + corner[1]) * 0.1f + nudge * unit (generator),
+                                    nudge * unit (generator), normal.m_x, normal.m_y, normal.m_z });
+      }
+      indices.insert (indices.end (), { first, first + 1, first + 2, first, first + 2, first + 3 });
+    }
+  }
+}
+
+SCENARIO ("Welding vertices with separate tolerances.", "[Geometry][A08]") {
+  GIVEN ("A 10 x 10 grid split into quads, with positions and normals nudged.") {
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    buildSplitGrid (10, 0.0002f, 0.4f, data, indices);
+    std::vector<float> original = data;
+    std::vector<unsigned int> originalIndices = indices;
+    WHEN ("I index it the old way.") {
+      std::vector<float> soup;
+      for (unsigned int index : indices) {
+        soup.insert (soup.end (), &data[index * 6], &data[index * 6 + 6]);
+      }
+      std::vector<float> indexed;
+      std::vector<unsigned int> indexedIndices;
+      indexData (soup, 6, indexed, indexedIndices);
+      THEN ("Nothing should be merged, since no two vertices match exactly.") {
+        REQUIRE (400u == indexed.size () / 6);
+      }
+    }
+    WHEN ("I weld it as normals with the default tolerances.") {
+      WeldStatistics statistics = weldVertices (data, 6, indices, VertexAttribute::NORMAL);
+      THEN ("Each grid point should become one vertex, and every triangle stay.") {
+        REQUIRE (400u - 121u == statistics.m_verticesRemoved);
+        REQUIRE (0u == statistics.m_trianglesRemoved);
+        REQUIRE (121u * 6 == data.size ());
+        REQUIRE (originalIndices.size () == indices.size ());
+      }
+      THEN ("Each corner should have moved no farther than the tolerances.") {
+        for (unsigned int corner = 0; corner < indices.size (); corner++) {
+          const float* before = &original[originalIndices[corner] * 6];
+          const float* after = &data[indices[corner] * 6];
+          Vector3 move (after[0] - before[0], after[1] - before[1], after[2] - before[2]);
+          REQUIRE (move.length () <= DEFAULT_WELD_TOLERANCES.m_positionDistance);
+          Vector3 normalBefore (before[3], before[4], before[5]);
+          Vector3 normalAfter (after[3], after[4], after[5]);
+          REQUIRE (normalBefore.dot (normalAfter) >= std::cos (static_cast<float> (M_PI) / 180.0f) - 1e-6f);
+        }
+      }
+    }
+    WHEN ("I weld it with a normal tolerance smaller than the nudges.") {
+      WeldStatistics statistics = weldVertices (data, 6, indices, VertexAttribute::NORMAL,
+                                                { 0.001f, 0.01f, 0.0f });
+      THEN ("Fewer vertices should be merged.") {
+        REQUIRE (statistics.m_verticesRemoved < 400u - 121u);
+        REQUIRE (0u == statistics.m_trianglesRemoved);
+      }
+    }
+  }
+
+  GIVEN ("Two faces of a cube meeting at a crease, with a normal each.") {
+    std::vector<float> crease = { 0, 0, 0,  0, 0, 1,   1, 0, 0,  0, 0, 1,   0, 1, 0,  0, 0, 1,
+                                  0, 0, 0,  0, 1, 0,   0, 0, -1,  0, 1, 0,   1, 0, 0,  0, 1, 0 };
+    std::vector<unsigned int> indices = { 0, 1, 2, 3, 4, 5 };
+    WHEN ("I weld it with the default tolerances.") {
+      std::vector<float> data = crease;
+      WeldStatistics statistics = weldVertices (data, 6, indices, VertexAttribute::NORMAL);
+      THEN ("The crease should keep its split.") {
+        REQUIRE (0u == statistics.m_verticesRemoved);
+        REQUIRE (crease == data);
+      }
+    }
+    WHEN ("I weld it allowing normals 100 degrees apart.") {
+      std::vector<float> data = crease;
+      WeldStatistics statistics = weldVertices (data, 6, indices, VertexAttribute::NORMAL,
+                                                { 0.001f, 100.0f, 0.0f });
+      THEN ("The two corners on the crease should each become one vertex.") {
+        REQUIRE (2u == statistics.m_verticesRemoved);
+        REQUIRE (std::vector<unsigned int> ({ 0, 1, 2, 0, 3, 1 }) == indices);
+      }
+    }
+  }
+
+  GIVEN ("A triangle whose corners differ from another's by one 8-bit color step.") {
+    const float STEP = 1.0f / 255.0f;
+    std::vector<float> colored = { 0, 0, 0,  0.5f, 0.5f, 0.5f,   1, 0, 0,  1, 0, 0,   0, 1, 0,  0, 1, 0,
+                                   0, 0, 0,  0.5f + STEP, 0.5f, 0.5f,   0, 1, 0,  0, 1, 0,   -1, 0, 0,  0, 0, 1 };
+    std::vector<unsigned int> indices = { 0, 1, 2, 3, 4, 5 };
+    THEN ("Only a color tolerance of at least a step should weld them.") {
+      std::vector<float> data = colored;
+      std::vector<unsigned int> welded = indices;
+      REQUIRE (1u == weldVertices (data, 6, welded, VertexAttribute::COLOR).m_verticesRemoved);
+      REQUIRE (std::vector<unsigned int> ({ 0, 1, 2, 3, 2, 4 }) == welded);
+      data = colored;
+      welded = indices;
+      REQUIRE (2u == weldVertices (data, 6, welded, VertexAttribute::COLOR,
+                                   { 0.001f, 1.0f, 1.5f * STEP }).m_verticesRemoved);
+    }
+  }
+
+  GIVEN ("A triangle smaller than the position tolerance, next to a normal one.") {
+    std::vector<float> data = { 0, 0, 0,   1, 0, 0,   0, 1, 0,   0.0001f, 0, 0,   0, 0.0001f, 0 };
+    std::vector<unsigned int> indices = { 0, 1, 2, 0, 3, 4 };
+    WHEN ("I weld its positions.") {
+      WeldStatistics statistics = weldVertices (data, 3, indices, VertexAttribute::NONE);
+      THEN ("It should collapse and be dropped, along with its vertices.") {
+        REQUIRE (1u == statistics.m_trianglesRemoved);
+        REQUIRE (2u == statistics.m_verticesRemoved);
+        REQUIRE (std::vector<unsigned int> ({ 0, 1, 2 }) == indices);
+        REQUIRE (9u == data.size ());
+      }
+    }
+  }
+}
+
+SCENARIO ("Interleaved writers and in-place indexing.", "[Geometry][A08]") {
+  GIVEN ("A cube with colors and normals.") {
+    std::vector<Triangle> cube = buildCube ();
+    std::vector<Vector3> faceColors = generateRandomFaceColors (cube);
+    std::vector<Vector3> vertexColors = generateRandomVertexColors (cube, 3);
+    std::vector<Vector3> faceNormals = computeFaceNormals (cube);
+    std::vector<Vector3> vertexNormals = computeVertexNormals (cube, faceNormals);
+    WHEN ("I write all four layouts back to back into one presized buffer.") {
+      std::vector<float> buffer (4 * interleavedFloatCount (cube));
+      float* end = writeFaceColors (cube, faceColors, buffer.data ());
+      end = writeVertexColors (cube, vertexColors, end);
+      end = writeFaceNormals (cube, faceNormals, end);
+      end = writeVertexNormals (cube, vertexNormals, end);
+      THEN ("It should be exactly filled with what the dataWith functions return.") {
+        REQUIRE (buffer.data () + buffer.size () == end);
+        std::vector<float> expected = dataWithFaceColors (cube, faceColors);
+        std::vector<float> more = dataWithVertexColors (cube, vertexColors);
+        expected.insert (expected.end (), more.begin (), more.end ());
+        more = dataWithFaceNormals (cube, faceNormals);
+        expected.insert (expected.end (), more.begin (), more.end ());
+        more = dataWithVertexNormals (cube, vertexNormals);
+        expected.insert (expected.end (), more.begin (), more.end ());
+        REQUIRE (expected == buffer);
+      }
+    }
+  }
+
+  GIVEN ("Triangle soups whose vertices are within about EPSILON of each other.") {
+    WHEN ("I index them in place.") {
+      THEN ("The front of the buffer and the indices should match indexData.") {
+        for (unsigned int floatsPerVertex = 1; floatsPerVertex <= 6; floatsPerVertex++) {
+          CAPTURE (floatsPerVertex);
+          std::vector<float> geometry = jitteredSoup (3000, floatsPerVertex, 20 + floatsPerVertex);
+          std::vector<float> data;
+          std::vector<unsigned int> expectedIndices;
+          indexData (geometry, floatsPerVertex, data, expectedIndices);
+          std::vector<unsigned int> indices;
+          unsigned int unique = indexDataInPlace (geometry.data (), geometry.size () / floatsPerVertex,
+                                                  floatsPerVertex, indices);
+          geometry.resize (unique * floatsPerVertex);
+          REQUIRE (data == geometry);
+          REQUIRE (expectedIndices == indices);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO ("Quadric error levels of detail.", "[Geometry][A08]") {
+  GIVEN ("A flat, indexed 20 x 20 grid.") {
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    indexPositions (buildWavyGrid (20, 0.0f), data, indices);
+    const unsigned int TRIANGLES = indices.size () / 3;
+    WHEN ("I build levels of detail down to 15% of the triangles.") {
+      std::vector<float> ratios = { 1.0f, 0.5f, 0.25f, 0.15f };
+      std::vector<LevelOfDetail> levels = buildLevelsOfDetail (data, 3, indices, ratios);
+      THEN ("The first level should be the original, exactly.") {
+        REQUIRE (4u == levels.size ());
+        REQUIRE (indices == levels[0].m_indices);
+        REQUIRE (0.0f == levels[0].m_error);
+      }
+      THEN ("Each level should meet its budget without leaving the plane.") {
+        for (unsigned int level = 1; level < levels.size (); level++) {
+          CAPTURE (level);
+          REQUIRE (levels[level].m_indices.size () / 3 <= ratios[level] * TRIANGLES);
+          REQUIRE (levels[level].m_indices.size () <= levels[level - 1].m_indices.size ());
+          REQUIRE (levels[level].m_error < 0.0001f);
+        }
+      }
+      THEN ("The coarsest level should keep the whole border and face the same way.") {
+        const std::vector<unsigned int>& coarse = levels.back ().m_indices;
+        for (unsigned int corner = 0; corner < coarse.size (); corner += 3) {
+          REQUIRE (coarse[corner] != coarse[corner + 1]);
+          REQUIRE (coarse[corner + 1] != coarse[corner + 2]);
+          REQUIRE (coarse[corner + 2] != coarse[corner]);
+          REQUIRE (indexedNormal (data, 3, &coarse[corner]).m_y > 0.0f);
+        }
+        for (unsigned int vertex = 0; vertex < data.size () / 3; vertex++) {
+          float x = data[vertex * 3];
+          float z = data[vertex * 3 + 2];
+          if (x == 0.0f || z == 0.0f || x > 1.99f || z > 1.99f) {
+            CAPTURE (x, z);
+            REQUIRE (std::find (coarse.begin (), coarse.end (), vertex) != coarse.end ());
+          }
+        }
+      }
+    }
+  }
+
+  GIVEN ("A wavy, indexed 30 x 30 grid.") {
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    indexPositions (buildWavyGrid (30), data, indices);
+    WHEN ("I build two levels of detail.") {
+      std::vector<LevelOfDetail> levels = buildLevelsOfDetail (data, 3, indices, { 0.5f, 0.2f });
+      THEN ("Coarser levels should report larger, but still small, errors.") {
+        CAPTURE (levels[0].m_error, levels[1].m_error);
+        REQUIRE (levels[1].m_indices.size () / 3 <= 0.2f * indices.size () / 3);
+        REQUIRE (levels[0].m_error > 0.0f);
+        REQUIRE (levels[0].m_error <= levels[1].m_error);
+        REQUIRE (levels[1].m_error < 0.15f);
+      }
+    }
+  }
+
+  GIVEN ("A wavy grid whose left and right halves have different colors.") {
+    std::vector<Triangle> grid = buildWavyGrid (30);
+    std::vector<Vector3> faceColors;
+    for (const Triangle& face : grid) {
+      float centerX = (face[0].m_x + face[1].m_x + face[2].m_x) / 3.0f;
+      faceColors.push_back (centerX < 1.5f ? Vector3 (1.0f, 0.0f, 0.0f) : Vector3 (0.0f, 0.0f, 1.0f));
+    }
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    indexData (dataWithFaceColors (grid, faceColors), 6, data, indices);
+    WHEN ("I simplify it to a quarter of its triangles.") {
+      std::vector<LevelOfDetail> levels = buildLevelsOfDetail (data, 6, indices, { 0.25f });
+      const std::vector<unsigned int>& coarse = levels[0].m_indices;
+      THEN ("No triangle should mix colors across the seam.") {
+        REQUIRE (coarse.size () / 3 <= indices.size () / 12);
+        for (unsigned int corner = 0; corner < coarse.size (); corner += 3) {
+          REQUIRE (data[coarse[corner] * 6 + 3] == data[coarse[corner + 1] * 6 + 3]);
+          REQUIRE (data[coarse[corner] * 6 + 3] == data[coarse[corner + 2] * 6 + 3]);
+        }
+      }
+      THEN ("Every vertex on the seam should still be used.") {
+        for (unsigned int vertex = 0; vertex < data.size () / 6; vertex++) {
+          if (std::fabs (data[vertex * 6] - 1.5f) < 0.001f) {
+            REQUIRE (std::find (coarse.begin (), coarse.end (), vertex) != coarse.end ());
+          }
+        }
+      }
+    }
+  }
+
+  GIVEN ("A cube with face normals, where every vertex is on a seam.") {
+    std::vector<Triangle> cube = buildCube ();
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    indexData (dataWithFaceNormals (cube, computeFaceNormals (cube)), 6, data, indices);
+    THEN ("It cannot be simplified at all.") {
+      std::vector<LevelOfDetail> levels = buildLevelsOfDetail (data, 6, indices, { 0.5f });
+      REQUIRE (indices == levels[0].m_indices);
+      REQUIRE (0.0f == levels[0].m_error);
+    }
+  }
+}
+
+SCENARIO ("Quantized vertex encodings.", "[Geometry][A08]") {
+  GIVEN ("Floats that halves store exactly, and some that they round.") {
+    THEN ("Exact values should round trip and the rest round to nearest even.") {
+      for (float value : { 0.0f, 1.0f, -2.5f, 0.099975586f, 65504.0f, 6.1035156e-05f, 5.9604645e-08f }) {
+        CAPTURE (value);
+        REQUIRE (value == decodeHalf (encodeHalf (value)));
+      }
+      REQUIRE (0x3C00u == encodeHalf (1.0f));
+      REQUIRE (0xC000u == encodeHalf (-2.0f));
+      REQUIRE (0x8000u == encodeHalf (-0.0f));
+      // 1 + 2^-11 is halfway between 1 and the next half, and rounds to even.
+      REQUIRE (0x3C00u == encodeHalf (1.00048828125f));
+      REQUIRE (0x3C02u == encodeHalf (1.00146484375f));
+      REQUIRE (0x0001u == encodeHalf (5.9604645e-08f));
+      REQUIRE (0x0000u == encodeHalf (2.9802322e-08f));
+      REQUIRE (0x7C00u == encodeHalf (65520.0f));
+      REQUIRE (0xFC00u == encodeHalf (-std::numeric_limits<float>::infinity ()));
+      REQUIRE (std::isnan (decodeHalf (encodeHalf (std::numeric_limits<float>::quiet_NaN ()))));
+      REQUIRE (std::isinf (decodeHalf (0x7C00u)));
+    }
+  }
+
+  GIVEN ("Normalized integer conversions.") {
+    THEN ("They should round and clamp the way OpenGL decodes them.") {
+      REQUIRE (32767 == encodeSnorm (1.0f, 16));
+      REQUIRE (-32767 == encodeSnorm (-3.0f, 16));
+      REQUIRE (64 == encodeSnorm (0.5f, 8));
+      REQUIRE (0 == encodeSnorm (0.0f, 8));
+      REQUIRE (255u == encodeUnorm8 (1.0f));
+      REQUIRE (128u == encodeUnorm8 (0.5f));
+      REQUIRE (0u == encodeUnorm8 (-0.5f));
+    }
+  }
+
+  GIVEN ("Unit normals in every octant, including the poles.") {
+    std::vector<Vector3> normals = { Vector3 (0.0f, 0.0f, 1.0f), Vector3 (0.0f, 0.0f, -1.0f),
+                                     Vector3 (1.0f, 0.0f, 0.0f), Vector3 (0.0f, -1.0f, 0.0f) };
+    std::mt19937 generator (11);
+    std::normal_distribution<float> distribution;
+    for (unsigned int count = 0; count < 500; count++) {
+      Vector3 normal (distribution (generator), distribution (generator), distribution (generator));
+      normal.normalize ();
+      normals.push_back (normal);
+    }
+    THEN ("Octahedral encoding should stay within the square and round trip closely.") {
+      for (const Vector3& normal : normals) {
+        CAPTURE (normal.m_x, normal.m_y, normal.m_z);
+        std::array<float, 2> folded = encodeOctahedral (normal);
+        REQUIRE (std::fabs (folded[0]) <= 1.0f);
+        REQUIRE (std::fabs (folded[1]) <= 1.0f);
+        REQUIRE (decodeOctahedral (folded[0], folded[1]).dot (normal) > 0.99999f);
+        float x16 = encodeSnorm (folded[0], 16) / 32767.0f;
+        float y16 = encodeSnorm (folded[1], 16) / 32767.0f;
+        REQUIRE (decodeOctahedral (x16, y16).dot (normal) > 0.99999f);
+        float x8 = encodeSnorm (folded[0], 8) / 127.0f;
+        float y8 = encodeSnorm (folded[1], 8) / 127.0f;
+        // About 1.5 degrees.
+        REQUIRE (decodeOctahedral (x8, y8).dot (normal) > 0.9996f);
+      }
+    }
+  }
+
+  GIVEN ("Each combination of formats.") {
+    THEN ("Attributes should be aligned and strides a multiple of 4 bytes.") {
+      REQUIRE (12u == packedAttributeOffset ({ PositionFormat::FLOAT32, AttributeFormat::FLOAT32 }));
+      REQUIRE (24u == packedVertexStride ({ PositionFormat::FLOAT32, AttributeFormat::FLOAT32 }));
+      REQUIRE (8u == packedAttributeOffset ({ PositionFormat::HALF_FLOAT, AttributeFormat::FLOAT32 }));
+      REQUIRE (20u == packedVertexStride ({ PositionFormat::HALF_FLOAT, AttributeFormat::FLOAT32 }));
+      REQUIRE (6u == packedAttributeOffset ({ PositionFormat::SNORM16, AttributeFormat::OCTAHEDRAL_SNORM16 }));
+      REQUIRE (12u == packedVertexStride ({ PositionFormat::SNORM16, AttributeFormat::OCTAHEDRAL_SNORM16 }));
+      REQUIRE (8u == packedVertexStride ({ PositionFormat::HALF_FLOAT, AttributeFormat::OCTAHEDRAL_SNORM8 }));
+      REQUIRE (12u == packedVertexStride ({ PositionFormat::HALF_FLOAT, AttributeFormat::UNORM8 }));
+      REQUIRE (16u == packedVertexStride ({ PositionFormat::FLOAT32, AttributeFormat::UNORM8 }));
+    }
+  }
+
+  GIVEN ("A wavy grid with face normals, far from the origin.") {
+    std::vector<Triangle> grid = buildWavyGrid (10);
+    for (Triangle& face : grid) {
+      for (Vector3& corner : face) {
+        corner += Vector3 (100.0f, -50.0f, 20.0f);
+      }
+    }
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    indexData (dataWithFaceNormals (grid, computeFaceNormals (grid)), 6, data, indices);
+    PositionQuantization quantization = computePositionQuantization (data, 6);
+    THEN ("The quantization should map the bounding box onto [-1, 1].") {
+      REQUIRE (quantization.m_offset.m_x == Approx (100.5f));
+      REQUIRE (quantization.m_offset.m_z == Approx (20.5f));
+      REQUIRE (quantization.m_scale == Approx (0.5f));
+    }
+    WHEN ("I encode it as snorm16 positions and 8-bit octahedral normals.") {
+      VertexFormat format = { PositionFormat::SNORM16, AttributeFormat::OCTAHEDRAL_SNORM8 };
+      std::vector<unsigned char> packed = encodeVertices (data, format, quantization);
+      THEN ("It should take a third of the space and decode to nearly the same vertices.") {
+        const unsigned int VERTICES = data.size () / 6;
+        REQUIRE (VERTICES * 8u == packed.size ());
+        REQUIRE (3 * packed.size () == data.size () * sizeof (float));
+        for (unsigned int vertex = 0; vertex < VERTICES; vertex++) {
+          std::int16_t position[3];
+          std::int8_t folded[2];
+          std::memcpy (position, &packed[vertex * 8], sizeof (position));
+          std::memcpy (folded, &packed[vertex * 8 + 6], sizeof (folded));
+          const float* original = &data[vertex * 6];
+          const float offset[3] = { quantization.m_offset.m_x, quantization.m_offset.m_y,
+                                    quantization.m_offset.m_z };
+          for (unsigned int axis = 0; axis < 3; axis++) {
+            float decoded = offset[axis] + quantization.m_scale * position[axis] / 32767.0f;
+            REQUIRE (std::fabs (decoded - original[axis]) < 0.0001f);
+          }
+          Vector3 normal = decodeOctahedral (folded[0] / 127.0f, folded[1] / 127.0f);
+          REQUIRE (normal.dot (Vector3 (original[3], original[4], original[5])) > 0.9996f);
+        }
+      }
+    }
+    WHEN ("I encode it as floats.") {
+      std::vector<unsigned char> packed = encodeVertices (data, { PositionFormat::FLOAT32, AttributeFormat::FLOAT32 },
+                                                          quantization);
+      THEN ("The bytes should be the data, unchanged.") {
+        REQUIRE (data.size () * sizeof (float) == packed.size ());
+        REQUIRE (0 == std::memcmp (data.data (), packed.data (), packed.size ()));
+      }
+    }
+  }
+}
+
+SCENARIO ("Bounding volumes of vertex data.", "[Geometry][A08]") {
+  GIVEN ("Random vertices with several strides and counts, some with tails.") {
+    std::mt19937 generator (11);
+    std::uniform_real_distribution<float> coordinate (-50.0f, 50.0f);
+    for (unsigned int floatsPerVertex : { 3u, 6u, 7u }) {
+      for (unsigned int vertices : { 1u, 2u, 5u, 16u, 17u, 333u }) {
+        std::vector<float> data (floatsPerVertex * vertices);
+        for (float& value : data) {
+          value = coordinate (generator);
+        }
+        CAPTURE (floatsPerVertex, vertices);
+        BoundingBox box = computeBoundingBox (data, floatsPerVertex);
+        THEN ("The box should match a plain scalar search exactly.") {
+          float low[3] = { data[0], data[1], data[2] };
+          float high[3] = { data[0], data[1], data[2] };
+          for (unsigned int vertex = 0; vertex < vertices; vertex++) {
+            for (unsigned int axis = 0; axis < 3; axis++) {
+              low[axis] = std::min (low[axis], data[vertex * floatsPerVertex + axis]);
+              high[axis] = std::max (high[axis], data[vertex * floatsPerVertex + axis]);
+            }
+          }
+          REQUIRE (low[0] == box.m_min.m_x);
+          REQUIRE (low[1] == box.m_min.m_y);
+          REQUIRE (low[2] == box.m_min.m_z);
+          REQUIRE (high[0] == box.m_max.m_x);
+          REQUIRE (high[1] == box.m_max.m_y);
+          REQUIRE (high[2] == box.m_max.m_z);
+        }
+        THEN ("The sphere should be centered on the box and just reach the farthest vertex.") {
+          BoundingSphere sphere = computeBoundingSphere (data, floatsPerVertex, box);
+          REQUIRE (((box.m_min + box.m_max) / 2.0f - sphere.m_center).length () == Approx (0.0f).margin (1e-5));
+          float farthest = 0.0f;
+          for (unsigned int vertex = 0; vertex < vertices; vertex++) {
+            Vector3 position (data[vertex * floatsPerVertex], data[vertex * floatsPerVertex + 1],
+                              data[vertex * floatsPerVertex + 2]);
+            farthest = std::max (farthest, (position - sphere.m_center).length ());
+          }
+          REQUIRE (farthest <= sphere.m_radius);
+          REQUIRE (farthest == Approx (sphere.m_radius));
+        }
+      }
+    }
+  }
+
+  GIVEN ("No vertices.") {
+    THEN ("The bounds should be empty, at the origin.") {
+      BoundingBox box = computeBoundingBox ({}, 6);
+      BoundingSphere sphere = computeBoundingSphere ({}, 6, box);
+      REQUIRE (0.0f == box.m_min.length ());
+      REQUIRE (0.0f == box.m_max.length ());
+      REQUIRE (0.0f == sphere.m_radius);
+    }
+  }
+}
+
+SCENARIO ("Lossless geometry compression.", "[Geometry][A08]") {
+  GIVEN ("An indexed 50 x 50 grid with an up normal at every vertex.") {
+    const unsigned int SIDE = 50;
+    std::vector<float> data;
+    for (unsigned int row = 0; row <= SIDE; row++) {
+      for (unsigned int column = 0; column <= SIDE; column++) {
+        data.insert (data.end (), { column * 0.1f, 0.05f * std::sin (column * 0.3f) * std::cos (row * 0.2f),
+                                    row * 0.1f, 0.0f, 1.0f, 0.0f });
+      }
+    }
+    std::vector<unsigned int> indices = buildGridIndices (SIDE, true);
+    WHEN ("I compress and decompress it.") {
+      CompressedGeometry compressed = compressGeometry (data, 6, indices);
+      std::vector<float> restoredData;
+      std::vector<unsigned int> restoredIndices;
+      decompressGeometry (compressed, restoredData, restoredIndices);
+      THEN ("Every bit should come back.") {
+        REQUIRE (data.size () == restoredData.size ());
+        REQUIRE (0 == std::memcmp (data.data (), restoredData.data (), data.size () * sizeof (float)));
+        REQUIRE (indices == restoredIndices);
+      }
+      THEN ("It should take less than half the memory.") {
+        std::size_t before = data.size () * sizeof (float) + indices.size () * sizeof (unsigned int);
+        std::size_t after = compressed.m_vertexBytes.size () + compressed.m_indexBytes.size ();
+        REQUIRE (after * 2 < before);
+        REQUIRE (compressed.m_indexBytes.size () < 2 * indices.size ());
+        WARN ("A 50 x 50 grid compresses from " << before << " to " << after << " bytes.");
+      }
+    }
+  }
+
+  GIVEN ("Values that are hard to compress: signed zeros, infinities, NaN, and the strip restart index.") {
+    const std::vector<float> DATA = { -0.0f, 0.0f, std::numeric_limits<float>::infinity (),
+                                      std::numeric_limits<float>::quiet_NaN (), -1e-38f, 3.4e38f,
+                                      0.0f };
+    const std::vector<unsigned int> INDICES = { 7, 0, std::numeric_limits<unsigned int>::max (), 3, 4294967294u, 0 };
+    WHEN ("I compress and decompress them, three floats per vertex.") {
+      std::vector<float> data;
+      std::vector<unsigned int> indices;
+      decompressGeometry (compressGeometry (DATA, 3, INDICES), data, indices);
+      THEN ("Every bit should come back.") {
+        REQUIRE (DATA.size () == data.size ());
+        REQUIRE (0 == std::memcmp (DATA.data (), data.data (), DATA.size () * sizeof (float)));
+        REQUIRE (INDICES == indices);
+      }
+    }
+  }
+}
+
+SCENARIO ("Vertex layouts.", "[Geometry][A08]") {
+  GIVEN ("A layout with a position, a normal, and texture coordinates.") {
+    typedef VertexLayout<PositionAttribute, NormalAttribute, TexCoordAttribute> Layout;
+    THEN ("Its stride and offsets should be worked out at compile time.") {
+      static_assert (Layout::FLOATS_PER_VERTEX == 8, "3 + 3 + 2 floats");
+      static_assert (Layout::STRIDE == 32, "8 floats");
+      static_assert (Layout::offsetOf<NormalAttribute> () == 3, "after the position");
+      static_assert (Layout::offsetOf<TexCoordAttribute> () == 6, "after the normal");
+      REQUIRE (3u == Layout::ATTRIBUTE_COUNT);
+      REQUIRE (3u == Layout::BINDINGS[2].m_location);
+      REQUIRE (2u == Layout::BINDINGS[2].m_floats);
+      REQUIRE (6u == Layout::BINDINGS[2].m_offset);
+    }
+    THEN ("Only layouts with one attribute after the position should have a welding kind.") {
+      REQUIRE (VertexAttribute::NONE == Layout::DESCRIPTION.m_attribute);
+      REQUIRE (VertexAttribute::COLOR == ColorsLayout::DESCRIPTION.m_attribute);
+      REQUIRE (VertexAttribute::NORMAL == NormalsLayout::DESCRIPTION.m_attribute);
+      REQUIRE (VertexAttribute::NONE == PositionsLayout::DESCRIPTION.m_attribute);
+    }
+    THEN ("Its signature should tell it apart from layouts of the same size.") {
+      typedef VertexLayout<PositionAttribute, TexCoordAttribute, NormalAttribute> Reordered;
+      typedef VertexLayout<PositionAttribute, ColorAttribute, TexCoordAttribute> Colored;
+      std::set<unsigned int> signatures { Layout::DESCRIPTION.m_signature, Reordered::DESCRIPTION.m_signature,
+                                          Colored::DESCRIPTION.m_signature, ColorsLayout::DESCRIPTION.m_signature,
+                                          NormalsLayout::DESCRIPTION.m_signature,
+                                          PositionsLayout::DESCRIPTION.m_signature };
+      REQUIRE (6u == signatures.size ());
+    }
+    WHEN ("I interleave two vertices from separate arrays.") {
+      const float POSITIONS[] = { 1, 2, 3, 4, 5, 6 };
+      const float NORMALS[] = { 0, 1, 0, 0, 0, 1 };
+      const float TEX_COORDS[] = { 0.25f, 0.75f, 1, 0 };
+      std::vector<float> data (2 * Layout::FLOATS_PER_VERTEX, -1.0f);
+      float* end = Layout::interleave (data.data (), 2, POSITIONS, NORMALS, TEX_COORDS);
+      THEN ("Each attribute should land at its offset in each vertex.") {
+        REQUIRE (data.data () + data.size () == end);
+        REQUIRE (data == std::vector<float> { 1, 2, 3, 0, 1, 0, 0.25f, 0.75f,
+                                              4, 5, 6, 0, 0, 1, 1, 0 });
+      }
+    }
+  }
+}
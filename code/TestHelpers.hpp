@@ -0,0 +1,94 @@
+/// \file TestHelpers.hpp
+/// \brief Definitions of the grid fixtures and index buffer comparisons
+///   shared by the Catch2 unit tests.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// Macro guard
+#ifndef TESTHELPERS_HPP
+#define TESTHELPERS_HPP
+
+/******************************************************************/
+// System includes
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/******************************************************************/
+/// \brief Builds the indices of a grid of side x side quads, two triangles
+///   per quad, whose (side + 1) x (side + 1) vertices are numbered row by
+///   row.
+/// \param[in] side The number of quads along each edge.
+/// \param[in] flipped Whether to wind every triangle the other way.
+/// \return Three indices per triangle.  Unless flipped, the triangles are
+///   counterclockwise seen from +Z when columns run along +X and rows along
+///   +Y; flipped, they are counterclockwise seen from +Y when rows run along
+///   +Z instead.
+inline std::vector<unsigned int>
+buildGridIndices (unsigned int side, bool flipped = false)
+{
+  std::vector<unsigned int> indices;
+  indices.reserve (6u * side * side);
+  for (unsigned int row = 0; row < side; row++)
+  {
+    for (unsigned int column = 0; column < side; column++)
+    {
+      unsigned int corner = row * (side + 1) + column;
+      indices.insert (indices.end (), { corner, corner + 1, corner + side + 1,
+                                        corner + 1, corner + side + 2, corner + side + 1 });
+    }
+  }
+  if (flipped)
+  {
+    for (std::size_t triangle = 0; triangle < indices.size (); triangle += 3)
+    {
+      std::swap (indices[triangle + 1], indices[triangle + 2]);
+    }
+  }
+  return indices;
+}
+
+/// \brief Builds an indexed, flat grid of side x side quads in the XY plane,
+///   centered on the origin, whose triangles face +Z.
+/// \param[in] side The number of quads along each edge.
+/// \param[in] spacing The width of each quad.
+/// \param[out] data Replaced by each vertex's position, row by row, each
+///   followed by attribute.
+/// \param[out] indices Replaced by buildGridIndices (side).
+/// \param[in] attribute The floats after every position, such as a color,
+///   or none for positions alone.
+inline void
+buildFlatGrid (unsigned int side, float spacing, std::vector<float>& data,
+               std::vector<unsigned int>& indices, const std::vector<float>& attribute = {})
+{
+  const float half = side * spacing / 2.0f;
+  data.clear ();
+  data.reserve ((side + 1u) * (side + 1u) * (3 + attribute.size ()));
+  for (unsigned int row = 0; row <= side; row++)
+  {
+    for (unsigned int column = 0; column <= side; column++)
+    {
+      data.insert (data.end (), { column * spacing - half, row * spacing - half, 0.0f });
+      data.insert (data.end (), attribute.begin (), attribute.end ());
+    }
+  }
+  indices = buildGridIndices (side);
+}
+
+/// \brief Gets the triangles of an index buffer in sorted order, so two
+///   buffers can be compared regardless of the order they draw in.
+inline std::vector<std::array<unsigned int, 3>>
+sortedTriangles (const std::vector<unsigned int>& indices)
+{
+  std::vector<std::array<unsigned int, 3>> triangles;
+  for (unsigned int corner = 0; corner + 2 < indices.size (); corner += 3)
+  {
+    triangles.push_back ({ { indices[corner], indices[corner + 1], indices[corner + 2] } });
+  }
+  std::sort (triangles.begin (), triangles.end ());
+  return triangles;
+}
+
+#endif//TESTHELPERS_HPP
@@ -0,0 +1,1152 @@
+/// \file TestMesh.cpp
+/// \brief A collection of Catch2 unit tests for the Mesh class, which observe
+///   its OpenGL calls through a MockOpenGLContext.
+/// \author Sean Malloy
+/// \version A08
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "BufferArena.hpp"
+#include "Camera.hpp"
+#include "ColorsMesh.hpp"
+#include "Geometry.hpp"
+#include "GeometryRegistry.hpp"
+#include "Matrix4.hpp"
+#include "MockOpenGLContext.hpp"
+#include "Scene.hpp"
+#include "ShaderProgram.hpp"
+#include "TestHelpers.hpp"
+#include "Transform.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+/// \brief Reads the indices back out of an uploaded element array buffer.
+/// \param[in] buffer The buffer.
+/// \param[in] type The type each index was stored as.
+/// \return The indices, widened to unsigned int.
+std::vector<unsigned int>
+decodeIndices (const MockOpenGLContext::Buffer& buffer, GLenum type)
+{
+  std::vector<unsigned int> indices;
+  const unsigned char* bytes = buffer.m_bytes.data ();
+  if (type == GL_UNSIGNED_BYTE)
+  {
+    indices.assign (bytes, bytes + buffer.m_bytes.size ());
+  }
+  else if (type == GL_UNSIGNED_SHORT)
+  {
+    std::vector<GLushort> shorts (buffer.m_bytes.size () / sizeof (GLushort));
+    std::memcpy (shorts.data (), bytes, buffer.m_bytes.size ());
+    indices.assign (shorts.begin (), shorts.end ());
+  }
+  else
+  {
+    indices.resize (buffer.m_bytes.size () / sizeof (GLuint));
+    std::memcpy (indices.data (), bytes, buffer.m_bytes.size ());
+  }
+  return indices;
+}
+
+SCENARIO ("Mesh index buffers use the smallest index type.", "[Mesh][A08]") {
+  GIVEN ("An indexed cube with a random color on each face.") {
+    MockOpenGLContext context;
+    ShaderProgram shader (&context);
+    ColorsMesh cube (&context, &shader);
+    std::vector<Triangle> faces = buildCube ();
+    writeFaceColors (faces, generateRandomFaceColors (faces),
+                     cube.stageGeometry (interleavedFloatCount (faces)));
+    cube.indexGeometry ();
+    WHEN ("I prepare and draw it.") {
+      cube.prepareVao ();
+      cube.draw (Transform (), Matrix4 ());
+      THEN ("Its 36 indices should be uploaded and drawn as single bytes.") {
+        REQUIRE (1u == context.getDrawCalls ().size ());
+        const MockOpenGLContext::DrawCall& call = context.getDrawCalls ()[0];
+        REQUIRE (GLenum (GL_UNSIGNED_BYTE) == call.m_type);
+        REQUIRE (36 == call.m_count);
+        REQUIRE (36u == context.getTotalBufferBytes (GL_ELEMENT_ARRAY_BUFFER));
+        REQUIRE (36u * 6 * sizeof (float) == context.getTotalBufferBytes (GL_ARRAY_BUFFER));
+        std::vector<unsigned int> uploaded = decodeIndices (context.getBuffer (call.m_elementBuffer), call.m_type);
+        std::vector<float> data;
+        std::vector<unsigned int> indices;
+        indexData (dataWithFaceColors (faces, generateRandomFaceColors (faces)), 6, data, indices);
+        REQUIRE (indices == uploaded);
+      }
+    }
+  }
+
+  GIVEN ("Meshes with vertex counts on either side of each limit.") {
+    struct Case { unsigned int m_vertices; GLenum m_type; unsigned int m_bytesPerIndex; };
+    const Case CASES[] = {
+      { 3, GL_UNSIGNED_BYTE, 1 },
+      { 255, GL_UNSIGNED_BYTE, 1 },
+      { 256, GL_UNSIGNED_SHORT, 2 },
+      { 65535, GL_UNSIGNED_SHORT, 2 },
+      { 65536, GL_UNSIGNED_INT, 4 },
+      { 100000, GL_UNSIGNED_INT, 4 }
+    };
+    THEN ("Each should get the narrowest type that reaches its last vertex.") {
+      for (const Case& test : CASES) {
+        CAPTURE (test.m_vertices);
+        MockOpenGLContext context;
+        ShaderProgram shader (&context);
+        ColorsMesh mesh (&context, &shader);
+        mesh.addGeometry (std::vector<float> (test.m_vertices * 6, 0.5f));
+        std::vector<unsigned int> indices = { 0, test.m_vertices - 1, test.m_vertices / 2,
+                                              test.m_vertices - 1, 0, 1 };
+        mesh.addIndices (indices);
+        mesh.prepareVao ();
+        mesh.draw (Transform (), Matrix4 ());
+        const MockOpenGLContext::DrawCall& call = context.getDrawCalls ().back ();
+        REQUIRE (test.m_type == call.m_type);
+        REQUIRE (6 == call.m_count);
+        REQUIRE (6u * test.m_bytesPerIndex == context.getTotalBufferBytes (GL_ELEMENT_ARRAY_BUFFER));
+        REQUIRE (indices == decodeIndices (context.getBuffer (call.m_elementBuffer), call.m_type));
+      }
+    }
+  }
+}
+
+SCENARIO ("Mesh vertex buffers can be quantized.", "[Mesh][A08]") {
+  GIVEN ("An indexed cube with a random color on each vertex.") {
+    MockOpenGLContext context;
+    ShaderProgram shader (&context);
+    ColorsMesh cube (&context, &shader);
+    std::vector<Triangle> faces = buildCube ();
+    std::vector<Vector3> colors = generateRandomVertexColors (faces, 5);
+    writeVertexColors (faces, colors, cube.stageGeometry (interleavedFloatCount (faces)));
+    cube.indexGeometry ();
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    indexData (dataWithVertexColors (faces, colors), 6, data, indices);
+    const std::size_t VERTICES = data.size () / 6;
+    WHEN ("I prepare it with snorm16 positions and unorm8 colors.") {
+      cube.setVertexFormat ({ PositionFormat::SNORM16, AttributeFormat::UNORM8 });
+      cube.prepareVao ();
+      THEN ("Each vertex should take 12 bytes instead of 24.") {
+        REQUIRE (VERTICES * 12 == context.getTotalBufferBytes (GL_ARRAY_BUFFER));
+      }
+      THEN ("The attribute pointers should describe the packed layout.") {
+        const std::vector<MockOpenGLContext::AttributePointer>& pointers = context.getAttributePointers ();
+        REQUIRE (2u == pointers.size ());
+        for (const MockOpenGLContext::AttributePointer& pointer : pointers) {
+          REQUIRE (12 == pointer.m_stride);
+          REQUIRE (GLboolean (GL_TRUE) == pointer.m_normalized);
+          REQUIRE (3 == pointer.m_size);
+          if (pointer.m_index == 0) {
+            REQUIRE (GLenum (GL_SHORT) == pointer.m_type);
+            REQUIRE (0u == pointer.m_offset);
+          }
+          else {
+            REQUIRE (1u == pointer.m_index);
+            REQUIRE (GLenum (GL_UNSIGNED_BYTE) == pointer.m_type);
+            REQUIRE (6u == pointer.m_offset);
+          }
+        }
+      }
+    }
+    WHEN ("I prepare it with the default format.") {
+      cube.prepareVao ();
+      THEN ("It should upload floats, as before.") {
+        REQUIRE (VERTICES * 24 == context.getTotalBufferBytes (GL_ARRAY_BUFFER));
+        for (const MockOpenGLContext::AttributePointer& pointer : context.getAttributePointers ()) {
+          REQUIRE (GLenum (GL_FLOAT) == pointer.m_type);
+          REQUIRE (24 == pointer.m_stride);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO ("Meshes culled by meshlet draw only what faces the camera.", "[Mesh][A08]") {
+  GIVEN ("A colored, flat 20 x 20 grid facing +Z, split into meshlets, 5 units in front of the camera.") {
+    MockOpenGLContext context;
+    ShaderProgram shader (&context);
+    ColorsMesh grid (&context, &shader);
+    const unsigned int SIDE = 20;
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    buildFlatGrid (SIDE, 0.1f, data, indices, { 0.5f, 0.5f, 0.5f });
+    grid.addGeometry (data);
+    grid.addIndices (indices);
+    grid.buildMeshlets ();
+    grid.moveBack (-5.0f);
+    grid.prepareVao ();
+    Matrix4 projection;
+    projection.setToPerspectiveProjection (60.0, 1.0, 0.1, 100.0);
+    const MockOpenGLContext::DrawCall* call = nullptr;
+    REQUIRE (grid.getMeshlets ().m_meshlets.size () > 1);
+
+    WHEN ("I draw it.") {
+      grid.draw (Transform (), projection);
+      call = &context.getDrawCalls ().back ();
+      THEN ("Every triangle should be uploaded to a dynamic IBO and drawn.") {
+        REQUIRE (indices.size () == static_cast<std::size_t> (call->m_count));
+        const MockOpenGLContext::Buffer& buffer = context.getBuffer (call->m_elementBuffer);
+        REQUIRE (GLenum (GL_DYNAMIC_DRAW) == buffer.m_usage);
+        REQUIRE (grid.getMeshlets ().m_indices == decodeIndices (buffer, call->m_type));
+      }
+    }
+
+    WHEN ("I turn it to face away and draw it.") {
+      grid.yaw (180.0f);
+      grid.draw (Transform (), projection);
+      call = &context.getDrawCalls ().back ();
+      THEN ("Nothing should be drawn.") {
+        REQUIRE (0 == call->m_count);
+        REQUIRE (context.getBuffer (call->m_elementBuffer).m_bytes.empty ());
+      }
+    }
+
+    WHEN ("I move it out of view and draw it.") {
+      grid.moveRight (30.0f);
+      grid.draw (Transform (), projection);
+      THEN ("Nothing should be drawn.") {
+        REQUIRE (0 == context.getDrawCalls ().back ().m_count);
+      }
+    }
+  }
+}
+
+SCENARIO ("Meshes keep their bounds up to date as they move.", "[Mesh][A08]") {
+  GIVEN ("A prepared cube from -0.5 to 0.5 on each axis.") {
+    MockOpenGLContext context;
+    ShaderProgram shader (&context);
+    ColorsMesh cube (&context, &shader);
+    std::vector<Triangle> faces = buildCube ();
+    writeFaceColors (faces, generateRandomFaceColors (faces),
+                     cube.stageGeometry (interleavedFloatCount (faces)));
+    cube.indexGeometry ();
+    cube.prepareVao ();
+    THEN ("Its local and world bounds should fit it exactly.") {
+      BoundingBox box = cube.getLocalBoundingBox ();
+      REQUIRE (Vector3 (-0.5f, -0.5f, -0.5f) == box.m_min);
+      REQUIRE (Vector3 (0.5f, 0.5f, 0.5f) == box.m_max);
+      REQUIRE (std::sqrt (0.75f) == Approx (cube.getLocalBoundingSphere ().m_radius));
+      REQUIRE (box.m_max == cube.getWorldBoundingBox ().m_max);
+      REQUIRE (std::sqrt (0.75f) == Approx (cube.getWorldBoundingSphere ().m_radius));
+    }
+    WHEN ("I move it, after asking for its world bounds.") {
+      cube.getWorldBoundingBox ();
+      cube.moveWorld (10.0f, Vector3 (1.0f, 0.0f, 0.0f));
+      THEN ("Its world bounds should follow, but its local bounds should not.") {
+        REQUIRE (Vector3 (9.5f, -0.5f, -0.5f) == cube.getWorldBoundingBox ().m_min);
+        REQUIRE (Vector3 (10.0f, 0.0f, 0.0f) == cube.getWorldBoundingSphere ().m_center);
+        REQUIRE (Vector3 (-0.5f, -0.5f, -0.5f) == cube.getLocalBoundingBox ().m_min);
+      }
+    }
+    WHEN ("I turn it 45 degrees about Y.") {
+      cube.yaw (45.0f);
+      THEN ("Its world box should widen to hold the corners, and its sphere should not grow.") {
+        BoundingBox box = cube.getWorldBoundingBox ();
+        REQUIRE (box.m_max.m_x == Approx (std::sqrt (0.5f)));
+        REQUIRE (box.m_max.m_y == Approx (0.5f));
+        REQUIRE (box.m_min.m_z == Approx (-std::sqrt (0.5f)));
+        REQUIRE (cube.getWorldBoundingSphere ().m_radius == Approx (std::sqrt (0.75f)));
+      }
+    }
+    WHEN ("I scale it by 3.") {
+      cube.scaleLocal (3.0f);
+      THEN ("Its world bounds should be 3 times as large.") {
+        REQUIRE (cube.getWorldBoundingBox ().m_max.m_z == Approx (1.5f));
+        REQUIRE (cube.getWorldBoundingSphere ().m_radius == Approx (3.0f * std::sqrt (0.75f)));
+      }
+    }
+    WHEN ("I shear it, so its corner at (0.5, 0.5, 0.5) moves to (1.5, 0.5, 0.5).") {
+      cube.shearLocalXByYz (1.0f, 1.0f);
+      THEN ("Its world box should reach that corner, and its sphere should hold every corner.") {
+        REQUIRE (cube.getWorldBoundingBox ().m_max.m_x == Approx (1.5f));
+        REQUIRE (cube.getWorldBoundingBox ().m_min.m_x == Approx (-1.5f));
+        BoundingSphere sphere = cube.getWorldBoundingSphere ();
+        Matrix4 world = cube.getWorld ().getTransform ();
+        for (float x : { -0.5f, 0.5f }) {
+          for (float y : { -0.5f, 0.5f }) {
+            for (float z : { -0.5f, 0.5f }) {
+              const float* m = world.data ();
+              Vector3 corner (m[0] * x + m[4] * y + m[8] * z + m[12],
+                              m[1] * x + m[5] * y + m[9] * z + m[13],
+                              m[2] * x + m[6] * y + m[10] * z + m[14]);
+              REQUIRE ((corner - sphere.m_center).length () <= sphere.m_radius + 1e-4f);
+            }
+          }
+        }
+        // The shear stretches (1, 1, 1) / sqrt (3) by sqrt (11 / 3), but no
+        //   direction by more than about 2.
+        REQUIRE (sphere.m_radius < 2.0f * std::sqrt (0.75f));
+        REQUIRE (sphere.m_radius >= std::sqrt (2.75f) - 1e-4f);
+      }
+    }
+  }
+}
+
+SCENARIO ("Meshes can be picked with rays through the camera.", "[Mesh][A08]") {
+  GIVEN ("A cube 5 units ahead of a camera with a 90 degree view, and a larger one 10 units ahead.") {
+    MockOpenGLContext context;
+    ShaderProgram shader (&context);
+    Scene scene;
+    for (const char* name : { "far", "near" }) {
+      ColorsMesh* cube = new ColorsMesh (&context, &shader);
+      std::vector<Triangle> faces = buildCube ();
+      writeFaceColors (faces, generateRandomFaceColors (faces),
+                         cube->stageGeometry (interleavedFloatCount (faces)));
+      cube->indexGeometry ();
+      cube->setPickable (true);
+      scene.add (name, cube);
+    }
+    scene.getMesh ("near")->moveBack (-5.0f);
+    scene.getMesh ("far")->moveBack (-10.0f);
+    scene.getMesh ("far")->scaleLocal (2.0f);
+    scene.getMesh ("near")->prepareVao ();
+    scene.getMesh ("far")->prepareVao ();
+    Camera camera (Vector3 (0.0f, 0.0f, 0.0f), Vector3 (0.0f, 0.0f, 1.0f), 0.1f, 100.0f, 1.0f, 90.0f);
+    const double SIZE = 600.0;
+
+    WHEN ("I pick through the middle of the window.") {
+      Ray ray = camera.getPickRay (SIZE / 2, SIZE / 2, SIZE, SIZE);
+      RayHit hit;
+      THEN ("The ray should go straight ahead and hit the near cube's front face.") {
+        REQUIRE (ray.m_direction.m_z == Approx (-1.0f));
+        REQUIRE (scene.getMesh ("near")->raycast (ray, 100.0f, hit));
+        REQUIRE (hit.m_distance == Approx (4.5f));
+        REQUIRE (scene.pickMesh (ray));
+        REQUIRE (scene.getMesh ("near") == scene.getActiveMesh ());
+      }
+      THEN ("The far cube should be hit through its scale.") {
+        REQUIRE (scene.getMesh ("far")->raycast (ray, 100.0f, hit));
+        REQUIRE (hit.m_distance == Approx (9.0f));
+        REQUIRE_FALSE (scene.getMesh ("far")->raycast (ray, 8.0f, hit));
+      }
+    }
+
+    WHEN ("I move the near cube right and pick where it went.") {
+      scene.getMesh ("near")->moveRight (3.0f);
+      scene.setActiveMesh ("far");
+      // x = 3 at a depth of 5 is 3 / 5 of the way to the window's right edge.
+      Ray ray = camera.getPickRay (SIZE * (1.0 + 0.6) / 2, SIZE / 2, SIZE, SIZE);
+      THEN ("The near cube should be picked where the ray enters it.") {
+        REQUIRE (scene.pickMesh (ray));
+        REQUIRE (scene.getMesh ("near") == scene.getActiveMesh ());
+        RayHit hit;
+        REQUIRE (scene.getMesh ("near")->raycast (ray, 100.0f, hit));
+        REQUIRE (hit.m_distance == Approx (std::sqrt (0.6f * 4.5f * 0.6f * 4.5f + 4.5f * 4.5f)));
+      }
+    }
+
+    WHEN ("I pick near the corner of the window, where there is nothing.") {
+      scene.setActiveMesh ("far");
+      THEN ("Nothing should be picked, and the active mesh should stay.") {
+        REQUIRE_FALSE (scene.pickMesh (camera.getPickRay (10.0, 10.0, SIZE, SIZE)));
+        REQUIRE (scene.getMesh ("far") == scene.getActiveMesh ());
+      }
+    }
+  }
+
+  GIVEN ("A cube 5 units ahead that was not marked pickable.") {
+    MockOpenGLContext context;
+    ShaderProgram shader (&context);
+    ColorsMesh cube (&context, &shader);
+    std::vector<Triangle> faces = buildCube ();
+    writeFaceColors (faces, generateRandomFaceColors (faces),
+                     cube.stageGeometry (interleavedFloatCount (faces)));
+    cube.indexGeometry ();
+    cube.moveBack (-5.0f);
+    cube.prepareVao ();
+    THEN ("A ray straight through it should not hit it.") {
+      RayHit hit;
+      REQUIRE_FALSE (cube.isPickable ());
+      REQUIRE_FALSE (cube.raycast (Ray { Vector3 (0.0f, 0.0f, 0.0f), Vector3 (0.0f, 0.0f, -1.0f) }, 100.0f, hit));
+    }
+  }
+}
+
+SCENARIO ("Meshes weld their vertices by what their attribute is.", "[Mesh][A08]") {
+  GIVEN ("Two triangles whose shared corners differ slightly in the attribute.") {
+    MockOpenGLContext context;
+    ShaderProgram shader (&context);
+    const std::vector<float> DATA = { 0, 0, 0,  0, 0, 1,       1, 0, 0,  0, 0, 1,   0, 1, 0,  0, 0, 1,
+                                      0, 0, 0,  0, 0.01f, 1,   0, 1, 0,  0, 0, 1,   -1, 0, 0,  0, 0, 1 };
+    const std::vector<unsigned int> INDICES = { 0, 1, 2, 3, 4, 5 };
+    WHEN ("They are colors, differing by more than half an 8-bit step.") {
+      ColorsMesh mesh (&context, &shader);
+      mesh.addGeometry (DATA);
+      mesh.addIndices (INDICES);
+      THEN ("Only the exact match should be welded.") {
+        REQUIRE (1u == mesh.weldGeometry ().m_verticesRemoved);
+      }
+    }
+  }
+}
+
+SCENARIO ("Meshes can be drawn as triangle strips.", "[Mesh][A08]") {
+  GIVEN ("A colored 10 x 10 grid in the XY plane, as a triangle list.") {
+    MockOpenGLContext context;
+    ShaderProgram shader (&context);
+    ColorsMesh grid (&context, &shader);
+    grid.setPickable (true);
+    const unsigned int SIDE = 10;
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    buildFlatGrid (SIDE, 1.0f, data, indices, { 0.5f, 0.5f, 0.5f });
+    grid.addGeometry (data);
+    grid.addIndices (indices);
+    WHEN ("I stripify, prepare, and draw it.") {
+      std::size_t saved = grid.stripify ();
+      grid.prepareVao ();
+      grid.draw (Transform (), Matrix4 ());
+      THEN ("It should be drawn as strips restarted at the largest byte index.") {
+        REQUIRE (1u == context.getDrawCalls ().size ());
+        const MockOpenGLContext::DrawCall& call = context.getDrawCalls ()[0];
+        REQUIRE (GLenum (GL_TRIANGLE_STRIP) == call.m_mode);
+        REQUIRE (GLenum (GL_UNSIGNED_BYTE) == call.m_type);
+        REQUIRE (call.m_primitiveRestart);
+        REQUIRE (0xFFu == call.m_restartIndex);
+        REQUIRE_FALSE (context.isEnabled (GL_PRIMITIVE_RESTART));
+        REQUIRE (indices.size () - saved == static_cast<std::size_t> (call.m_count));
+        std::vector<unsigned int> uploaded = decodeIndices (context.getBuffer (call.m_elementBuffer), call.m_type);
+        REQUIRE (SIDE - 1 == static_cast<unsigned int> (std::count (uploaded.begin (), uploaded.end (), 0xFFu)));
+        WARN ("A 10 x 10 grid needs " << indices.size () << " indices as a list and "
+              << call.m_count << " as strips.");
+      }
+      THEN ("It should still be picked by rays.") {
+        RayHit hit;
+        REQUIRE (grid.raycast (Ray { Vector3 (0.25f, 0.25f, 5.0f), Vector3 (0.0f, 0.0f, -1.0f) }, 100.0f, hit));
+        REQUIRE (hit.m_distance == Approx (5.0f));
+      }
+    }
+  }
+}
+
+/// \brief Makes an indexed cube with a color at each corner, drawing its
+///   buffers from a registry.
+/// \param[in] context The context the cube draws through.
+/// \param[in] shader The cube's shader program.
+/// \param[in] registry The registry the cube shares buffers through.
+/// \param[in] seed Chooses the corner colors.
+std::unique_ptr<ColorsMesh>
+makeSharedCube (MockOpenGLContext& context, ShaderProgram& shader, GeometryRegistry& registry,
+                unsigned int seed)
+{
+  std::unique_ptr<ColorsMesh> cube (new ColorsMesh (&context, &shader));
+  std::vector<Triangle> faces = buildCube ();
+  writeVertexColors (faces, generateRandomVertexColors (faces, seed),
+                     cube->stageGeometry (interleavedFloatCount (faces)));
+  cube->indexGeometry ();
+  cube->setGeometryRegistry (&registry);
+  return cube;
+}
+
+SCENARIO ("Meshes with identical geometry share their buffers.", "[Mesh][A08]") {
+  GIVEN ("A registry, and three cubes with the same colors.") {
+    MockOpenGLContext context;
+    ShaderProgram shader (&context);
+    GeometryRegistry registry (&context);
+    std::unique_ptr<ColorsMesh> cubes[3];
+    for (std::unique_ptr<ColorsMesh>& cube : cubes) {
+      cube = makeSharedCube (context, shader, registry, 1);
+    }
+    WHEN ("I prepare and draw each of them.") {
+      for (std::unique_ptr<ColorsMesh>& cube : cubes) {
+        cube->prepareVao ();
+        cube->draw (Transform (), Matrix4 ());
+      }
+      THEN ("Only one VBO and one IBO should be filled, and every draw should use them.") {
+        const std::size_t VERTEX_BYTES = 8u * 6 * sizeof (float);
+        REQUIRE (1u == registry.getBufferPairCount ());
+        REQUIRE (VERTEX_BYTES == context.getTotalBufferBytes (GL_ARRAY_BUFFER));
+        REQUIRE (36u == context.getTotalBufferBytes (GL_ELEMENT_ARRAY_BUFFER));
+        REQUIRE (VERTEX_BYTES + 36u == registry.getUploadedBytes ());
+        REQUIRE (2 * (VERTEX_BYTES + 36u) == registry.getSavedBytes ());
+        REQUIRE (3u == context.getDrawCalls ().size ());
+        for (const MockOpenGLContext::DrawCall& call : context.getDrawCalls ()) {
+          REQUIRE (context.getDrawCalls ()[0].m_elementBuffer == call.m_elementBuffer);
+          REQUIRE (36 == call.m_count);
+        }
+        REQUIRE (context.getDrawCalls ()[0].m_vertexArray != context.getDrawCalls ()[1].m_vertexArray);
+        // A vertex array per cube, and the one shared buffer pair.
+        REQUIRE (3u + 2 == context.getGeneratedObjectCount ());
+        for (std::unique_ptr<ColorsMesh>& cube : cubes) {
+          REQUIRE (cube->sharesGeometry ());
+        }
+      }
+      THEN ("The buffers should last until the last cube using them is gone.") {
+        GLuint elementBuffer = context.getDrawCalls ()[0].m_elementBuffer;
+        cubes[0].reset ();
+        cubes[1].reset ();
+        REQUIRE (context.hasBuffer (elementBuffer));
+        REQUIRE (1u == registry.getBufferPairCount ());
+        cubes[2].reset ();
+        REQUIRE_FALSE (context.hasBuffer (elementBuffer));
+        REQUIRE (0u == registry.getBufferPairCount ());
+        REQUIRE (0u == registry.getUploadedBytes ());
+        REQUIRE (0u == context.getTotalBufferBytes (GL_ARRAY_BUFFER));
+      }
+    }
+    WHEN ("One of them is stored in a different vertex format.") {
+      cubes[1]->setVertexFormat ({ PositionFormat::SNORM16, AttributeFormat::UNORM8 });
+      for (std::unique_ptr<ColorsMesh>& cube : cubes) {
+        cube->prepareVao ();
+      }
+      THEN ("It should get buffers of its own.") {
+        REQUIRE (2u == registry.getBufferPairCount ());
+        REQUIRE (72u == context.getTotalBufferBytes (GL_ELEMENT_ARRAY_BUFFER));
+      }
+    }
+    WHEN ("One of them has its triangles grouped into meshlets.") {
+      cubes[2]->buildMeshlets ();
+      for (std::unique_ptr<ColorsMesh>& cube : cubes) {
+        cube->prepareVao ();
+      }
+      THEN ("It should keep its own buffers, since its IBO changes every draw.") {
+        REQUIRE (1u == registry.getBufferPairCount ());
+        REQUIRE_FALSE (cubes[2]->sharesGeometry ());
+        REQUIRE (cubes[1]->sharesGeometry ());
+      }
+    }
+  }
+
+  GIVEN ("A registry, and two cubes with different colors.") {
+    MockOpenGLContext context;
+    ShaderProgram shader (&context);
+    GeometryRegistry registry (&context);
+    std::unique_ptr<ColorsMesh> first = makeSharedCube (context, shader, registry, 1);
+    std::unique_ptr<ColorsMesh> second = makeSharedCube (context, shader, registry, 2);
+    WHEN ("I prepare both.") {
+      first->prepareVao ();
+      second->prepareVao ();
+      THEN ("Each should have buffers of its own.") {
+        REQUIRE (2u == registry.getBufferPairCount ());
+        REQUIRE (0u == registry.getSavedBytes ());
+        REQUIRE (2u * 8 * 6 * sizeof (float) == context.getTotalBufferBytes (GL_ARRAY_BUFFER));
+      }
+    }
+  }
+
+  GIVEN ("A registry, and the bytes of a triangle.") {
+    MockOpenGLContext context;
+    GeometryRegistry registry (&context);
+    const float VERTICES[18] = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+                                 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+    const unsigned char INDICES[3] = { 0, 1, 2 };
+    const GeometryLayout COLORED = { { PositionFormat::FLOAT32, AttributeFormat::FLOAT32 }, 6,
+                                     GL_UNSIGNED_BYTE };
+    GLuint vao;
+    context.genVertexArrays (1, &vao);
+    context.bindVertexArray (vao);
+    SharedGeometry first = registry.acquire (VERTICES, sizeof (VERTICES), INDICES, 3, COLORED);
+    WHEN ("The same bytes are acquired again, and then read as positions alone.") {
+      SharedGeometry again = registry.acquire (VERTICES, sizeof (VERTICES), INDICES, 3, COLORED);
+      GeometryLayout positions = COLORED;
+      positions.m_floatsPerVertex = 3;
+      SharedGeometry reread = registry.acquire (VERTICES, sizeof (VERTICES), INDICES, 3, positions);
+      THEN ("Only the same layout should share the buffers.") {
+        REQUIRE (first.m_vbo == again.m_vbo);
+        REQUIRE (first.m_vbo != reread.m_vbo);
+        REQUIRE (2u == registry.getBufferPairCount ());
+      }
+      THEN ("Releasing them should free each pair once it is unused.") {
+        registry.release (reread);
+        registry.release (again);
+        REQUIRE (1u == registry.getBufferPairCount ());
+        registry.release (first);
+        REQUIRE (0u == registry.getBufferPairCount ());
+        REQUIRE (0u == registry.getUploadedBytes ());
+      }
+    }
+  }
+}
+
+/// \brief A Mesh with a normal after each position, like NormalsMesh, which
+///   cannot be linked into the tests.
+class TestNormalsMesh : public Mesh
+{
+public:
+  TestNormalsMesh (OpenGLContext* context, ShaderProgram* shader)
+    : Mesh (context, shader, NormalsLayout ())
+  {
+  }
+};
+
+/// \brief Makes an unprepared, static triangle in the plane x + y = 1, with
+///   its normal at each corner.
+/// \param[in] context The context the triangle draws through.
+/// \param[in] shader The triangle's shader program.
+Mesh*
+makeStaticTriangle (MockOpenGLContext& context, ShaderProgram& shader)
+{
+  const float N = std::sqrt (0.5f);
+  Mesh* triangle = new TestNormalsMesh (&context, &shader);
+  triangle->addGeometry ({ 1, 0, 0,  N, N, 0,   0, 1, 0,  N, N, 0,   0, 1, 1,  N, N, 0 });
+  triangle->addIndices ({ 0, 1, 2 });
+  triangle->setStatic (true);
+  return triangle;
+}
+
+/// \brief Reads one vertex's position or normal out of a batched VBO.
+/// \param[in] floats The VBO's contents, six floats per vertex.
+/// \param[in] vertex Which vertex.
+/// \param[in] part 0 for the position, or 3 for the normal.
+Vector3
+readVertex (const std::vector<float>& floats, unsigned int vertex, unsigned int part)
+{
+  const float* values = &floats[vertex * 6 + part];
+  return Vector3 (values[0], values[1], values[2]);
+}
+
+SCENARIO ("Static meshes drawn the same way are batched into one draw call.", "[Mesh][A08]") {
+  GIVEN ("Three static triangles with one shader, moved, stretched, and mirrored, and three others.") {
+    MockOpenGLContext context;
+    ShaderProgram shader (&context);
+    ShaderProgram otherShader (&context);
+    Scene scene;
+    scene.add ("a", makeStaticTriangle (context, shader));
+    scene.add ("b", makeStaticTriangle (context, shader));
+    scene.getMesh ("b")->moveRight (3.0f);
+    scene.getMesh ("b")->scaleLocal (2.0f, 1.0f, 1.0f);
+    scene.add ("c", makeStaticTriangle (context, shader));
+    scene.getMesh ("c")->moveUp (-2.0f);
+    scene.getMesh ("c")->scaleLocal (-1.0f, 1.0f, 1.0f);
+    scene.add ("d", makeStaticTriangle (context, otherShader));
+    scene.add ("e", makeStaticTriangle (context, shader));
+    scene.getMesh ("e")->setStatic (false);
+    scene.getMesh ("e")->prepareVao ();
+    scene.add ("f", makeStaticTriangle (context, shader));
+    scene.getMesh ("f")->buildMeshlets ();
+    scene.getMesh ("f")->prepareVao ();
+
+    WHEN ("I make e active, batch the static meshes, prepare d, and draw the scene.") {
+      scene.setActiveMesh ("e");
+      unsigned int objects = context.getGeneratedObjectCount ();
+      unsigned int saved = scene.batchStaticMeshes ();
+      unsigned int batchObjects = context.getGeneratedObjectCount () - objects;
+      scene.getMesh ("d")->prepareVao ();
+      scene.draw (Transform (), Matrix4 ());
+      THEN ("The triangles sharing a shader should be drawn together, and the rest alone.") {
+        REQUIRE (2u == saved);
+        REQUIRE_FALSE (scene.hasMesh ("b"));
+        REQUIRE_FALSE (scene.hasMesh ("c"));
+        REQUIRE (4u == context.getDrawCalls ().size ());
+        REQUIRE (9 == context.getDrawCalls ()[0].m_count);
+        REQUIRE (3 == context.getDrawCalls ()[1].m_count);
+      }
+      THEN ("Only the merged mesh should have been prepared, and e should still be active.") {
+        REQUIRE (3u == batchObjects);
+        REQUIRE (scene.getMesh ("e") == scene.getActiveMesh ());
+      }
+      THEN ("Positions should be in world coordinates, and normals should stay perpendicular.") {
+        GLuint vertexArray = context.getDrawCalls ()[0].m_vertexArray;
+        GLuint vertexBuffer = 0;
+        for (const MockOpenGLContext::AttributePointer& pointer : context.getAttributePointers ()) {
+          if (pointer.m_vertexArray == vertexArray) {
+            vertexBuffer = pointer.m_buffer;
+          }
+        }
+        const std::vector<unsigned char>& bytes = context.getBuffer (vertexBuffer).m_bytes;
+        std::vector<float> floats (bytes.size () / sizeof (float));
+        std::memcpy (floats.data (), bytes.data (), bytes.size ());
+        REQUIRE (9u * 6 == floats.size ());
+        REQUIRE (readVertex (floats, 3, 0).m_x == Approx (5.0f));
+        REQUIRE (readVertex (floats, 6, 0).m_x == Approx (-1.0f));
+        REQUIRE (readVertex (floats, 6, 0).m_y == Approx (-2.0f));
+        // Stretching x by 2 tilts the plane to x / 2 + y = 1.
+        Vector3 stretched = readVertex (floats, 3, 3);
+        REQUIRE (stretched.m_x == Approx (1.0f / std::sqrt (5.0f)));
+        REQUIRE (stretched.m_y == Approx (2.0f / std::sqrt (5.0f)));
+
+        std::vector<unsigned int> indices = decodeIndices (
+          context.getBuffer (context.getDrawCalls ()[0].m_elementBuffer), GL_UNSIGNED_BYTE);
+        for (unsigned int triangle = 0; triangle < 3; triangle++) {
+          Vector3 corners[3];
+          for (unsigned int corner = 0; corner < 3; corner++) {
+            corners[corner] = readVertex (floats, indices[triangle * 3 + corner], 0);
+          }
+          Vector3 faceNormal = (corners[1] - corners[0]).cross (corners[2] - corners[0]);
+          faceNormal.normalize ();
+          // The mirrored triangle is rewound, so it still faces its normal.
+          REQUIRE (faceNormal.dot (readVertex (floats, indices[triangle * 3], 3)) == Approx (1.0f));
+        }
+      }
+    }
+
+    WHEN ("I make b active and batch the static meshes.") {
+      scene.setActiveMesh ("b");
+      scene.batchStaticMeshes ();
+      THEN ("The first mesh should be active, since b was merged away.") {
+        REQUIRE (scene.getMesh ("a") == scene.getActiveMesh ());
+      }
+    }
+  }
+}
+
+SCENARIO ("Meshes can keep their geometry in a shared buffer arena.", "[Mesh][A08]") {
+  GIVEN ("An arena with room for five colored cubes per block, and ten cubes.") {
+    MockOpenGLContext context;
+    ShaderProgram shader (&context);
+    const std::size_t CUBE_VERTEX_BYTES = 8u * 6 * sizeof (float);
+    BufferArena arena (&context, 5 * CUBE_VERTEX_BYTES, 256);
+    std::vector<std::unique_ptr<ColorsMesh>> cubes;
+    for (unsigned int seed = 1; seed <= 10; seed++) {
+      std::unique_ptr<ColorsMesh> cube (new ColorsMesh (&context, &shader));
+      std::vector<Triangle> faces = buildCube ();
+      writeVertexColors (faces, generateRandomVertexColors (faces, seed),
+                         cube->stageGeometry (interleavedFloatCount (faces)));
+      cube->indexGeometry ();
+      cube->setBufferArena (&arena);
+      cubes.push_back (std::move (cube));
+    }
+    WHEN ("I prepare and draw each of them.") {
+      for (std::unique_ptr<ColorsMesh>& cube : cubes) {
+        cube->prepareVao ();
+        cube->draw (Transform (), Matrix4 ());
+      }
+      THEN ("Two blocks should hold them, and each draw should find its cube by offsets.") {
+        REQUIRE (2u == arena.getBlockCount ());
+        REQUIRE (10 * (CUBE_VERTEX_BYTES + 36) == arena.getUsedBytes ());
+        REQUIRE (10 * CUBE_VERTEX_BYTES == context.getTotalBufferBytes (GL_ARRAY_BUFFER));
+        REQUIRE (10u == context.getDrawCalls ().size ());
+        for (unsigned int cube = 0; cube < 10; cube++) {
+          const MockOpenGLContext::DrawCall& call = context.getDrawCalls ()[cube];
+          const MockOpenGLContext::DrawCall& first = context.getDrawCalls ()[cube / 5 * 5];
+          REQUIRE (cubes[cube]->usesBufferArena ());
+          REQUIRE (first.m_vertexArray == call.m_vertexArray);
+          REQUIRE (first.m_elementBuffer == call.m_elementBuffer);
+          REQUIRE (GLint (cube % 5 * 8) == call.m_baseVertex);
+          REQUIRE (cube % 5 * 36u == call.m_offset);
+          std::vector<unsigned int> indices = decodeIndices (context.getBuffer (call.m_elementBuffer), call.m_type);
+          REQUIRE (7u == *std::max_element (indices.begin () + call.m_offset,
+                                            indices.begin () + call.m_offset + call.m_count));
+        }
+        REQUIRE (context.getDrawCalls ()[0].m_vertexArray != context.getDrawCalls ()[5].m_vertexArray);
+        // The cubes make no objects of their own; each block makes three.
+        REQUIRE (2u * 3 == context.getGeneratedObjectCount ());
+        // Only the first cube in each block sets up its vertex array.
+        REQUIRE (2u * 2 == context.getAttributePointers ().size ());
+      }
+      THEN ("Freed ranges should be reused, and a block should go once it is empty.") {
+        GLint baseVertex = context.getDrawCalls ()[2].m_baseVertex;
+        cubes[2].reset ();
+        std::unique_ptr<ColorsMesh> replacement (new ColorsMesh (&context, &shader));
+        std::vector<Triangle> faces = buildCube ();
+        writeVertexColors (faces, generateRandomVertexColors (faces, 11),
+                           replacement->stageGeometry (interleavedFloatCount (faces)));
+        replacement->indexGeometry ();
+        replacement->setBufferArena (&arena);
+        replacement->prepareVao ();
+        replacement->draw (Transform (), Matrix4 ());
+        REQUIRE (baseVertex == context.getDrawCalls ().back ().m_baseVertex);
+        REQUIRE (2u == arena.getBlockCount ());
+        for (unsigned int cube = 5; cube < 10; cube++) {
+          cubes[cube].reset ();
+        }
+        REQUIRE (1u == arena.getBlockCount ());
+        REQUIRE (5 * CUBE_VERTEX_BYTES == context.getTotalBufferBytes (GL_ARRAY_BUFFER));
+      }
+    }
+    WHEN ("Half of them are stored in a different vertex format.") {
+      for (unsigned int cube = 0; cube < 10; cube += 2) {
+        cubes[cube]->setVertexFormat ({ PositionFormat::SNORM16, AttributeFormat::UNORM8 });
+      }
+      for (std::unique_ptr<ColorsMesh>& cube : cubes) {
+        cube->prepareVao ();
+      }
+      THEN ("Each format should get a block of its own.") {
+        REQUIRE (2u == arena.getBlockCount ());
+      }
+    }
+  }
+}
+
+/// \brief Makes an unprepared, indexed grid of gray quads in the XY plane.
+/// \param[in] context The context the grid draws through.
+/// \param[in] shader The grid's shader program.
+/// \param[in] side The number of quads along each edge.
+std::unique_ptr<ColorsMesh>
+makeColoredGrid (MockOpenGLContext& context, ShaderProgram& shader, unsigned int side)
+{
+  std::unique_ptr<ColorsMesh> grid (new ColorsMesh (&context, &shader));
+  std::vector<float> data;
+  std::vector<unsigned int> indices;
+  buildFlatGrid (side, 1.0f, data, indices, { 0.5f, 0.5f, 0.5f });
+  grid->addGeometry (data);
+  grid->addIndices (indices);
+  return grid;
+}
+
+SCENARIO ("Meshes can free or compress their CPU geometry after upload.", "[Mesh][A08]") {
+  GIVEN ("A 100 x 100 colored grid.") {
+    MockOpenGLContext context;
+    ShaderProgram shader (&context);
+    std::unique_ptr<ColorsMesh> grid = makeColoredGrid (context, shader, 100);
+    const std::size_t GEOMETRY_BYTES = 101u * 101 * 6 * sizeof (float) + 100u * 100 * 6 * sizeof (unsigned int);
+    WHEN ("It keeps its geometry.") {
+      grid->prepareVao ();
+      THEN ("All of it should still be held.") {
+        REQUIRE (GeometryRetention::KEEP == grid->getGeometryRetention ());
+        REQUIRE (grid->getRetainedBytes () >= GEOMETRY_BYTES);
+      }
+    }
+    WHEN ("It discards its geometry.") {
+      grid->setGeometryRetention (GeometryRetention::DISCARD);
+      grid->prepareVao ();
+      grid->draw (Transform (), Matrix4 ());
+      THEN ("None of it should be held, but it should still draw.") {
+        REQUIRE (0u == grid->getRetainedBytes ());
+        REQUIRE (60000 == context.getDrawCalls ()[0].m_count);
+      }
+    }
+    WHEN ("It discards its geometry, but is pickable.") {
+      grid->setGeometryRetention (GeometryRetention::DISCARD);
+      grid->setPickable (true);
+      grid->prepareVao ();
+      THEN ("Only its bounding volume hierarchy should be held, and it should still be picked.") {
+        REQUIRE (grid->getRetainedBytes () >= 20000u * 3 * sizeof (Vector3));
+        RayHit hit;
+        REQUIRE (grid->raycast (Ray { Vector3 (0.25f, 0.25f, 5.0f), Vector3 (0.0f, 0.0f, -1.0f) }, 100.0f, hit));
+        REQUIRE (hit.m_distance == Approx (5.0f));
+      }
+    }
+    WHEN ("It is split into meshlets, discards its geometry, and is drawn 100 units ahead.") {
+      grid->buildMeshlets ();
+      grid->setGeometryRetention (GeometryRetention::DISCARD);
+      grid->moveBack (-100.0f);
+      grid->prepareVao ();
+      Matrix4 projection;
+      projection.setToPerspectiveProjection (60.0, 1.0, 0.1, 1000.0);
+      grid->draw (Transform (), projection);
+      THEN ("Only the meshlets should be held, and they should be drawn straight from a static IBO.") {
+        REQUIRE (grid->getMeshlets ().m_indices.empty ());
+        REQUIRE (grid->getMeshlets ().m_meshlets.capacity () * sizeof (Meshlet) == grid->getRetainedBytes ());
+        GLsizei drawn = 0;
+        for (const MockOpenGLContext::DrawCall& call : context.getDrawCalls ()) {
+          REQUIRE (GLenum (GL_STATIC_DRAW) == context.getBuffer (call.m_elementBuffer).m_usage);
+          drawn += call.m_count;
+        }
+        REQUIRE (60000 == drawn);
+        REQUIRE (0u == context.getDrawCalls ()[0].m_offset);
+      }
+      AND_WHEN ("It is turned to face away and drawn again.") {
+        std::size_t calls = context.getDrawCalls ().size ();
+        grid->yaw (180.0f);
+        grid->draw (Transform (), projection);
+        THEN ("Nothing more should be drawn.") {
+          REQUIRE (calls == context.getDrawCalls ().size ());
+        }
+      }
+    }
+    WHEN ("It compresses its geometry, and is then batched into another mesh.") {
+      grid->setGeometryRetention (GeometryRetention::COMPRESS);
+      grid->prepareVao ();
+      std::unique_ptr<ColorsMesh> batch = makeColoredGrid (context, shader, 1);
+      batch->appendStaticGeometry (*grid);
+      batch->prepareVao ();
+      THEN ("It should hold less than half as much, and still hand over every triangle.") {
+        REQUIRE (grid->getRetainedBytes () > 0u);
+        REQUIRE (grid->getRetainedBytes () * 2 < GEOMETRY_BYTES);
+        REQUIRE (GLsizeiptr (4 * 6 * sizeof (float) + 101u * 101 * 6 * sizeof (float))
+                 == GLsizeiptr (context.getTotalBufferBytes (GL_ARRAY_BUFFER) - 101u * 101 * 6 * sizeof (float)));
+        WARN ("A 100 x 100 grid holds " << GEOMETRY_BYTES << " bytes kept and "
+              << grid->getRetainedBytes () << " compressed.");
+      }
+    }
+  }
+}
+
+/// \brief Moves one row of a grid from makeColoredGrid to some height.
+/// \param[in] side The number of quads along each edge of the grid.
+/// \param[in] row The row of vertices.
+/// \param[in] z The new Z coordinate of each vertex in the row.
+/// \return The row's vertices, for Mesh::updateVertices.
+std::vector<float>
+makeGridRow (unsigned int side, unsigned int row, float z)
+{
+  std::vector<float> data;
+  std::vector<unsigned int> indices;
+  buildFlatGrid (side, 1.0f, data, indices, { 0.5f, 0.5f, 0.5f });
+  std::vector<float> vertices (data.begin () + row * (side + 1) * 6, data.begin () + (row + 1) * (side + 1) * 6);
+  for (std::size_t vertex = 0; vertex < vertices.size (); vertex += 6) {
+    vertices[vertex + 2] = z;
+  }
+  return vertices;
+}
+
+SCENARIO ("Meshes can stream vertex updates without stalling.", "[Mesh][A08]") {
+  GIVEN ("A 4 x 4 colored grid, which has 25 vertices and 96 byte indices.") {
+    MockOpenGLContext context;
+    ShaderProgram shader (&context);
+    std::unique_ptr<ColorsMesh> grid = makeColoredGrid (context, shader, 4);
+    const std::size_t VERTEX_BYTES = 25 * 6 * sizeof (float);
+    WHEN ("It streams through a ring, and a row is moved before each of six draws.") {
+      grid->setStreaming (StreamingMode::RING);
+      grid->prepareVao ();
+      grid->draw (Transform (), Matrix4 ());
+      const unsigned int UPDATES = 6;
+      for (unsigned int update = 1; update <= UPDATES; update++) {
+        grid->updateVertices (5, makeGridRow (4, 1, float (update)));
+        grid->draw (Transform (), Matrix4 ());
+      }
+      GLuint vbo = context.getAttributePointers ()[0].m_buffer;
+      THEN ("Each draw should read the next of three regions.") {
+        REQUIRE (3 * VERTEX_BYTES == context.getBuffer (vbo).m_bytes.size ());
+        REQUIRE (UPDATES + 1 == context.getDrawCalls ().size ());
+        for (unsigned int draw = 0; draw <= UPDATES; draw++) {
+          const MockOpenGLContext::DrawCall& call = context.getDrawCalls ()[draw];
+          REQUIRE (GLint (draw % 3 * 25) == call.m_baseVertex);
+          REQUIRE (draw % 3 * 96u == call.m_offset);
+          REQUIRE (GL_UNSIGNED_BYTE == call.m_type);
+        }
+      }
+      THEN ("Only the moved row should be written, into the region about to be drawn.") {
+        REQUIRE (UPDATES == context.getMappedRanges ().size ());
+        for (unsigned int update = 1; update <= UPDATES; update++) {
+          const MockOpenGLContext::MappedRange& range = context.getMappedRanges ()[update - 1];
+          REQUIRE (vbo == range.m_buffer);
+          REQUIRE (update % 3 * VERTEX_BYTES + 5 * 6 * sizeof (float) == range.m_offset);
+          REQUIRE (5 * 6 * sizeof (float) == range.m_length);
+          REQUIRE ((range.m_access & GL_MAP_UNSYNCHRONIZED_BIT) != 0u);
+        }
+        std::vector<float> floats (context.getBuffer (vbo).m_bytes.size () / sizeof (float));
+        std::memcpy (floats.data (), context.getBuffer (vbo).m_bytes.data (), floats.size () * sizeof (float));
+        for (unsigned int region = 0; region < 3; region++) {
+          // The last three updates went to regions 1, 2 and 0.
+          float expected = float (UPDATES - 2 + (region + 2) % 3);
+          REQUIRE (expected == floats[region * 25 * 6 + 7 * 6 + 2]);
+          REQUIRE (0.0f == floats[region * 25 * 6 + 12 * 6 + 2]);
+        }
+      }
+      THEN ("A fence should guard each region, and only reused regions should be waited on.") {
+        REQUIRE (3u == context.getLiveSyncCount ());
+        REQUIRE (UPDATES - 2 == context.getSyncWaitCount ());
+        REQUIRE (0u == context.getLongestSyncTimeout ());
+      }
+    }
+    WHEN ("It streams through a ring, and a row is moved while the GPU still reads the next region.") {
+      grid->setStreaming (StreamingMode::RING);
+      grid->prepareVao ();
+      for (unsigned int update = 0; update < 3; update++) {
+        grid->updateVertices (5, makeGridRow (4, 1, 1.0f));
+        grid->draw (Transform (), Matrix4 ());
+      }
+      context.setSyncsSignaled (false);
+      grid->updateVertices (5, makeGridRow (4, 1, 9.0f));
+      THEN ("The bounds should grow at once, without waiting for the upload.") {
+        REQUIRE (9.0f == grid->getLocalBoundingBox ().m_max.m_z);
+        BoundingSphere sphere = grid->getLocalBoundingSphere ();
+        for (float x = -2.0f; x <= 2.0f; x++) {
+          REQUIRE ((Vector3 (x, -1.0f, 9.0f) - sphere.m_center).length () <= sphere.m_radius * 1.0001f);
+        }
+      }
+      grid->draw (Transform (), Matrix4 ());
+      THEN ("The last region should be drawn again, with the update left pending.") {
+        REQUIRE (0 == context.getDrawCalls ()[3].m_baseVertex);
+        REQUIRE (0 == context.getDrawCalls ()[2].m_baseVertex);
+        REQUIRE (3u == context.getMappedRanges ().size ());
+      }
+      AND_WHEN ("The GPU finishes with the region, and it is drawn again.") {
+        context.setSyncsSignaled (true);
+        grid->draw (Transform (), Matrix4 ());
+        THEN ("The update should go to the next region.") {
+          REQUIRE (25 == context.getDrawCalls ()[4].m_baseVertex);
+          REQUIRE (4u == context.getMappedRanges ().size ());
+          REQUIRE (0u == context.getLongestSyncTimeout ());
+        }
+      }
+    }
+    WHEN ("It streams by orphaning, and a row is moved before a draw.") {
+      grid->setStreaming (StreamingMode::ORPHAN);
+      grid->prepareVao ();
+      grid->updateVertices (5, makeGridRow (4, 1, 3.0f));
+      grid->draw (Transform (), Matrix4 ());
+      GLuint vbo = context.getAttributePointers ()[0].m_buffer;
+      THEN ("The buffer should be respecified as a stream, with nothing mapped or fenced.") {
+        const MockOpenGLContext::Buffer& buffer = context.getBuffer (vbo);
+        REQUIRE (GL_STREAM_DRAW == buffer.m_usage);
+        REQUIRE (VERTEX_BYTES == buffer.m_bytes.size ());
+        float z;
+        std::memcpy (&z, buffer.m_bytes.data () + (7 * 6 + 2) * sizeof (float), sizeof (float));
+        REQUIRE (3.0f == z);
+        REQUIRE (0 == context.getDrawCalls ()[0].m_baseVertex);
+        REQUIRE (context.getMappedRanges ().empty ());
+        REQUIRE (0u == context.getLiveSyncCount ());
+      }
+    }
+    WHEN ("It streams, and is then asked to share, pack, split, or discard its geometry, or to be pickable.") {
+      GeometryRegistry registry (&context);
+      BufferArena arena (&context, 1 << 16, 1 << 16);
+      REQUIRE (grid->setStreaming (StreamingMode::RING));
+      THEN ("Each request should be refused, and it should still get buffers of its own.") {
+        REQUIRE_FALSE (grid->setGeometryRegistry (&registry));
+        REQUIRE_FALSE (grid->setBufferArena (&arena));
+        REQUIRE_FALSE (grid->setVertexFormat ({ PositionFormat::SNORM16, AttributeFormat::UNORM8 }));
+        REQUIRE_FALSE (grid->buildMeshlets ());
+        REQUIRE_FALSE (grid->setGeometryRetention (GeometryRetention::DISCARD));
+        REQUIRE_FALSE (grid->setPickable (true));
+        grid->prepareVao ();
+        REQUIRE_FALSE (grid->sharesGeometry ());
+        REQUIRE_FALSE (grid->usesBufferArena ());
+        REQUIRE (grid->getMeshlets ().m_meshlets.empty ());
+        REQUIRE (GeometryRetention::KEEP == grid->getGeometryRetention ());
+        REQUIRE_FALSE (grid->isPickable ());
+        REQUIRE (3 * VERTEX_BYTES == context.getBuffer (context.getAttributePointers ()[0].m_buffer).m_bytes.size ());
+      }
+    }
+    WHEN ("It shares its geometry through a registry, and is then asked to stream.") {
+      GeometryRegistry registry (&context);
+      REQUIRE (grid->setGeometryRegistry (&registry));
+      THEN ("Streaming should be refused.") {
+        REQUIRE_FALSE (grid->setStreaming (StreamingMode::ORPHAN));
+        REQUIRE (StreamingMode::NONE == grid->getStreaming ());
+      }
+    }
+    WHEN ("It is pickable, and is then asked to stream.") {
+      REQUIRE (grid->setPickable (true));
+      THEN ("Streaming should be refused, since updates would not reach its hierarchy.") {
+        REQUIRE_FALSE (grid->setStreaming (StreamingMode::RING));
+        REQUIRE (StreamingMode::NONE == grid->getStreaming ());
+        REQUIRE (grid->setPickable (false));
+        REQUIRE (grid->setStreaming (StreamingMode::RING));
+      }
+    }
+  }
+}
+
+SCENARIO ("Meshes can take over their geometry without copying it.", "[Mesh][A08]") {
+  GIVEN ("The vertices and indices of a colored quad.") {
+    MockOpenGLContext context;
+    ShaderProgram shader (&context);
+    const std::vector<float> QUAD { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+                                    1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f,
+                                    1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+                                    0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f };
+    const std::vector<unsigned int> QUAD_INDICES { 0, 1, 2, 0, 2, 3 };
+    ColorsMesh mesh (&context, &shader);
+    WHEN ("They are moved into an empty mesh.") {
+      std::vector<float> data (QUAD);
+      std::vector<unsigned int> indices (QUAD_INDICES);
+      const float* dataBuffer = data.data ();
+      mesh.addGeometry (std::move (data));
+      mesh.addIndices (std::move (indices));
+      THEN ("The mesh should hold the very same buffers, and upload them.") {
+        REQUIRE (data.empty ());
+        REQUIRE (indices.empty ());
+        REQUIRE (dataBuffer + QUAD.size () == mesh.stageGeometry (0));
+        mesh.prepareVao ();
+        const MockOpenGLContext::Buffer& vbo = context.getBuffer (context.getAttributePointers ()[0].m_buffer);
+        REQUIRE (0 == std::memcmp (QUAD.data (), vbo.m_bytes.data (), QUAD.size () * sizeof (float)));
+      }
+    }
+    WHEN ("They are moved into a mesh that already has a triangle.") {
+      mesh.addGeometry (QUAD.data (), 18);
+      mesh.addIndices (QUAD_INDICES.data (), 3);
+      mesh.addGeometry (std::vector<float> (QUAD));
+      mesh.addIndices (std::vector<unsigned int> (QUAD_INDICES));
+      mesh.prepareVao ();
+      mesh.draw (Transform (), Matrix4 ());
+      THEN ("They should be appended after it.") {
+        REQUIRE (9 == context.getDrawCalls ()[0].m_count);
+        const MockOpenGLContext::Buffer& vbo = context.getBuffer (context.getAttributePointers ()[0].m_buffer);
+        REQUIRE ((18 + QUAD.size ()) * sizeof (float) == vbo.m_bytes.size ());
+      }
+    }
+    WHEN ("Room is reserved and they are added a vertex and a triangle at a time.") {
+      mesh.reserveGeometry (QUAD.size (), QUAD_INDICES.size ());
+      const float* reserved = mesh.stageGeometry (0);
+      for (std::size_t vertex = 0; vertex < 4; vertex++) {
+        mesh.addGeometry (QUAD.data () + vertex * 6, 6);
+      }
+      mesh.addIndices (QUAD_INDICES.data (), 3);
+      mesh.addIndices (QUAD_INDICES.data () + 3, 3);
+      THEN ("The stores should never have grown past what was reserved.") {
+        REQUIRE (reserved + QUAD.size () == mesh.stageGeometry (0));
+        REQUIRE (QUAD.size () * sizeof (float) + QUAD_INDICES.size () * sizeof (unsigned int)
+                 == mesh.getRetainedBytes ());
+      }
+    }
+  }
+}
+
+SCENARIO ("Meshes can hold any vertex layout.", "[Mesh][A08]") {
+  GIVEN ("A triangle with a position, a normal, and texture coordinates at each corner.") {
+    typedef VertexLayout<PositionAttribute, NormalAttribute, TexCoordAttribute> Layout;
+    MockOpenGLContext context;
+    ShaderProgram shader (&context);
+    const float N = std::sqrt (0.5f);
+    const std::vector<float> TRIANGLE { 1, 0, 0,  N, N, 0,  0, 0,
+                                        0, 1, 0,  N, N, 0,  1, 0,
+                                        0, 1, 1,  N, N, 0,  1, 1 };
+    WHEN ("It is prepared.") {
+      Mesh mesh (&context, &shader, Layout ());
+      mesh.addGeometry (TRIANGLE);
+      mesh.addIndices ({ 0, 1, 2 });
+      mesh.prepareVao ();
+      THEN ("Each attribute should be pointed at its location and offset.") {
+        REQUIRE (8u == mesh.getFloatsPerVertex ());
+        const std::vector<MockOpenGLContext::AttributePointer>& pointers = context.getAttributePointers ();
+        REQUIRE (3u == pointers.size ());
+        const GLuint LOCATIONS[] = { 0, 2, 3 };
+        const GLint SIZES[] = { 3, 3, 2 };
+        const std::uintptr_t OFFSETS[] = { 0, 12, 24 };
+        for (unsigned int attribute = 0; attribute < 3; attribute++) {
+          REQUIRE (LOCATIONS[attribute] == pointers[attribute].m_index);
+          REQUIRE (SIZES[attribute] == pointers[attribute].m_size);
+          REQUIRE (OFFSETS[attribute] == pointers[attribute].m_offset);
+          REQUIRE (32 == pointers[attribute].m_stride);
+          REQUIRE (GLenum (GL_FLOAT) == pointers[attribute].m_type);
+        }
+      }
+    }
+    WHEN ("A mesh of positions alone is prepared.") {
+      Mesh mesh (&context, &shader);
+      mesh.addGeometry ({ 1, 0, 0,  0, 1, 0,  0, 1, 1 });
+      mesh.addIndices ({ 0, 1, 2 });
+      mesh.prepareVao ();
+      THEN ("Its stride should be one position.") {
+        REQUIRE (1u == context.getAttributePointers ().size ());
+        REQUIRE (12 == context.getAttributePointers ()[0].m_stride);
+      }
+    }
+    WHEN ("A mirrored copy is batched into it.") {
+      Mesh batch (&context, &shader, Layout ());
+      batch.addGeometry (TRIANGLE);
+      batch.addIndices ({ 0, 1, 2 });
+      Mesh mirrored (&context, &shader, Layout ());
+      mirrored.addGeometry (TRIANGLE);
+      mirrored.addIndices ({ 0, 1, 2 });
+      mirrored.scaleLocal (-1.0f, 1.0f, 1.0f);
+      batch.appendStaticGeometry (mirrored);
+      batch.prepareVao ();
+      THEN ("The copy's normals should be transformed where the layout puts them, and nothing else.") {
+        const MockOpenGLContext::Buffer& vbo = context.getBuffer (context.getAttributePointers ()[0].m_buffer);
+        std::vector<float> floats (vbo.m_bytes.size () / sizeof (float));
+        std::memcpy (floats.data (), vbo.m_bytes.data (), vbo.m_bytes.size ());
+        REQUIRE (48u == floats.size ());
+        for (unsigned int vertex = 3; vertex < 6; vertex++) {
+          REQUIRE (floats[vertex * 8 + 3] == Approx (-N));
+          REQUIRE (floats[vertex * 8 + 4] == Approx (N));
+          REQUIRE (floats[vertex * 8 + 6] == TRIANGLE[(vertex - 3) * 8 + 6]);
+          REQUIRE (floats[vertex * 8 + 7] == TRIANGLE[(vertex - 3) * 8 + 7]);
+        }
+      }
+    }
+    WHEN ("It and a mesh of the same size but another layout go into one arena.") {
+      BufferArena arena (&context);
+      Mesh mesh (&context, &shader, Layout ());
+      mesh.addGeometry (TRIANGLE);
+      mesh.addIndices ({ 0, 1, 2 });
+      mesh.setBufferArena (&arena);
+      mesh.prepareVao ();
+      Mesh colored (&context, &shader, VertexLayout<PositionAttribute, ColorAttribute, TexCoordAttribute> ());
+      colored.addGeometry (TRIANGLE);
+      colored.addIndices ({ 0, 1, 2 });
+      colored.setBufferArena (&arena);
+      colored.prepareVao ();
+      THEN ("They should not share a vertex array.") {
+        REQUIRE (2u == arena.getBlockCount ());
+      }
+    }
+  }
+}
@@ -0,0 +1,287 @@
+/// \file TestMeshOptimizer.cpp
+/// \brief A collection of Catch2 unit tests for the global functions in
+///   MeshOptimizer.hpp.
+/// \author Sean Malloy
+/// \version A08
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include "MeshOptimizer.hpp"
+#include "TestHelpers.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+/// \brief Builds the indices of a side x side grid of quads, two triangles
+///   per quad, with the triangles shuffled the way an exporter might leave
+///   them.
+std::vector<unsigned int>
+shuffledGridIndices (unsigned int side, unsigned int seed)
+{
+  std::vector<unsigned int> grid = buildGridIndices (side);
+  std::vector<std::array<unsigned int, 3>> triangles;
+  for (std::size_t corner = 0; corner < grid.size (); corner += 3)
+  {
+    triangles.push_back ({ { grid[corner], grid[corner + 1], grid[corner + 2] } });
+  }
+  std::mt19937 generator (seed);
+  std::shuffle (triangles.begin (), triangles.end (), generator);
+  std::vector<unsigned int> indices;
+  for (const std::array<unsigned int, 3>& triangle : triangles)
+  {
+    indices.insert (indices.end (), triangle.begin (), triangle.end ());
+  }
+  return indices;
+}
+
+/// \brief Gives the vertices of an index buffer new, random numbers, as if
+///   they had been stored in no particular order.
+/// \return The renumbered indices.
+std::vector<unsigned int>
+scrambleVertices (const std::vector<unsigned int>& indices, unsigned int vertexCount,
+                  unsigned int seed)
+{
+  std::vector<unsigned int> newNumber (vertexCount);
+  for (unsigned int vertex = 0; vertex < vertexCount; vertex++)
+  {
+    newNumber[vertex] = vertex;
+  }
+  std::mt19937 generator (seed);
+  std::shuffle (newNumber.begin (), newNumber.end (), generator);
+  std::vector<unsigned int> scrambled;
+  for (unsigned int index : indices)
+  {
+    scrambled.push_back (newNumber[index]);
+  }
+  return scrambled;
+}
+
+/// \brief Looks up the data of every vertex an index buffer draws, in order.
+std::vector<float>
+expandVertices (const std::vector<float>& data, const std::vector<unsigned int>& indices,
+                unsigned int floatsPerVertex)
+{
+  std::vector<float> expanded;
+  for (unsigned int index : indices)
+  {
+    expanded.insert (expanded.end (), data.begin () + index * floatsPerVertex,
+                     data.begin () + (index + 1) * floatsPerVertex);
+  }
+  return expanded;
+}
+
+/// \brief Gets the triangles of an index buffer in sorted order, each turned
+///   to start at its smallest vertex, so two buffers can be compared
+///   regardless of where each triangle starts but not of its winding.
+std::vector<std::array<unsigned int, 3>>
+sortedWoundTriangles (const std::vector<unsigned int>& indices)
+{
+  std::vector<std::array<unsigned int, 3>> triangles = sortedTriangles (indices);
+  for (std::array<unsigned int, 3>& triangle : triangles)
+  {
+    std::rotate (triangle.begin (), std::min_element (triangle.begin (), triangle.end ()),
+                 triangle.end ());
+  }
+  std::sort (triangles.begin (), triangles.end ());
+  return triangles;
+}
+
+SCENARIO ("Vertex cache statistics.", "[MeshOptimizer][A08]") {
+  GIVEN ("A single triangle.") {
+    std::vector<unsigned int> indices = { 0, 1, 2 };
+    WHEN ("I analyze it.") {
+      VertexCacheStatistics statistics = analyzeVertexCache (indices, 3);
+      THEN ("Every vertex should miss exactly once.") {
+        REQUIRE (3u == statistics.m_misses);
+        REQUIRE (3.0f == statistics.m_acmr);
+        REQUIRE (1.0f == statistics.m_atvr);
+      }
+    }
+  }
+
+  GIVEN ("Two triangles, then the first one again.") {
+    std::vector<unsigned int> indices = { 0, 1, 2, 3, 4, 5, 0, 1, 2 };
+    WHEN ("The cache holds all six vertices.") {
+      VertexCacheStatistics statistics = analyzeVertexCache (indices, 6, 6);
+      THEN ("The repeated triangle should be free.") {
+        REQUIRE (6u == statistics.m_misses);
+        REQUIRE (2.0f == statistics.m_acmr);
+        REQUIRE (1.0f == statistics.m_atvr);
+      }
+    }
+    WHEN ("The cache only holds three vertices.") {
+      VertexCacheStatistics statistics = analyzeVertexCache (indices, 6, 3);
+      THEN ("The repeated triangle should have been evicted.") {
+        REQUIRE (9u == statistics.m_misses);
+        REQUIRE (3.0f == statistics.m_acmr);
+        REQUIRE (1.5f == statistics.m_atvr);
+      }
+    }
+  }
+
+  GIVEN ("No triangles.") {
+    std::vector<unsigned int> indices;
+    THEN ("Both ratios should be 0.") {
+      VertexCacheStatistics statistics = analyzeVertexCache (indices, 4);
+      REQUIRE (0u == statistics.m_misses);
+      REQUIRE (0.0f == statistics.m_acmr);
+      REQUIRE (0.0f == statistics.m_atvr);
+      REQUIRE (optimizeVertexCache (indices, 4).empty ());
+    }
+  }
+}
+
+SCENARIO ("Vertex cache optimization.", "[MeshOptimizer][A08]") {
+  GIVEN ("A 60 x 60 grid of quads whose triangles are shuffled.") {
+    const unsigned int SIDE = 60;
+    const unsigned int VERTICES = (SIDE + 1) * (SIDE + 1);
+    std::vector<unsigned int> indices = shuffledGridIndices (SIDE, 7);
+    WHEN ("I optimize it for the vertex cache.") {
+      std::vector<unsigned int> optimized = optimizeVertexCache (indices, VERTICES);
+      VertexCacheStatistics before = analyzeVertexCache (indices, VERTICES);
+      VertexCacheStatistics after = analyzeVertexCache (optimized, VERTICES);
+      THEN ("It should draw exactly the same triangles with the same winding.") {
+        REQUIRE (indices.size () == optimized.size ());
+        REQUIRE (sortedTriangles (indices) == sortedTriangles (optimized));
+      }
+      THEN ("It should miss the cache far less often.") {
+        CAPTURE (before.m_acmr, after.m_acmr, after.m_atvr);
+        REQUIRE (before.m_acmr > 2.5f);
+        REQUIRE (after.m_acmr < 0.8f);
+        REQUIRE (after.m_atvr < 1.5f);
+      }
+      THEN ("Optimizing the same input again should give the same order.") {
+        REQUIRE (optimized == optimizeVertexCache (indices, VERTICES));
+      }
+    }
+    WHEN ("I optimize it for a larger cache.") {
+      std::vector<unsigned int> optimized = optimizeVertexCache (indices, VERTICES, 32);
+      THEN ("It should do at least as well in that cache.") {
+        VertexCacheStatistics small = analyzeVertexCache (optimizeVertexCache (indices, VERTICES), VERTICES, 32);
+        VertexCacheStatistics large = analyzeVertexCache (optimized, VERTICES, 32);
+        CAPTURE (small.m_acmr, large.m_acmr);
+        REQUIRE (large.m_acmr <= small.m_acmr);
+      }
+    }
+  }
+
+  GIVEN ("Triangles that share no vertices, some unused vertices, and a degenerate triangle.") {
+    std::vector<unsigned int> indices = { 5, 6, 7, 0, 1, 2, 9, 9, 8 };
+    WHEN ("I optimize them.") {
+      std::vector<unsigned int> optimized = optimizeVertexCache (indices, 12);
+      THEN ("Every triangle should still be drawn once.") {
+        REQUIRE (sortedTriangles (indices) == sortedTriangles (optimized));
+      }
+    }
+  }
+}
+
+SCENARIO ("Vertex fetch remapping.", "[MeshOptimizer][A08]") {
+  GIVEN ("A vertex cache optimized grid whose vertices are stored in random order.") {
+    const unsigned int SIDE = 40;
+    const unsigned int VERTICES = (SIDE + 1) * (SIDE + 1);
+    std::vector<unsigned int> indices = optimizeVertexCache (
+      scrambleVertices (shuffledGridIndices (SIDE, 3), VERTICES, 4), VERTICES);
+    THEN ("Remapping should keep every drawn vertex, for any vertex size.") {
+      for (unsigned int floatsPerVertex = 1; floatsPerVertex <= 8; floatsPerVertex++) {
+        CAPTURE (floatsPerVertex);
+        std::vector<float> data;
+        for (unsigned int part = 0; part < VERTICES * floatsPerVertex; part++) {
+          data.push_back (static_cast<float> (part));
+        }
+        std::vector<float> drawn = expandVertices (data, indices, floatsPerVertex);
+        std::vector<unsigned int> remappedIndices = indices;
+        REQUIRE (VERTICES == remapVerticesForFetch (data, remappedIndices, floatsPerVertex));
+        REQUIRE (VERTICES * floatsPerVertex == data.size ());
+        REQUIRE (drawn == expandVertices (data, remappedIndices, floatsPerVertex));
+      }
+    }
+    WHEN ("I remap its vertices into first-use order.") {
+      const unsigned int FLOATS_PER_VERTEX = 6;
+      std::vector<float> data (VERTICES * FLOATS_PER_VERTEX, 1.0f);
+      VertexFetchStatistics before = analyzeVertexFetch (indices, VERTICES, FLOATS_PER_VERTEX * sizeof (float));
+      remapVerticesForFetch (data, indices, FLOATS_PER_VERTEX);
+      VertexFetchStatistics after = analyzeVertexFetch (indices, VERTICES, FLOATS_PER_VERTEX * sizeof (float));
+      THEN ("Each index should be at most one more than any before it.") {
+        unsigned int next = 0;
+        for (unsigned int index : indices) {
+          REQUIRE (index <= next);
+          next = std::max (next, index + 1);
+        }
+      }
+      THEN ("It should read much less memory.") {
+        CAPTURE (before.m_overfetch, after.m_overfetch);
+        REQUIRE (before.m_overfetch > 2.0f);
+        REQUIRE (after.m_overfetch < 1.5f);
+        REQUIRE (after.m_bytesFetched < before.m_bytesFetched);
+      }
+    }
+  }
+
+  GIVEN ("Data with vertices that no triangle uses.") {
+    std::vector<float> data = { 0.0f, 0.5f, 1.0f, 1.5f, 2.0f, 2.5f, 3.0f, 3.5f, 4.0f, 4.5f };
+    std::vector<unsigned int> indices = { 4, 1, 3, 3, 1, 4 };
+    WHEN ("I remap it with two floats per vertex.") {
+      unsigned int kept = remapVerticesForFetch (data, indices, 2);
+      THEN ("The unused vertices should be dropped and the rest renumbered.") {
+        REQUIRE (3u == kept);
+        REQUIRE (std::vector<float> ({ 4.0f, 4.5f, 1.0f, 1.5f, 3.0f, 3.5f }) == data);
+        REQUIRE (std::vector<unsigned int> ({ 0, 1, 2, 2, 1, 0 }) == indices);
+      }
+    }
+  }
+
+  GIVEN ("One vertex that fills exactly one line.") {
+    std::vector<unsigned int> indices = { 0, 0, 0 };
+    THEN ("It should be fetched once with no overfetch.") {
+      VertexFetchStatistics statistics = analyzeVertexFetch (indices, 1, VERTEX_FETCH_LINE_SIZE);
+      REQUIRE (VERTEX_FETCH_LINE_SIZE == statistics.m_bytesFetched);
+      REQUIRE (1.0f == statistics.m_overfetch);
+    }
+  }
+}
+
+SCENARIO ("Stripification.", "[MeshOptimizer][A08]") {
+  GIVEN ("A shuffled 40 x 40 grid, with its vertices scrambled.") {
+    const unsigned int SIDE = 40;
+    const unsigned int VERTICES = (SIDE + 1) * (SIDE + 1);
+    std::vector<unsigned int> indices = scrambleVertices (shuffledGridIndices (SIDE, 3), VERTICES, 4);
+    WHEN ("I turn it into strips.") {
+      std::vector<unsigned int> strips = stripify (indices, VERTICES);
+      THEN ("The strips should draw every triangle once, wound the same way.") {
+        REQUIRE (sortedWoundTriangles (indices) == sortedWoundTriangles (unstripify (strips)));
+      }
+      THEN ("They should need far fewer indices than the list.") {
+        unsigned int stripCount = 1 + std::count (strips.begin (), strips.end (), STRIP_RESTART_INDEX);
+        float reduction = 1.0f - static_cast<float> (strips.size ()) / indices.size ();
+        WARN ("Triangle list: " << indices.size () << " indices.  Strips: " << strips.size ()
+              << " indices in " << stripCount << " strips, "
+              << static_cast<int> (reduction * 100.0f + 0.5f) << "% fewer.");
+        REQUIRE (strips.size () < indices.size () * 2 / 5);
+      }
+    }
+  }
+
+  GIVEN ("A triangle list with one triangle, one repeated vertex, and an island.") {
+    std::vector<unsigned int> indices = { 0, 1, 2,   3, 3, 4,   5, 6, 7,   7, 6, 8 };
+    WHEN ("I turn it into strips.") {
+      std::vector<unsigned int> strips = stripify (indices, 9);
+      THEN ("The flat triangle should be dropped, and the rest kept in two strips.") {
+        REQUIRE (1 == std::count (strips.begin (), strips.end (), STRIP_RESTART_INDEX));
+        REQUIRE (3u + 1u + 4u == strips.size ());
+        std::vector<unsigned int> kept = { 0, 1, 2, 5, 6, 7, 7, 6, 8 };
+        REQUIRE (sortedWoundTriangles (kept) == sortedWoundTriangles (unstripify (strips)));
+      }
+    }
+  }
+
+  GIVEN ("No triangles.") {
+    THEN ("There should be no strips.") {
+      REQUIRE (stripify ({}, 0).empty ());
+      REQUIRE (unstripify ({}).empty ());
+    }
+  }
+}
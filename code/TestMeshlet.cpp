@@ -0,0 +1,193 @@
+/// \file TestMeshlet.cpp
+/// \brief A collection of Catch2 unit tests for the global functions in
+///   Meshlet.hpp.
+/// \author Sean Malloy
+/// \version A08
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <set>
+#include <vector>
+
+#include "Meshlet.hpp"
+#include "TestHelpers.hpp"
+#include "Vector4.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+/// \brief Gets the position of a vertex with three floats per vertex.
+Vector3
+vertexAt (const std::vector<float>& data, unsigned int vertex)
+{
+  return Vector3 (data[vertex * 3], data[vertex * 3 + 1], data[vertex * 3 + 2]);
+}
+
+/// \brief Makes a model-view matrix that moves and turns a mesh in front of
+///   a camera at the origin.
+Matrix4
+placeInFront (float x, float z, float yawDegrees)
+{
+  Vector4 right (std::cos (yawDegrees * static_cast<float> (M_PI) / 180.0f), 0.0f,
+                 -std::sin (yawDegrees * static_cast<float> (M_PI) / 180.0f), 0.0f);
+  Vector4 back (std::sin (yawDegrees * static_cast<float> (M_PI) / 180.0f), 0.0f,
+                std::cos (yawDegrees * static_cast<float> (M_PI) / 180.0f), 0.0f);
+  return Matrix4 (right, Vector4 (0.0f, 1.0f, 0.0f, 0.0f), back, Vector4 (x, 0.0f, z, 1.0f));
+}
+
+SCENARIO ("Building meshlets.", "[Meshlet][A08]") {
+  GIVEN ("A flat 40 x 40 grid.") {
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    buildFlatGrid (40, 0.1f, data, indices);
+    WHEN ("I build meshlets with the default limits.") {
+      MeshletSet set = buildMeshlets (data, 3, indices);
+      THEN ("Every triangle should be in exactly one meshlet, wound the same way.") {
+        REQUIRE (indices.size () == set.m_indices.size ());
+        REQUIRE (sortedTriangles (indices) == sortedTriangles (set.m_indices));
+        unsigned int next = 0;
+        for (const Meshlet& meshlet : set.m_meshlets) {
+          REQUIRE (next == meshlet.m_indexOffset);
+          next += meshlet.m_triangleCount * 3;
+        }
+        REQUIRE (indices.size () == next);
+      }
+      THEN ("Each meshlet should respect the limits and be well filled.") {
+        for (const Meshlet& meshlet : set.m_meshlets) {
+          std::set<unsigned int> vertices (set.m_indices.begin () + meshlet.m_indexOffset,
+                                           set.m_indices.begin () + meshlet.m_indexOffset + meshlet.m_triangleCount * 3);
+          REQUIRE (vertices.size () == meshlet.m_vertexCount);
+          REQUIRE (meshlet.m_vertexCount <= MAX_MESHLET_VERTICES);
+          REQUIRE (meshlet.m_triangleCount <= MAX_MESHLET_TRIANGLES);
+        }
+        float averageTriangles = static_cast<float> (indices.size () / 3) / set.m_meshlets.size ();
+        CAPTURE (set.m_meshlets.size (), averageTriangles);
+        REQUIRE (averageTriangles > 70.0f);
+      }
+      THEN ("Each bounding sphere should hold its vertices, and each cone face +Z exactly.") {
+        float radiusSum = 0.0f;
+        for (const Meshlet& meshlet : set.m_meshlets) {
+          for (unsigned int corner = 0; corner < meshlet.m_triangleCount * 3; corner++) {
+            Vector3 position = vertexAt (data, set.m_indices[meshlet.m_indexOffset + corner]);
+            REQUIRE ((position - meshlet.m_center).length () <= meshlet.m_radius + 1e-5f);
+          }
+          REQUIRE (meshlet.m_coneAxis.m_z == Approx (1.0f));
+          REQUIRE (meshlet.m_coneCutoff == Approx (0.0f).margin (1e-3));
+          radiusSum += meshlet.m_radius;
+        }
+        // A square of 64 vertices would have a radius of about 0.5.
+        CAPTURE (radiusSum / set.m_meshlets.size ());
+        REQUIRE (radiusSum / set.m_meshlets.size () < 0.55f);
+      }
+    }
+    WHEN ("I limit meshlets to one triangle each.") {
+      MeshletSet set = buildMeshlets (data, 3, indices, 3, 1);
+      THEN ("There should be one meshlet per triangle.") {
+        REQUIRE (indices.size () / 3 == set.m_meshlets.size ());
+        REQUIRE (sortedTriangles (indices) == sortedTriangles (set.m_indices));
+      }
+    }
+  }
+
+  GIVEN ("The six faces of a cube, each two triangles facing out.") {
+    std::vector<float> data = { -1, -1, -1,   1, -1, -1,   1,  1, -1,   -1,  1, -1,
+                                -1, -1,  1,   1, -1,  1,   1,  1,  1,   -1,  1,  1 };
+    std::vector<unsigned int> indices = { 4, 5, 6, 4, 6, 7,   1, 0, 3, 1, 3, 2,
+                                          5, 1, 2, 5, 2, 6,   0, 4, 7, 0, 7, 3,
+                                          7, 6, 2, 7, 2, 3,   0, 1, 5, 0, 5, 4 };
+    WHEN ("I build one meshlet from all of them.") {
+      MeshletSet set = buildMeshlets (data, 3, indices);
+      THEN ("Its cone should never cull it.") {
+        REQUIRE (1u == set.m_meshlets.size ());
+        REQUIRE (8u == set.m_meshlets[0].m_vertexCount);
+        REQUIRE (1.0f == set.m_meshlets[0].m_coneCutoff);
+        REQUIRE (std::sqrt (3.0f) == Approx (set.m_meshlets[0].m_radius));
+      }
+    }
+  }
+
+  GIVEN ("No triangles.") {
+    THEN ("There should be no meshlets.") {
+      MeshletSet set = buildMeshlets ({ 0.0f, 0.0f, 0.0f }, 3, {});
+      REQUIRE (set.m_meshlets.empty ());
+      REQUIRE (set.m_indices.empty ());
+    }
+  }
+}
+
+SCENARIO ("Culling meshlets.", "[Meshlet][A08]") {
+  GIVEN ("A flat 40 x 40 grid in meshlets, and a 60 degree perspective projection.") {
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    buildFlatGrid (40, 0.1f, data, indices);
+    MeshletSet set = buildMeshlets (data, 3, indices);
+    Matrix4 projection;
+    projection.setToPerspectiveProjection (60.0, 1.0, 0.1, 100.0);
+    std::vector<unsigned int> visible;
+
+    WHEN ("The grid faces the camera, 5 units away.") {
+      Frustum frustum = extractFrustum (projection, placeInFront (0.0f, -5.0f, 0.0f));
+      unsigned int count = cullMeshlets (set, frustum, Vector3 (0.0f, 0.0f, 5.0f), visible);
+      THEN ("Every meshlet should be drawn.") {
+        REQUIRE (set.m_meshlets.size () == count);
+        REQUIRE (set.m_indices == visible);
+      }
+    }
+
+    WHEN ("The grid has been turned around to face away.") {
+      Frustum frustum = extractFrustum (projection, placeInFront (0.0f, -5.0f, 180.0f));
+      unsigned int count = cullMeshlets (set, frustum, Vector3 (0.0f, 0.0f, -5.0f), visible);
+      THEN ("Every meshlet should be culled as back facing.") {
+        REQUIRE (0u == count);
+        REQUIRE (visible.empty ());
+      }
+    }
+
+    WHEN ("The grid is off to the side of the camera.") {
+      Frustum frustum = extractFrustum (projection, placeInFront (20.0f, -5.0f, 0.0f));
+      unsigned int count = cullMeshlets (set, frustum, Vector3 (-20.0f, 0.0f, 5.0f), visible);
+      THEN ("Every meshlet should be culled as outside the view.") {
+        REQUIRE (0u == count);
+      }
+    }
+
+    WHEN ("The grid is so close that it fills more than the view.") {
+      const float DISTANCE = 0.5f;
+      Frustum frustum = extractFrustum (projection, placeInFront (0.5f, -DISTANCE, 0.0f));
+      unsigned int count = cullMeshlets (set, frustum, Vector3 (-0.5f, 0.0f, DISTANCE), visible);
+      THEN ("Only some meshlets should be drawn, including every triangle in view.") {
+        CAPTURE (count, set.m_meshlets.size ());
+        REQUIRE (count > 0u);
+        REQUIRE (count < set.m_meshlets.size () / 2);
+        std::vector<std::array<unsigned int, 3>> drawn = sortedTriangles (visible);
+        const float HALF_WIDTH = DISTANCE * std::tan (30.0f * static_cast<float> (M_PI) / 180.0f);
+        for (const std::array<unsigned int, 3>& triangle : sortedTriangles (indices)) {
+          Vector3 center = (vertexAt (data, triangle[0]) + vertexAt (data, triangle[1])
+                            + vertexAt (data, triangle[2])) / 3.0f;
+          if (std::fabs (center.m_x + 0.5f) < HALF_WIDTH && std::fabs (center.m_y) < HALF_WIDTH) {
+            REQUIRE (std::binary_search (drawn.begin (), drawn.end (), triangle));
+          }
+        }
+      }
+    }
+  }
+
+  GIVEN ("The view volume of a camera at the origin.") {
+    Matrix4 projection;
+    projection.setToPerspectiveProjection (90.0, 1.0, 1.0, 10.0);
+    Frustum frustum = extractFrustum (projection, Matrix4 ());
+    THEN ("Each plane should face in, and be a unit distance function.") {
+      Vector3 inside (0.0f, 0.0f, -5.0f);
+      for (const FrustumPlane& plane : frustum) {
+        REQUIRE (plane.m_normal.length () == Approx (1.0f));
+        REQUIRE (plane.m_normal.dot (inside) + plane.m_distance > 0.0f);
+      }
+      // The near plane is at z = -1 and the far plane at z = -10.
+      REQUIRE (frustum[4].m_normal.dot (Vector3 (0.0f, 0.0f, -3.0f)) + frustum[4].m_distance == Approx (2.0f));
+      REQUIRE (frustum[5].m_normal.dot (Vector3 (0.0f, 0.0f, -3.0f)) + frustum[5].m_distance == Approx (7.0f));
+      // With a 90 degree field of view, x = -z is on the right plane.
+      REQUIRE (frustum[1].m_normal.dot (Vector3 (4.0f, 0.0f, -4.0f)) + frustum[1].m_distance == Approx (0.0f).margin (1e-5));
+    }
+  }
+}
@@ -0,0 +1,224 @@
+/// \file TestPrimitives.cpp
+/// \brief A collection of Catch2 unit tests for the global functions in
+///   Primitives.hpp.
+/// \author Sean Malloy
+/// \version A08
+
+#include <cmath>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "Geometry.hpp"
+#include "Primitives.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+/// \brief Gets the position of a vertex.
+Vector3
+positionAt (const std::vector<float>& data, unsigned int vertex)
+{
+  const float* position = &data[vertex * PRIMITIVE_FLOATS_PER_VERTEX];
+  return Vector3 (position[0], position[1], position[2]);
+}
+
+/// \brief Gets the normal of a vertex.
+Vector3
+normalAt (const std::vector<float>& data, unsigned int vertex)
+{
+  const float* normal = &data[vertex * PRIMITIVE_FLOATS_PER_VERTEX + 3];
+  return Vector3 (normal[0], normal[1], normal[2]);
+}
+
+/// \brief Checks what every generator promises: a valid, fully shared index
+///   buffer, unit normals, and triangles that face the way their normals do.
+/// \param[in] closed Whether the shape has no border, so every edge must be
+///   shared by exactly two triangles that cross it in opposite directions.
+void
+requireWellFormed (const std::vector<float>& data, const std::vector<unsigned int>& indices,
+                   bool closed)
+{
+  const unsigned int vertexCount = data.size () / PRIMITIVE_FLOATS_PER_VERTEX;
+  REQUIRE (data.size () % PRIMITIVE_FLOATS_PER_VERTEX == 0);
+  REQUIRE (indices.size () % 3 == 0);
+  std::vector<bool> used (vertexCount, false);
+  std::map<std::pair<unsigned int, unsigned int>, unsigned int> edges;
+  for (unsigned int corner = 0; corner < indices.size (); corner += 3)
+  {
+    const unsigned int* triangle = &indices[corner];
+    Vector3 a = positionAt (data, triangle[0]);
+    Vector3 facing = (positionAt (data, triangle[1]) - a).cross (positionAt (data, triangle[2]) - a);
+    Vector3 normals = normalAt (data, triangle[0]) + normalAt (data, triangle[1]) + normalAt (data, triangle[2]);
+    CAPTURE (corner / 3);
+    REQUIRE (facing.length () > 0.0f);
+    REQUIRE (facing.dot (normals) > 0.0f);
+    for (unsigned int side = 0; side < 3; side++)
+    {
+      REQUIRE (triangle[side] < vertexCount);
+      used[triangle[side]] = true;
+      edges[std::make_pair (triangle[side], triangle[(side + 1) % 3])]++;
+    }
+  }
+  for (unsigned int vertex = 0; vertex < vertexCount; vertex++)
+  {
+    REQUIRE (used[vertex]);
+    REQUIRE (normalAt (data, vertex).length () == Approx (1.0f));
+  }
+  for (const auto& edge : edges)
+  {
+    REQUIRE (1u == edge.second);
+    if (closed)
+    {
+      REQUIRE (edges.count (std::make_pair (edge.first.second, edge.first.first)) == 1);
+    }
+  }
+
+  // Welding the unindexed triangles must find nothing left to share.
+  std::vector<float> soup;
+  for (unsigned int index : indices)
+  {
+    soup.insert (soup.end (), &data[index * PRIMITIVE_FLOATS_PER_VERTEX],
+                 &data[(index + 1) * PRIMITIVE_FLOATS_PER_VERTEX]);
+  }
+  std::vector<float> welded;
+  std::vector<unsigned int> weldedIndices;
+  indexData (soup, PRIMITIVE_FLOATS_PER_VERTEX, welded, weldedIndices);
+  REQUIRE (data.size () == welded.size ());
+}
+
+/// \brief Checks that a generator writes the same thing on any number of
+///   threads.
+void
+requireThreadIndependent (const std::function<void (std::vector<float>&, std::vector<unsigned int>&,
+                                                    unsigned int)>& generate)
+{
+  std::vector<float> serialData, parallelData;
+  std::vector<unsigned int> serialIndices, parallelIndices;
+  generate (serialData, serialIndices, 1);
+  generate (parallelData, parallelIndices, 4);
+  REQUIRE (serialData == parallelData);
+  REQUIRE (serialIndices == parallelIndices);
+}
+
+SCENARIO ("Generating spheres.", "[Primitives][A08]") {
+  GIVEN ("A UV sphere of radius 2 with 24 slices and 12 stacks.") {
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    buildUvSphere (2.0f, 24, 12, data, indices);
+    THEN ("It should have exactly the promised vertices and triangles, all well formed.") {
+      REQUIRE (11u * 24 + 2 == data.size () / PRIMITIVE_FLOATS_PER_VERTEX);
+      REQUIRE (2u * 24 * 11 * 3 == indices.size ());
+      requireWellFormed (data, indices, true);
+    }
+    THEN ("Every vertex should be on the sphere, with its normal pointing out.") {
+      for (unsigned int vertex = 0; vertex < data.size () / PRIMITIVE_FLOATS_PER_VERTEX; vertex++) {
+        REQUIRE (positionAt (data, vertex).length () == Approx (2.0f));
+        REQUIRE ((positionAt (data, vertex) / 2.0f - normalAt (data, vertex)).length () == Approx (0.0f).margin (1e-5));
+      }
+    }
+    THEN ("The thread count should not matter.") {
+      requireThreadIndependent ([] (std::vector<float>& d, std::vector<unsigned int>& i, unsigned int threads) {
+        buildUvSphere (2.0f, 24, 12, d, i, threads);
+      });
+    }
+  }
+
+  GIVEN ("Icospheres of several frequencies.") {
+    for (unsigned int frequency : { 1u, 2u, 3u, 8u }) {
+      std::vector<float> data;
+      std::vector<unsigned int> indices;
+      buildIcosphere (1.5f, frequency, data, indices);
+      CAPTURE (frequency);
+      THEN ("Each should have exactly the promised vertices and triangles, all well formed.") {
+        REQUIRE (10 * frequency * frequency + 2 == data.size () / PRIMITIVE_FLOATS_PER_VERTEX);
+        REQUIRE (20 * frequency * frequency * 3 == indices.size ());
+        requireWellFormed (data, indices, true);
+        for (unsigned int vertex = 0; vertex < data.size () / PRIMITIVE_FLOATS_PER_VERTEX; vertex++) {
+          REQUIRE (positionAt (data, vertex).length () == Approx (1.5f));
+        }
+      }
+    }
+    THEN ("The thread count should not matter.") {
+      requireThreadIndependent ([] (std::vector<float>& d, std::vector<unsigned int>& i, unsigned int threads) {
+        buildIcosphere (1.0f, 16, d, i, threads);
+      });
+    }
+  }
+}
+
+SCENARIO ("Generating tori, cylinders, and height fields.", "[Primitives][A08]") {
+  GIVEN ("A torus with 32 by 12 segments.") {
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    buildTorus (2.0f, 0.5f, 32, 12, data, indices);
+    THEN ("It should be closed and well formed, with every vertex on the tube.") {
+      REQUIRE (32u * 12 == data.size () / PRIMITIVE_FLOATS_PER_VERTEX);
+      REQUIRE (2u * 32 * 12 * 3 == indices.size ());
+      requireWellFormed (data, indices, true);
+      for (unsigned int vertex = 0; vertex < 32 * 12; vertex++) {
+        Vector3 position = positionAt (data, vertex);
+        Vector3 ring (position.m_x, 0.0f, position.m_z);
+        ring.normalize ();
+        REQUIRE ((position - ring * 2.0f).length () == Approx (0.5f));
+      }
+    }
+    THEN ("The thread count should not matter.") {
+      requireThreadIndependent ([] (std::vector<float>& d, std::vector<unsigned int>& i, unsigned int threads) {
+        buildTorus (2.0f, 0.5f, 32, 12, d, i, threads);
+      });
+    }
+  }
+
+  GIVEN ("A capped cylinder with 16 slices and 3 stacks.") {
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    buildCylinder (1.0f, 4.0f, 16, 3, data, indices);
+    THEN ("It should be well formed, and span its height.") {
+      REQUIRE (4u * 16 + 2 * 17 == data.size () / PRIMITIVE_FLOATS_PER_VERTEX);
+      REQUIRE (2u * 16 * 4 * 3 == indices.size ());
+      // The caps have their own vertices, so the side and caps only meet
+      //   by position, not by index.
+      requireWellFormed (data, indices, false);
+      BoundingBox box = computeBoundingBox (data, PRIMITIVE_FLOATS_PER_VERTEX);
+      REQUIRE (box.m_min.m_y == Approx (-2.0f));
+      REQUIRE (box.m_max.m_y == Approx (2.0f));
+      REQUIRE (box.m_max.m_x == Approx (1.0f));
+    }
+    THEN ("The thread count should not matter.") {
+      requireThreadIndependent ([] (std::vector<float>& d, std::vector<unsigned int>& i, unsigned int threads) {
+        buildCylinder (1.0f, 4.0f, 16, 3, d, i, threads);
+      });
+    }
+  }
+
+  GIVEN ("A 5 by 4 height field that slopes up along +X.") {
+    std::vector<float> heights;
+    for (unsigned int row = 0; row < 4; row++) {
+      for (unsigned int column = 0; column < 5; column++) {
+        heights.push_back (0.5f * column);
+      }
+    }
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    buildHeightField (heights, 5, 1.0f, data, indices);
+    THEN ("It should be well formed, centered, with every normal tilted away from the slope.") {
+      REQUIRE (20u == data.size () / PRIMITIVE_FLOATS_PER_VERTEX);
+      REQUIRE (2u * 4 * 3 * 3 == indices.size ());
+      requireWellFormed (data, indices, false);
+      REQUIRE (positionAt (data, 0) == Vector3 (-2.0f, 0.0f, -1.5f));
+      REQUIRE (positionAt (data, 19) == Vector3 (2.0f, 2.0f, 1.5f));
+      Vector3 expected (-0.5f, 1.0f, 0.0f);
+      expected.normalize ();
+      for (unsigned int vertex = 0; vertex < 20; vertex++) {
+        REQUIRE ((normalAt (data, vertex) - expected).length () == Approx (0.0f).margin (1e-6));
+      }
+    }
+    THEN ("The thread count should not matter.") {
+      requireThreadIndependent ([&] (std::vector<float>& d, std::vector<unsigned int>& i, unsigned int threads) {
+        buildHeightField (heights, 5, 1.0f, d, i, threads);
+      });
+    }
+  }
+}
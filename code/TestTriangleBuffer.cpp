@@ -0,0 +1,103 @@
+/// \file TestTriangleBuffer.cpp
+/// \brief A collection of Catch2 unit tests for the TriangleBuffer class.
+/// \author Sean Malloy
+/// \version A08
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Geometry.hpp"
+#include "TriangleBuffer.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+/// \brief Builds some random, non-degenerate-looking triangles.
+std::vector<Triangle>
+randomTriangles (unsigned int count, unsigned int seed)
+{
+  std::mt19937 generator (seed);
+  std::uniform_real_distribution<float> coordinate (-5.0f, 5.0f);
+  std::vector<Triangle> faces;
+  for (unsigned int face = 0; face < count; face++)
+  {
+    Triangle triangle;
+    for (Vector3& corner : triangle)
+    {
+      corner = Vector3 (coordinate (generator), coordinate (generator), coordinate (generator));
+    }
+    faces.push_back (triangle);
+  }
+  return faces;
+}
+
+SCENARIO ("TriangleBuffer conversions.", "[TriangleBuffer][A08]") {
+  GIVEN ("A collection of 13 triangles (not a multiple of any SIMD width).") {
+    std::vector<Triangle> faces = randomTriangles (13, 1);
+    WHEN ("I convert them to a TriangleBuffer.") {
+      TriangleBuffer buffer (faces);
+      THEN ("The size should match and the streams should be padded and aligned.") {
+        REQUIRE (13u == buffer.size ());
+        REQUIRE (16u == buffer.paddedSize ());
+        for (unsigned int corner = 0; corner < 3; corner++) {
+          REQUIRE (0u == reinterpret_cast<std::uintptr_t> (buffer.x (corner)) % 32);
+          REQUIRE (0u == reinterpret_cast<std::uintptr_t> (buffer.y (corner)) % 32);
+          REQUIRE (0u == reinterpret_cast<std::uintptr_t> (buffer.z (corner)) % 32);
+        }
+      }
+      THEN ("Each stream should hold one coordinate of one corner of every face.") {
+        REQUIRE (faces[4][2].m_y == buffer.y (2)[4]);
+        REQUIRE (faces[12][0].m_z == buffer.z (0)[12]);
+        REQUIRE (0.0f == buffer.x (1)[15]);
+      }
+      THEN ("Converting back should give exactly the same faces.") {
+        std::vector<Triangle> back = buffer.toTriangles ();
+        REQUIRE (faces == back);
+      }
+    }
+  }
+}
+
+SCENARIO ("TriangleBuffer SIMD kernels match the scalar code.", "[TriangleBuffer][A08]") {
+  GIVEN ("A few thousand random triangles and the unit cube.") {
+    std::vector<Triangle> faces = randomTriangles (3001, 2);
+    std::vector<Triangle> cube = buildCube ();
+    faces.insert (faces.end (), cube.begin (), cube.end ());
+    TriangleBuffer buffer (faces);
+    WHEN ("I compute face normals.") {
+      std::vector<Vector3> normals = buffer.computeFaceNormals ();
+      std::vector<Vector3> expected = computeFaceNormals (faces);
+      THEN ("They should match computeFaceNormals.") {
+        REQUIRE (expected.size () == normals.size ());
+        for (unsigned int face = 0; face < faces.size (); face++) {
+          REQUIRE (expected[face] == normals[face]);
+        }
+      }
+    }
+    WHEN ("I compute areas.") {
+      std::vector<float> areas = buffer.computeAreas ();
+      THEN ("They should be half the length of each face's cross product.") {
+        REQUIRE (faces.size () == areas.size ());
+        for (unsigned int face = 0; face < faces.size (); face++) {
+          float expected = 0.5f * ((faces[face][1] - faces[face][0]).cross (faces[face][2] - faces[face][0])).length ();
+          REQUIRE (expected == Approx (areas[face]).epsilon (1e-5));
+        }
+      }
+    }
+    WHEN ("I compute corner angles.") {
+      std::vector<float> angles = buffer.computeCornerAngles ();
+      THEN ("They should match Vector3::angleBetween.") {
+        REQUIRE (faces.size () * 3 == angles.size ());
+        for (unsigned int face = 0; face < faces.size (); face++) {
+          for (unsigned int corner = 0; corner < 3; corner++) {
+            const Triangle& f = faces[face];
+            float expected = (f[(corner + 1) % 3] - f[corner]).angleBetween (f[(corner + 2) % 3] - f[corner]);
+            REQUIRE (expected == Approx (angles[face * 3 + corner]).margin (1e-5));
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,241 @@
+/// \file TriangleBuffer.cpp
+/// \brief Implementation of TriangleBuffer class and any associated global
+///   functions.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// System includes
+#include <cassert>
+#include <cstdint>
+
+/******************************************************************/
+// Local includes
+#include "TriangleBuffer.hpp"
+#include "Simd.hpp"
+
+/******************************************************************/
+// Streams are always aligned and padded for 8-wide AVX, even in builds that
+//   only use SSE, so a buffer's layout never depends on compiler flags.
+static const unsigned int STREAM_FLOATS_ALIGNMENT = 8;
+static const unsigned int STREAM_COUNT = 9;
+
+/// \brief Rounds a face count up to a whole number of SIMD registers.
+static unsigned int
+padFaceCount (unsigned int size)
+{
+  return (size + STREAM_FLOATS_ALIGNMENT - 1) / STREAM_FLOATS_ALIGNMENT * STREAM_FLOATS_ALIGNMENT;
+}
+
+TriangleBuffer::TriangleBuffer (unsigned int size)
+  : m_size (size),
+    m_paddedSize (padFaceCount (size)),
+    m_storage (STREAM_COUNT * m_paddedSize + STREAM_FLOATS_ALIGNMENT, 0.0f)
+{
+}
+
+TriangleBuffer::TriangleBuffer (const std::vector<Triangle>& faces)
+  : TriangleBuffer (faces.size ())
+{
+  for (unsigned int face = 0; face < faces.size (); face++)
+  {
+    setTriangle (face, faces[face]);
+  }
+}
+
+unsigned int
+TriangleBuffer::size () const
+{
+  return m_size;
+}
+
+unsigned int
+TriangleBuffer::paddedSize () const
+{
+  return m_paddedSize;
+}
+
+float*
+TriangleBuffer::stream (unsigned int stream)
+{
+  return const_cast<float*> (static_cast<const TriangleBuffer*> (this)->stream (stream));
+}
+
+const float*
+TriangleBuffer::stream (unsigned int stream) const
+{
+  assert (stream < STREAM_COUNT);
+  const std::uintptr_t ALIGNMENT = STREAM_FLOATS_ALIGNMENT * sizeof (float);
+  std::uintptr_t address = reinterpret_cast<std::uintptr_t> (m_storage.data ());
+  std::uintptr_t aligned = (address + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+  return reinterpret_cast<const float*> (aligned) + static_cast<std::size_t> (stream) * m_paddedSize;
+}
+
+float*
+TriangleBuffer::x (unsigned int corner)
+{
+  return stream (corner * 3);
+}
+
+const float*
+TriangleBuffer::x (unsigned int corner) const
+{
+  return stream (corner * 3);
+}
+
+float*
+TriangleBuffer::y (unsigned int corner)
+{
+  return stream (corner * 3 + 1);
+}
+
+const float*
+TriangleBuffer::y (unsigned int corner) const
+{
+  return stream (corner * 3 + 1);
+}
+
+float*
+TriangleBuffer::z (unsigned int corner)
+{
+  return stream (corner * 3 + 2);
+}
+
+const float*
+TriangleBuffer::z (unsigned int corner) const
+{
+  return stream (corner * 3 + 2);
+}
+
+Triangle
+TriangleBuffer::getTriangle (unsigned int face) const
+{
+  assert (face < m_size);
+  Triangle triangle;
+  for (unsigned int corner = 0; corner < 3; corner++)
+  {
+    triangle[corner] = Vector3 (x (corner)[face], y (corner)[face], z (corner)[face]);
+  }
+  return triangle;
+}
+
+void
+TriangleBuffer::setTriangle (unsigned int face, const Triangle& triangle)
+{
+  assert (face < m_size);
+  for (unsigned int corner = 0; corner < 3; corner++)
+  {
+    x (corner)[face] = triangle[corner].m_x;
+    y (corner)[face] = triangle[corner].m_y;
+    z (corner)[face] = triangle[corner].m_z;
+  }
+}
+
+std::vector<Triangle>
+TriangleBuffer::toTriangles () const
+{
+  std::vector<Triangle> faces (m_size);
+  for (unsigned int face = 0; face < m_size; face++)
+  {
+    faces[face] = getTriangle (face);
+  }
+  return faces;
+}
+
+/// \brief The edges leaving one corner of FloatLanes::WIDTH faces at once.
+struct CornerEdges
+{
+  /// The edge to the next corner.
+  FloatLanes m_ax, m_ay, m_az;
+  /// The edge to the corner after that.
+  FloatLanes m_bx, m_by, m_bz;
+};
+
+/// \brief Loads the two edges leaving a corner for several faces.
+/// \param[in] buffer The faces.
+/// \param[in] corner Which corner the edges leave from.
+/// \param[in] face The first of the FloatLanes::WIDTH faces to load.
+/// \return The edges, (next - corner) and (after next - corner).
+static CornerEdges
+loadCornerEdges (const TriangleBuffer& buffer, unsigned int corner, unsigned int face)
+{
+  unsigned int next = (corner + 1) % 3;
+  unsigned int after = (corner + 2) % 3;
+  FloatLanes px = FloatLanes::load (buffer.x (corner) + face);
+  FloatLanes py = FloatLanes::load (buffer.y (corner) + face);
+  FloatLanes pz = FloatLanes::load (buffer.z (corner) + face);
+  CornerEdges edges;
+  edges.m_ax = FloatLanes::load (buffer.x (next) + face) - px;
+  edges.m_ay = FloatLanes::load (buffer.y (next) + face) - py;
+  edges.m_az = FloatLanes::load (buffer.z (next) + face) - pz;
+  edges.m_bx = FloatLanes::load (buffer.x (after) + face) - px;
+  edges.m_by = FloatLanes::load (buffer.y (after) + face) - py;
+  edges.m_bz = FloatLanes::load (buffer.z (after) + face) - pz;
+  return edges;
+}
+
+std::vector<Vector3>
+TriangleBuffer::computeFaceNormals () const
+{
+  std::vector<Vector3> normals (m_size);
+  alignas (32) float nx[FloatLanes::WIDTH];
+  alignas (32) float ny[FloatLanes::WIDTH];
+  alignas (32) float nz[FloatLanes::WIDTH];
+  for (unsigned int face = 0; face < m_size; face += FloatLanes::WIDTH)
+  {
+    // (p1 - p0) x (p2 - p0), then normalized, exactly as computeFaceNormals.
+    CornerEdges edges = loadCornerEdges (*this, 0, face);
+    FloatLanes cx = edges.m_ay * edges.m_bz - edges.m_az * edges.m_by;
+    FloatLanes cy = edges.m_az * edges.m_bx - edges.m_ax * edges.m_bz;
+    FloatLanes cz = edges.m_ax * edges.m_by - edges.m_ay * edges.m_bx;
+    FloatLanes length = sqrt (cx * cx + cy * cy + cz * cz);
+    (cx / length).store (nx);
+    (cy / length).store (ny);
+    (cz / length).store (nz);
+    for (unsigned int lane = 0; lane < FloatLanes::WIDTH && face + lane < m_size; lane++)
+    {
+      normals[face + lane] = Vector3 (nx[lane], ny[lane], nz[lane]);
+    }
+  }
+  return normals;
+}
+
+std::vector<float>
+TriangleBuffer::computeAreas () const
+{
+  // Write straight into a padded vector, then trim the padding off.
+  std::vector<float> areas (m_paddedSize);
+  const FloatLanes HALF = FloatLanes::broadcast (0.5f);
+  for (unsigned int face = 0; face < m_size; face += FloatLanes::WIDTH)
+  {
+    CornerEdges edges = loadCornerEdges (*this, 0, face);
+    FloatLanes cx = edges.m_ay * edges.m_bz - edges.m_az * edges.m_by;
+    FloatLanes cy = edges.m_az * edges.m_bx - edges.m_ax * edges.m_bz;
+    FloatLanes cz = edges.m_ax * edges.m_by - edges.m_ay * edges.m_bx;
+    (HALF * sqrt (cx * cx + cy * cy + cz * cz)).storeUnaligned (&areas[face]);
+  }
+  areas.resize (m_size);
+  return areas;
+}
+
+std::vector<float>
+TriangleBuffer::computeCornerAngles () const
+{
+  std::vector<float> angles (m_size * 3);
+  alignas (32) float lanes[FloatLanes::WIDTH];
+  for (unsigned int corner = 0; corner < 3; corner++)
+  {
+    for (unsigned int face = 0; face < m_size; face += FloatLanes::WIDTH)
+    {
+      CornerEdges edges = loadCornerEdges (*this, corner, face);
+      FloatLanes dot = edges.m_ax * edges.m_bx + edges.m_ay * edges.m_by + edges.m_az * edges.m_bz;
+      FloatLanes lengthA = sqrt (edges.m_ax * edges.m_ax + edges.m_ay * edges.m_ay + edges.m_az * edges.m_az);
+      FloatLanes lengthB = sqrt (edges.m_bx * edges.m_bx + edges.m_by * edges.m_by + edges.m_bz * edges.m_bz);
+      acos (dot / (lengthA * lengthB)).store (lanes);
+      for (unsigned int lane = 0; lane < FloatLanes::WIDTH && face + lane < m_size; lane++)
+      {
+        angles[(face + lane) * 3 + corner] = lanes[lane];
+      }
+    }
+  }
+  return angles;
+}
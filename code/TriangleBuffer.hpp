@@ -0,0 +1,146 @@
+/// \file TriangleBuffer.hpp
+/// \brief Declaration of TriangleBuffer class and any associated global
+///   functions.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// Macro guard
+#ifndef TRIANGLE_BUFFER_HPP
+#define TRIANGLE_BUFFER_HPP
+
+/******************************************************************/
+// System includes
+#include <vector>
+
+/******************************************************************/
+// Local includes
+#include "Geometry.hpp"
+#include "Vector3.hpp"
+
+/******************************************************************/
+/// \brief A collection of triangles stored as a structure of arrays.
+///
+/// Where std::vector<Triangle> stores x, y, z, x, y, z, ... for each corner of
+///   each face, a TriangleBuffer keeps nine separate streams: the x, y, and z
+///   coordinates of corner 0 of every face, then of corner 1, then of corner 2.
+///   Each stream is aligned for, and padded to a multiple of, the widest SIMD
+///   register, so kernels can process several faces per instruction without
+///   any shuffling.  Padding faces are all zeros.
+class TriangleBuffer
+{
+public:
+  /// \brief Constructs a TriangleBuffer of degenerate triangles.
+  /// \param[in] size The number of faces.
+  /// \post Every coordinate of every face is 0.0f.
+  explicit TriangleBuffer (unsigned int size = 0);
+
+  /// \brief Constructs a TriangleBuffer holding copies of some faces.
+  /// \param[in] faces A collection of faces.
+  /// \post This buffer holds the same faces, in the same order.
+  explicit TriangleBuffer (const std::vector<Triangle>& faces);
+
+  /// \brief Copy constructor removed because the streams are large and should
+  ///   not be copied by accident.
+  TriangleBuffer (const TriangleBuffer&) = delete;
+
+  /// \brief Assignment operator removed for the same reason.
+  TriangleBuffer&
+  operator= (const TriangleBuffer&) = delete;
+
+  /// \brief Moves the streams of another TriangleBuffer into a new one.
+  TriangleBuffer (TriangleBuffer&&) = default;
+
+  /// \brief Moves the streams of another TriangleBuffer into this one.
+  TriangleBuffer&
+  operator= (TriangleBuffer&&) = default;
+
+  /// \brief Gets the number of faces.
+  /// \return The number of faces, not counting padding.
+  unsigned int
+  size () const;
+
+  /// \brief Gets the length of each stream.
+  /// \return The number of faces including padding, which is a multiple of
+  ///   FloatLanes::WIDTH.
+  unsigned int
+  paddedSize () const;
+
+  /// \brief Gets the x-coordinate stream of one corner.
+  /// \param[in] corner Which corner (0, 1, or 2).
+  /// \return A pointer to paddedSize() aligned floats.
+  float*
+  x (unsigned int corner);
+
+  /// \brief Gets the x-coordinate stream of one corner.
+  const float*
+  x (unsigned int corner) const;
+
+  /// \brief Gets the y-coordinate stream of one corner.
+  float*
+  y (unsigned int corner);
+
+  /// \brief Gets the y-coordinate stream of one corner.
+  const float*
+  y (unsigned int corner) const;
+
+  /// \brief Gets the z-coordinate stream of one corner.
+  float*
+  z (unsigned int corner);
+
+  /// \brief Gets the z-coordinate stream of one corner.
+  const float*
+  z (unsigned int corner) const;
+
+  /// \brief Gets one face.
+  /// \param[in] face The index of the face.
+  /// \return A copy of that face.
+  Triangle
+  getTriangle (unsigned int face) const;
+
+  /// \brief Replaces one face.
+  /// \param[in] face The index of the face.
+  /// \param[in] triangle The new corners of that face.
+  void
+  setTriangle (unsigned int face, const Triangle& triangle);
+
+  /// \brief Converts this buffer back to an array of structures.
+  /// \return A collection containing every face, in order.
+  std::vector<Triangle>
+  toTriangles () const;
+
+  /// \brief Computes a normal vector for each face.
+  /// \return One unit normal per face, the same as computeFaceNormals would
+  ///   give for toTriangles().
+  std::vector<Vector3>
+  computeFaceNormals () const;
+
+  /// \brief Computes the area of each face.
+  /// \return One area per face.
+  std::vector<float>
+  computeAreas () const;
+
+  /// \brief Computes the angle at each corner of each face.
+  /// \return Three angles (in radians) per face, in the same order as the
+  ///   corners, to within about 1e-6 of Vector3::angleBetween.
+  std::vector<float>
+  computeCornerAngles () const;
+
+private:
+  /// \brief Gets the start of one of the nine streams.
+  /// \param[in] stream Which stream, as 3 * corner + axis.
+  float*
+  stream (unsigned int stream);
+
+  /// \brief Gets the start of one of the nine streams.
+  const float*
+  stream (unsigned int stream) const;
+
+  /// The number of faces.
+  unsigned int m_size;
+  /// The number of faces including padding.
+  unsigned int m_paddedSize;
+  /// Room for all nine streams plus enough slack to align the first one.
+  std::vector<float> m_storage;
+};
+
+#endif//TRIANGLE_BUFFER_HPP
@@ -12,7 +12,8 @@
 // Vertex attributes
 // Incoming position attribute for each vertex
 layout (location = 0) in vec3 aPosition;
-// Incoming normal attribute for each vertex
+// Incoming normal attribute for each vertex.  When it is octahedral
+//   encoded only x and y are set.
 layout (location = 2) in vec3 aNormal;
 
 /*********************************************************/
@@ -23,6 +24,8 @@ layout (location = 2) in vec3 aNormal;
 uniform mat4 uModelView;
 // Specify projection
 uniform mat4 uProjection;
+// Whether aNormal holds an octahedral encoded normal instead of a vector.
+uniform bool uOctahedralNormals = false;
 
 // We are using a single directional light to illuminate our scene. 
 // You can modify these parameters for your model.
@@ -39,6 +42,18 @@ uniform vec3 uLightIntensity = vec3 (0.5, 0.2, 0.1);
 // Vertex color we will output
 out vec3 vColor;
 
+// Unfolds a normal stored as a point on an octahedron, the inverse of
+//   encodeOctahedral in Geometry.cpp.
+vec3
+decodeOctahedral (vec2 folded)
+{
+  vec3 normal = vec3 (folded, 1.0 - abs (folded.x) - abs (folded.y));
+  float fold = max (-normal.z, 0.0);
+  normal.x += normal.x >= 0.0 ? -fold : fold;
+  normal.y += normal.y >= 0.0 ? -fold : fold;
+  return normalize (normal);
+}
+
 void
 main ()
 {
@@ -52,7 +67,8 @@ main ()
   //   to transform normals to eye space. 
   normalMatrix = transpose (inverse (normalMatrix));
   // Transform local/model normal to eye space. 
-  vec3 normalEye = normalize (normalMatrix * aNormal);
+  vec3 normal = uOctahedralNormals ? decodeOctahedral (aNormal.xy) : aNormal;
+  vec3 normalEye = normalize (normalMatrix * normal);
   // How directly is the light shining on the surface?
   float brightness = dot (normalEye, normalize (uLightDirection));
   // Ensure brightness is between 0 and 1
@@ -0,0 +1,249 @@
+/// \file VertexLayout.hpp
+/// \brief Declaration of VertexLayout, which describes an interleaved vertex
+///   by the attributes in it, working out its stride and offsets at compile
+///   time.
+/// \author Sean Malloy
+/// \version A08
+/******************************************************************/
+// Macro guard
+#ifndef VERTEXLAYOUT_HPP
+#define VERTEXLAYOUT_HPP
+
+/******************************************************************/
+// System includes
+#include <algorithm>
+#include <cstddef>
+
+/******************************************************************/
+// Local includes
+#include "Geometry.hpp"
+
+/******************************************************************/
+/// \brief A position, which every layout starts with.
+struct PositionAttribute
+{
+  /// The shader input location.
+  static constexpr unsigned int LOCATION = 0;
+  /// The number of floats.
+  static constexpr unsigned int FLOATS = 3;
+  /// What the welder treats it as.
+  static constexpr VertexAttribute KIND = VertexAttribute::NONE;
+};
+
+/// \brief A red, green, blue color.
+struct ColorAttribute
+{
+  static constexpr unsigned int LOCATION = 1;
+  static constexpr unsigned int FLOATS = 3;
+  static constexpr VertexAttribute KIND = VertexAttribute::COLOR;
+};
+
+/// \brief A unit normal vector.
+struct NormalAttribute
+{
+  static constexpr unsigned int LOCATION = 2;
+  static constexpr unsigned int FLOATS = 3;
+  static constexpr VertexAttribute KIND = VertexAttribute::NORMAL;
+};
+
+/// \brief A pair of texture coordinates.
+struct TexCoordAttribute
+{
+  static constexpr unsigned int LOCATION = 3;
+  static constexpr unsigned int FLOATS = 2;
+  static constexpr VertexAttribute KIND = VertexAttribute::NONE;
+};
+
+/// \brief Where one attribute is in each vertex, as vertexAttribPointer is
+///   told it.
+struct AttributeBinding
+{
+  /// The shader input location.
+  unsigned int m_location;
+  /// The number of floats.
+  unsigned int m_floats;
+  /// The number of floats before it in each vertex.
+  unsigned int m_offset;
+};
+
+/// \brief A VertexLayout as a Mesh keeps it, so that the Mesh need not be a
+///   template.
+struct VertexLayoutDescription
+{
+  /// The number of floats in each vertex.
+  unsigned int m_floatsPerVertex;
+  /// What the welder, and the packed vertex formats, treat the attribute
+  ///   after the position as.  This is NONE unless there is exactly one.
+  VertexAttribute m_attribute;
+  /// The attributes' locations in order, one octal digit each, plus one.
+  ///   Two layouts are the same exactly when their signatures are.
+  unsigned int m_signature;
+  /// Each attribute, in order.
+  const AttributeBinding* m_bindings;
+  /// The number of attributes.
+  unsigned int m_bindingCount;
+};
+
+/******************************************************************/
+/// \brief Adds up the floats of some attributes.
+template<typename... Attributes>
+struct AttributeFloats;
+
+template<>
+struct AttributeFloats<>
+{
+  static constexpr unsigned int VALUE = 0;
+};
+
+template<typename First, typename... Rest>
+struct AttributeFloats<First, Rest...>
+{
+  static constexpr unsigned int VALUE = First::FLOATS + AttributeFloats<Rest...>::VALUE;
+};
+
+/// \brief Counts the floats of the attributes before Wanted.
+template<typename Wanted, typename... Attributes>
+struct AttributeOffset;
+
+template<typename Wanted>
+struct AttributeOffset<Wanted>
+{
+  static_assert (sizeof (Wanted) == 0, "The attribute is not in the layout.");
+};
+
+template<typename Wanted, typename First, typename... Rest>
+struct AttributeOffset<Wanted, First, Rest...>
+{
+  static constexpr unsigned int VALUE = First::FLOATS + AttributeOffset<Wanted, Rest...>::VALUE;
+};
+
+template<typename Wanted, typename... Rest>
+struct AttributeOffset<Wanted, Wanted, Rest...>
+{
+  static constexpr unsigned int VALUE = 0;
+};
+
+/// \brief Folds the locations of some attributes into a signature.
+template<typename... Attributes>
+struct AttributeSignature;
+
+template<>
+struct AttributeSignature<>
+{
+  static constexpr unsigned int VALUE = 0;
+};
+
+template<typename First, typename... Rest>
+struct AttributeSignature<First, Rest...>
+{
+  /// Octal digits, most significant first, so that order matters.
+  static constexpr unsigned int VALUE = (First::LOCATION + 1) << (3 * sizeof... (Rest))
+    | AttributeSignature<Rest...>::VALUE;
+};
+
+/// \brief Finds what the welder treats the attribute after a position as,
+///   which is NONE unless there is exactly one.
+template<typename... Attributes>
+struct SingleAttributeKind
+{
+  static constexpr VertexAttribute VALUE = VertexAttribute::NONE;
+};
+
+template<typename Attribute>
+struct SingleAttributeKind<PositionAttribute, Attribute>
+{
+  static constexpr VertexAttribute VALUE = Attribute::KIND;
+};
+
+/// \brief The type of the source each attribute is interleaved from.
+template<typename Attribute>
+struct AttributeSource
+{
+  typedef const float* Type;
+};
+
+/******************************************************************/
+/// \brief An interleaved vertex of floats holding Attributes, in order.
+/// \tparam Attributes Any of ColorAttribute, NormalAttribute, and
+///   TexCoordAttribute after a PositionAttribute, each at most once.
+/// Everything about the layout is known at compile time, so code written
+///   against it needs no virtual calls to find out where an attribute is.
+template<typename... Attributes>
+class VertexLayout
+{
+public:
+  /// The number of attributes.
+  static constexpr unsigned int ATTRIBUTE_COUNT = sizeof... (Attributes);
+  /// The number of floats in each vertex.
+  static constexpr unsigned int FLOATS_PER_VERTEX = AttributeFloats<Attributes...>::VALUE;
+  /// The number of bytes from one vertex to the next.
+  static constexpr std::size_t STRIDE = FLOATS_PER_VERTEX * sizeof (float);
+  /// Each attribute, in order.
+  static constexpr AttributeBinding BINDINGS[] =
+    { { Attributes::LOCATION, Attributes::FLOATS,
+        AttributeOffset<Attributes, Attributes...>::VALUE }... };
+  /// The layout as a Mesh keeps it.
+  static constexpr VertexLayoutDescription DESCRIPTION =
+    { FLOATS_PER_VERTEX, SingleAttributeKind<Attributes...>::VALUE,
+      AttributeSignature<Attributes...>::VALUE, BINDINGS, ATTRIBUTE_COUNT };
+
+  static_assert (AttributeOffset<PositionAttribute, Attributes...>::VALUE == 0,
+                 "Every vertex starts with its position.");
+
+  /// \brief Gets how far into each vertex an attribute starts.
+  /// \tparam Attribute One of Attributes.
+  /// \return The number of floats before it.
+  template<typename Attribute>
+  static constexpr unsigned int
+  offsetOf ()
+  {
+    return AttributeOffset<Attribute, Attributes...>::VALUE;
+  }
+
+  /// \brief Interleaves separate arrays, one per attribute, into this layout.
+  /// \param[out] destination Where to write vertexCount * FLOATS_PER_VERTEX
+  ///   floats.
+  /// \param[in] vertexCount The number of vertices.
+  /// \param[in] sources One array per attribute, in order, each holding
+  ///   vertexCount of that attribute back to back.
+  /// \return A pointer just past the last float written.
+  static float*
+  interleave (float* destination, std::size_t vertexCount,
+              typename AttributeSource<Attributes>::Type... sources)
+  {
+    for (std::size_t vertex = 0; vertex < vertexCount; vertex++)
+    {
+      // Each attribute's copy is unrolled, since its size is a constant.
+      int expand[] = { (std::copy (sources + vertex * Attributes::FLOATS,
+                                   sources + (vertex + 1) * Attributes::FLOATS,
+                                   destination + offsetOf<Attributes> ()), 0)... };
+      static_cast<void> (expand);
+      destination += FLOATS_PER_VERTEX;
+    }
+    return destination;
+  }
+};
+
+template<typename... Attributes>
+constexpr unsigned int VertexLayout<Attributes...>::ATTRIBUTE_COUNT;
+
+template<typename... Attributes>
+constexpr unsigned int VertexLayout<Attributes...>::FLOATS_PER_VERTEX;
+
+template<typename... Attributes>
+constexpr std::size_t VertexLayout<Attributes...>::STRIDE;
+
+template<typename... Attributes>
+constexpr AttributeBinding VertexLayout<Attributes...>::BINDINGS[];
+
+template<typename... Attributes>
+constexpr VertexLayoutDescription VertexLayout<Attributes...>::DESCRIPTION;
+
+/// Positions alone.
+typedef VertexLayout<PositionAttribute> PositionsLayout;
+/// Positions and colors, as ColorsMesh draws them.
+typedef VertexLayout<PositionAttribute, ColorAttribute> ColorsLayout;
+/// Positions and normals, as NormalsMesh draws them.
+typedef VertexLayout<PositionAttribute, NormalAttribute> NormalsLayout;
+
+#endif//VERTEXLAYOUT_HPP